@@ -65,3 +65,11 @@ set( CF_MPI_TESTS_SIZE         "4" CACHE STRING "Size description of the MPI tes
 mark_as_advanced(CF_MPI_TESTS_NB_PROCS)
 mark_as_advanced(CF_MPI_TESTS_MAX_NB_PROCS)
 mark_as_advanced(CF_MPI_TESTS_SIZE)
+
+# benchmark options
+
+set( CF_BENCHMARK_SIZE "1" CACHE STRING "Scale factor for the problem size of the benchmarks, run using the benchmark target")
+set( CF_BENCHMARK_DIR  "${CMAKE_BINARY_DIR}/benchmark" CACHE PATH "Directory where the benchmark target writes the results")
+
+mark_as_advanced(CF_BENCHMARK_SIZE)
+mark_as_advanced(CF_BENCHMARK_DIR)
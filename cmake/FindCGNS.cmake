@@ -7,6 +7,7 @@
 #   CGNS_INCLUDE_DIR
 #   CGNS_LIBRARIES
 #   CF_HAVE_CGNS
+#   CF_HAVE_CGNS_PARALLEL  (the library provides the parallel cgp_* API)
 #
 
 option( CF_SKIP_CGNS "Skip search for CGNS library" OFF )
@@ -35,3 +36,33 @@ option( CF_SKIP_CGNS "Skip search for CGNS library" OFF )
 
 coolfluid_add_package( PACKAGE CGNS DESCRIPTION "CFD General Notation System" URL "http://cgns.sourceforge.net"
                        VARS CGNS_INCLUDE_DIR CGNS_LIBRARIES )
+
+# check if the library was built with parallel HDF5, which provides the parallel cgp_* interface
+set( CF_HAVE_CGNS_PARALLEL OFF CACHE BOOL "CGNS provides parallel I/O" FORCE )
+if( CF_HAVE_CGNS )
+
+  set( CMAKE_REQUIRED_INCLUDES  ${CGNS_INCLUDE_DIR} ${MPI_INCLUDE_PATH} )
+  set( CMAKE_REQUIRED_LIBRARIES ${CGNS_LIBRARIES} ${MPI_LIBRARIES} )
+
+  check_cxx_source_compiles(
+    "#include <pcgnslib.h>
+     #if !CG_BUILD_PARALLEL
+     #error CGNS was built without parallel support
+     #endif
+     int main(int argc, char* argv[])
+     {
+       int file;
+       return cgp_open(\"test.cgns\", CG_MODE_WRITE, &file);
+     }"
+     CF_CGNS_PARALLEL_COMPILES )
+
+  unset( CMAKE_REQUIRED_INCLUDES )
+  unset( CMAKE_REQUIRED_LIBRARIES )
+
+  if( CF_CGNS_PARALLEL_COMPILES )
+    set( CF_HAVE_CGNS_PARALLEL ON CACHE BOOL "CGNS provides parallel I/O" FORCE )
+  endif()
+
+  coolfluid_log_file( "[CGNS] parallel I/O : [${CF_HAVE_CGNS_PARALLEL}]" )
+
+endif()
@@ -189,6 +189,35 @@ if( ${${UTESTNAME}_builds} ) # dont add if it does not build
 
   endif() # mpi and performance skip
 
+  # benchmarks are also run by the benchmark target, which stores the results in CF_BENCHMARK_DIR
+  if( ${UTESTNAME}_benchmark )
+
+    if( ${UTESTNAME}_mpi_test )
+      if( NOT DEFINED ${UTESTNAME}_mpi_nprocs )
+         set(${UTESTNAME}_mpi_nprocs "1")
+      endif()
+      set( ${UTESTNAME}_benchmark_command ${CF_MPIRUN_PROGRAM} "-np" ${${UTESTNAME}_mpi_nprocs} ${CMAKE_CURRENT_BINARY_DIR}/${UTESTNAME} )
+    else()
+      set( ${UTESTNAME}_benchmark_command ${CMAKE_CURRENT_BINARY_DIR}/${UTESTNAME} )
+    endif()
+
+    add_custom_target( benchmark-${UTESTNAME}
+                       COMMAND ${CMAKE_COMMAND} -E make_directory ${CF_BENCHMARK_DIR}
+                       COMMAND ${${UTESTNAME}_benchmark_command} ${${UTESTNAME}_args} ${CF_BENCHMARK_DIR}/${UTESTNAME}.json
+                       WORKING_DIRECTORY ${CMAKE_CURRENT_BINARY_DIR}
+                       DEPENDS ${UTESTNAME} )
+
+    # benchmarks must not run concurrently, so chain them
+    get_property( CF_LAST_BENCHMARK GLOBAL PROPERTY CF_LAST_BENCHMARK )
+    if( CF_LAST_BENCHMARK )
+      add_dependencies( benchmark-${UTESTNAME} ${CF_LAST_BENCHMARK} )
+    endif()
+    set_property( GLOBAL PROPERTY CF_LAST_BENCHMARK benchmark-${UTESTNAME} )
+
+    add_dependencies( benchmark benchmark-${UTESTNAME} )
+
+  endif()
+
 endif() # build guard
 
 endmacro( coolfluid_add_unit_test )
@@ -33,6 +33,9 @@ public: //typedefs
   typedef boost::shared_ptr<Cons2D> Ptr;
   typedef boost::shared_ptr<Cons2D const> ConstPtr;
 
+  /// implements compute_properties, flux_jacobian_eigen_structure and residual for MODEL::BatchProperties
+  enum { has_batch_interface = true };
+
 public: // functions
 
   /// constructor
@@ -65,14 +68,7 @@ public: // functions
     p.rhov  = sol[RhoV];
     p.rhoE  = sol[RhoE];
 
-    p.inv_rho = 1. / p.rho;
-
-    p.u   = p.rhou * p.inv_rho;
-    p.v   = p.rhov * p.inv_rho;
-
-    p.uuvv = p.u*p.u + p.v*p.v;
-
-    p.P = p.gamma_minus_1 * ( p.rhoE - 0.5 * p.rho * p.uuvv );
+    compute_derived_properties<Real>(p);
 
     if( p.P <= 0. )
     {
@@ -91,22 +87,35 @@ public: // functions
                                    + Common::to_str(coord[YY])
                                    + "]");
     }
+  }
 
-    const Real RT = p.P * p.inv_rho;    // RT = p/rho
-
-    p.E = p.rhoE * p.inv_rho;           // E = rhoE / rho
-
-    p.H = p.E + RT;                     // H = E + p/rho
-
-    p.a = sqrt( p.gamma * RT );
+  /// compute physical properties for a batch of states
+  /// @param coords coordinates of the states, one row per state
+  /// @param sol    variables of the states, one row per state
+  template < int N, typename CM, typename SM >
+  static void compute_properties ( const CM& coords,
+                                   const SM& sol,
+                                   MODEL::BatchProperties<N>& p )
+  {
+    p.R = 287.058;                 // air
+    p.gamma = 1.4;                 // diatomic ideal gas
+    p.gamma_minus_1 = p.gamma - 1.;
 
-    p.a2 = p.a * p.a;
+    p.rho   = sol.col(Rho ).array();
+    p.rhou  = sol.col(RhoU).array();
+    p.rhov  = sol.col(RhoV).array();
+    p.rhoE  = sol.col(RhoE).array();
 
-    p.Ma = sqrt( p.uuvv / p.a2 );
+    compute_derived_properties< typename MODEL::BatchProperties<N>::ArrayT >(p);
 
-    p.T = RT / p.R;
-
-    p.half_gm1_v2 = 0.5 * p.gamma_minus_1 * p.uuvv;
+    for(int i = 0; i != N; ++i)
+    {
+      if( p.P[i] <= 0. )
+        throw Common::BadValue( FromHere(), "Pressure is negative at coordinates ["
+                                     + Common::to_str(coords(i,XX)) + ","
+                                     + Common::to_str(coords(i,YY))
+                                     + "]");
+    }
   }
 
   /// compute the physical flux
@@ -159,6 +168,23 @@ public: // functions
     Dv[3] = op_um - p.a;
   }
 
+  /// compute the eigen values of the flux jacobians for a batch of states
+  /// @param direction projection direction for each state, one row per state
+  /// @param Dv eigen values, one row per state
+  template < int N >
+  static void flux_jacobian_eigen_values(const MODEL::BatchProperties<N>& p,
+                                         const typename MODEL::BatchProperties<N>::GeoA& direction,
+                                         typename MODEL::BatchProperties<N>::SolA& Dv)
+  {
+    const typename MODEL::BatchProperties<N>::ArrayT um = p.u * direction.col(XX)
+                                                        + p.v * direction.col(YY);
+
+    Dv.col(0) = um;
+    Dv.col(1) = um;
+    Dv.col(2) = um + p.a;
+    Dv.col(3) = um - p.a;
+  }
+
   /// decompose the eigen structure of the flux jacobians projected on the gradients
   template < typename GV, typename EM, typename EV >
   static void flux_jacobian_eigen_structure(const MODEL::Properties& p,
@@ -230,6 +256,78 @@ public: // functions
 
   }
 
+  /// decompose the eigen structure of the flux jacobians projected on the gradients, for a batch of states
+  /// @param direction projection direction for each state, one row per state
+  /// @param Rv right eigen vectors, one row per state
+  /// @param Lv left eigen vectors, one row per state
+  /// @param Dv eigen values, one row per state
+  template < int N >
+  static void flux_jacobian_eigen_structure(const MODEL::BatchProperties<N>& p,
+                                            const typename MODEL::BatchProperties<N>::GeoA& direction,
+                                            typename MODEL::BatchProperties<N>::SolMA& Rv,
+                                            typename MODEL::BatchProperties<N>::SolMA& Lv,
+                                            typename MODEL::BatchProperties<N>::SolA& Dv)
+  {
+    typedef typename MODEL::BatchProperties<N>::ArrayT ArrayT;
+
+    const ArrayT nx = direction.col(XX);
+    const ArrayT ny = direction.col(YY);
+
+    const ArrayT inv_a  = p.a.inverse();
+    const ArrayT inv_a2 = inv_a * inv_a;
+
+    const ArrayT um = p.u * nx + p.v * ny;
+    const ArrayT ra = 0.5 * p.rho * inv_a;
+
+    const ArrayT coeffM2 = p.half_gm1_v2 * inv_a2;
+    const ArrayT uDivA = p.gamma_minus_1 * p.u * inv_a;
+    const ArrayT vDivA = p.gamma_minus_1 * p.v * inv_a;
+
+    const ArrayT gm1_ov_rhoa = p.gamma_minus_1 * ( p.rho * p.a ).inverse();
+
+    // matrix of right eigen vectors R
+
+    Rv.col(ij(0,0)).setOnes();
+    Rv.col(ij(0,1)).setZero();
+    Rv.col(ij(0,2)) = ra;
+    Rv.col(ij(0,3)) = ra;
+    Rv.col(ij(1,0)) = p.u;
+    Rv.col(ij(1,1)) = p.rho * ny;
+    Rv.col(ij(1,2)) = ra*(p.u + p.a*nx);
+    Rv.col(ij(1,3)) = ra*(p.u - p.a*nx);
+    Rv.col(ij(2,0)) = p.v;
+    Rv.col(ij(2,1)) = -p.rho*nx;
+    Rv.col(ij(2,2)) = ra*(p.v + p.a*ny);
+    Rv.col(ij(2,3)) = ra*(p.v - p.a*ny);
+    Rv.col(ij(3,0)) = 0.5 * p.uuvv;
+    Rv.col(ij(3,1)) = p.rho * (p.u*ny - p.v*nx);
+    Rv.col(ij(3,2)) = ra*(p.H + p.a*um);
+    Rv.col(ij(3,3)) = ra*(p.H - p.a*um);
+
+    // matrix of left eigen vectors L = R.inverse();
+
+    Lv.col(ij(0,0)) = 1.- coeffM2;
+    Lv.col(ij(0,1)) = uDivA*inv_a;
+    Lv.col(ij(0,2)) = vDivA*inv_a;
+    Lv.col(ij(0,3)) = -p.gamma_minus_1 * inv_a2;
+    Lv.col(ij(1,0)) = p.inv_rho * (p.v*nx - p.u*ny);
+    Lv.col(ij(1,1)) = p.inv_rho * ny;
+    Lv.col(ij(1,2)) = -p.inv_rho * nx;
+    Lv.col(ij(1,3)).setZero();
+    Lv.col(ij(2,0)) = p.a*p.inv_rho * (coeffM2 - um*inv_a);
+    Lv.col(ij(2,1)) = p.inv_rho * (nx - uDivA);
+    Lv.col(ij(2,2)) = p.inv_rho * (ny - vDivA);
+    Lv.col(ij(2,3)) = gm1_ov_rhoa;
+    Lv.col(ij(3,0)) = p.a*p.inv_rho*(coeffM2 + um*inv_a);
+    Lv.col(ij(3,1)) = -p.inv_rho*(nx + uDivA);
+    Lv.col(ij(3,2)) = -p.inv_rho*(ny + vDivA);
+    Lv.col(ij(3,3)) = gm1_ov_rhoa;
+
+    // eigen values
+
+    flux_jacobian_eigen_values(p, direction, Dv);
+  }
+
   /// compute the PDE residual
   template < typename JM, typename RV >
   static void residual(const MODEL::Properties& p,
@@ -293,6 +391,104 @@ public: // functions
     res = A * p.grad_vars.col(XX) + B * p.grad_vars.col(YY);
   }
 
+  /// compute the PDE residual for a batch of states
+  /// @param grad_vars gradient of the variables along each dimension, one row per state
+  /// @param res residual, one row per state
+  template < int N >
+  static void residual(const MODEL::BatchProperties<N>& p,
+                       const typename MODEL::BatchProperties<N>::SolA grad_vars[],
+                       typename MODEL::BatchProperties<N>::SolA& res)
+  {
+    typedef typename MODEL::BatchProperties<N>::ArrayT ArrayT;
+
+    const Real gamma_minus_3 = p.gamma - 3.;
+
+    const ArrayT uu = p.u * p.u;
+    const ArrayT uv = p.u * p.v;
+    const ArrayT vv = p.v * p.v;
+
+    const typename MODEL::BatchProperties<N>::SolA& dx = grad_vars[XX];
+    const typename MODEL::BatchProperties<N>::SolA& dy = grad_vars[YY];
+
+    // A.dU/dx + B.dU/dy, with the flux jacobians A and B written out as in the single state version
+
+    res.col(0) = dx.col(1)
+               + dy.col(2);
+
+    res.col(1) = ( p.half_gm1_v2 - uu ) * dx.col(0)
+               - gamma_minus_3 * p.u * dx.col(1)
+               - p.gamma_minus_1 * p.v * dx.col(2)
+               + p.gamma_minus_1 * dx.col(3)
+               - uv * dy.col(0)
+               + p.v * dy.col(1)
+               + p.u * dy.col(2);
+
+    res.col(2) = - uv * dx.col(0)
+                 + p.v * dx.col(1)
+                 + p.u * dx.col(2)
+                 + ( p.half_gm1_v2 - vv ) * dy.col(0)
+                 - p.gamma_minus_1 * p.u * dy.col(1)
+                 - gamma_minus_3 * p.v * dy.col(2)
+                 + p.gamma_minus_1 * dy.col(3);
+
+    res.col(3) = ( p.half_gm1_v2*p.u - p.u*p.H ) * dx.col(0)
+               + ( p.H - p.gamma_minus_1*uu ) * dx.col(1)
+               - p.gamma_minus_1 * uv * dx.col(2)
+               + p.gamma * p.u * dx.col(3)
+               + ( p.half_gm1_v2*p.v - p.v*p.H ) * dy.col(0)
+               - p.gamma_minus_1 * uv * dy.col(1)
+               + ( p.H - p.gamma_minus_1*vv ) * dy.col(2)
+               + p.gamma * p.v * dy.col(3);
+  }
+
+private: // functions
+
+  /// compute the properties that follow from rho, rhou, rhov and rhoE.
+  /// Written once for a single state (T is Real) and for a batch of states (T is an Eigen array)
+  template < typename T, typename PT >
+  static void compute_derived_properties ( PT& p )
+  {
+    using std::sqrt;
+
+    p.inv_rho = reciprocal(p.rho);
+
+    p.u   = p.rhou * p.inv_rho;
+    p.v   = p.rhov * p.inv_rho;
+
+    p.uuvv = p.u*p.u + p.v*p.v;
+
+    p.P = p.gamma_minus_1 * ( p.rhoE - 0.5 * p.rho * p.uuvv );
+
+    const T RT = p.P * p.inv_rho;       // RT = p/rho
+
+    p.E = p.rhoE * p.inv_rho;           // E = rhoE / rho
+
+    p.H = p.E + RT;                     // H = E + p/rho
+
+    p.a = sqrt( p.gamma * RT );
+
+    p.a2 = p.a * p.a;
+
+    p.Ma = sqrt( p.uuvv / p.a2 );
+
+    p.T = RT / p.R;
+
+    p.half_gm1_v2 = 0.5 * p.gamma_minus_1 * p.uuvv;
+  }
+
+  /// column of coefficient (i,j) in the matrices of a batch of states
+  static Uint ij ( const Uint i, const Uint j ) { return i + MODEL::_neqs * j; }
+
+  /// inverse of a single value
+  static Real reciprocal ( const Real x ) { return 1. / x; }
+
+  /// coefficient-wise inverse of a batch of values
+  template < typename Derived >
+  static const Eigen::CwiseUnaryOp<Eigen::internal::scalar_inverse_op<Real>, const Derived> reciprocal ( const Eigen::ArrayBase<Derived>& x )
+  {
+    return x.inverse();
+  }
+
 }; // Cons2D
 
 ////////////////////////////////////////////////////////////////////////////////////
@@ -77,6 +77,46 @@ public: // functions
     Real Ma;                  ///< mach number
   };
 
+  /// physical properties of a batch of N states, stored as one array per property (structure of arrays)
+  /// so the computations for all states in the batch are done in the same vectorizable loops
+  template < int N >
+  struct BatchProperties
+  {
+
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW  ///< storing fixed-sized Eigen structures
+
+    typedef Eigen::Array<Real, N, 1>     ArrayT;  ///< type of a property for all states in the batch
+    typedef Eigen::Array<Real, N, _ndim> GeoA;    ///< type of a vector in space for all states, one row per state
+    typedef Eigen::Array<Real, N, _neqs> SolA;    ///< type of the variables for all states, one row per state
+    /// type of a matrix of size _neqs x _neqs for all states, one row per state,
+    /// with coefficient (i,j) in column i + _neqs*j
+    typedef Eigen::Array<Real, N, _neqs*_neqs> SolMA;
+
+    Real gamma;               ///< specific heat ratio
+    Real gamma_minus_1;       ///< specific heat ratio minus one, very commonly used
+    Real R;                   ///< gas constant
+
+    ArrayT rho;               ///< density
+    ArrayT rhou;              ///< rho.u
+    ArrayT rhov;              ///< rho.v
+    ArrayT rhoE;              ///< rho.E
+
+    ArrayT inv_rho;           ///< inverse of density, very commonly used
+
+    ArrayT u;                 ///< velocity along XX
+    ArrayT v;                 ///< velocity along YY
+    ArrayT uuvv;              ///< u^2 + v^2
+
+    ArrayT H;                 ///< specific enthalpy
+    ArrayT a2;                ///< square of speed of sound, very commonly used
+    ArrayT a;                 ///< speed of sound
+    ArrayT P;                 ///< pressure
+    ArrayT T;                 ///< temperature
+    ArrayT E;                 ///< specific internal energy
+    ArrayT half_gm1_v2;       ///< 1/2.(g-1).(u^2+v^2), very commonly used
+    ArrayT Ma;                ///< mach number
+  };
+
   /// @name INTERFACE
   //@{
 
@@ -7,12 +7,15 @@
 #define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MODULE "Test module for CF::Physics::NavierStokes::Cons2D"
 
+#include <cmath>
+
 #include <boost/test/unit_test.hpp>
 
 #include "Common/Log.hpp"
 #include "Common/Core.hpp"
 #include "Common/CRoot.hpp"
 #include "Common/CEnv.hpp"
+#include "Common/BasicExceptions.hpp"
 
 #include "NavierStokes/Cons2D.hpp"
 
@@ -57,6 +60,107 @@ BOOST_AUTO_TEST_CASE( flux )
 {
 }
 
+BOOST_AUTO_TEST_CASE( batch_matches_single_states )
+{
+  enum { N = 4 };
+
+  typedef NavierStokes2D::BatchProperties<N> BatchPropertiesT;
+
+  // batch of states, one per row
+
+  Eigen::Matrix<Real, N, NavierStokes2D::_ndim> coords;
+  Eigen::Matrix<Real, N, NavierStokes2D::_neqs> vars;
+  BatchPropertiesT::GeoA normals;
+
+  for(int i = 0; i != N; ++i)
+  {
+    coords(i,XX) = 0.5 * i;
+    coords(i,YY) = 2.0;
+
+    vars(i,Cons2D::Rho ) = 1.0 + 0.1 * i;
+    vars(i,Cons2D::RhoU) = 2.83972 - 0.5 * i;
+    vars(i,Cons2D::RhoV) = 0.3 * i;
+    vars(i,Cons2D::RhoE) = 6.532 + 0.2 * i;
+
+    normals(i,XX) = std::cos(0.4 * i);
+    normals(i,YY) = std::sin(0.4 * i);
+  }
+
+  BatchPropertiesT batch;
+  Cons2D::compute_properties(coords, vars, batch);
+
+  BatchPropertiesT::SolA batch_grad_vars[NavierStokes2D::_ndim];
+  for(int i = 0; i != N; ++i)
+    for(Uint eq = 0; eq != NavierStokes2D::_neqs; ++eq)
+    {
+      batch_grad_vars[XX](i,eq) = 0.1 * (eq + 1) - 0.05 * i;
+      batch_grad_vars[YY](i,eq) = 0.02 * i * eq - 0.3;
+    }
+
+  BatchPropertiesT::SolA batch_residual;
+  Cons2D::residual(batch, batch_grad_vars, batch_residual);
+
+  BatchPropertiesT::SolMA batch_right_eigen_vectors;
+  BatchPropertiesT::SolMA batch_left_eigen_vectors;
+  BatchPropertiesT::SolA batch_eigen_values;
+  Cons2D::flux_jacobian_eigen_structure(batch, normals, batch_right_eigen_vectors, batch_left_eigen_vectors, batch_eigen_values);
+
+  // compare with the properties computed one state at a time
+
+  for(int i = 0; i != N; ++i)
+  {
+    NavierStokes2D::GeoV coord = coords.row(i).transpose();
+    NavierStokes2D::SolV sol = vars.row(i).transpose();
+    NavierStokes2D::GeoV normal = normals.row(i).matrix().transpose();
+
+    NavierStokes2D::SolM grad_vars;
+    grad_vars.col(XX) = batch_grad_vars[XX].row(i).matrix().transpose();
+    grad_vars.col(YY) = batch_grad_vars[YY].row(i).matrix().transpose();
+
+    NavierStokes2D::Properties p;
+    Cons2D::compute_properties(coord, sol, grad_vars, p);
+
+    BOOST_CHECK_CLOSE(batch.P[i],  p.P,  1e-10);
+    BOOST_CHECK_CLOSE(batch.H[i],  p.H,  1e-10);
+    BOOST_CHECK_CLOSE(batch.a[i],  p.a,  1e-10);
+    BOOST_CHECK_CLOSE(batch.T[i],  p.T,  1e-10);
+    BOOST_CHECK_CLOSE(batch.Ma[i], p.Ma, 1e-10);
+
+    Eigen::Matrix<Real, NavierStokes2D::_neqs, NavierStokes2D::_neqs> flux_jacob[NavierStokes2D::_ndim];
+    NavierStokes2D::SolV res;
+    Cons2D::residual(p, flux_jacob, res);
+
+    Eigen::Matrix<Real, NavierStokes2D::_neqs, NavierStokes2D::_neqs> right_eigen_vectors;
+    Eigen::Matrix<Real, NavierStokes2D::_neqs, NavierStokes2D::_neqs> left_eigen_vectors;
+    NavierStokes2D::SolV eigen_values;
+    Cons2D::flux_jacobian_eigen_structure(p, normal, right_eigen_vectors, left_eigen_vectors, eigen_values);
+
+    for(Uint eq = 0; eq != NavierStokes2D::_neqs; ++eq)
+    {
+      BOOST_CHECK_SMALL(batch_residual(i,eq) - res[eq], 1e-12);
+      BOOST_CHECK_SMALL(batch_eigen_values(i,eq) - eigen_values[eq], 1e-12);
+
+      for(Uint j = 0; j != NavierStokes2D::_neqs; ++j)
+      {
+        BOOST_CHECK_SMALL(batch_right_eigen_vectors(i, eq + NavierStokes2D::_neqs*j) - right_eigen_vectors(eq,j), 1e-12);
+        BOOST_CHECK_SMALL(batch_left_eigen_vectors(i, eq + NavierStokes2D::_neqs*j) - left_eigen_vectors(eq,j), 1e-12);
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( batch_negative_pressure )
+{
+  Eigen::Matrix<Real, 2, NavierStokes2D::_ndim> coords = Eigen::Matrix<Real, 2, NavierStokes2D::_ndim>::Zero();
+  Eigen::Matrix<Real, 2, NavierStokes2D::_neqs> vars;
+
+  vars << 1.0, 1.0, 0.0, 6.5,
+          1.0, 4.0, 0.0, 1.0;
+
+  NavierStokes2D::BatchProperties<2> batch;
+  BOOST_CHECK_THROW(Cons2D::compute_properties(coords, vars, batch), BadValue);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,180 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef CF_RDM_BatchMatrix_hpp
+#define CF_RDM_BatchMatrix_hpp
+
+#include <Eigen/Dense>
+
+#include "Math/Consts.hpp"
+
+#include "RDM/LibRDM.hpp"
+
+namespace CF {
+namespace RDM {
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+/// Small dense matrices of the same size for a batch of NB elements, stored as a structure of arrays.
+/// Coefficient (i,j) of all the matrices in the batch is one contiguous column of NB values,
+/// so the operations below work on all elements of the batch at once, in vectorizable loops.
+template < int NB, int R, int C >
+struct BatchMatrix
+{
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW  ///< storing fixed-sized Eigen structures
+
+  /// coefficients for all elements in the batch
+  typedef Eigen::Array<Real, NB, 1> LaneT;
+  /// storage, one column per coefficient
+  typedef Eigen::Array<Real, NB, R*C> DataT;
+
+  /// coefficient (i,j) for all elements in the batch
+  typename DataT::ColXpr operator() ( const Uint i, const Uint j ) { return data.col(i + R*j); }
+  /// coefficient (i,j) for all elements in the batch
+  typename DataT::ConstColXpr operator() ( const Uint i, const Uint j ) const { return data.col(i + R*j); }
+
+  /// set the matrix of element b of the batch
+  template < typename MatrixT >
+  void set ( const Uint b, const MatrixT& m )
+  {
+    for(Uint j = 0; j < C; ++j)
+      for(Uint i = 0; i < R; ++i)
+        data(b, i + R*j) = m(i,j);
+  }
+
+  /// get the matrix of element b of the batch
+  template < typename MatrixT >
+  void get ( const Uint b, MatrixT& m ) const
+  {
+    for(Uint j = 0; j < C; ++j)
+      for(Uint i = 0; i < R; ++i)
+        m(i,j) = data(b, i + R*j);
+  }
+
+  void setZero() { data.setZero(); }
+
+  DataT data;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+/// y += a * x, for all elements in the batch
+template < int NB, int R, int C, int K >
+inline void batch_multiply_add ( const BatchMatrix<NB,R,C>& a,
+                                 const BatchMatrix<NB,C,K>& x,
+                                 BatchMatrix<NB,R,K>& y )
+{
+  for(Uint k = 0; k < K; ++k)
+    for(Uint j = 0; j < C; ++j)
+      for(Uint i = 0; i < R; ++i)
+        y(i,k) += a(i,j) * x(j,k);
+}
+
+/// k = r * diag(d) * l, for all elements in the batch
+template < int NB, int N >
+inline void batch_diagonal_product ( const BatchMatrix<NB,N,N>& r,
+                                     const BatchMatrix<NB,N,1>& d,
+                                     const BatchMatrix<NB,N,N>& l,
+                                     BatchMatrix<NB,N,N>& k )
+{
+  typedef typename BatchMatrix<NB,N,N>::LaneT LaneT;
+
+  k.setZero();
+  for(Uint m = 0; m < N; ++m)
+    for(Uint j = 0; j < N; ++j)
+    {
+      const LaneT dl = d(m,0) * l(m,j);
+      for(Uint i = 0; i < N; ++i)
+        k(i,j) += r(i,m) * dl;
+    }
+}
+
+/// Solves a.x = b for all elements in the batch by gaussian elimination with partial pivoting,
+/// overwriting b with the solution. a is destroyed.
+/// The rows are exchanged lane by lane, so each element gets its own pivots
+/// while the elimination still runs on all elements of the batch at once.
+/// @return false if a matrix is singular to working precision, that is if a pivot is smaller than
+///         eps * N times the infinity norm of its matrix. The contents of a and b are then undefined.
+template < int NB, int N, int K >
+inline bool batch_solve ( BatchMatrix<NB,N,N>& a, BatchMatrix<NB,N,K>& b )
+{
+  typedef typename BatchMatrix<NB,N,N>::LaneT LaneT;
+  typedef Eigen::Array<bool, NB, 1> MaskT;
+
+  // infinity norm of each matrix
+
+  LaneT norm = LaneT::Zero();
+  for(Uint i = 0; i < N; ++i)
+  {
+    LaneT row_sum = a(i,0).abs();
+    for(Uint j = 1; j < N; ++j)
+      row_sum += a(i,j).abs();
+    norm = norm.max(row_sum);
+  }
+
+  const LaneT tolerance = norm * ( Math::Consts::eps() * N );
+
+  for(Uint p = 0; p < N; ++p)
+  {
+    // bring the largest coefficient of column p on or below the diagonal to the pivot row
+
+    for(Uint i = p+1; i < N; ++i)
+    {
+      const MaskT larger = a(i,p).abs() > a(p,p).abs();
+      if( !larger.any() )
+        continue;
+
+      for(Uint j = p; j < N; ++j)
+      {
+        const LaneT row_p = a(p,j);
+        a(p,j) = larger.select(a(i,j), row_p);
+        a(i,j) = larger.select(row_p, a(i,j));
+      }
+      for(Uint k = 0; k < K; ++k)
+      {
+        const LaneT row_p = b(p,k);
+        b(p,k) = larger.select(b(i,k), row_p);
+        b(i,k) = larger.select(row_p, b(i,k));
+      }
+    }
+
+    if( ( a(p,p).abs() <= tolerance ).any() )
+      return false;
+
+    const LaneT inv_pivot = a(p,p).inverse();
+
+    for(Uint i = p+1; i < N; ++i)
+    {
+      const LaneT factor = a(i,p) * inv_pivot;
+      for(Uint j = p+1; j < N; ++j)
+        a(i,j) -= factor * a(p,j);
+      for(Uint k = 0; k < K; ++k)
+        b(i,k) -= factor * b(p,k);
+    }
+  }
+
+  // back substitution
+
+  for(int p = N-1; p >= 0; --p)
+  {
+    const LaneT inv_pivot = a(p,p).inverse();
+    for(Uint k = 0; k < K; ++k)
+    {
+      for(Uint j = p+1; j < N; ++j)
+        b(p,k) -= a(p,j) * b(j,k);
+      b(p,k) *= inv_pivot;
+    }
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+} // RDM
+} // CF
+
+#endif // CF_RDM_BatchMatrix_hpp
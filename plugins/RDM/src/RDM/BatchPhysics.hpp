@@ -0,0 +1,230 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef CF_RDM_BatchPhysics_hpp
+#define CF_RDM_BatchPhysics_hpp
+
+#include <Eigen/Dense>
+
+#include "RDM/BatchMatrix.hpp"
+
+namespace CF {
+namespace RDM {
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+/// Evaluates the physics PHYS for a batch of NB states, such as the same quadrature point of NB elements.
+/// The flux jacobians of each state are projected on NDIR directions, typically the gradients of the shape functions.
+/// The states are stored and the results are returned as structures of arrays.
+/// If PHYS::has_batch_interface, the whole batch is passed to PHYS at once,
+/// otherwise the states are evaluated one by one with the single state interface.
+template < typename PHYS, int NB, int NDIR, bool BATCH = PHYS::has_batch_interface >
+class BatchPhysics;
+
+/// Data shared by both implementations of BatchPhysics
+template < typename PHYS, int NB, int NDIR >
+class BatchPhysicsBase
+{
+public: // typedefs
+
+  typedef typename PHYS::MODEL MODEL;
+
+  typedef BatchMatrix<NB, MODEL::_neqs, MODEL::_neqs>  PhysicsMT;  ///< matrix of size neqs x neqs for all states
+  typedef BatchMatrix<NB, MODEL::_neqs, 1u>            PhysicsVT;  ///< vector of size neqs for all states
+
+  typedef Eigen::Array<Real, NB, MODEL::_ndim>         DimA;       ///< vector in space for all states, one row per state
+  typedef Eigen::Array<Real, NB, MODEL::_neqs>         SolA;       ///< variables for all states, one row per state
+
+public: // functions
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW  ///< storing fixed-sized Eigen structures
+
+  /// store the coordinates, the variables and the gradient of the variables of state b
+  /// @param grad_vars gradient of the variables, one column per dimension
+  template < typename CV, typename SV, typename GM >
+  void set_state ( const Uint b, const CV& coord, const SV& sol, const GM& grad_vars )
+  {
+    for(Uint d = 0; d < MODEL::_ndim; ++d)
+      coords(b,d) = coord[d];
+
+    for(Uint v = 0; v < MODEL::_neqs; ++v)
+      vars(b,v) = sol[v];
+
+    for(Uint d = 0; d < MODEL::_ndim; ++d)
+      for(Uint v = 0; v < MODEL::_neqs; ++v)
+        dvars[d](b,v) = grad_vars(v,d);
+  }
+
+  /// store the direction i on which the flux jacobians of state b are projected
+  template < typename GV >
+  void set_direction ( const Uint b, const Uint i, const GV& direction )
+  {
+    for(Uint d = 0; d < MODEL::_ndim; ++d)
+      directions[i](b,d) = direction[d];
+  }
+
+public: // data
+
+  /// right eigen vectors of the flux jacobians projected on each direction
+  PhysicsMT Rv [NDIR];
+  /// left eigen vectors of the flux jacobians projected on each direction
+  PhysicsMT Lv [NDIR];
+  /// eigen values of the flux jacobians projected on each direction
+  PhysicsVT Dv [NDIR];
+  /// PDE residual L(u)
+  PhysicsVT LU;
+
+protected: // data
+
+  /// coordinates of the states
+  DimA coords;
+  /// variables of the states
+  SolA vars;
+  /// gradient of the variables of the states, one array per dimension
+  SolA dvars [MODEL::_ndim];
+  /// projection directions of the flux jacobians
+  DimA directions [NDIR];
+
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+/// BatchPhysics for physics that work on one state at a time
+template < typename PHYS, int NB, int NDIR >
+class BatchPhysics<PHYS,NB,NDIR,false> : public BatchPhysicsBase<PHYS,NB,NDIR>
+{
+public: // typedefs
+
+  typedef BatchPhysicsBase<PHYS,NB,NDIR> B;
+  typedef typename B::MODEL MODEL;
+
+public: // functions
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW  ///< storing fixed-sized Eigen structures
+
+  BatchPhysics()
+  {
+    for(Uint d = 0; d < MODEL::_ndim; ++d)
+      dFdU[d].setZero();
+  }
+
+  /// compute the physical properties of all states
+  void compute_properties()
+  {
+    for(Uint b = 0; b < NB; ++b)
+    {
+      X = B::coords.row(b).matrix().transpose();
+      U = B::vars.row(b).matrix().transpose();
+      for(Uint d = 0; d < MODEL::_ndim; ++d)
+        dUdX.col(d) = B::dvars[d].row(b).matrix().transpose();
+
+      PHYS::compute_properties(X, U, dUdX, props[b]);
+    }
+  }
+
+  /// decompose the eigen structure of the flux jacobians projected on all directions
+  /// @pre compute_properties() was called
+  void compute_eigen_structure()
+  {
+    for(Uint b = 0; b < NB; ++b)
+      for(Uint i = 0; i < NDIR; ++i)
+      {
+        dN = B::directions[i].row(b).matrix().transpose();
+
+        PHYS::flux_jacobian_eigen_structure(props[b], dN, Rs, Ls, Ds);
+
+        B::Rv[i].set(b, Rs);
+        B::Lv[i].set(b, Ls);
+        B::Dv[i].set(b, Ds);
+      }
+  }
+
+  /// compute the PDE residual of all states
+  /// @pre compute_properties() was called
+  void compute_residual()
+  {
+    for(Uint b = 0; b < NB; ++b)
+    {
+      PHYS::residual(props[b], dFdU, LUs);
+      B::LU.set(b, LUs);
+    }
+  }
+
+private: // data
+
+  /// physical properties of each state
+  typename MODEL::Properties props [NB];
+
+  /// coordinates of one state
+  Eigen::Matrix<Real, MODEL::_ndim, 1u> X;
+  /// variables of one state
+  Eigen::Matrix<Real, MODEL::_neqs, 1u> U;
+  /// gradient of the variables of one state
+  Eigen::Matrix<Real, MODEL::_neqs, MODEL::_ndim> dUdX;
+  /// one projection direction
+  Eigen::Matrix<Real, MODEL::_ndim, 1u> dN;
+  /// right eigen vectors of one state
+  Eigen::Matrix<Real, MODEL::_neqs, MODEL::_neqs> Rs;
+  /// left eigen vectors of one state
+  Eigen::Matrix<Real, MODEL::_neqs, MODEL::_neqs> Ls;
+  /// eigen values of one state
+  Eigen::Matrix<Real, MODEL::_neqs, 1u> Ds;
+  /// PDE residual of one state
+  Eigen::Matrix<Real, MODEL::_neqs, 1u> LUs;
+  /// flux jacobians of one state
+  Eigen::Matrix<Real, MODEL::_neqs, MODEL::_neqs> dFdU [MODEL::_ndim];
+
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+/// BatchPhysics for physics that work on a batch of states in a PHYS::MODEL::BatchProperties
+template < typename PHYS, int NB, int NDIR >
+class BatchPhysics<PHYS,NB,NDIR,true> : public BatchPhysicsBase<PHYS,NB,NDIR>
+{
+public: // typedefs
+
+  typedef BatchPhysicsBase<PHYS,NB,NDIR> B;
+  typedef typename B::MODEL MODEL;
+
+public: // functions
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW  ///< storing fixed-sized Eigen structures
+
+  /// compute the physical properties of all states
+  void compute_properties()
+  {
+    PHYS::compute_properties(B::coords, B::vars, props);
+  }
+
+  /// decompose the eigen structure of the flux jacobians projected on all directions
+  /// @pre compute_properties() was called
+  void compute_eigen_structure()
+  {
+    for(Uint i = 0; i < NDIR; ++i)
+      PHYS::flux_jacobian_eigen_structure(props, B::directions[i], B::Rv[i].data, B::Lv[i].data, B::Dv[i].data);
+  }
+
+  /// compute the PDE residual of all states
+  /// @pre compute_properties() was called
+  void compute_residual()
+  {
+    PHYS::residual(props, B::dvars, B::LU.data);
+  }
+
+private: // data
+
+  /// physical properties of all states
+  typename MODEL::template BatchProperties<NB> props;
+
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+} // RDM
+} // CF
+
+#endif // CF_RDM_BatchPhysics_hpp
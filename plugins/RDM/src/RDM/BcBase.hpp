@@ -99,7 +99,7 @@ protected: // data
 
   boost::weak_ptr< Mesh::Field > csolution;   ///< solution field
   boost::weak_ptr< Mesh::Field > cresidual;   ///< residual field
-  boost::weak_ptr< Mesh::Field > cwave_speed; ///< wave_speed field
+  boost::weak_ptr< Mesh::SinglePrecisionField > cwave_speed; ///< wave_speed field
 
   /// pointer to connectivity table, may reset when iterating over element types
   Mesh::CConnectivity::Ptr connectivity;
@@ -109,8 +109,8 @@ protected: // data
   Mesh::CTable<Real>::Ptr solution;
   /// pointer to solution table, may reset when iterating over element types
   Mesh::CTable<Real>::Ptr residual;
-  /// pointer to solution table, may reset when iterating over element types
-  Mesh::CTable<Real>::Ptr wave_speed;
+  /// pointer to wave speed table, may reset when iterating over element types
+  Mesh::CTable<float>::Ptr wave_speed;
 
   typename PHYS::MODEL::Properties phys_props; ///< physical properties
 
@@ -32,7 +32,7 @@ BoundaryTerm::BoundaryTerm ( const std::string& name ) :
   m_options.add_option(OptionComponent<Field>::create( RDM::Tags::solution(), &m_solution))
       ->pretty_name("Solution Field");
 
-  m_options.add_option(OptionComponent<Field>::create( RDM::Tags::wave_speed(), &m_wave_speed))
+  m_options.add_option(OptionComponent<SinglePrecisionField>::create( RDM::Tags::wave_speed(), &m_wave_speed))
       ->pretty_name("Wave Speed Field");
 
   m_options.add_option(OptionComponent<Field>::create( RDM::Tags::residual(), &m_residual))
@@ -49,7 +49,7 @@ void BoundaryTerm::link_fields()
 
   if( is_null( m_wave_speed.lock() ) )
     m_wave_speed = solver().as_type<RDM::RDSolver>().fields()
-                         .get_child( RDM::Tags::wave_speed() ).follow()->as_ptr_checked<Field>();
+                         .get_child( RDM::Tags::wave_speed() ).follow()->as_ptr_checked<SinglePrecisionField>();
 
   if( is_null( m_residual.lock() ) )
     m_residual = solver().as_type<RDM::RDSolver>().fields()
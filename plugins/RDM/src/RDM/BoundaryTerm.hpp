@@ -14,7 +14,7 @@
 
 namespace CF {
 
-namespace Mesh { class Field; }
+namespace Mesh { class Field; class SinglePrecisionField; }
 
 namespace RDM {
 
@@ -58,7 +58,7 @@ public: // functions
 
   Mesh::Field& residual()    { return *m_residual.lock(); }
 
-  Mesh::Field& wave_speed()  { return *m_wave_speed.lock(); }
+  Mesh::SinglePrecisionField& wave_speed()  { return *m_wave_speed.lock(); }
 
   //@} END ACCESSORS
 
@@ -72,7 +72,7 @@ protected: // data
 
   boost::weak_ptr<Mesh::Field> m_residual;     ///< access to the residual field
 
-  boost::weak_ptr<Mesh::Field> m_wave_speed;   ///< access to the wave_speed field
+  boost::weak_ptr<Mesh::SinglePrecisionField> m_wave_speed;   ///< access to the wave_speed field
 
 };
 
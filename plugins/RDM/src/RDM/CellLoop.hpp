@@ -7,6 +7,8 @@
 #ifndef CF_RDM_CellLoop_hpp
 #define CF_RDM_CellLoop_hpp
 
+#include "Common/CTimings.hpp"
+
 #include "Mesh/Field.hpp"
 
 #include "RDM/ElementLoop.hpp"
@@ -72,6 +74,7 @@ struct CellLoopT1 : public CellLoop
   /// execute the action
   virtual void execute ()
   {
+    Common::ScopedTimer timer(*this);
     boost::mpl::for_each< typename RDM::AllCellTypes >( boost::ref(*this) );
   }
 
@@ -98,6 +101,9 @@ struct CellLoopT1 : public CellLoop
       // point the term to the elements of the (sub)region
       term.set_elements(elements);
 
+      // measure the cost of the elements, for load balancing
+      Mesh::ScopedCostTimer cost_timer(elements);
+
       const Uint nb_elem = elements.size();
       for ( Uint elem = 0; elem != nb_elem; ++elem )
       {
@@ -126,6 +132,7 @@ struct CellLoopT : public CellLoop
   /// execute the action
   virtual void execute ()
   {
+    Common::ScopedTimer timer(*this);
     boost::mpl::for_each< typename RDM::CellTypes< PHYS::MODEL::_ndim >::Cells >( boost::ref(*this) );
   }
 
@@ -152,12 +159,12 @@ struct CellLoopT : public CellLoop
       // point the term to the elements of the (sub)region
       term.set_elements(elements);
 
-      const Uint nb_elem = elements.size();
-      for ( Uint elem = 0; elem != nb_elem; ++elem )
-      {
-        term.select_loop_idx(elem);
-        term.execute();
-      }
+      // measure the cost of the elements, for load balancing
+      Mesh::ScopedCostTimer cost_timer(elements);
+
+      // loop over all elements, letting the term group them in batches if it can
+
+      term.execute_range(0, elements.size());
     }
   }
 
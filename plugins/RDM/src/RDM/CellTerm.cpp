@@ -32,7 +32,7 @@ CellTerm::CellTerm ( const std::string& name ) :
   m_options.add_option(OptionComponent<Field>::create( RDM::Tags::solution(), &m_solution))
       ->pretty_name("Solution Field");
 
-  m_options.add_option(OptionComponent<Field>::create( RDM::Tags::wave_speed(), &m_wave_speed))
+  m_options.add_option(OptionComponent<SinglePrecisionField>::create( RDM::Tags::wave_speed(), &m_wave_speed))
       ->pretty_name("Wave Speed Field");
 
   m_options.add_option(OptionComponent<Field>::create( RDM::Tags::residual(), &m_residual))
@@ -61,7 +61,7 @@ void CellTerm::link_fields()
   if( is_null( m_wave_speed.lock() ) )
   {
     m_wave_speed = solver().as_type<RDM::RDSolver>().fields()
-                         .get_child( RDM::Tags::wave_speed() ).follow()->as_ptr_checked<Field>();
+                         .get_child( RDM::Tags::wave_speed() ).follow()->as_ptr_checked<SinglePrecisionField>();
     configure_option_recursively( RDM::Tags::wave_speed(), m_wave_speed.lock()->uri() );
   }
 }
@@ -53,31 +53,51 @@ void FwdEuler::execute()
   if (m_solution.expired())
     m_solution = mysolver.fields().get_child( RDM::Tags::solution() ).follow()->as_ptr_checked<Field>();
   if (m_wave_speed.expired())
-    m_wave_speed = mysolver.fields().get_child( RDM::Tags::wave_speed() ).follow()->as_ptr_checked<Field>();
+    m_wave_speed = mysolver.fields().get_child( RDM::Tags::wave_speed() ).follow()->as_ptr_checked<SinglePrecisionField>();
   if (m_residual.expired())
     m_residual = mysolver.fields().get_child( RDM::Tags::residual() ).follow()->as_ptr_checked<Field>();
 
-  Field& solution     = *m_solution.lock();
-  Field& wave_speed   = *m_wave_speed.lock();
-  Field& residual     = *m_residual.lock();
+  Field& solution                  = *m_solution.lock();
+  SinglePrecisionField& wave_speed = *m_wave_speed.lock();
+  Field& residual                  = *m_residual.lock();
 
   const Real CFL = options().option("cfl").value<Real>();
 
   const Uint nbdofs = solution.size();
   const Uint nbvars = solution.row_size();
+
+  // update coefficient of every node, zero where the wave speed is null
+  m_update.resize(nbdofs);
   for ( Uint i=0; i< nbdofs; ++i )
   {
     if ( is_zero(wave_speed[i][0]) )
     {
       for ( Uint j=0; j< nbvars; ++j )
         if( is_not_zero(residual[i][j]) )
-          CFwarn << "residual not null but wave_speed null at node [" << i << "] variable [" << j << "]" << CFendl;
+          CFLogWarn( "residual not null but wave_speed null at node [" << i << "] variable [" << j << "]\n" );
+      m_update[i] = 0.;
       continue;
     }
 
-    const Real update = CFL / wave_speed[i][0] ;
+    m_update[i] = CFL / wave_speed[i][0] ;
+  }
+
+  if ( solution.layout() == Field::COLUMN_MAJOR && residual.layout() == Field::COLUMN_MAJOR )
+  {
+    // each variable is a contiguous column, so the loop over the nodes vectorizes
     for ( Uint j=0; j< nbvars; ++j )
-      solution[i][j] += - update * residual[i][j];
+    {
+      Real* u = solution.array().data() + j*nbdofs;
+      const Real* r = residual.array().data() + j*nbdofs;
+      for ( Uint i=0; i< nbdofs; ++i )
+        u[i] -= m_update[i] * r[i];
+    }
+  }
+  else
+  {
+    for ( Uint i=0; i< nbdofs; ++i )
+      for ( Uint j=0; j< nbvars; ++j )
+        solution[i][j] += - m_update[i] * residual[i][j];
   }
 }
 
@@ -7,6 +7,8 @@
 #ifndef CF_RDM_FwdEuler_hpp
 #define CF_RDM_FwdEuler_hpp
 
+#include <vector>
+
 #include "Solver/Action.hpp"
 
 #include "RDM/LibRDM.hpp"
@@ -14,7 +16,7 @@
 /////////////////////////////////////////////////////////////////////////////////////
 
 namespace CF {
-namespace Mesh { class Field; }
+namespace Mesh { class Field; class SinglePrecisionField; }
 namespace RDM {
 
 class RDM_API FwdEuler : public CF::Solver::Action {
@@ -46,7 +48,10 @@ private: // data
   /// residual field pointer
   boost::weak_ptr<Mesh::Field> m_residual;
   /// wave_speed field pointer
-  boost::weak_ptr<Mesh::Field> m_wave_speed;
+  boost::weak_ptr<Mesh::SinglePrecisionField> m_wave_speed;
+
+  /// update coefficient of every node
+  std::vector<Real> m_update;
 
 };
 
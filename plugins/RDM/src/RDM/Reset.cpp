@@ -63,6 +63,11 @@ void Reset::config_fields()
       boost::weak_ptr<Field> wptr = field;
       m_fields.push_back( wptr );
     }
+    else if ( SinglePrecisionField::Ptr field = comp.as_ptr<SinglePrecisionField>() )
+    {
+      boost::weak_ptr<SinglePrecisionField> wptr = field;
+      m_single_precision_fields.push_back( wptr );
+    }
     else
       throw ValueNotFound ( FromHere(), "Could not find field with path [" + field_path.path() +"]" );
   }
@@ -83,6 +88,11 @@ void Reset::config_field_tags()
         boost::weak_ptr<Field> wptr = field;
         m_fields.push_back( wptr );
       }
+      else if( SinglePrecisionField::Ptr field = link.follow()->as_ptr<SinglePrecisionField>() )
+      {
+        boost::weak_ptr<SinglePrecisionField> wptr = field;
+        m_single_precision_fields.push_back( wptr );
+      }
     }
 }
 
@@ -99,6 +109,15 @@ void Reset::execute()
 
     field = 0.; // set all entries to zero
   }
+
+  boost_foreach(boost::weak_ptr<SinglePrecisionField> ptr, m_single_precision_fields)
+  {
+    if( ptr.expired() ) continue; // skip if pointer invalid
+
+    CTable<float>& field = *ptr.lock();
+
+    field = 0.f; // set all entries to zero
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
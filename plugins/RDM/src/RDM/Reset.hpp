@@ -14,7 +14,7 @@
 /////////////////////////////////////////////////////////////////////////////////////
 
 namespace CF {
-namespace Mesh { class Field; }
+namespace Mesh { class Field; class SinglePrecisionField; }
 namespace RDM {
 
 
@@ -48,6 +48,7 @@ private: // helper functions
 private: // data
 
   std::vector< boost::weak_ptr<Mesh::Field> > m_fields;
+  std::vector< boost::weak_ptr<Mesh::SinglePrecisionField> > m_single_precision_fields;
 
 };
 
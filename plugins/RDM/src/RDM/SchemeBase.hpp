@@ -71,6 +71,17 @@ public: // functions
 
   void sol_gradients_at_qdpoint(const Uint q);
 
+  /// execute the action for the elements in [begin,end[, one element at a time.
+  /// Schemes that process several elements at once hide this function
+  void execute_range ( const Uint begin, const Uint end )
+  {
+    for ( Uint elem = begin; elem != end; ++elem )
+    {
+      select_loop_idx(elem);
+      execute();
+    }
+  }
+
 protected: // helper functions
 
   void change_elements()
@@ -120,7 +131,7 @@ protected: // data
 
   boost::weak_ptr< Mesh::Field > csolution;   ///< solution field
   boost::weak_ptr< Mesh::Field > cresidual;   ///< residual field
-  boost::weak_ptr< Mesh::Field > cwave_speed; ///< wave_speed field
+  boost::weak_ptr< Mesh::SinglePrecisionField > cwave_speed; ///< wave_speed field
 
   /// pointer to connectivity table, may reset when iterating over element types
   Mesh::CConnectivity::Ptr connectivity;
@@ -130,8 +141,8 @@ protected: // data
   Mesh::Field::Ptr solution;
   /// pointer to solution table, may reset when iterating over element types
   Mesh::Field::Ptr residual;
-  /// pointer to solution table, may reset when iterating over element types
-  Mesh::Field::Ptr wave_speed;
+  /// pointer to wave speed table, kept in single precision since it only scales the update
+  Mesh::SinglePrecisionField::Ptr wave_speed;
 
   /// helper object to compute the quadrature information
   const QD& m_quadrature;
@@ -202,7 +213,7 @@ SchemeBase<SF,QD,PHYS>::SchemeBase ( const std::string& name ) :
   m_options.add_option(
         Common::OptionComponent<Mesh::Field>::create( RDM::Tags::solution(), &csolution));
   m_options.add_option(
-        Common::OptionComponent<Mesh::Field>::create( RDM::Tags::wave_speed(), &cwave_speed));
+        Common::OptionComponent<Mesh::SinglePrecisionField>::create( RDM::Tags::wave_speed(), &cwave_speed));
   m_options.add_option(
         Common::OptionComponent<Mesh::Field>::create( RDM::Tags::residual(), &cresidual));
 
@@ -11,6 +11,8 @@
 
 #include "RDM/CellTerm.hpp"
 #include "RDM/SchemeBase.hpp"
+#include "RDM/BatchMatrix.hpp"
+#include "RDM/BatchPhysics.hpp"
 
 #include "RDM/Schemes/LibSchemes.hpp"
 
@@ -64,6 +66,9 @@ public: // typedefs
   typedef boost::shared_ptr< Term > Ptr;
   typedef boost::shared_ptr< Term const> ConstPtr;
 
+  /// number of elements processed together by execute_range
+  enum { batch_size = 4 };
+
 public: // functions
 
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW  ///< storing fixed-sized Eigen structures
@@ -84,8 +89,41 @@ public: // functions
   /// execute the action
   virtual void execute ();
 
+  /// execute the action for the elements in [begin,end[, in batches of batch_size elements
+  void execute_range ( const Uint begin, const Uint end );
+
+protected: // functions
+
+  /// execute the action for the batch_size elements starting at first
+  void execute_batch ( const Uint first );
+
+protected: // typedefs
+
+  typedef BatchMatrix<batch_size, PHYS::MODEL::_neqs, PHYS::MODEL::_neqs> BatchPhysicsMT;
+  typedef BatchMatrix<batch_size, PHYS::MODEL::_neqs, 1u>                 BatchPhysicsVT;
+  typedef BatchPhysics<PHYS, batch_size, SF::nb_nodes>                    BatchPhysicsT;
+
 protected: // data
 
+  /// states of all elements in the batch, at each quadrature point
+  BatchPhysicsT phys_b [QD::nb_points];
+  /// integration factors of all elements in the batch
+  Eigen::Array<Real, batch_size, QD::nb_points> wj_b;
+  /// contribution to the wave speed of each node of all elements in the batch
+  Eigen::Array<Real, batch_size, SF::nb_nodes> ws_b;
+  /// Ki_n of all elements in the batch, at one quadrature point
+  BatchPhysicsMT Ki_b [SF::nb_nodes];
+  /// positive eigen values of all elements in the batch
+  BatchPhysicsVT DvPlus_b;
+  /// sum of Lplus of all elements in the batch, destroyed by the solve
+  BatchPhysicsMT sumLplus_b;
+  /// L(u) multiplied by the integration factor of all elements in the batch
+  BatchPhysicsVT LUwq_b;
+  /// InvKi_n * L(u) * wj of all elements in the batch
+  BatchPhysicsVT InvKiLUwq_b;
+  /// contribution to nodal residuals of all elements in the batch
+  BatchPhysicsVT Phi_b [SF::nb_nodes];
+
   /// The operator L in the advection equation Lu = f
   /// Matrix Ki_n stores the value L(N_i) at each quadrature point for each shape function N_i
   typename B::PhysicsMT  Ki_n [SF::nb_nodes];
@@ -382,6 +420,133 @@ void LDA::Term<SF,QD,PHYS>::execute()
 
 /////////////////////////////////////////////////////////////////////////////////////
 
+template<typename SF,typename QD, typename PHYS>
+void LDA::Term<SF,QD,PHYS>::execute_range( const Uint begin, const Uint end )
+{
+  Uint elem = begin;
+
+  for( ; elem + batch_size <= end; elem += batch_size )
+    execute_batch(elem);
+
+  // remaining elements, one at a time
+
+  for( ; elem != end; ++elem )
+  {
+    B::select_loop_idx(elem);
+    execute();
+  }
+}
+
+template<typename SF,typename QD, typename PHYS>
+void LDA::Term<SF,QD,PHYS>::execute_batch( const Uint first )
+{
+  // gather the states at the quadrature points of all elements in the batch
+
+  for(Uint b = 0; b < batch_size; ++b)
+  {
+    B::select_loop_idx(first + b);
+
+    B::interpolate( (*B::connectivity)[B::idx()] );
+
+    for(Uint q=0; q < QD::nb_points; ++q)
+    {
+      B::sol_gradients_at_qdpoint(q);
+
+      phys_b[q].set_state(b, B::X_q.row(q), B::U_q.row(q), B::dUdXq);
+
+      for(Uint n=0; n < SF::nb_nodes; ++n)
+      {
+        for(Uint d = 0; d < PHYS::MODEL::_ndim; ++d)
+          B::dN[d] = B::dNdX[d](q,n);
+
+        phys_b[q].set_direction(b, n, B::dN);
+      }
+
+      wj_b(b,q) = B::wj[q];
+    }
+  }
+
+  // LDA distribution, for all elements in the batch at once
+
+  for(Uint n = 0; n < SF::nb_nodes; ++n)
+    Phi_b[n].setZero();
+
+  ws_b.setZero();
+
+  for(Uint q=0; q < QD::nb_points; ++q)
+  {
+    // properties, eigen structure and PDE residual at this quadrature point
+
+    BatchPhysicsT& phys = phys_b[q];
+
+    phys.compute_properties();
+    phys.compute_eigen_structure();
+    phys.compute_residual();
+
+    // L(N)+ for every state
+
+    for(Uint n=0; n < SF::nb_nodes; ++n)
+    {
+      DvPlus_b.data = phys.Dv[n].data.unaryExpr(std::ptr_fun(plus));
+
+      batch_diagonal_product(phys.Rv[n], DvPlus_b, phys.Lv[n], Ki_b[n]);
+
+      // compute the wave_speed for scaling the update
+
+      ws_b.col(n) += DvPlus_b.data.rowwise().maxCoeff() * wj_b.col(q);
+    }
+
+    for(Uint v = 0; v < PHYS::MODEL::_neqs; ++v)
+      LUwq_b(v,0) = phys.LU(v,0) * wj_b.col(q);
+
+    sumLplus_b = Ki_b[0];
+    for(Uint n = 1; n < SF::nb_nodes; ++n)
+      sumLplus_b.data += Ki_b[n].data;
+
+    InvKiLUwq_b = LUwq_b;
+
+    if( !batch_solve(sumLplus_b, InvKiLUwq_b) )
+    {
+      // some sum of L plus is singular, invert them one by one as execute() does
+      for(Uint b = 0; b < batch_size; ++b)
+      {
+        Ki_b[0].get(b, sumLplus);
+        for(Uint n = 1; n < SF::nb_nodes; ++n)
+        {
+          Ki_b[n].get(b, InvKi_n);
+          sumLplus += InvKi_n;
+        }
+
+        InvKi_n = sumLplus.inverse();
+
+        LUwq_b.get(b, LUwq);
+        LUwq = InvKi_n * LUwq;
+        InvKiLUwq_b.set(b, LUwq);
+      }
+    }
+
+    for(Uint n = 0; n < SF::nb_nodes; ++n)
+      batch_multiply_add(Ki_b[n], InvKiLUwq_b, Phi_b[n]);
+  }
+
+  // update the residual and the wave speed
+
+  for(Uint b = 0; b < batch_size; ++b)
+  {
+    const Mesh::CConnectivity::ConstRow nodes_idx = (*B::connectivity)[first + b];
+
+    for (Uint n=0; n<SF::nb_nodes; ++n)
+    {
+      for (Uint v=0; v < PHYS::MODEL::_neqs; ++v)
+        (*B::residual)[nodes_idx[n]][v] += Phi_b[n].data(b,v);
+
+      (*B::wave_speed)[nodes_idx[n]][0] += ws_b(b,n);
+    }
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+
 } // RDM
 } // CF
 
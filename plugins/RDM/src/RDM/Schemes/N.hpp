@@ -9,6 +9,8 @@
 
 #include "RDM/CellTerm.hpp"
 #include "RDM/SchemeBase.hpp"
+#include "RDM/BatchMatrix.hpp"
+#include "RDM/BatchPhysics.hpp"
 
 #include "RDM/Schemes/LibSchemes.hpp"
 
@@ -59,6 +61,9 @@ public: // typedefs
   typedef boost::shared_ptr< Term > Ptr;
   typedef boost::shared_ptr< Term const> ConstPtr;
 
+  /// number of elements processed together by execute_range
+  enum { batch_size = 4 };
+
 public: // functions
 
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW  ///< storing fixed-sized Eigen structures
@@ -79,8 +84,54 @@ public: // functions
   /// execute the action
   virtual void execute ();
 
+  /// execute the action for the elements in [begin,end[, in batches of batch_size elements
+  void execute_range ( const Uint begin, const Uint end );
+
+protected: // functions
+
+  /// execute the action for the batch_size elements starting at first
+  void execute_batch ( const Uint first );
+
+protected: // typedefs
+
+  typedef BatchMatrix<batch_size, PHYS::MODEL::_neqs, PHYS::MODEL::_neqs>   BatchPhysicsMT;
+  typedef BatchMatrix<batch_size, PHYS::MODEL::_neqs, 1u>                   BatchPhysicsVT;
+  typedef BatchMatrix<batch_size, PHYS::MODEL::_neqs, SF::nb_nodes>         BatchNodalMT;
+  typedef BatchPhysics<PHYS, batch_size, SF::nb_nodes>                      BatchPhysicsT;
+
 protected: // data
 
+  /// states of all elements in the batch, at each quadrature point
+  BatchPhysicsT phys_b [QD::nb_points];
+  /// contribution to the wave speed of each node of all elements in the batch
+  Eigen::Array<Real, batch_size, SF::nb_nodes> ws_b;
+  /// KiP_n of all elements in the batch, at one quadrature point
+  BatchPhysicsMT KiP_b [SF::nb_nodes];
+  /// KiM_n of all elements in the batch, at one quadrature point
+  BatchPhysicsMT KiM_b [SF::nb_nodes];
+  /// positive eigen values of all elements in the batch
+  BatchPhysicsVT DvP_b;
+  /// negative eigen values of all elements in the batch
+  BatchPhysicsVT DvM_b;
+  /// sum of KiP_n of all elements in the batch, destroyed by the solve
+  BatchPhysicsMT sumKplus_b;
+  /// node values of the solution of all elements in the batch
+  BatchPhysicsVT U_b [SF::nb_nodes];
+  /// integration factors of all elements in the batch
+  Eigen::Array<Real, batch_size, QD::nb_points> wj_b;
+  /// for each node i, the sum of KiM_j.(U_i - U_j).wj over the other nodes j,
+  /// overwritten by the solution of sumKplus.x = sum
+  BatchNodalMT dPhi_b;
+  /// difference of the solution between two nodes, for all elements in the batch
+  BatchPhysicsVT dU_b;
+  /// contribution to nodal residuals of all elements in the batch
+  BatchPhysicsVT Phi_b [SF::nb_nodes];
+  /// fluctuation of one node of one element, used when the batch can not be solved at once
+  typename B::PhysicsVT  dPhi;
+  /// difference of the solution between two nodes of one element
+  typename B::PhysicsVT  dU;
+
+
   /// Matrix KiP_n stores the value L(N_i)+ at each quadrature point for each shape function N_i
   typename B::PhysicsMT  KiP_n [SF::nb_nodes];
   /// Matrix KiM_n stores the value L(N_i)- at each quadrature point for each shape function N_i
@@ -247,6 +298,170 @@ void N::Term<SF,QD,PHYS>::execute()
 
 }
 
+/////////////////////////////////////////////////////////////////////////////////////
+
+template<typename SF,typename QD, typename PHYS>
+void N::Term<SF,QD,PHYS>::execute_range( const Uint begin, const Uint end )
+{
+  Uint elem = begin;
+
+  for( ; elem + batch_size <= end; elem += batch_size )
+    execute_batch(elem);
+
+  // remaining elements, one at a time
+
+  for( ; elem != end; ++elem )
+  {
+    B::select_loop_idx(elem);
+    execute();
+  }
+}
+
+template<typename SF,typename QD, typename PHYS>
+void N::Term<SF,QD,PHYS>::execute_batch( const Uint first )
+{
+  // gather the states at the quadrature points of all elements in the batch
+
+  for(Uint b = 0; b < batch_size; ++b)
+  {
+    B::select_loop_idx(first + b);
+
+    B::interpolate( (*B::connectivity)[B::idx()] );
+
+    for(Uint n = 0; n < SF::nb_nodes; ++n)
+      U_b[n].set(b, B::U_n.row(n).transpose());
+
+    for(Uint q=0; q < QD::nb_points; ++q)
+    {
+      B::sol_gradients_at_qdpoint(q);
+
+      phys_b[q].set_state(b, B::X_q.row(q), B::U_q.row(q), B::dUdXq);
+
+      for(Uint n=0; n < SF::nb_nodes; ++n)
+      {
+        for(Uint d = 0; d < PHYS::MODEL::_ndim; ++d)
+          B::dN[d] = B::dNdX[d](q,n);
+
+        phys_b[q].set_direction(b, n, B::dN);
+      }
+
+      wj_b(b,q) = B::wj[q];
+    }
+  }
+
+  // N distribution, for all elements in the batch at once
+
+  for(Uint n = 0; n < SF::nb_nodes; ++n)
+    Phi_b[n].setZero();
+
+  ws_b.setZero();
+
+  for(Uint q=0; q < QD::nb_points; ++q)
+  {
+    // properties and eigen structure at this quadrature point
+
+    BatchPhysicsT& phys = phys_b[q];
+
+    phys.compute_properties();
+    phys.compute_eigen_structure();
+
+    // L(N)+ and L(N)- for every state
+
+    for(Uint n=0; n < SF::nb_nodes; ++n)
+    {
+      DvP_b.data = phys.Dv[n].data.unaryExpr(std::ptr_fun(plus));
+      DvM_b.data = phys.Dv[n].data.unaryExpr(std::ptr_fun(minus));
+
+      batch_diagonal_product(phys.Rv[n], DvP_b, phys.Lv[n], KiP_b[n]);
+      batch_diagonal_product(phys.Rv[n], DvM_b, phys.Lv[n], KiM_b[n]);
+
+      // compute the wave_speed for scaling the update
+
+      ws_b.col(n) += DvP_b.data.rowwise().maxCoeff() * wj_b.col(q);
+    }
+
+    // sum of KiM_j.(U_i - U_j).wj for each node i
+
+    dPhi_b.setZero();
+    for(Uint i = 0; i < SF::nb_nodes; ++i)
+      for(Uint j = 0; j < SF::nb_nodes; ++j)
+      {
+        if (i==j) continue;
+
+        for(Uint v = 0; v < PHYS::MODEL::_neqs; ++v)
+          dU_b(v,0) = ( U_b[i](v,0) - U_b[j](v,0) ) * wj_b.col(q);
+
+        for(Uint c = 0; c < PHYS::MODEL::_neqs; ++c)
+          for(Uint r = 0; r < PHYS::MODEL::_neqs; ++r)
+            dPhi_b(r,i) += KiM_b[j](r,c) * dU_b(c,0);
+      }
+
+    // solve with the sum of K plus, for all nodes at once
+
+    sumKplus_b = KiP_b[0];
+    for(Uint n = 1; n < SF::nb_nodes; ++n)
+      sumKplus_b.data += KiP_b[n].data;
+
+    if( !batch_solve(sumKplus_b, dPhi_b) )
+    {
+      // some sum of K plus is singular, invert them one by one as execute() does
+      for(Uint b = 0; b < batch_size; ++b)
+      {
+        KiP_b[0].get(b, sumKmin);
+        for(Uint n = 1; n < SF::nb_nodes; ++n)
+        {
+          KiP_b[n].get(b, Ki);
+          sumKmin += Ki;
+        }
+
+        InvKi_n = sumKmin.inverse();
+
+        for(Uint i = 0; i < SF::nb_nodes; ++i)
+        {
+          dPhi.setZero();
+          for(Uint j = 0; j < SF::nb_nodes; ++j)
+          {
+            if (i==j) continue;
+
+            for(Uint v = 0; v < PHYS::MODEL::_neqs; ++v)
+              dU[v] = ( U_b[i].data(b,v) - U_b[j].data(b,v) ) * wj_b(b,q);
+
+            KiM_b[j].get(b, Ki);
+            dPhi += Ki * dU;
+          }
+
+          dU = InvKi_n * dPhi;
+
+          for(Uint v = 0; v < PHYS::MODEL::_neqs; ++v)
+            dPhi_b.data(b, v + PHYS::MODEL::_neqs * i) = dU[v];
+        }
+      }
+    }
+
+    // N scheme
+
+    for(Uint i = 0; i < SF::nb_nodes; ++i)
+      for(Uint c = 0; c < PHYS::MODEL::_neqs; ++c)
+        for(Uint r = 0; r < PHYS::MODEL::_neqs; ++r)
+          Phi_b[i](r,0) -= KiP_b[i](r,c) * dPhi_b(c,i);
+  }
+
+  // update the residual and the wave speed
+
+  for(Uint b = 0; b < batch_size; ++b)
+  {
+    const Mesh::CConnectivity::ConstRow nodes_idx = (*B::connectivity)[first + b];
+
+    for (Uint n=0; n<SF::nb_nodes; ++n)
+    {
+      for (Uint v=0; v < PHYS::MODEL::_neqs; ++v)
+        (*B::residual)[nodes_idx[n]][v] += Phi_b[n].data(b,v);
+
+      (*B::wave_speed)[nodes_idx[n]][0] += ws_b(b,n);
+    }
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////////
 
 } // RDM
@@ -112,12 +112,12 @@ void SetupSingleSolution::execute()
     residual->add_tag(Tags::residual());
   }
 
-  // configure wave_speed
+  // configure wave_speed, in single precision since it only scales the update
 
-  Field::Ptr wave_speed = find_component_ptr_with_tag<Field>( *solution_group, RDM::Tags::wave_speed());
+  SinglePrecisionField::Ptr wave_speed = find_component_ptr_with_tag<SinglePrecisionField>( *solution_group, RDM::Tags::wave_speed());
   if ( is_null( wave_speed ) )
   {
-    wave_speed = solution_group->create_field( Tags::wave_speed(), "ws[1]" ).as_ptr<Field>();
+    wave_speed = solution_group->create_field<SinglePrecisionField>( Tags::wave_speed(), "ws[1]" ).as_ptr<SinglePrecisionField>();
     wave_speed->add_tag(Tags::wave_speed());
   }
 
@@ -0,0 +1,162 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Benchmark of the RDM explicit iterations for the 2D Euler equations"
+
+#include <boost/test/unit_test.hpp>
+
+#include "Common/Core.hpp"
+#include "Common/CRoot.hpp"
+#include "Common/CTimings.hpp"
+#include "Common/FindComponents.hpp"
+#include "Common/Foreach.hpp"
+#include "Common/OptionArray.hpp"
+#include "Common/OptionT.hpp"
+
+#include "Common/MPI/PE.hpp"
+
+#include "Common/XML/SignalFrame.hpp"
+#include "Common/XML/SignalOptions.hpp"
+
+#include "Mesh/CDomain.hpp"
+#include "Mesh/CElements.hpp"
+#include "Mesh/CMesh.hpp"
+#include "Mesh/CRegion.hpp"
+
+#include "Solver/CModel.hpp"
+
+#include "RDM/CellTerm.hpp"
+#include "RDM/DomainDiscretization.hpp"
+#include "RDM/InitialConditions.hpp"
+#include "RDM/IterativeSolver.hpp"
+#include "RDM/RDSolver.hpp"
+#include "RDM/SteadyExplicit.hpp"
+#include "RDM/Tags.hpp"
+
+#include "Tools/MeshGeneration/MeshGeneration.hpp"
+#include "Tools/Testing/Benchmark.hpp"
+
+using namespace CF;
+using namespace CF::Common;
+using namespace CF::Common::XML;
+using namespace CF::Mesh;
+using namespace CF::Solver;
+using namespace CF::Tools::Testing;
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_GLOBAL_FIXTURE( BenchmarkOutput );
+
+struct RDMBenchmarkFixture : BenchmarkFixture
+{
+  /// Number of volume elements on this rank
+  Uint nb_elements(const CMesh& mesh)
+  {
+    Uint result = 0;
+    boost_foreach(const CElements& elements, find_components_recursively_with_filter<CElements>(mesh.topology(), IsElementsVolume()))
+      result += elements.size();
+    return result;
+  }
+
+  CModel& model()
+  {
+    return Core::instance().root().get_child("Model").as_type<CModel>();
+  }
+
+  RDM::RDSolver& solver()
+  {
+    return model().get_child("RDSolver").as_type<RDM::RDSolver>();
+  }
+
+  CMesh& mesh()
+  {
+    return model().domain().get_child("mesh").as_type<CMesh>();
+  }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE( RDMBenchmarkSuite )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( init_mpi )
+{
+  Core::instance().initiate(boost::unit_test::framework::master_test_suite().argc, boost::unit_test::framework::master_test_suite().argv);
+  Comm::PE::instance().init(boost::unit_test::framework::master_test_suite().argc, boost::unit_test::framework::master_test_suite().argv);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_CASE( Setup, RDMBenchmarkFixture )
+{
+  // Same model as atest-rdm-euler2d-uniform-flow, on a generated mesh
+  RDM::SteadyExplicit& wizard = Core::instance().root().create_component<RDM::SteadyExplicit>("Wizard");
+  wizard.create_model("Model", "CF.Physics.NavierStokes.NavierStokes2D");
+
+  CMesh& rectangle = model().domain().create_component<CMesh>("mesh");
+  Tools::MeshGeneration::create_rectangle_tris(rectangle, 1., 1., 100 * scale(), 100 * scale());
+
+  RDM::RDSolver& rdsolver = solver();
+  rdsolver.configure_option(RDM::Tags::update_vars(), std::string("Cons2D"));
+  rdsolver.configure_option(RDM::Tags::mesh(), rectangle.uri()); // creates the fields
+  rdsolver.iterative_solver().get_child("MaxIterations").configure_option("maxiter", 10u);
+  rdsolver.iterative_solver().get_child("Update").get_child("Step").configure_option("cfl", 0.25);
+
+  // Smooth subsonic flow
+  SignalFrame frame;
+  SignalOptions options;
+  options.add_option< OptionT<std::string> >("Name", std::string("INIT"));
+  frame = options.create_frame("create_initial_condition", rdsolver.initial_conditions().uri(), rdsolver.initial_conditions().uri());
+  rdsolver.initial_conditions().signal_create_initial_condition(frame);
+
+  std::vector<std::string> functions;
+  functions.push_back("1.2+0.2*x");
+  functions.push_back("(1.2+0.2*x)*(0.6+0.1*y)");
+  functions.push_back("(1.2+0.2*x)*(0.2*x-0.1*y)");
+  functions.push_back("(1.+0.1*x*y)/0.4+0.5*(1.2+0.2*x)*((0.6+0.1*y)^2+(0.2*x-0.1*y)^2)");
+  rdsolver.initial_conditions().get_child("INIT").configure_option("functions", functions);
+
+  std::vector<URI> regions(1, rectangle.topology().uri());
+  rdsolver.domain_discretization().create_cell_term("CF.RDM.Schemes.LDA", "INTERNAL", regions);
+
+  rdsolver.initial_conditions().execute();
+
+  set_problem_size(nb_elements(rectangle));
+}
+
+BOOST_FIXTURE_TEST_CASE( Iterations, RDMBenchmarkFixture )
+{
+  // The time spent in the cell term is collected by the timings component
+  CTimings& timings = Core::instance().timings();
+  timings.configure_option("enabled", true);
+
+  restart_timer();
+  model().simulate();
+  set_problem_size(nb_elements(mesh()));
+
+  const Uint nb_elems = nb_elements(mesh());
+  BenchmarkResults& results = BenchmarkResults::instance();
+  results.add("CellTerms", timings.data(solver().domain_discretization().get_child("CellTerms")).time, nb_elems);
+  results.add("Update", timings.data(solver().iterative_solver().get_child("Update")).time, nb_elems);
+
+  timings.configure_option("enabled", false);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( finalize_mpi )
+{
+  Comm::PE::instance().finalize();
+  Core::instance().terminate();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -10,8 +10,24 @@
 #include <boost/test/unit_test.hpp>
 
 #include "Common/Core.hpp"
+#include "Common/CRoot.hpp"
+#include "Common/FindComponents.hpp"
+#include "Common/Foreach.hpp"
+
+#include "Math/VariablesDescriptor.hpp"
+
+#include "Mesh/CMesh.hpp"
+#include "Mesh/CMeshReader.hpp"
+#include "Mesh/CRegion.hpp"
+#include "Mesh/Field.hpp"
+#include "Mesh/Geometry.hpp"
+
+#include "Physics/NavierStokes/Cons2D.hpp"
 
 #include "RDM/Schemes/LDA.hpp"
+#include "RDM/Schemes/N.hpp"
+#include "RDM/BatchMatrix.hpp"
+#include "RDM/Tags.hpp"
 
 using namespace CF;
 using namespace CF::Common;
@@ -40,6 +56,94 @@ struct CoreInit {
 
 //////////////////////////////////////////////////////////////////////////////
 
+/// Residual and wave speed of a cell term, computed for all elements in batches by execute_range()
+/// and one element at a time by execute(), on the mesh with the fields built in the test case mesh_and_fields
+template < typename SF, typename TermT >
+void check_batches_match_elements ( const std::string& name )
+{
+  CMesh& mesh = Core::instance().root().get_child("mesh").as_type<CMesh>();
+  Field& solution                  = mesh.geometry().get_child( RDM::Tags::solution()   ).as_type<Field>();
+  Field& residual                  = mesh.geometry().get_child( RDM::Tags::residual()   ).as_type<Field>();
+  SinglePrecisionField& wave_speed = mesh.geometry().get_child( RDM::Tags::wave_speed() ).as_type<SinglePrecisionField>();
+
+  TermT& term = Core::instance().root().create_component<TermT>(name);
+  term.configure_option( RDM::Tags::solution(),   solution.uri()   );
+  term.configure_option( RDM::Tags::residual(),   residual.uri()   );
+  term.configure_option( RDM::Tags::wave_speed(), wave_speed.uri() );
+
+  const Uint nb_nodes = solution.size();
+  const Uint nb_eqs = solution.row_size();
+
+  Uint nb_elems = 0;
+
+  std::vector<Real> batch_residual(nb_nodes * nb_eqs, 0.);
+  std::vector<float> batch_wave_speed(nb_nodes, 0.f);
+
+  for (Uint pass = 0; pass != 2; ++pass)
+  {
+    for (Uint n = 0; n != nb_nodes; ++n)
+    {
+      for (Uint v = 0; v != nb_eqs; ++v)
+        residual[n][v] = 0.;
+      wave_speed[n][0] = 0.;
+    }
+
+    boost_foreach(CElements& elements,
+                  find_components_recursively_with_filter<CElements>(mesh.topology(),RDM::IsElementType<SF>()))
+    {
+      term.set_elements(elements);
+
+      if (pass == 0)
+      {
+        nb_elems += elements.size();
+        term.execute_range(0, elements.size());
+      }
+      else
+      {
+        for (Uint elem = 0; elem != elements.size(); ++elem)
+        {
+          term.select_loop_idx(elem);
+          term.execute();
+        }
+      }
+    }
+
+    if (pass == 0)
+    {
+      for (Uint n = 0; n != nb_nodes; ++n)
+      {
+        for (Uint v = 0; v != nb_eqs; ++v)
+          batch_residual[n*nb_eqs + v] = residual[n][v];
+        batch_wave_speed[n] = wave_speed[n][0];
+      }
+    }
+  }
+
+  // the mesh must have full batches and remaining elements
+  BOOST_CHECK_GT(nb_elems, Uint(TermT::batch_size));
+  BOOST_CHECK_NE(nb_elems % TermT::batch_size, 0u);
+
+  Real max_residual = 0.;
+  for (Uint n = 0; n != nb_nodes; ++n)
+    for (Uint v = 0; v != nb_eqs; ++v)
+      max_residual = std::max(max_residual, std::abs(residual[n][v]));
+  BOOST_CHECK_GT(max_residual, 0.);
+
+  for (Uint n = 0; n != nb_nodes; ++n)
+  {
+    for (Uint v = 0; v != nb_eqs; ++v)
+      BOOST_CHECK_SMALL(batch_residual[n*nb_eqs + v] - residual[n][v], 1e-10 * max_residual);
+
+    BOOST_CHECK_GT(wave_speed[n][0], 0.);
+    // the wave speed is summed in single precision, in a different order
+    BOOST_CHECK_CLOSE(batch_wave_speed[n], wave_speed[n][0], 1e-3f);
+  }
+
+  Core::instance().root().remove_component(term);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 BOOST_GLOBAL_FIXTURE( CoreInit )
 
 BOOST_AUTO_TEST_SUITE( lda_test_suite )
@@ -50,6 +154,182 @@ BOOST_AUTO_TEST_CASE( const_solution )
 {
 }
 
+BOOST_AUTO_TEST_CASE( batch_solve_matches_inverse )
+{
+  using namespace CF::RDM;
+
+  typedef Eigen::Matrix<Real, 4, 4> MatrixT;
+  typedef Eigen::Matrix<Real, 4, 2> RhsT;
+
+  BatchMatrix<4,4,4> a;
+  BatchMatrix<4,4,2> x;
+
+  MatrixT m[4];
+  RhsT rhs[4];
+
+  for(Uint b = 0; b < 4; ++b)
+  {
+    for(Uint i = 0; i < 4; ++i)
+    {
+      for(Uint j = 0; j < 4; ++j)
+        m[b](i,j) = 1. / (1. + i + j + b);
+      m[b](i,i) += 2. + b;
+      rhs[b](i,0) = 1. + i;
+      rhs[b](i,1) = b - 0.5 * i;
+    }
+
+    a.set(b, m[b]);
+    x.set(b, rhs[b]);
+  }
+
+  BOOST_CHECK( batch_solve(a, x) );
+
+  for(Uint b = 0; b < 4; ++b)
+  {
+    RhsT result;
+    x.get(b, result);
+
+    const RhsT expected = m[b].inverse() * rhs[b];
+    for(Uint i = 0; i < 4; ++i)
+      for(Uint k = 0; k < 2; ++k)
+        BOOST_CHECK_CLOSE(result(i,k), expected(i,k), 1e-10);
+  }
+
+  // zero and tiny pivots, that need row exchanges in some of the matrices
+
+  MatrixT permuted[4];
+  for(Uint b = 0; b < 4; ++b)
+    permuted[b] = m[b];
+
+  permuted[1](0,0) = 0.;
+  permuted[2].row(0).swap(permuted[2].row(3));
+  permuted[2](0,0) = 1e-14;
+
+  for(Uint b = 0; b < 4; ++b)
+  {
+    a.set(b, permuted[b]);
+    x.set(b, rhs[b]);
+  }
+
+  BOOST_CHECK( batch_solve(a, x) );
+
+  for(Uint b = 0; b < 4; ++b)
+  {
+    RhsT result;
+    x.get(b, result);
+
+    const RhsT expected = permuted[b].fullPivLu().solve(rhs[b]);
+    for(Uint i = 0; i < 4; ++i)
+      for(Uint k = 0; k < 2; ++k)
+        BOOST_CHECK_CLOSE(result(i,k), expected(i,k), 1e-10);
+  }
+
+  // singular matrix in one of the lanes
+
+  MatrixT singular = m[2];
+  singular.row(3) = 2. * singular.row(1) - singular.row(0);
+
+  a.set(2, singular);
+  for(Uint b = 0; b < 4; ++b)
+    if(b != 2)
+      a.set(b, m[b]);
+
+  BOOST_CHECK( !batch_solve(a, x) );
+}
+
+BOOST_AUTO_TEST_CASE( batch_multiply_add_matches_product )
+{
+  using namespace CF::RDM;
+
+  typedef Eigen::Matrix<Real, 3, 3> MatrixT;
+  typedef Eigen::Matrix<Real, 3, 1> VectorT;
+
+  BatchMatrix<2,3,3> a;
+  BatchMatrix<2,3,1> x;
+  BatchMatrix<2,3,1> y;
+  y.setZero();
+
+  MatrixT m[2];
+  VectorT v[2];
+  for(Uint b = 0; b < 2; ++b)
+  {
+    for(Uint i = 0; i < 3; ++i)
+    {
+      for(Uint j = 0; j < 3; ++j)
+        m[b](i,j) = i - 2. * j + b;
+      v[b][i] = 0.5 + i * b;
+    }
+    a.set(b, m[b]);
+    x.set(b, v[b]);
+  }
+
+  batch_multiply_add(a, x, y);
+  batch_multiply_add(a, x, y);
+
+  for(Uint b = 0; b < 2; ++b)
+  {
+    VectorT result;
+    y.get(b, result);
+
+    const VectorT expected = 2. * m[b] * v[b];
+    for(Uint i = 0; i < 3; ++i)
+      BOOST_CHECK_SMALL(result[i] - expected[i], 1e-12);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( mesh_and_fields )
+{
+  CMesh& mesh = Core::instance().root().create_component<CMesh>("mesh");
+
+  CMeshReader::Ptr reader = build_component_abstract_type<CMeshReader>("CF.Mesh.Gmsh.CReader","reader");
+  reader->read_mesh_into("rectangle-tg-p1.msh", mesh);
+
+  Geometry& geometry = mesh.geometry();
+
+  Field& solution = geometry.create_field( RDM::Tags::solution(), "rho[1],rhou[1],rhov[1],rhoE[1]" );
+  geometry.create_field( RDM::Tags::residual(), solution.descriptor().description() );
+  geometry.create_field<SinglePrecisionField>( RDM::Tags::wave_speed(), "ws[1]" );
+
+  // smooth subsonic flow, so the sum of K plus is regular
+
+  const Real gamma = 1.4;
+  for (Uint n = 0; n != solution.size(); ++n)
+  {
+    const Real x = geometry.coordinates()[n][XX];
+    const Real y = geometry.coordinates()[n][YY];
+
+    const Real rho = 1.2 + 0.2 * x;
+    const Real u   = 0.6 + 0.1 * y;
+    const Real v   = 0.2 * x - 0.1 * y;
+    const Real P   = 1.0 + 0.1 * x * y;
+
+    solution[n][0] = rho;
+    solution[n][1] = rho * u;
+    solution[n][2] = rho * v;
+    solution[n][3] = P / (gamma - 1.) + 0.5 * rho * (u*u + v*v);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( lda_batches_match_elements )
+{
+  using namespace CF::RDM;
+
+  typedef Mesh::SF::Triag2DLagrangeP1 SF;
+  typedef DefaultQuadrature<SF>::type QD;
+
+  check_batches_match_elements< SF, LDA::Term<SF,QD,Physics::NavierStokes::Cons2D> >("lda");
+}
+
+BOOST_AUTO_TEST_CASE( n_batches_match_elements )
+{
+  using namespace CF::RDM;
+
+  typedef Mesh::SF::Triag2DLagrangeP1 SF;
+  typedef DefaultQuadrature<SF>::type QD;
+
+  check_batches_match_elements< SF, N::Term<SF,QD,Physics::NavierStokes::Cons2D> >("n");
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 BOOST_AUTO_TEST_SUITE_END()
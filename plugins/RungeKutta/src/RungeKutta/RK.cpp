@@ -4,13 +4,20 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "Common/Foreach.hpp"
 #include "Common/OptionT.hpp"
 #include "Common/OptionComponent.hpp"
 #include "Common/CBuilder.hpp"
 #include "Common/CGroupActions.hpp"
 #include "Common/CGroup.hpp"
+#include "Common/MPI/PE.hpp"
 
 #include "Mesh/CMesh.hpp"
+#include "Mesh/CSpace.hpp"
 #include "Mesh/Field.hpp"
 #include "Mesh/MeshMetadata.hpp"
 #include "Solver/FlowSolver.hpp"
@@ -34,7 +41,9 @@ ComponentBuilder<RK, CAction, LibRungeKutta> RK_builder;
 
 RK::RK ( const std::string& name  )
   : Solver::Action(name),
-    m_stages(4u)
+    m_stages(4u),
+    m_multirate_levels(0u),
+    m_tolerance(1e-12)
 {
   properties()["brief"] = std::string("Runge Kutta differential equation solver");
   properties()["description"] = std::string("Solves the differential equation using Runge Kutta method");
@@ -48,6 +57,15 @@ RK::RK ( const std::string& name  )
 
   config_stages();
 
+  options().add_option(OptionT<Uint>::create("multirate_levels", m_multirate_levels))
+      ->description("Maximum number of power-of-two time step levels for multirate time stepping. 0 uses the same time step for all cells")
+      ->pretty_name("Multirate Levels")
+      ->link_to(&m_multirate_levels);
+
+  options().add_option(OptionT<Real>::create("milestone_dt", 0.))
+      ->description("Limits the multirate time step of the coarsest level to fall on milestones")
+      ->pretty_name("Milestone Time Step");
+
   options().add_option(OptionComponent<CTime>::create( Solver::Tags::time(), &m_time))
       ->description("Time component")
       ->pretty_name("Time");
@@ -60,6 +78,10 @@ RK::RK ( const std::string& name  )
       ->description("Residual")
       ->pretty_name("Residual");
 
+  options().add_option(OptionComponent<SinglePrecisionField>::create("single_precision_residual", &m_single_precision_residual))
+      ->description("Residual stored in single precision. If set, it is used instead of the residual")
+      ->pretty_name("Single Precision Residual");
+
   options().add_option(OptionComponent<Field>::create(FlowSolver::Tags::update_coeff(), &m_update_coeff))
       ->description("Update Coefficient")
       ->pretty_name("Update Coefficient");
@@ -166,9 +188,19 @@ void RK::execute()
   /// @todo put this in triggers of own config options
   m_update->configure_option("solution",m_solution.lock()->uri());
   m_update->configure_option("solution_backup",m_solution_backup.lock()->uri());
-  m_update->configure_option("residual",m_residual.lock()->uri());
+  if ( !m_residual.expired() )
+    m_update->configure_option("residual",m_residual.lock()->uri());
+  if ( !m_single_precision_residual.expired() )
+    m_update->configure_option("single_precision_residual",m_single_precision_residual.lock()->uri());
   m_update->configure_option("update_coeff",m_update_coeff.lock()->uri());
 
+  if (m_multirate_levels > 0)
+  {
+    execute_multirate();
+    return;
+  }
+  m_update->set_multirate(0.,0);
+
   /// 1) backup solution and time
   U0 = U;
 
@@ -204,5 +236,231 @@ void RK::execute()
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void RK::execute_multirate()
+{
+  if (m_update_coeff.expired()) throw SetupError (FromHere(), "update_coeff was not set");
+
+  Field& U = *m_solution.lock();
+  Field& H = *m_update_coeff.lock();
+
+  if ( m_solution_end.expired() )
+    m_solution_end = U.field_group().create_field("solution_multirate_end", U.descriptor()).as_ptr<Field>();
+  if ( m_reflux.expired() )
+    m_reflux = U.field_group().create_field("reflux_correction", U.descriptor()).as_ptr<Field>();
+  if ( m_level.expired() )
+    m_level = H.field_group().create_field("multirate_level").as_ptr<Field>();
+
+  Field& U1 = *m_solution_end.lock();
+  Field& C  = *m_reflux.lock();
+  CTime& time = *m_time.lock();
+
+  m_update->configure_option("multirate_level",m_level.lock()->uri());
+  m_pre_update->configure_option_recursively("multirate_level",m_level.lock()->uri());
+  m_pre_update->configure_option_recursively("reflux_correction",m_reflux.lock()->uri());
+
+  const Real T0 = time.current_time();
+
+  /// 1) All cells start their first step from the current solution
+  U1 = U;
+  for (Uint i=0; i<C.size(); ++i)
+    for (Uint j=0; j<C.row_size(); ++j)
+      C[i][j] = 0.;
+
+  /// 2) Residual and local time step in all cells, which determines the levels.
+  ///    The levels are not known yet, so no reflux correction is done.
+  time.current_time() = T0;
+  m_pre_update->configure_option_recursively("freeze_update_coeff",false);
+  m_pre_update->configure_option_recursively("max_active_level",m_multirate_levels);
+  m_pre_update->configure_option_recursively("reflux_weight",0.);
+  m_pre_update->execute();
+  m_pre_update->configure_option_recursively("freeze_update_coeff",true);
+
+  Real dt_min;
+  const Uint max_level = assign_levels(dt_min);
+  const Uint nb_substeps = 1u << max_level;
+
+  /// - The step of the coarsest level ends at the next milestone or the end time at the latest
+  const Real tf = limit_end_time(T0, time.end_time());
+  if (tf > T0 && T0 + dt_min*nb_substeps + m_tolerance > tf)
+    dt_min = (tf - T0) / static_cast<Real>(nb_substeps);
+  time.dt() = dt_min;
+
+  /// - Weight of the residual of each stage in the update of a step of the finest level,
+  ///   used by the residual actions for the reflux correction
+  ///   @f[ U^{end} = U^0 + H \sum_k w_k R(U^k), \quad w_k = \beta_k \prod_{j>k} \alpha_j @f]
+  std::vector<Real> reflux_weight(m_stages);
+  for (Uint k=0; k<m_stages; ++k)
+  {
+    reflux_weight[k] = m_beta[k] * dt_min;
+    for (Uint j=k+1; j<m_stages; ++j)
+      reflux_weight[k] *= m_alpha[j];
+  }
+
+  /// 3) Sub-cycle with the smallest time step
+  for (Uint substep=0; substep<nb_substeps; ++substep)
+  {
+    /// - Levels up to max_active_level start a new step in this sub-step
+    Uint max_active_level = 0;
+    while (max_active_level < max_level && ((substep >> max_active_level) & 1u) == 0)
+      ++max_active_level;
+
+    start_substep(substep);
+    m_pre_update->configure_option_recursively("max_active_level",max_active_level);
+    m_update->set_multirate(dt_min,max_active_level);
+
+    for (Uint k=0; k<m_stages; ++k)
+    {
+      time.current_time() = T0 + (substep + m_gamma[k]) * dt_min;
+
+      /// - The residual of the first stage of the first sub-step is computed again,
+      ///   now that the levels are known for the reflux correction
+      m_pre_update->configure_option_recursively("reflux_weight",reflux_weight[k]);
+      m_pre_update->execute();
+
+      m_update->set_coefficients(m_alpha[k],m_beta[k]);
+      m_update->execute();
+
+      m_post_update->execute();
+    }
+
+    finish_substep(max_active_level);
+  }
+
+  /// 4) All cells end their last step, since every step size divides the number of sub-steps
+  start_substep(nb_substeps);
+  m_update->set_multirate(0.,0);
+
+  /// Set time back to pre-stages time, so that the action Solver::CAdvanceTime will update the time
+  /// with the time step of the coarsest level
+  time.current_time() = T0;
+  time.dt() = dt_min * nb_substeps;
+  m_advance_time->execute();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Real RK::limit_end_time(const Real time, const Real end_time) const
+{
+  const Real milestone_dt = option("milestone_dt").value<Real>();
+  if (milestone_dt == 0)
+    return end_time;
+
+  const Real milestone_time = (Uint((time+m_tolerance)/milestone_dt)+1.)*milestone_dt;
+  return std::min(milestone_time,end_time);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Uint RK::assign_levels(Real& dt_min)
+{
+  const Field& H = *m_update_coeff.lock();
+  Field& L = *m_level.lock();
+
+  Real loc_dt_min = std::numeric_limits<Real>::max();
+  for (Uint i=0; i<H.size(); ++i)
+  {
+    if (H[i][0] > 0.)
+      loc_dt_min = std::min(loc_dt_min,H[i][0]);
+  }
+  dt_min = loc_dt_min;
+  if (Comm::PE::instance().is_active())
+    Comm::PE::instance().all_reduce(Comm::min(), &loc_dt_min, 1, &dt_min);
+
+  if (dt_min == std::numeric_limits<Real>::max())
+    throw SetupError (FromHere(), "update_coeff has no positive local time step to derive the multirate levels from");
+
+  Uint loc_max_level = 0;
+  for (Uint i=0; i<H.size(); ++i)
+  {
+    Uint level = 0;
+    while (level < m_multirate_levels && H[i][0] >= dt_min * static_cast<Real>(2u << level))
+      ++level;
+    L[i][0] = level;
+    loc_max_level = std::max(loc_max_level,level);
+  }
+
+  Uint max_level = loc_max_level;
+  if (Comm::PE::instance().is_active())
+    Comm::PE::instance().all_reduce(Comm::max(), &loc_max_level, 1, &max_level);
+
+  return max_level;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void RK::start_substep(const Uint substep)
+{
+  Field& U  = *m_solution.lock();
+  Field& U0 = *m_solution_backup.lock();
+  const Field& U1 = *m_solution_end.lock();
+  Field& C  = *m_reflux.lock();
+  const Field& L = *m_level.lock();
+
+  boost_foreach(const CEntities& elements, U.entities_range())
+  {
+    CSpace& solution_space = U.space(elements);
+    CSpace& P0_space = L.space(elements);
+    for (Uint e=0; e<elements.size(); ++e)
+    {
+      const Uint step_size = 1u << static_cast<Uint>(L[P0_space.indexes_for_element(e)[0]][0]);
+      const Uint position = substep % step_size;
+      if (position == 0)
+      {
+        /// - The end of the previous step, with the reflux correction, is the start of the next one
+        boost_foreach(const Uint state, solution_space.indexes_for_element(e))
+        {
+          for (Uint j=0; j<U.row_size(); ++j)
+          {
+            U[state][j] = U1[state][j] + C[state][j];
+            C[state][j] = 0.;
+            U0[state][j] = U[state][j];
+          }
+        }
+      }
+      else
+      {
+        /// - Inside the step, finer neighbours see the state interpolated in time
+        const Real fraction = static_cast<Real>(position) / static_cast<Real>(step_size);
+        boost_foreach(const Uint state, solution_space.indexes_for_element(e))
+        {
+          for (Uint j=0; j<U.row_size(); ++j)
+          {
+            U[state][j] = U0[state][j] + fraction*(U1[state][j] - U0[state][j]);
+          }
+        }
+      }
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void RK::finish_substep(const Uint max_active_level)
+{
+  Field& U = *m_solution.lock();
+  Field& U1 = *m_solution_end.lock();
+  const Field& L = *m_level.lock();
+
+  boost_foreach(const CEntities& elements, U.entities_range())
+  {
+    CSpace& solution_space = U.space(elements);
+    CSpace& P0_space = L.space(elements);
+    for (Uint e=0; e<elements.size(); ++e)
+    {
+      if (static_cast<Uint>(L[P0_space.indexes_for_element(e)[0]][0]) > max_active_level)
+        continue;
+      boost_foreach(const Uint state, solution_space.indexes_for_element(e))
+      {
+        for (Uint j=0; j<U.row_size(); ++j)
+        {
+          U1[state][j] = U[state][j];
+        }
+      }
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 } // RungeKutta
 } // CF
@@ -16,7 +16,7 @@
 
 namespace CF {
 namespace Common { class CGroupActions; class CGroup;}
-namespace Mesh { class Field; }
+namespace Mesh { class Field; class SinglePrecisionField; }
 namespace Solver { namespace Actions { class CAdvanceTime; } }
 namespace RungeKutta {
   class UpdateSolution;
@@ -33,6 +33,23 @@ namespace RungeKutta {
 /// - post_update_actions
 /// The update itself is delegated to the UpdateSolution component
 /// time and dt are updated as well. (time update could be separate)
+///
+/// With the option "multirate_levels" larger than zero, cells are grouped in levels
+/// by their local time step (the update coefficient computed in the first stage),
+/// where level l advances with a time step dt_min*2^l. Each global step covers the
+/// time step of the coarsest level, and is sub-cycled in steps of dt_min.
+/// In each sub-step, only the levels that start a new step are updated; the other
+/// cells are interpolated in time between the start and end of their current step.
+/// The step of the coarsest level is shortened to end at the end time, or at the next
+/// multiple of the option "milestone_dt".
+/// Residual actions can restrict their work using the options "max_active_level" and
+/// "multirate_level", which are set recursively in the pre_update_actions. They can keep
+/// the method conservative by adding the difference between the fluxes integrated on the
+/// fine side and on the coarse side of an interface to the field set in the option
+/// "reflux_correction", which is added to the coarse cells at the end of their step
+/// (see Reflux, which does this for residuals with one state per cell).
+/// The residual of a stage enters the update of a cell of level l with the weight
+/// 2^l times the option "reflux_weight", which is set before every stage.
 /// @author Willem Deconinck
 class RungeKutta_API RK : public Solver::Action {
 
@@ -59,10 +76,33 @@ private:
 
   void config_stages();
 
+  /// Sub-cycled time step with cells grouped in power-of-two time step levels
+  void execute_multirate();
+
+  /// Next time the step of the coarsest level may not pass
+  /// @return the minimum of the end time and the next milestone after time
+  Real limit_end_time(const Real time, const Real end_time) const;
+
+  /// Assign a level to every cell, from its local time step in the update coefficient
+  /// @param [out] dt_min  smallest local time step, over all processes
+  /// @return the highest level in use, over all processes
+  Uint assign_levels(Real& dt_min);
+
+  /// Prepare the cells for the given sub-step: cells starting a new step get the end state
+  /// of their previous step, the other cells are interpolated in time inside their current step
+  void start_substep(const Uint substep);
+
+  /// Store the end state of the cells that were updated in this sub-step
+  void finish_substep(const Uint max_active_level);
+
 private:
 
   Uint m_stages;
 
+  Uint m_multirate_levels;
+
+  Real m_tolerance;
+
   boost::shared_ptr<Common::CGroup> m_for_each_stage;
   boost::shared_ptr<Common::CGroupActions> m_pre_update;
   boost::shared_ptr<UpdateSolution> m_update;
@@ -73,8 +113,12 @@ private:
 
   boost::weak_ptr<Mesh::Field> m_solution;
   boost::weak_ptr<Mesh::Field> m_residual;
+  boost::weak_ptr< Mesh::SinglePrecisionField > m_single_precision_residual;
   boost::weak_ptr<Mesh::Field> m_update_coeff;
   boost::weak_ptr<Mesh::Field> m_solution_backup;
+  boost::weak_ptr<Mesh::Field> m_solution_end;
+  boost::weak_ptr<Mesh::Field> m_reflux;
+  boost::weak_ptr<Mesh::Field> m_level;
 
   std::vector<Real> m_alpha;
   std::vector<Real> m_beta;
@@ -0,0 +1,35 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include "Common/BasicExceptions.hpp"
+
+#include "RungeKutta/Reflux.hpp"
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+using namespace CF::Common;
+using namespace CF::Mesh;
+
+namespace CF {
+namespace RungeKutta {
+
+////////////////////////////////////////////////////////////////////////////////
+
+Reflux::Reflux(const Field& level, Field& correction, const Uint max_active_level, const Real weight) :
+  m_level(level),
+  m_correction(correction),
+  m_max_active_level(max_active_level),
+  m_weight(weight)
+{
+  if (m_level.size() != m_correction.size())
+    throw BadValue(FromHere(), "The reflux correction " + m_correction.uri().string() + " needs one state per cell, like "
+                               + m_level.uri().string());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // RungeKutta
+} // CF
@@ -0,0 +1,92 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef CF_RungeKutta_Reflux_hpp
+#define CF_RungeKutta_Reflux_hpp
+
+#include "Mesh/Field.hpp"
+
+#include "RungeKutta/LibRungeKutta.hpp"
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+namespace CF {
+namespace RungeKutta {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Face flux bookkeeping of a residual action in multirate time stepping (see RK).
+///
+/// A residual action constructs it at each execution from its options "multirate_level",
+/// "reflux_correction", "max_active_level" and "reflux_weight", only computes the residual
+/// of the active cells, and passes the contribution of every face to add_face().
+/// On faces between cells of different levels, the coarser cell then gets the contribution
+/// integrated in the steps of the finer cell instead of its own, which keeps the method conservative.
+/// The level and the correction are read in the row of the cell, so each cell has one state.
+class RungeKutta_API Reflux
+{
+public:
+
+  /// @param level             multirate level of each cell
+  /// @param correction        reflux correction of each cell
+  /// @param max_active_level  highest level that is computed in this sub-step
+  /// @param weight            weight of the residual in the update of the finest level
+  Reflux(const Mesh::Field& level, Mesh::Field& correction, const Uint max_active_level, const Real weight);
+
+  /// Level of the given cell
+  Uint level(const Uint cell) const { return static_cast<Uint>(m_level[cell][0]); }
+
+  /// True if the residual of the given cell is computed in this sub-step
+  bool is_active(const Uint cell) const { return level(cell) <= m_max_active_level; }
+
+  /// Account for a face between two cells. Only the part of the residual of the active cells
+  /// should be added to the residual itself.
+  /// @param left          cell on one side of the face
+  /// @param right         cell on the other side of the face
+  /// @param left_update   contribution of the face to the residual of the left cell
+  /// @param right_update  contribution of the face to the residual of the right cell
+  template <typename RowT>
+  void add_face(const Uint left, const Uint right, const RowT& left_update, const RowT& right_update)
+  {
+    const Uint left_level = level(left);
+    const Uint right_level = level(right);
+    if (m_weight == 0. || left_level == right_level)
+      return;
+
+    const bool left_is_fine = left_level < right_level;
+    const Uint coarse = left_is_fine ? right : left;
+    const Uint fine_level = left_is_fine ? left_level : right_level;
+    const Uint coarse_level = left_is_fine ? right_level : left_level;
+    const RowT& coarse_update = left_is_fine ? right_update : left_update;
+
+    // Add what the fine cell integrates, remove what the coarse cell integrates itself
+    Real factor = 0.;
+    if (fine_level <= m_max_active_level)
+      factor += m_weight * static_cast<Real>(1u << fine_level);
+    if (coarse_level <= m_max_active_level)
+      factor -= m_weight * static_cast<Real>(1u << coarse_level);
+
+    Mesh::Field::Row correction = m_correction[coarse];
+    for (Uint j=0; j<m_correction.row_size(); ++j)
+      correction[j] += factor * coarse_update[j];
+  }
+
+private:
+
+  const Mesh::Field& m_level;
+  Mesh::Field& m_correction;
+  const Uint m_max_active_level;
+  const Real m_weight;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // RungeKutta
+} // CF
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+#endif // CF_RungeKutta_Reflux_hpp
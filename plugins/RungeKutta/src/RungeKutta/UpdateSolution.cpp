@@ -4,10 +4,16 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <algorithm>
+
+#include <boost/bind.hpp>
+
 #include "Common/Foreach.hpp"
 #include "Common/CBuilder.hpp"
 #include "Common/OptionComponent.hpp"
 #include "Common/OptionT.hpp"
+#include "Common/ThreadPool.hpp"
+#include "Common/MPI/PE.hpp"
 #include "Mesh/CSpace.hpp"
 #include "Mesh/Field.hpp"
 #include "Mesh/CMesh.hpp"
@@ -30,7 +36,11 @@ Common::ComponentBuilder < UpdateSolution, CAction, LibRungeKutta > UpdateSoluti
 UpdateSolution::UpdateSolution ( const std::string& name ) :
   CAction(name),
   m_alpha(1.),  // forward euler step with these coefficients for alpha and beta
-  m_beta(1.)
+  m_beta(1.),
+  m_dt_min(0.),
+  m_max_active_level(0),
+  m_nb_threads(1),
+  m_nb_states(0)
 {
   mark_basic();
 
@@ -38,7 +48,8 @@ UpdateSolution::UpdateSolution ( const std::string& name ) :
 
   m_options.add_option(OptionComponent<Field>::create("solution", &m_solution))
       ->description("Solution to update")
-      ->pretty_name("Solution");
+      ->pretty_name("Solution")
+      ->attach_trigger( boost::bind( &UpdateSolution::clear_blocks, this) );
 
   m_options.add_option(OptionComponent<Field>::create("solution_backup", &m_solution_backup))
       ->description("Solution Backup")
@@ -46,12 +57,21 @@ UpdateSolution::UpdateSolution ( const std::string& name ) :
 
   m_options.add_option(OptionComponent<Field>::create("update_coeff", &m_update_coeff))
       ->description("Update coefficient")
-      ->pretty_name("Update Coefficient");
+      ->pretty_name("Update Coefficient")
+      ->attach_trigger( boost::bind( &UpdateSolution::clear_blocks, this) );
 
   m_options.add_option(OptionComponent<Field>::create("residual", &m_residual))
       ->description("Residual")
       ->pretty_name("Residual");
 
+  m_options.add_option(OptionComponent<SinglePrecisionField>::create("single_precision_residual", &m_single_precision_residual))
+      ->description("Residual stored in single precision. If set, it is used instead of the residual")
+      ->pretty_name("Single Precision Residual");
+
+  m_options.add_option(OptionComponent<Field>::create("multirate_level", &m_level))
+      ->description("Time step level of each cell, for multirate time stepping")
+      ->pretty_name("Multirate Level");
+
   m_options.add_option(OptionT<Real>::create("alpha", m_alpha))
       ->description("RK coefficient alpha")
       ->pretty_name("alpha")
@@ -61,6 +81,11 @@ UpdateSolution::UpdateSolution ( const std::string& name ) :
       ->description("RK coefficient beta")
       ->pretty_name("beta")
       ->link_to(&m_beta);
+
+  m_options.add_option(OptionT<Uint>::create("nb_threads", m_nb_threads))
+      ->description("Number of threads that update parts of the solution. 0 uses the threads of the process (see Comm::PE::nb_threads)")
+      ->pretty_name("Number of Threads")
+      ->link_to(&m_nb_threads);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -69,29 +94,168 @@ void UpdateSolution::execute()
 {
   if (m_solution.expired())     throw SetupError(FromHere(), "Solution field was not set");
   if (m_solution_backup.expired())     throw SetupError(FromHere(), "Solution backup field was not set");
-  if (m_residual.expired())     throw SetupError(FromHere(), "Residual field was not set");
   if (m_update_coeff.expired()) throw SetupError(FromHere(), "UpdateCoeff Field was not set");
+  if (m_dt_min > 0. && m_level.expired()) throw SetupError(FromHere(), "Multirate level field was not set");
 
-  Field& U  = *m_solution.lock();
-  Field& U0 = *m_solution_backup.lock();
-  Field& R  = *m_residual.lock();
-  Field& H  = *m_update_coeff.lock();
+  if (m_blocks.empty() || m_nb_states != m_solution.lock()->size())
+    build_blocks();
+
+  const Uint nb_threads = m_nb_threads == 0 ? Comm::PE::instance().nb_threads() : m_nb_threads;
+  const Uint nb_parts = std::max(1u, std::min(nb_threads, m_nb_states));
+  ThreadPool& pool = Comm::PE::instance().thread_pool();
+
+  if (m_single_precision_residual.expired())
+  {
+    if (m_residual.expired())   throw SetupError(FromHere(), "Residual field was not set");
+    const Field& R = *m_residual.lock();
+    pool.run(nb_parts, boost::bind(&UpdateSolution::update<Field>, this, boost::cref(R), nb_parts, _1));
+  }
+  else
+  {
+    const SinglePrecisionField& R = *m_single_precision_residual.lock();
+    pool.run(nb_parts, boost::bind(&UpdateSolution::update<SinglePrecisionField>, this, boost::cref(R), nb_parts, _1));
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void UpdateSolution::build_blocks()
+{
+  Field& U = *m_solution.lock();
+  const Field& H = *m_update_coeff.lock();
+
+  m_blocks.clear();
+  m_nb_states = U.size();
+
+  // States of cells that do not form a block, with the row of their update coefficient
+  std::vector<int> coeff_row_of_state;
 
-  const Real one_minus_alpha = 1.-m_alpha;
   boost_foreach(const CEntities& elements, U.entities_range())
   {
-    CSpace& solution_space = U.space(elements);
-    CSpace& P0_space = H.space(elements);
-    for (Uint e=0; e<elements.size(); ++e)
+    const CSpace& solution_space = U.space(elements);
+    const CSpace& coeff_space = H.space(elements);
+    const Uint nb_elems = elements.size();
+    if (nb_elems == 0)
+      continue;
+
+    Block block;
+    block.states_per_cell = solution_space.nb_states();
+    block.states_begin = solution_space.indexes_for_element(0)[0];
+    block.states_end = block.states_begin + nb_elems*block.states_per_cell;
+    block.coeff_begin = coeff_space.indexes_for_element(0)[0];
+
+    bool is_block = block.states_per_cell > 0;
+    for (Uint e=0; e<nb_elems && is_block; ++e)
+    {
+      is_block = coeff_space.indexes_for_element(e)[0] == block.coeff_begin + e;
+      CConnectivity::ConstRow states = solution_space.indexes_for_element(e);
+      for (Uint k=0; k<block.states_per_cell && is_block; ++k)
+        is_block = states[k] == block.states_begin + e*block.states_per_cell + k;
+    }
+
+    if (is_block)
+    {
+      m_blocks.push_back(block);
+      continue;
+    }
+
+    // Shared or scattered states: each state is a block of its own, the last cell that uses it wins
+    coeff_row_of_state.resize(m_nb_states, -1);
+    for (Uint e=0; e<nb_elems; ++e)
     {
-      Real h = H[P0_space.indexes_for_element(e)[0]][0];
+      const Uint coeff_row = coeff_space.indexes_for_element(e)[0];
       boost_foreach(const Uint state, solution_space.indexes_for_element(e))
+        coeff_row_of_state[state] = coeff_row;
+    }
+  }
+
+  for (Uint i=0; i<coeff_row_of_state.size(); ++i)
+  {
+    if (coeff_row_of_state[i] < 0)
+      continue;
+    Block block;
+    block.states_begin = i;
+    block.states_end = i+1;
+    block.states_per_cell = 1;
+    block.coeff_begin = coeff_row_of_state[i];
+    m_blocks.push_back(block);
+  }
+
+  std::sort(m_blocks.begin(), m_blocks.end(), boost::bind(&Block::states_begin, _1) < boost::bind(&Block::states_begin, _2));
+
+  for (Uint b=1; b<m_blocks.size(); ++b)
+  {
+    if (m_blocks[b].states_begin < m_blocks[b-1].states_end)
+      throw SetupError(FromHere(), "Cells of different element types share states of solution " + U.uri().string());
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename ResidualT>
+void UpdateSolution::update(const ResidualT& R, const Uint nb_parts, const Uint i)
+{
+  Field& U  = *m_solution.lock();
+  const Field& U0 = *m_solution_backup.lock();
+  const Field& H = *m_update_coeff.lock();
+  const Field& L = m_dt_min > 0. ? *m_level.lock() : H;
+
+  cf_assert(R.size() == U.size());
+  cf_assert(R.row_size() == U.row_size());
+
+  const Uint nb_vars = U.row_size();
+  const Real one_minus_alpha = 1.-m_alpha;
+
+  // Position of entry (state,var) is state*state_stride + var*var_stride, for each of the layouts
+  const Uint u_state_stride  = U.layout()  == Field::COLUMN_MAJOR ? 1 : nb_vars;
+  const Uint u_var_stride    = U.layout()  == Field::COLUMN_MAJOR ? U.size() : 1;
+  const Uint u0_state_stride = U0.layout() == Field::COLUMN_MAJOR ? 1 : nb_vars;
+  const Uint u0_var_stride   = U0.layout() == Field::COLUMN_MAJOR ? U0.size() : 1;
+  const Uint r_state_stride  = R.layout()  == ResidualT::COLUMN_MAJOR ? 1 : nb_vars;
+  const Uint r_var_stride    = R.layout()  == ResidualT::COLUMN_MAJOR ? R.size() : 1;
+
+  Real* u = U.array().data();
+  const Real* u0 = U0.array().data();
+  const typename ResidualT::value_type* r = R.array().data();
+
+  const Uint begin = (m_nb_states * i) / nb_parts;
+  const Uint end = (m_nb_states * (i+1)) / nb_parts;
+
+  // U = (1-alpha)*U0 + alpha*U + beta*h*R, written as an increment of U,
+  // so that the states that are not active keep their value
+  boost_foreach(const Block& block, m_blocks)
+  {
+    if (block.states_end <= begin || block.states_begin >= end)
+      continue;
+
+    Uint state = std::max(block.states_begin, begin);
+    const Uint states_end = std::min(block.states_end, end);
+    while (state != states_end)
+    {
+      // The time step of the cell is broadcast to all its states
+      const Uint cell = (state - block.states_begin) / block.states_per_cell;
+      const Uint cell_end = std::min(states_end, block.states_begin + (cell+1)*block.states_per_cell);
+      const Uint coeff_row = block.coeff_begin + cell;
+
+      // In multirate mode, the time step follows from the level, and only the active levels are updated
+      const Uint level = m_dt_min > 0. ? static_cast<Uint>(L[coeff_row][0]) : 0u;
+      if (level <= m_max_active_level || m_dt_min == 0.)
       {
-        for (Uint j=0; j<U.row_size(); ++j)
+        const Real h = m_dt_min > 0. ? m_dt_min * static_cast<Real>(1u << level) : H[coeff_row][0];
+        const Real beta_h = m_beta*h;
+        for (Uint var=0; var<nb_vars; ++var)
         {
-          U[state][j] = one_minus_alpha*U0[state][j] + m_alpha*U[state][j] + m_beta*h*R[state][j];
+          Real* u_var = u + var*u_var_stride;
+          const Real* u0_var = u0 + var*u0_var_stride;
+          const typename ResidualT::value_type* r_var = r + var*r_var_stride;
+          for (Uint s=state; s!=cell_end; ++s)
+          {
+            Real& u_s = u_var[s*u_state_stride];
+            u_s += one_minus_alpha*(u0_var[s*u0_state_stride] - u_s) + beta_h*r_var[s*r_state_stride];
+          }
         }
       }
+      state = cell_end;
     }
   }
 }
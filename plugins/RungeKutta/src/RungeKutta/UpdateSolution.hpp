@@ -7,6 +7,8 @@
 #ifndef CF_RungeKutta_UpdateSolution_hpp
 #define CF_RungeKutta_UpdateSolution_hpp
 
+#include <vector>
+
 #include "Common/CAction.hpp"
 
 #include "RungeKutta/LibRungeKutta.hpp"
@@ -14,7 +16,7 @@
 /////////////////////////////////////////////////////////////////////////////////////
 
 namespace CF {
-namespace Mesh   { class Field; }
+namespace Mesh   { class Field; class SinglePrecisionField; }
 namespace RungeKutta {
 
 class RungeKutta_API UpdateSolution : public Common::CAction
@@ -45,15 +47,61 @@ public: // functions
     m_beta = beta;
   }
 
+  /// Multirate update: only the cells with a level up to max_active_level are updated, each with
+  /// the time step dt_min*2^level instead of the update coefficient.
+  /// A dt_min of zero switches back to the update coefficient for all cells.
+  void set_multirate(const Real& dt_min, const Uint max_active_level)
+  {
+    m_dt_min = dt_min;
+    m_max_active_level = max_active_level;
+  }
+
+private: // functions
+
+  /// Find the row of the update coefficient of every state of the solution
+  void build_blocks();
+
+  /// Forget the blocks, so they are found again at the next execution
+  void clear_blocks() { m_blocks.clear(); }
+
+  /// Update the solution with the given residual, which can be stored in double or single precision.
+  /// The states are split in nb_parts equal parts, of which part i is updated.
+  template <typename ResidualT>
+  void update(const ResidualT& R, const Uint nb_parts, const Uint i);
+
 private: // data
 
   boost::weak_ptr<Mesh::Field> m_solution;
   boost::weak_ptr<Mesh::Field> m_solution_backup;
   boost::weak_ptr<Mesh::Field> m_residual;
+  boost::weak_ptr< Mesh::SinglePrecisionField > m_single_precision_residual;
   boost::weak_ptr<Mesh::Field> m_update_coeff;
+  boost::weak_ptr<Mesh::Field> m_level;
 
   Real m_alpha;
   Real m_beta;
+
+  Real m_dt_min;
+  Uint m_max_active_level;
+
+  /// Number of threads used for the update, 0 to use Comm::PE::nb_threads()
+  Uint m_nb_threads;
+
+  /// Consecutive states of cells that each have the same number of states, with their update coefficients in
+  /// consecutive rows. The update coefficient of state i is in row coeff_begin + (i-states_begin)/states_per_cell.
+  struct Block
+  {
+    Uint states_begin;
+    Uint states_end;
+    Uint states_per_cell;
+    Uint coeff_begin;
+  };
+
+  /// Blocks, ordered by their first state
+  std::vector<Block> m_blocks;
+
+  /// Number of states the blocks were found for
+  Uint m_nb_states;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
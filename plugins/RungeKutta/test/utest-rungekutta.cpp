@@ -7,6 +7,8 @@
 #define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MODULE "Test module for CF::RiemannSolvers"
 
+#include <cmath>
+
 #include <boost/test/unit_test.hpp>
 
 
@@ -14,8 +16,12 @@
 #include "Common/Core.hpp"
 #include "Common/CRoot.hpp"
 #include "Common/CEnv.hpp"
+#include "Common/CGroupActions.hpp"
+#include "Common/OptionComponent.hpp"
+#include "Common/OptionT.hpp"
 
 #include "Math/Defs.hpp"
+#include "Math/MatrixTypes.hpp"
 #include "Mesh/CSimpleMeshGenerator.hpp"
 #include "Mesh/Field.hpp"
 #include "Mesh/Actions/CreateSpaceP0.hpp"
@@ -23,6 +29,7 @@
 #include "Solver/CTime.hpp"
 
 #include "RungeKutta/RK.hpp"
+#include "RungeKutta/Reflux.hpp"
 
 using namespace CF;
 using namespace CF::Common;
@@ -32,6 +39,142 @@ using namespace CF::Mesh;
 
 //////////////////////////////////////////////////////////////////////////////
 
+/// Residual of dU/dt = -U in each cell, with a local time step that is 4 times smaller
+/// in the first 2 cells. Only the cells in the active multirate levels are evaluated.
+/// The residual is stored in single precision if the option "single_precision_residual" is set.
+class DecayResidual : public CAction
+{
+public:
+  typedef boost::shared_ptr<DecayResidual> Ptr;
+  typedef boost::shared_ptr<DecayResidual const> ConstPtr;
+
+  DecayResidual(const std::string& name) :
+    CAction(name),
+    m_freeze(false),
+    m_max_active_level(0)
+  {
+    m_options.add_option(OptionComponent<Field>::create("solution", &m_solution));
+    m_options.add_option(OptionComponent<Field>::create("residual", &m_residual));
+    m_options.add_option(OptionComponent<SinglePrecisionField>::create("single_precision_residual", &m_single_precision_residual));
+    m_options.add_option(OptionComponent<Field>::create("update_coeff", &m_update_coeff));
+    m_options.add_option(OptionComponent<Field>::create("multirate_level", &m_level));
+    m_options.add_option(OptionT<bool>::create("freeze_update_coeff", m_freeze))->link_to(&m_freeze);
+    m_options.add_option(OptionT<Uint>::create("max_active_level", m_max_active_level))->link_to(&m_max_active_level);
+  }
+
+  static std::string type_name () { return "DecayResidual"; }
+
+  virtual void execute()
+  {
+    const Field& U = *m_solution.lock();
+    Field& H = *m_update_coeff.lock();
+    nb_evaluations.resize(U.size(),0);
+
+    for (Uint i=0; i<U.size(); ++i)
+    {
+      if (!m_freeze)
+        H[i][0] = i < 2 ? 0.01 : 0.04;
+      if (!m_level.expired() && static_cast<Uint>((*m_level.lock())[i][0]) > m_max_active_level)
+        continue;
+      if (m_single_precision_residual.expired())
+        (*m_residual.lock())[i][0] = -U[i][0];
+      else
+        (*m_single_precision_residual.lock())[i][0] = -U[i][0];
+      ++nb_evaluations[i];
+    }
+  }
+
+  std::vector<Uint> nb_evaluations;
+
+private:
+  boost::weak_ptr<Field> m_solution;
+  boost::weak_ptr<Field> m_residual;
+  boost::weak_ptr< SinglePrecisionField > m_single_precision_residual;
+  boost::weak_ptr<Field> m_update_coeff;
+  boost::weak_ptr<Field> m_level;
+  bool m_freeze;
+  Uint m_max_active_level;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// Upwind finite volume residual of dU/dt + dU/dx = 0 on a periodic line of cells of length 0.1,
+/// with a local time step that is 4 times smaller in the first 2 cells.
+/// Only the cells in the active multirate levels are evaluated, and the reflux correction
+/// computed by RungeKutta::Reflux keeps the sum of U constant.
+class AdvectionResidual : public CAction
+{
+public:
+  typedef boost::shared_ptr<AdvectionResidual> Ptr;
+  typedef boost::shared_ptr<AdvectionResidual const> ConstPtr;
+
+  AdvectionResidual(const std::string& name) :
+    CAction(name),
+    m_freeze(false),
+    m_max_active_level(0),
+    m_reflux_weight(0.)
+  {
+    m_options.add_option(OptionComponent<Field>::create("solution", &m_solution));
+    m_options.add_option(OptionComponent<Field>::create("residual", &m_residual));
+    m_options.add_option(OptionComponent<Field>::create("update_coeff", &m_update_coeff));
+    m_options.add_option(OptionComponent<Field>::create("multirate_level", &m_level));
+    m_options.add_option(OptionComponent<Field>::create("reflux_correction", &m_reflux));
+    m_options.add_option(OptionT<bool>::create("freeze_update_coeff", m_freeze))->link_to(&m_freeze);
+    m_options.add_option(OptionT<Uint>::create("max_active_level", m_max_active_level))->link_to(&m_max_active_level);
+    m_options.add_option(OptionT<Real>::create("reflux_weight", m_reflux_weight))->link_to(&m_reflux_weight);
+  }
+
+  static std::string type_name () { return "AdvectionResidual"; }
+
+  virtual void execute()
+  {
+    const Field& U = *m_solution.lock();
+    Field& R = *m_residual.lock();
+    Field& H = *m_update_coeff.lock();
+    const Field& L = *m_level.lock();
+    Field& C = *m_reflux.lock();
+    const Real dx = 0.1;
+    const Uint nb_cells = U.size();
+    Reflux reflux(L, C, m_max_active_level, m_reflux_weight);
+
+    for (Uint i=0; i<nb_cells; ++i)
+    {
+      if (!m_freeze)
+        H[i][0] = i < 2 ? 0.01 : 0.04;
+      if (reflux.is_active(i))
+        R[i][0] = 0.;
+    }
+
+    // upwind flux through the face between the cells left and right
+    RealVector left_update(1);
+    RealVector right_update(1);
+    for (Uint right=0; right<nb_cells; ++right)
+    {
+      const Uint left = (right+nb_cells-1) % nb_cells;
+      const Real flux = U[left][0] / dx;
+      left_update[0] = -flux;
+      right_update[0] = flux;
+      if (reflux.is_active(left))
+        R[left][0] += left_update[0];
+      if (reflux.is_active(right))
+        R[right][0] += right_update[0];
+      reflux.add_face(left, right, left_update, right_update);
+    }
+  }
+
+private:
+  boost::weak_ptr<Field> m_solution;
+  boost::weak_ptr<Field> m_residual;
+  boost::weak_ptr<Field> m_update_coeff;
+  boost::weak_ptr<Field> m_level;
+  boost::weak_ptr<Field> m_reflux;
+  bool m_freeze;
+  Uint m_max_active_level;
+  Real m_reflux_weight;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
 BOOST_AUTO_TEST_SUITE( RiemannSolvers_Suite )
 
 //////////////////////////////////////////////////////////////////////////////
@@ -63,6 +206,265 @@ BOOST_AUTO_TEST_CASE( test_RK )
 
 ////////////////////////////////////////////////////////////////////////////////
 
+BOOST_AUTO_TEST_CASE( test_RK_multirate )
+{
+  CMesh& mesh = Core::instance().root().create_component<CMesh>("multirate_mesh");
+  CSimpleMeshGenerator::create_line(mesh,1.,10);
+  allocate_component<Mesh::Actions::CreateSpaceP0>("create_space[0]")->transform(mesh);
+  FieldGroup& P0 = mesh.create_field_group("P0",FieldGroup::Basis::ELEMENT_BASED);
+  Field& solution     = P0.create_field("solution");
+  Field& residual     = P0.create_field("residual");
+  Field& update_coeff = P0.create_field("update_coeff");
+  for (Uint i=0; i<solution.size(); ++i)
+    solution[i][0] = 1.;
+
+  CTime& time = Core::instance().root().create_component<CTime>("multirate_time");
+
+  CAction& rk4 = Core::instance().root().create_component("multirate_RK4","CF.RungeKutta.RK").as_type<CAction>();
+  DecayResidual& decay = rk4.access_component("1_for_each_stage/1_pre_update_actions").create_component<DecayResidual>("decay");
+  decay.configure_option("solution",solution.uri());
+  decay.configure_option("residual",residual.uri());
+  decay.configure_option("update_coeff",update_coeff.uri());
+
+  rk4.configure_option("stages",4u);
+  rk4.configure_option("multirate_levels",3u);
+  rk4.configure_option_recursively("ctime",time.uri());
+  rk4.configure_option("solution",solution.uri());
+  rk4.configure_option("residual",residual.uri());
+  rk4.configure_option("update_coeff",update_coeff.uri());
+  rk4.execute();
+
+  // The coarsest level is 2, so the global step is 4 times the smallest local time step
+  BOOST_CHECK_CLOSE(time.current_time(), 0.04, 1e-8);
+  const Field& level = P0.get_child("multirate_level").as_type<Field>();
+  BOOST_CHECK_EQUAL(level[0][0], 0.);
+  BOOST_CHECK_EQUAL(level[5][0], 2.);
+
+  // Fine cells are sub-cycled 4 times, coarse cells take one step: both reach the same time
+  for (Uint i=0; i<solution.size(); ++i)
+    BOOST_CHECK_CLOSE(solution[i][0], std::exp(-0.04), 1e-6);
+
+  // Residuals are only evaluated in the active levels,
+  // after the evaluation in all cells that determines the levels
+  BOOST_CHECK_EQUAL(decay.nb_evaluations[0], 17u);
+  BOOST_CHECK_EQUAL(decay.nb_evaluations[5], 5u);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( test_RK_multirate_reflux )
+{
+  CMesh& mesh = Core::instance().root().create_component<CMesh>("reflux_mesh");
+  CSimpleMeshGenerator::create_line(mesh,1.,10);
+  allocate_component<Mesh::Actions::CreateSpaceP0>("create_space[0]")->transform(mesh);
+  FieldGroup& P0 = mesh.create_field_group("P0",FieldGroup::Basis::ELEMENT_BASED);
+  Field& solution     = P0.create_field("solution");
+  Field& residual     = P0.create_field("residual");
+  Field& update_coeff = P0.create_field("update_coeff");
+  Real total = 0.;
+  for (Uint i=0; i<solution.size(); ++i)
+  {
+    solution[i][0] = 1. + i;
+    total += solution[i][0];
+  }
+
+  // The end time comes before the end of the step of the coarsest level
+  CTime& time = Core::instance().root().create_component<CTime>("reflux_time");
+  time.configure_option("end_time",0.03);
+
+  CAction& rk3 = Core::instance().root().create_component("reflux_RK3","CF.RungeKutta.RK").as_type<CAction>();
+  AdvectionResidual& advection = rk3.access_component("1_for_each_stage/1_pre_update_actions").create_component<AdvectionResidual>("advection");
+  advection.configure_option("solution",solution.uri());
+  advection.configure_option("residual",residual.uri());
+  advection.configure_option("update_coeff",update_coeff.uri());
+
+  rk3.configure_option("stages",3u);
+  rk3.configure_option("multirate_levels",3u);
+  rk3.configure_option_recursively("ctime",time.uri());
+  rk3.configure_option("solution",solution.uri());
+  rk3.configure_option("residual",residual.uri());
+  rk3.configure_option("update_coeff",update_coeff.uri());
+  rk3.execute();
+
+  // The 4 sub-steps are shortened to end at the end time
+  BOOST_CHECK_CLOSE(time.current_time(), 0.03, 1e-8);
+  BOOST_CHECK_CLOSE(time.dt(), 0.03, 1e-8);
+
+  // The fluxes through the faces between fine and coarse cells cancel out
+  Real new_total = 0.;
+  for (Uint i=0; i<solution.size(); ++i)
+    new_total += solution[i][0];
+  BOOST_CHECK_CLOSE(new_total, total, 1e-10);
+
+  // Cells away from the periodic jump have only moved a little
+  BOOST_CHECK_LT(std::abs(solution[5][0] - 6.), 0.5);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( test_Reflux )
+{
+  CMesh& mesh = Core::instance().root().create_component<CMesh>("reflux_helper_mesh");
+  CSimpleMeshGenerator::create_line(mesh,1.,3);
+  allocate_component<Mesh::Actions::CreateSpaceP0>("create_space[0]")->transform(mesh);
+  FieldGroup& P0 = mesh.create_field_group("P0",FieldGroup::Basis::ELEMENT_BASED);
+  Field& level      = P0.create_field("multirate_level");
+  Field& correction = P0.create_field("reflux_correction","rho[s],rhoU[s]");
+  level[0][0] = 0.;
+  level[1][0] = 1.;
+  level[2][0] = 1.;
+
+  RealVector left_update(correction.row_size());
+  RealVector right_update(correction.row_size());
+  left_update.setConstant(-1.);
+  right_update.setConstant(2.);
+
+  // Only the fine cell is active: the coarse cell gets the contribution of the fine step
+  Reflux fine_substep(level, correction, 0, 0.5);
+  BOOST_CHECK(fine_substep.is_active(0));
+  BOOST_CHECK(!fine_substep.is_active(1));
+  fine_substep.add_face(0, 1, left_update, right_update);
+  fine_substep.add_face(1, 2, left_update, right_update);
+  BOOST_CHECK_EQUAL(correction[0][0], 0.);
+  BOOST_CHECK_EQUAL(correction[1][0], 1.);
+  BOOST_CHECK_EQUAL(correction[2][0], 0.);
+
+  // Both are active: the contribution of the coarse step is removed again
+  Reflux coarse_substep(level, correction, 1, 0.5);
+  coarse_substep.add_face(1, 0, left_update, right_update);
+  BOOST_CHECK_EQUAL(correction[1][0], 1.5);
+  BOOST_CHECK_EQUAL(correction[1][1], 1.5);
+
+  // Without a weight, nothing is corrected
+  Reflux first_evaluation(level, correction, 1, 0.);
+  first_evaluation.add_face(0, 1, left_update, right_update);
+  BOOST_CHECK_EQUAL(correction[1][0], 1.5);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( test_RK_single_precision_residual )
+{
+  CMesh& mesh = Core::instance().root().create_component<CMesh>("single_precision_mesh");
+  CSimpleMeshGenerator::create_line(mesh,1.,10);
+  allocate_component<Mesh::Actions::CreateSpaceP0>("create_space[0]")->transform(mesh);
+  FieldGroup& P0 = mesh.create_field_group("P0",FieldGroup::Basis::ELEMENT_BASED);
+  Field& solution        = P0.create_field("solution");
+  Field& single_solution = P0.create_field("single_solution");
+  Field& residual        = P0.create_field("residual");
+  Field& update_coeff    = P0.create_field("update_coeff");
+  SinglePrecisionField& single_residual = P0.create_field<SinglePrecisionField>("single_residual");
+  BOOST_CHECK_EQUAL(single_residual.size(), solution.size());
+  BOOST_CHECK_EQUAL(single_residual.row_size(), 1u);
+
+  for (Uint i=0; i<solution.size(); ++i)
+  {
+    solution[i][0] = 1. + 0.1*i;
+    single_solution[i][0] = solution[i][0];
+  }
+
+  CTime& time = Core::instance().root().create_component<CTime>("single_precision_time");
+
+  // Same problem, once with the residual in double precision and once in single precision
+  CAction& rk4 = Core::instance().root().create_component("double_RK4","CF.RungeKutta.RK").as_type<CAction>();
+  DecayResidual& decay = rk4.access_component("1_for_each_stage/1_pre_update_actions").create_component<DecayResidual>("decay");
+  decay.configure_option("solution",solution.uri());
+  decay.configure_option("residual",residual.uri());
+  decay.configure_option("update_coeff",update_coeff.uri());
+  rk4.configure_option("stages",4u);
+  rk4.configure_option_recursively("ctime",time.uri());
+  rk4.configure_option("solution",solution.uri());
+  rk4.configure_option("residual",residual.uri());
+  rk4.configure_option("update_coeff",update_coeff.uri());
+
+  CAction& single_rk4 = Core::instance().root().create_component("single_RK4","CF.RungeKutta.RK").as_type<CAction>();
+  DecayResidual& single_decay = single_rk4.access_component("1_for_each_stage/1_pre_update_actions").create_component<DecayResidual>("decay");
+  single_decay.configure_option("solution",single_solution.uri());
+  single_decay.configure_option("single_precision_residual",single_residual.uri());
+  single_decay.configure_option("update_coeff",update_coeff.uri());
+  single_rk4.configure_option("stages",4u);
+  single_rk4.configure_option_recursively("ctime",time.uri());
+  single_rk4.configure_option("solution",single_solution.uri());
+  single_rk4.configure_option("single_precision_residual",single_residual.uri());
+  single_rk4.configure_option("update_coeff",update_coeff.uri());
+
+  // The single precision run also goes through the column-major update,
+  // the solution backups are created by RK in the field group
+  single_solution.configure_option("column_major",true);
+  single_residual.set_layout(SinglePrecisionField::COLUMN_MAJOR);
+  P0.configure_option("column_major",true);
+
+  for (Uint step=0; step<10; ++step)
+  {
+    rk4.execute();
+    single_rk4.execute();
+  }
+  BOOST_CHECK_EQUAL(P0.get_child("solution_backup").as_type<Field>().layout(), Field::COLUMN_MAJOR);
+
+  // The residual is rounded to single precision, but the solution is accumulated in double precision,
+  // so the solutions agree to about the single precision round-off
+  for (Uint i=0; i<solution.size(); ++i)
+  {
+    const Real exact = (1. + 0.1*i) * std::exp(i < 2 ? -0.1 : -0.4);
+    BOOST_CHECK_CLOSE(solution[i][0], exact, 1e-4);
+    BOOST_CHECK_CLOSE(single_solution[i][0], solution[i][0], 1e-4);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( test_RK_threaded_update )
+{
+  CMesh& mesh = Core::instance().root().create_component<CMesh>("threaded_mesh");
+  CSimpleMeshGenerator::create_line(mesh,1.,10);
+  allocate_component<Mesh::Actions::CreateSpaceP0>("create_space[0]")->transform(mesh);
+  FieldGroup& P0 = mesh.create_field_group("P0",FieldGroup::Basis::ELEMENT_BASED);
+  Field& solution          = P0.create_field("solution");
+  Field& threaded_solution = P0.create_field("threaded_solution");
+  Field& residual          = P0.create_field("residual");
+  Field& threaded_residual = P0.create_field("threaded_residual");
+  Field& update_coeff      = P0.create_field("update_coeff");
+  for (Uint i=0; i<solution.size(); ++i)
+  {
+    solution[i][0] = 1. + 0.1*i;
+    threaded_solution[i][0] = solution[i][0];
+  }
+
+  CTime& time = Core::instance().root().create_component<CTime>("threaded_time");
+
+  // Same problem, once updated in the calling thread and once split over 3 threads
+  CAction& rk4 = Core::instance().root().create_component("serial_RK4","CF.RungeKutta.RK").as_type<CAction>();
+  DecayResidual& decay = rk4.access_component("1_for_each_stage/1_pre_update_actions").create_component<DecayResidual>("decay");
+  decay.configure_option("solution",solution.uri());
+  decay.configure_option("residual",residual.uri());
+  decay.configure_option("update_coeff",update_coeff.uri());
+  rk4.configure_option_recursively("ctime",time.uri());
+  rk4.configure_option("solution",solution.uri());
+  rk4.configure_option("residual",residual.uri());
+  rk4.configure_option("update_coeff",update_coeff.uri());
+
+  CAction& threaded_rk4 = Core::instance().root().create_component("threaded_RK4","CF.RungeKutta.RK").as_type<CAction>();
+  DecayResidual& threaded_decay = threaded_rk4.access_component("1_for_each_stage/1_pre_update_actions").create_component<DecayResidual>("decay");
+  threaded_decay.configure_option("solution",threaded_solution.uri());
+  threaded_decay.configure_option("residual",threaded_residual.uri());
+  threaded_decay.configure_option("update_coeff",update_coeff.uri());
+  threaded_rk4.configure_option_recursively("ctime",time.uri());
+  threaded_rk4.configure_option("solution",threaded_solution.uri());
+  threaded_rk4.configure_option("residual",threaded_residual.uri());
+  threaded_rk4.configure_option("update_coeff",update_coeff.uri());
+  threaded_rk4.access_component("1_for_each_stage/2_update").configure_option("nb_threads",3u);
+
+  for (Uint step=0; step<10; ++step)
+  {
+    rk4.execute();
+    threaded_rk4.execute();
+  }
+
+  // Each state is updated by exactly one thread, with the same operations
+  for (Uint i=0; i<solution.size(); ++i)
+    BOOST_CHECK_EQUAL(threaded_solution[i][0], solution[i][0]);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -4,6 +4,9 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <algorithm>
+#include <cmath>
+
 #include "Common/Log.hpp"
 #include "Common/CBuilder.hpp"
 #include "Common/FindComponents.hpp"
@@ -26,6 +29,66 @@ namespace SFDM {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+namespace {
+
+/// Sum-factorized reconstruction for the lines of "to" in one orientation.
+/// N is the number of points per line of "from", or Eigen::Dynamic if it is only known at run time.
+/// The first step applies the 1D operator along the lines of "from", the second step combines the
+/// lines of "from" into the lines of "to". Each step costs O(p^3) operations, where the dense
+/// reconstruction matrix needs O(p^4).
+template<int N>
+void sum_factorization(const RealMatrix& along,
+                       const RealMatrix& across,
+                       const std::vector<Uint>& from_points,
+                       const std::vector<Uint>& to_points,
+                       const RealMatrix& from_states,
+                       RealMatrix& work,
+                       RealMatrix& to_states)
+{
+  const Uint nb_from = N == Eigen::Dynamic ? along.cols() : N;
+  const Uint nb_to_per_line = along.rows();
+  const Uint nb_to_lines = across.rows();
+  const Uint nb_vars = from_states.cols();
+
+  work.resize(nb_to_per_line*nb_from, nb_vars);
+
+  // 1D operator along the lines: work(k*nb_from+j) = sum_i along(k,i) * from(i,j)
+  for (Uint k=0; k<nb_to_per_line; ++k)
+  {
+    for (Uint j=0; j<nb_from; ++j)
+    {
+      const Uint* from_line = &from_points[j*nb_from];
+      for (Uint var=0; var<nb_vars; ++var)
+      {
+        Real sum = 0.;
+        for (Uint i=0; i<nb_from; ++i)
+          sum += along(k,i) * from_states(from_line[i],var);
+        work(k*nb_from+j,var) = sum;
+      }
+    }
+  }
+
+  // 1D operator across the lines: to(k,l) = sum_j across(l,j) * work(k*nb_from+j)
+  for (Uint l=0; l<nb_to_lines; ++l)
+  {
+    for (Uint k=0; k<nb_to_per_line; ++k)
+    {
+      const Uint to_point = to_points[l*nb_to_per_line+k];
+      for (Uint var=0; var<nb_vars; ++var)
+      {
+        Real sum = 0.;
+        for (Uint j=0; j<nb_from; ++j)
+          sum += across(l,j) * work(k*nb_from+j,var);
+        to_states(to_point,var) = sum;
+      }
+    }
+  }
+}
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
 Common::ComponentBuilder < Reconstruct, Component, LibSFDM> Reconstruct_Builder;
 
 //////////////////////////////////////////////////////////////////////////////
@@ -46,6 +109,11 @@ Reconstruct::Reconstruct( const std::string& name )
       ->mark_basic()
       ->attach_trigger( boost::bind ( &Reconstruct::configure_from_to , this ) );
 
+  m_options.add_option( OptionT<bool>::create("sum_factorization", true) )
+      ->description("Reconstruct line by line with 1D operators if both shape functions are tensor-product quadrilaterals")
+      ->pretty_name("Sum Factorization")
+      ->attach_trigger( boost::bind ( &Reconstruct::configure_tensor_operators , this ) );
+
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -72,6 +140,91 @@ void Reconstruct::configure_from_to()
     for (Uint d=0; d<m_to->dimensionality(); ++d)
       m_gradient_reconstruction_matrix[d].row(to_node) = grad.row(d);
   }
+
+  configure_tensor_operators();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void Reconstruct::configure_tensor_operators()
+{
+  m_tensor_operators.clear();
+
+  if ( is_null(m_from) || is_null(m_to) || !option("sum_factorization").value<bool>() )
+    return;
+  if ( m_from->shape() != Mesh::GeoShape::QUAD || m_to->shape() != Mesh::GeoShape::QUAD )
+    return;
+
+  const ShapeFunction& from_line = m_from->line();
+  const Uint nb_from = m_from->nb_nodes_per_line();
+  const Uint nb_to_per_line = m_to->nb_nodes_per_line();
+  const Uint nb_to_lines = m_to->nb_lines_per_orientation();
+  if ( m_from->nb_lines_per_orientation() != nb_from || m_from->nb_nodes() != nb_from*nb_from )
+    return;
+
+  const RealMatrix& from_coords = m_from->local_coordinates();
+  const RealMatrix& to_coords = m_to->local_coordinates();
+  const Real tolerance = 1e-12;
+
+  std::vector<TensorOperator> tensor_operators(m_to->dimensionality());
+  std::vector<bool> to_point_covered(m_to->nb_nodes(),false);
+  for (Uint orientation=0; orientation<tensor_operators.size(); ++orientation)
+  {
+    const Uint transverse = 1-orientation;
+    TensorOperator& op = tensor_operators[orientation];
+
+    op.from_points.resize(nb_from*nb_from);
+    for (Uint j=0; j<nb_from; ++j)
+    {
+      for (Uint i=0; i<nb_from; ++i)
+      {
+        const Uint point = m_from->points()[orientation][j][i];
+        // points along the lines of "from" must be ordered as the points of its line shape function
+        if ( std::abs(from_coords(point,orientation) - from_line.local_coordinates()(i,KSI)) > tolerance )
+          return;
+        op.from_points[j*nb_from+i] = point;
+      }
+    }
+
+    op.to_points.resize(nb_to_lines*nb_to_per_line);
+    op.along.resize(nb_to_per_line,nb_from);
+    op.along_gradient.resize(nb_to_per_line,nb_from);
+    op.across.resize(nb_to_lines,nb_from);
+    op.across_gradient.resize(nb_to_lines,nb_from);
+    RealVector line_coord(1);
+    for (Uint l=0; l<nb_to_lines; ++l)
+    {
+      for (Uint k=0; k<nb_to_per_line; ++k)
+      {
+        const Uint point = m_to->points()[orientation][l][k];
+        op.to_points[l*nb_to_per_line+k] = point;
+        to_point_covered[point] = true;
+
+        // the points of "to" in this orientation have to form a tensor-product grid
+        const Uint first_in_line = m_to->points()[orientation][l][0];
+        const Uint first_in_column = m_to->points()[orientation][0][k];
+        if ( std::abs(to_coords(point,transverse) - to_coords(first_in_line,transverse)) > tolerance ||
+             std::abs(to_coords(point,orientation) - to_coords(first_in_column,orientation)) > tolerance )
+          return;
+      }
+
+      line_coord[KSI] = to_coords(op.to_points[l*nb_to_per_line],transverse);
+      op.across.row(l) = from_line.value(line_coord);
+      op.across_gradient.row(l) = from_line.gradient(line_coord).row(KSI);
+    }
+    for (Uint k=0; k<nb_to_per_line; ++k)
+    {
+      line_coord[KSI] = to_coords(op.to_points[k],orientation);
+      op.along.row(k) = from_line.value(line_coord);
+      op.along_gradient.row(k) = from_line.gradient(line_coord).row(KSI);
+    }
+  }
+
+  // every point of "to" has to lie on one of the lines
+  if ( std::find(to_point_covered.begin(),to_point_covered.end(),false) != to_point_covered.end() )
+    return;
+
+  m_tensor_operators.swap(tensor_operators);
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -79,6 +232,12 @@ void Reconstruct::configure_from_to()
 RealMatrix Reconstruct::value(const RealMatrix& from_states) const
 {
   cf_assert_desc("matrix dimensions don't match ["+to_str((Uint)from_states.rows())+"!="+to_str((Uint)m_value_reconstruction_matrix.cols())+"]  ",from_states.rows() == m_value_reconstruction_matrix.cols());
+  if (is_sum_factorized())
+  {
+    RealMatrix to_states(m_value_reconstruction_matrix.rows(),from_states.cols());
+    tensor_reconstruct(from_states,-1,to_states);
+    return to_states;
+  }
   return m_value_reconstruction_matrix * from_states;
 }
 
@@ -87,9 +246,47 @@ RealMatrix Reconstruct::value(const RealMatrix& from_states) const
 RealMatrix Reconstruct::gradient(const RealMatrix& from_states, const CoordRef orientation) const
 {
   cf_assert_desc("matrix dimensions don't match ["+to_str((Uint)from_states.rows())+"!="+to_str((Uint)m_gradient_reconstruction_matrix[orientation].cols())+"]  ",from_states.rows() == m_gradient_reconstruction_matrix[orientation].cols());
+  if (is_sum_factorized())
+  {
+    RealMatrix to_states(m_gradient_reconstruction_matrix[orientation].rows(),from_states.cols());
+    tensor_reconstruct(from_states,orientation,to_states);
+    return to_states;
+  }
   return m_gradient_reconstruction_matrix[orientation] * from_states;
 }
 
+/////////////////////////////////////////////////////////////////////////////
+
+void Reconstruct::tensor_reconstruct(const RealMatrix& from_states, const int derivative, RealMatrix& to_states) const
+{
+  for (Uint orientation=0; orientation<m_tensor_operators.size(); ++orientation)
+  {
+    const TensorOperator& op = m_tensor_operators[orientation];
+    const RealMatrix& along  = derivative == (int)orientation ? op.along_gradient : op.along;
+    const RealMatrix& across = derivative >= 0 && derivative != (int)orientation ? op.across_gradient : op.across;
+
+    // fixed-size kernels for the available solution orders P0 - P3
+    switch (m_from->nb_nodes_per_line())
+    {
+      case 1:
+        sum_factorization<1>(along,across,op.from_points,op.to_points,from_states,m_tensor_work,to_states);
+        break;
+      case 2:
+        sum_factorization<2>(along,across,op.from_points,op.to_points,from_states,m_tensor_work,to_states);
+        break;
+      case 3:
+        sum_factorization<3>(along,across,op.from_points,op.to_points,from_states,m_tensor_work,to_states);
+        break;
+      case 4:
+        sum_factorization<4>(along,across,op.from_points,op.to_points,from_states,m_tensor_work,to_states);
+        break;
+      default:
+        sum_factorization<Eigen::Dynamic>(along,across,op.from_points,op.to_points,from_states,m_tensor_work,to_states);
+        break;
+    }
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////
 
 } // SFDM
@@ -52,10 +52,43 @@ public: // functions
   /// @param orientation  Direction to which the derivative is taken (KSI / ETA / ZTA)
   RealMatrix gradient(const RealMatrix& from_states, const CoordRef orientation) const;
 
+  /// True if the reconstruction is applied line by line, as a product of 1D operators
+  bool is_sum_factorized() const { return !m_tensor_operators.empty(); }
+
 private:
 
   void configure_from_to();
 
+  /// Set up the 1D operators for the sum-factorized reconstruction,
+  /// if both shape functions are tensor-product quadrilaterals
+  void configure_tensor_operators();
+
+  /// Sum-factorized reconstruction
+  /// @param derivative  Direction of the derivative, or -1 for the value
+  void tensor_reconstruct(const RealMatrix& from_states, const int derivative, RealMatrix& to_states) const;
+
+  /// 1D operators for the lines of "to" in one orientation.
+  /// The points of "to" on these lines form a tensor-product grid, so the reconstruction is done
+  /// with a 1D operator along the lines, followed by a 1D operator across the lines.
+  struct TensorOperator
+  {
+    /// Line shape function of "from", in the coordinate along the lines of each point of a line of "to"
+    RealMatrix along;
+    RealMatrix along_gradient;
+    /// Line shape function of "from", in the coordinate across the lines of each line of "to"
+    RealMatrix across;
+    RealMatrix across_gradient;
+    /// Point of "from" with index i along and index j across the lines, stored at j*nb_nodes_per_line+i
+    std::vector<Uint> from_points;
+    /// Point of "to" with index k on line l, stored at l*nb_nodes_per_line+k
+    std::vector<Uint> to_points;
+  };
+
+  std::vector<TensorOperator> m_tensor_operators;
+
+  /// Intermediate result of the 1D operator along the lines
+  mutable RealMatrix m_tensor_work;
+
   RealMatrix m_value_reconstruction_matrix;
 
   std::vector<RealMatrix> m_gradient_reconstruction_matrix;
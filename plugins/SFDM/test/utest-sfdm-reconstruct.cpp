@@ -0,0 +1,167 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test module for sum-factorized reconstruction in CF::SFDM"
+
+#include <cmath>
+
+#include <boost/test/unit_test.hpp>
+
+#include "Common/Log.hpp"
+#include "Common/Core.hpp"
+#include "Common/CRoot.hpp"
+#include "Common/StringConversion.hpp"
+#include "Math/MatrixTypes.hpp"
+#include "SFDM/ShapeFunction.hpp"
+#include "SFDM/Reconstruct.hpp"
+
+#include "Tools/Testing/Benchmark.hpp"
+
+using namespace CF;
+using namespace CF::Common;
+using namespace CF::SFDM;
+using namespace CF::Tools::Testing;
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_GLOBAL_FIXTURE( BenchmarkOutput );
+
+struct ReconstructFixture
+{
+  /// Create a reconstruction from the quad solution points of order P to the quad flux points of order P+1
+  Reconstruct& create_reconstruct(const std::string& name, const Uint P, const bool sum_factorization)
+  {
+    Reconstruct& reconstruct = Core::instance().root().create_component(name,"CF.SFDM.Reconstruct").as_type<Reconstruct>();
+    reconstruct.configure_option("sum_factorization",sum_factorization);
+    std::vector<std::string> from_to(2);
+    from_to[0] = "CF.SFDM.SF.QuadSolutionP"+to_str(P);
+    from_to[1] = "CF.SFDM.SF.QuadFluxP"+to_str(P+1);
+    reconstruct.configure_option("from_to",from_to);
+    return reconstruct;
+  }
+
+  /// Reconstruct value and gradients nb_iterations times, returning a checksum
+  Real run(const Reconstruct& reconstruct, const Uint nb_solution_points, const Uint nb_iterations)
+  {
+    RealMatrix solution(nb_solution_points,nb_vars);
+    for (Uint i=0; i<nb_solution_points; ++i)
+      for (Uint var=0; var<nb_vars; ++var)
+        solution(i,var) = 1. + 0.1*i - 0.3*var;
+
+    Real checksum = 0.;
+    for (Uint iter=0; iter<nb_iterations; ++iter)
+    {
+      checksum += reconstruct.value(solution).sum();
+      checksum += reconstruct.gradient(solution,KSI).sum();
+      checksum += reconstruct.gradient(solution,ETA).sum();
+    }
+    return checksum;
+  }
+
+  void check_equal(const RealMatrix& a, const RealMatrix& b)
+  {
+    BOOST_REQUIRE_EQUAL(a.rows(), b.rows());
+    BOOST_REQUIRE_EQUAL(a.cols(), b.cols());
+    for (Uint i=0; i<a.rows(); ++i)
+      for (Uint j=0; j<a.cols(); ++j)
+        BOOST_CHECK_SMALL(a(i,j) - b(i,j), 1e-12);
+  }
+
+  static const Uint nb_vars = 4;
+};
+
+/// Times the reconstructions, the problem size is the number of reconstructed cells
+struct ReconstructBenchmarkFixture : ReconstructFixture, BenchmarkFixture
+{
+  void benchmark(const std::string& name, const Uint P, const bool sum_factorization)
+  {
+    const Reconstruct& reconstruct = create_reconstruct(name,P,sum_factorization);
+    const Uint nb_iterations = 100000*scale();
+    restart_timer();
+    CFinfo << "checksum: " << run(reconstruct,(P+1)*(P+1),nb_iterations) << CFendl;
+    set_problem_size(nb_iterations);
+  }
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE( SFDM_Reconstruct_Suite )
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_CASE( SumFactorizationMatchesDense, ReconstructFixture )
+{
+  for (Uint P=0; P<3; ++P)
+  {
+    Reconstruct& dense = create_reconstruct("dense_P"+to_str(P),P,false);
+    Reconstruct& tensor = create_reconstruct("tensor_P"+to_str(P),P,true);
+    BOOST_CHECK(!dense.is_sum_factorized());
+    BOOST_CHECK(tensor.is_sum_factorized());
+
+    const Uint nb_solution_points = (P+1)*(P+1);
+    RealMatrix solution(nb_solution_points,nb_vars);
+    for (Uint i=0; i<nb_solution_points; ++i)
+      for (Uint var=0; var<nb_vars; ++var)
+        solution(i,var) = std::sin(1.+i) * (var+1.);
+
+    check_equal(tensor.value(solution), dense.value(solution));
+    check_equal(tensor.gradient(solution,KSI), dense.gradient(solution,KSI));
+    check_equal(tensor.gradient(solution,ETA), dense.gradient(solution,ETA));
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_CASE( LinesAreNotSumFactorized, ReconstructFixture )
+{
+  Reconstruct& reconstruct = Core::instance().root().create_component("reconstruct_line","CF.SFDM.Reconstruct").as_type<Reconstruct>();
+  std::vector<std::string> from_to(2);
+  from_to[0] = "CF.SFDM.SF.LineSolutionP2";
+  from_to[1] = "CF.SFDM.SF.LineFluxP3";
+  reconstruct.configure_option("from_to",from_to);
+  BOOST_CHECK(!reconstruct.is_sum_factorized());
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+// Benchmark, from solution order P to flux order P+1
+
+BOOST_FIXTURE_TEST_CASE( DenseP0P1, ReconstructBenchmarkFixture )
+{
+  benchmark("bench_dense_P0",0,false);
+}
+
+BOOST_FIXTURE_TEST_CASE( SumFactorizedP0P1, ReconstructBenchmarkFixture )
+{
+  benchmark("bench_tensor_P0",0,true);
+}
+
+BOOST_FIXTURE_TEST_CASE( DenseP1P2, ReconstructBenchmarkFixture )
+{
+  benchmark("bench_dense_P1",1,false);
+}
+
+BOOST_FIXTURE_TEST_CASE( SumFactorizedP1P2, ReconstructBenchmarkFixture )
+{
+  benchmark("bench_tensor_P1",1,true);
+}
+
+BOOST_FIXTURE_TEST_CASE( DenseP2P3, ReconstructBenchmarkFixture )
+{
+  benchmark("bench_dense_P2",2,false);
+}
+
+BOOST_FIXTURE_TEST_CASE( SumFactorizedP2P3, ReconstructBenchmarkFixture )
+{
+  benchmark("bench_tensor_P2",2,true);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+//////////////////////////////////////////////////////////////////////////////
@@ -42,6 +42,7 @@ struct LinearSolverUnsteady::Implementation
   
   boost::weak_ptr<CTime> m_time;
   Real m_invdt;
+  ElementMatrixCache m_element_matrix_cache;
 };
 
 LinearSolverUnsteady::LinearSolverUnsteady(const std::string& name) :
@@ -63,6 +64,23 @@ Real& LinearSolverUnsteady::invdt()
   return m_implementation->m_invdt;
 }
 
+ElementMatrixCache& LinearSolverUnsteady::element_matrix_cache()
+{
+  return m_implementation->m_element_matrix_cache;
+}
+
+void LinearSolverUnsteady::mesh_loaded(CMesh& mesh)
+{
+  LinearSolver::mesh_loaded(mesh);
+  m_implementation->m_element_matrix_cache.reset();
+}
+
+void LinearSolverUnsteady::mesh_changed(CMesh& mesh)
+{
+  LinearSolver::mesh_changed(mesh);
+  m_implementation->m_element_matrix_cache.reset();
+}
+
 
 
 } // UFEM
@@ -7,6 +7,8 @@
 #ifndef CF_UFEM_LinearSolverUnsteady_hpp
 #define CF_UFEM_LinearSolverUnsteady_hpp
 
+#include "Solver/Actions/Proto/ElementMatrixCache.hpp"
+
 #include "LinearSolver.hpp"
 #include "LibUFEM.hpp"
 
@@ -40,6 +42,15 @@ public: // functions
   /// Reference to the inverse timestep, linked to the model time step
   Real& invdt();
   
+  /// Cache for the element matrix contributions that don't change in time, for use with
+  /// cached(solver.element_matrix_cache(), _A, _T) << (...) in the assembly expression.
+  /// The cache is reset when a mesh is loaded or changed.
+  Solver::Actions::Proto::ElementMatrixCache& element_matrix_cache();
+  
+  virtual void mesh_loaded(Mesh::CMesh& mesh);
+  
+  virtual void mesh_changed(Mesh::CMesh& mesh);
+  
 private:
   class Implementation;
   boost::scoped_ptr<Implementation> m_implementation;
@@ -45,13 +45,16 @@ Expression::Ptr stokes_artifdiss(LinearSolverUnsteady& solver, SUPGCoeffs& coefs
     group <<
     (
       _A = _0, _T = _0,
-      element_quadrature <<
+      cached(solver.element_matrix_cache(), _A, _T) << // All terms only depend on the geometry
       (
-        _A(p    , u[_i]) += transpose(N(p)) * nabla(u)[_i],
-        _A(p    , p)     += epsilon * transpose(nabla(p))*nabla(p),
-        _A(u[_i], u[_i]) += mu * transpose(nabla(u))*nabla(u),
-        _A(u[_i], p)     += 1./coefs.rho * transpose(N(u))*nabla(p)[_i],
-        _T(u[_i], u[_i]) += transpose(N(u))*N(u)
+        element_quadrature <<
+        (
+          _A(p    , u[_i]) += transpose(N(p)) * nabla(u)[_i],
+          _A(p    , p)     += epsilon * transpose(nabla(p))*nabla(p),
+          _A(u[_i], u[_i]) += mu * transpose(nabla(u))*nabla(u),
+          _A(u[_i], p)     += 1./coefs.rho * transpose(N(u))*nabla(p)[_i],
+          _T(u[_i], u[_i]) += transpose(N(u))*N(u)
+        )
       ),
       solver.system_matrix += solver.invdt() * _T + 0.5 * _A,
       solver.system_rhs -= _A * _b
@@ -75,14 +78,17 @@ Expression::Ptr stokes_pspg(LinearSolverUnsteady& solver, SUPGCoeffs& coefs)
     (
       _A = _0, _T = _0,
       compute_tau(u, coefs),
-      element_quadrature <<
+      cached(solver.element_matrix_cache(), _A, _T) << // tau_ps only depends on the geometry, so all terms can be cached
       (
-        _A(p    , u[_i]) +=          transpose(N(p))         * nabla(u)[_i], // Continuity, standard
-        _A(p    , p)     += coefs.tau_ps * transpose(nabla(p))     * nabla(p),     // Continuity, PSPG
-        _A(u[_i], u[_i]) += mu     * transpose(nabla(u))     * nabla(u),     // Diffusion
-        _A(u[_i], p)     += 1./coefs.rho * transpose(N(u))         * nabla(p)[_i], // Pressure gradient
-        _T(p    , u[_i]) += coefs.tau_ps * transpose(nabla(p)[_i]) * N(u),         // Time, PSPG
-        _T(u[_i], u[_i]) += transpose(N(u))         * N(u)          // Time, standard
+        element_quadrature <<
+        (
+          _A(p    , u[_i]) +=          transpose(N(p))         * nabla(u)[_i], // Continuity, standard
+          _A(p    , p)     += coefs.tau_ps * transpose(nabla(p))     * nabla(p),     // Continuity, PSPG
+          _A(u[_i], u[_i]) += mu     * transpose(nabla(u))     * nabla(u),     // Diffusion
+          _A(u[_i], p)     += 1./coefs.rho * transpose(N(u))         * nabla(p)[_i], // Pressure gradient
+          _T(p    , u[_i]) += coefs.tau_ps * transpose(nabla(p)[_i]) * N(u),         // Time, PSPG
+          _T(u[_i], u[_i]) += transpose(N(u))         * N(u)          // Time, standard
+        )
       ),
       solver.system_matrix += solver.invdt() * _T + 0.5 * _A,
       solver.system_rhs -= _A * _b
@@ -106,14 +112,22 @@ Expression::Ptr navier_stokes_pspg(LinearSolverUnsteady& solver, SUPGCoeffs& coe
     (
       _A = _0, _T = _0,
       compute_tau(u, coefs),
+      cached(solver.element_matrix_cache(), _A, _T) << // Terms that only depend on the geometry
+      (
+        element_quadrature <<
+        (
+          _A(p    , u[_i]) +=          transpose(N(p))         * nabla(u)[_i], // Standard continuity
+          _A(p    , p)     += coefs.tau_ps * transpose(nabla(p))     * nabla(p),     // Continuity, PSPG
+          _A(u[_i], u[_i]) += mu     * transpose(nabla(u))     * nabla(u),     // Diffusion
+          _A(u[_i], p)     += 1./coefs.rho * transpose(N(u))         * nabla(p)[_i], // Pressure gradient
+          _T(p    , u[_i]) += coefs.tau_ps * transpose(nabla(p)[_i]) * N(u),         // Time, PSPG
+          _T(u[_i], u[_i]) += transpose(N(u))         * N(u)          // Time, standard
+        )
+      ),
       element_quadrature <<
       (
-        _A(p    , u[_i]) +=          transpose(N(p))         * nabla(u)[_i] + coefs.tau_ps * transpose(nabla(p)[_i]) * u*nabla(u), // Standard continuity + PSPG for advection
-        _A(p    , p)     += coefs.tau_ps * transpose(nabla(p))     * nabla(p),     // Continuity, PSPG
-        _A(u[_i], u[_i]) += mu     * transpose(nabla(u))     * nabla(u)     + transpose(N(u)) * u*nabla(u),     // Diffusion + advection
-        _A(u[_i], p)     += 1./coefs.rho * transpose(N(u))         * nabla(p)[_i], // Pressure gradient
-        _T(p    , u[_i]) += coefs.tau_ps * transpose(nabla(p)[_i]) * N(u),         // Time, PSPG
-        _T(u[_i], u[_i]) += transpose(N(u))         * N(u)          // Time, standard
+        _A(p    , u[_i]) += coefs.tau_ps * transpose(nabla(p)[_i]) * u*nabla(u), // PSPG for advection
+        _A(u[_i], u[_i]) += transpose(N(u)) * u*nabla(u)     // Advection
       ),
       solver.system_matrix += solver.invdt() * _T + 1.0 * _A,
       solver.system_rhs -= _A * _b
@@ -137,14 +151,24 @@ Expression::Ptr navier_stokes_supg(LinearSolverUnsteady& solver, SUPGCoeffs& coe
     (
       _A = _0, _T = _0,
       compute_tau(u, coefs),
+      cached(solver.element_matrix_cache(), _A, _T) << // Terms that only depend on the geometry
+      (
+        element_quadrature <<
+        (
+          _A(p    , u[_i]) +=          transpose(N(p))         * nabla(u)[_i], // Standard continuity
+          _A(p    , p)     += coefs.tau_ps * transpose(nabla(p))     * nabla(p),     // Continuity, PSPG
+          _A(u[_i], u[_i]) += mu     * transpose(nabla(u))     * nabla(u),     // Diffusion
+          _A(u[_i], p)     += 1./coefs.rho * transpose(N(u))         * nabla(p)[_i], // Pressure gradient (standard)
+          _T(p    , u[_i]) += coefs.tau_ps * transpose(nabla(p)[_i]) * N(u),         // Time, PSPG
+          _T(u[_i], u[_i]) += transpose(N(u))         * N(u)          // Time, standard
+        )
+      ),
       element_quadrature <<
       (
-        _A(p    , u[_i]) +=          transpose(N(p))         * nabla(u)[_i] + coefs.tau_ps * transpose(nabla(p)[_i]) * u*nabla(u), // Standard continuity + PSPG for advection
-        _A(p    , p)     += coefs.tau_ps * transpose(nabla(p))     * nabla(p),     // Continuity, PSPG
-        _A(u[_i], u[_i]) += mu     * transpose(nabla(u))     * nabla(u)     + transpose(N(u) + coefs.tau_su*u*nabla(u)) * u*nabla(u),     // Diffusion + advection
-        _A(u[_i], p)     += 1./coefs.rho * transpose(N(u) + coefs.tau_su*u*nabla(u)) * nabla(p)[_i], // Pressure gradient (standard and SUPG)
-        _T(p    , u[_i]) += coefs.tau_ps * transpose(nabla(p)[_i]) * N(u),         // Time, PSPG
-        _T(u[_i], u[_i]) += transpose(N(u) + coefs.tau_su*u*nabla(u))         * N(u)          // Time, standard + SUPG
+        _A(p    , u[_i]) += coefs.tau_ps * transpose(nabla(p)[_i]) * u*nabla(u), // PSPG for advection
+        _A(u[_i], u[_i]) += transpose(N(u) + coefs.tau_su*u*nabla(u)) * u*nabla(u),     // Advection
+        _A(u[_i], p)     += 1./coefs.rho * transpose(coefs.tau_su*u*nabla(u)) * nabla(p)[_i], // Pressure gradient (SUPG)
+        _T(u[_i], u[_i]) += transpose(coefs.tau_su*u*nabla(u))         * N(u)          // Time, SUPG
       ),
       solver.system_matrix += solver.invdt() * _T + 1.0 * _A,
       solver.system_rhs -= _A * _b
@@ -168,15 +192,25 @@ Expression::Ptr navier_stokes_bulk(LinearSolverUnsteady& solver, SUPGCoeffs& coe
     (
       _A = _0, _T = _0,
       compute_tau(u, coefs),
+      cached(solver.element_matrix_cache(), _A, _T) << // Terms that only depend on the geometry
+      (
+        element_quadrature <<
+        (
+          _A(p    , u[_i]) +=          transpose(N(p))         * nabla(u)[_i], // Standard continuity
+          _A(p    , p)     += coefs.tau_ps * transpose(nabla(p))     * nabla(p),     // Continuity, PSPG
+          _A(u[_i], u[_i]) += mu     * transpose(nabla(u))     * nabla(u),     // Diffusion
+          _A(u[_i], p)     += 1./coefs.rho * transpose(N(u))         * nabla(p)[_i], // Pressure gradient (standard)
+          _A(u[_i], u[_j]) += coefs.tau_bulk * transpose(nabla(u)[_i]) * nabla(u)[_j], // Bulk viscosity
+          _T(p    , u[_i]) += coefs.tau_ps * transpose(nabla(p)[_i]) * N(u),         // Time, PSPG
+          _T(u[_i], u[_i]) += transpose(N(u))         * N(u)          // Time, standard
+        )
+      ),
       element_quadrature <<
       (
-        _A(p    , u[_i]) +=          transpose(N(p))         * nabla(u)[_i] + coefs.tau_ps * transpose(nabla(p)[_i]) * u*nabla(u), // Standard continuity + PSPG for advection
-        _A(p    , p)     += coefs.tau_ps * transpose(nabla(p))     * nabla(p),     // Continuity, PSPG
-        _A(u[_i], u[_i]) += mu     * transpose(nabla(u))     * nabla(u)     + transpose(N(u) + coefs.tau_su*u*nabla(u)) * u*nabla(u),     // Diffusion + advection
-        _A(u[_i], p)     += 1./coefs.rho * transpose(N(u) + coefs.tau_su*u*nabla(u)) * nabla(p)[_i], // Pressure gradient (standard and SUPG)
-        _A(u[_i], u[_j]) += coefs.tau_bulk * transpose(nabla(u)[_i]) * nabla(u)[_j], // Bulk viscosity
-        _T(p    , u[_i]) += coefs.tau_ps * transpose(nabla(p)[_i]) * N(u),         // Time, PSPG
-        _T(u[_i], u[_i]) += transpose(N(u) + coefs.tau_su*u*nabla(u))         * N(u)          // Time, standard
+        _A(p    , u[_i]) += coefs.tau_ps * transpose(nabla(p)[_i]) * u*nabla(u), // PSPG for advection
+        _A(u[_i], u[_i]) += transpose(N(u) + coefs.tau_su*u*nabla(u)) * u*nabla(u),     // Advection
+        _A(u[_i], p)     += 1./coefs.rho * transpose(coefs.tau_su*u*nabla(u)) * nabla(p)[_i], // Pressure gradient (SUPG)
+        _T(u[_i], u[_i]) += transpose(coefs.tau_su*u*nabla(u))         * N(u)          // Time, SUPG
       ),
       solver.system_matrix += solver.invdt() * _T + 1.0 * _A,
       solver.system_rhs -= _A * _b
@@ -124,6 +124,64 @@ BOOST_AUTO_TEST_CASE( Heat1DComponent )
   model.simulate();
 }
 
+BOOST_AUTO_TEST_CASE( Heat1DMatrixFree )
+{
+  Real length            = 5.;
+  const Uint nb_segments = 20;
+
+  CModel& model = root.create_component<CModel>("MatrixFreeModel");
+  CDomain& domain = model.create_domain("Domain");
+  UFEM::LinearSolver& solver = model.create_component<UFEM::LinearSolver>("Solver");
+
+  CEigenLSS& lss = model.create_component<CEigenLSS>("LSS");
+  lss.set_config_file(solver_config);
+  solver.solve_action().configure_option("lss", lss.uri());
+
+  MeshTerm<0, ScalarField> temperature("Temperature", "T");
+
+  boost::mpl::vector1<Mesh::SF::Line1DLagrangeP1> allowed_elements;
+
+  // The assembly is executed again for each matrix-vector product
+  CAction::Ptr assembly = create_proto_action
+  (
+    "Assembly",
+    elements_expression
+    (
+      allowed_elements,
+      group <<
+      (
+        _A = _0,
+        element_quadrature( _A(temperature) += transpose(nabla(temperature)) * nabla(temperature) ),
+        solver.system_matrix += _A
+      )
+    )
+  );
+
+  solver
+    << assembly
+    << solver.boundary_conditions()
+    << solver.solve_action()
+    << create_proto_action("Increment", nodes_expression(temperature += solver.solution(temperature)))
+    << create_proto_action("CheckResult", nodes_expression(_check_close(temperature, 10. + 25.*(coordinates(0,0) / length), 1e-6)));
+
+  lss.configure_option("matrix_free", true);
+  lss.configure_option("operator", assembly->uri());
+  lss.configure_option("tolerance", 1e-12);
+
+  model.create_physics("CF.Physics.DynamicModel");
+
+  CMesh& mesh = domain.create_component<CMesh>("Mesh");
+  Tools::MeshGeneration::create_line(mesh, length, nb_segments);
+
+  solver.boundary_conditions().add_constant_bc("xneg", "Temperature", 10.);
+  solver.boundary_conditions().add_constant_bc("xpos", "Temperature", 35.);
+
+  model.simulate();
+
+  // Only the diagonal was stored
+  BOOST_CHECK_EQUAL(lss.diagonal().size(), lss.size());
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -15,6 +15,9 @@
 
 #include "Mesh/CDomain.hpp"
 
+#include "Physics/PhysModel.hpp"
+#include "Physics/VariableManager.hpp"
+
 #include "Solver/CModelUnsteady.hpp"
 #include "Solver/CTime.hpp"
 #include "Solver/Tags.hpp"
@@ -95,10 +98,15 @@ BOOST_AUTO_TEST_CASE( ProtoNavierStokes )
   typedef Expression::Ptr (*FactoryT)(LinearSolverUnsteady&, SUPGCoeffs&);
   std::vector<FactoryT> factories = boost::assign::list_of(&stokes_artifdiss)(&stokes_pspg)(&navier_stokes_pspg)(&navier_stokes_supg)(&navier_stokes_bulk);
 
-  // Loop over all model types
-  for(Uint i = 0; i != names.size(); ++i)
+  // Solve the monolithic system with the configured external solver, and with the built-in GMRES and the SIMPLE block preconditioner
+  const std::vector<std::string> preconditioners = boost::assign::list_of("Jacobi")("SIMPLE");
+
+  // Loop over all model types and preconditioners
+  for(Uint i = 0; i != names.size() * preconditioners.size(); ++i)
   {
-    std::cout << "Running test for model " << names[i] << std::endl;
+    const std::string& name = names[i % names.size()];
+    const std::string& preconditioner = preconditioners[i / names.size()];
+    std::cout << "Running test for model " << name << " with preconditioner " << preconditioner << std::endl;
     // Setup a model
     CModelUnsteady& model = Core::instance().root().create_component<CModelUnsteady>("Model");
     CDomain& domain = model.create_domain("Domain");
@@ -126,7 +134,7 @@ BOOST_AUTO_TEST_CASE( ProtoNavierStokes )
       ( // Time loop
         solver.create_component<TimeLoop>("TimeLoop")
         << solver.zero_action()
-        << create_proto_action("Assembly", factories[i](solver, coefs))
+        << create_proto_action("Assembly", factories[i % names.size()](solver, coefs))
         << solver.boundary_conditions()
         << solver.solve_action()
         << create_proto_action("IncrementU", nodes_expression(u += solver.solution(u)))
@@ -140,6 +148,14 @@ BOOST_AUTO_TEST_CASE( ProtoNavierStokes )
     model.create_physics("CF.Physics.DynamicModel");
     solver.mesh_loaded(mesh);
 
+    // The SIMPLE block preconditioner needs the layout of the coupled velocity-pressure unknowns
+    lss.configure_option("preconditioner", preconditioner);
+    if(preconditioner == "SIMPLE")
+    {
+      lss.configure_option("block_size", model.physics().variable_manager().nb_dof());
+      lss.configure_option("pressure_index", model.physics().variable_manager().offset("Pressure"));
+    }
+
     solver.boundary_conditions().add_constant_bc("left", "Pressure", p0);
     solver.boundary_conditions().add_constant_bc("right", "Pressure", p1);
     solver.boundary_conditions().add_constant_bc("bottom", "Velocity", u_wall);
@@ -208,4 +208,93 @@ BOOST_AUTO_TEST_CASE( Heat1DUnsteady )
   );
 };
 
+/// Same problem, but with the time-invariant element matrices cached
+BOOST_AUTO_TEST_CASE( Heat1DUnsteadyCached )
+{
+  t = start_time;
+
+  // Setup a model
+  CModelUnsteady& model = Core::instance().root().create_component<CModelUnsteady>("CachedModel");
+  CDomain& domain = model.create_domain("Domain");
+  UFEM::LinearSolverUnsteady& solver = model.create_component<UFEM::LinearSolverUnsteady>("Solver");
+  model.create_physics("CF.Physics.DynamicModel");
+
+  // Setup mesh
+  CMesh& mesh = domain.create_component<CMesh>("Mesh");
+  Tools::MeshGeneration::create_line(mesh, length, nb_segments);
+
+  CEigenLSS& lss = model.create_component<CEigenLSS>("LSS");
+  lss.set_config_file(boost::unit_test::framework::master_test_suite().argv[1]);
+  solver.solve_action().configure_option("lss", lss.uri());
+
+  // Proto placeholders
+  MeshTerm<0, ScalarField> temperature("Temperature", "T");
+  MeshTerm<1, ScalarField> temperature_analytical("TemperatureAnalytical", "T");
+
+  boost::mpl::vector1<Mesh::SF::Line1DLagrangeP1> allowed_elements;
+
+  solver
+    << create_proto_action("Initialize", nodes_expression(temperature = initial_temp))
+    << create_proto_action("InitializeAnalytical", nodes_expression(temperature_analytical = initial_temp))
+    <<
+    (
+      solver.create_component<UFEM::TimeLoop>("TimeLoop")
+      << solver.zero_action()
+      << create_proto_action
+      (
+        "Assembly",
+        elements_expression
+        (
+          allowed_elements,
+          group <<
+          (
+            _A = _0, _T = _0,
+            cached(solver.element_matrix_cache(), _A, _T) << // invdt is kept outside, so the time step may change
+            (
+              element_quadrature <<
+              (
+                _A(temperature) += alpha * transpose(nabla(temperature))*nabla(temperature),
+                _T(temperature) += transpose(N(temperature))*N(temperature)
+              )
+            ),
+            solver.system_matrix += solver.invdt() * _T + 0.5 * _A,
+            solver.system_rhs -= _A * nodal_values(temperature)
+          )
+        )
+      )
+      << solver.boundary_conditions()
+      << solver.solve_action()
+      << create_proto_action("Increment", nodes_expression(temperature += solver.solution(temperature)))
+    );
+
+  model.create_physics("CF.Physics.DynamicModel");
+  solver.mesh_loaded(mesh);
+
+  solver.boundary_conditions().add_constant_bc("xneg", "Temperature", ambient_temp);
+  solver.boundary_conditions().add_constant_bc("xpos", "Temperature", ambient_temp);
+
+  CTime& time = model.create_time();
+  time.configure_option("time_step", dt);
+  time.configure_option("end_time", end_time);
+
+  BOOST_CHECK_EQUAL(solver.element_matrix_cache().nb_stored(), 0u);
+
+  model.simulate();
+
+  // Each element is stored exactly once
+  BOOST_CHECK_EQUAL(solver.element_matrix_cache().nb_stored(), nb_segments);
+
+  t = model.time().current_time();
+  set_analytical_solution(mesh.topology(), "TemperatureAnalytical", "T");
+  for_each_node
+  (
+    mesh.topology(),
+    _check_close(temperature_analytical, temperature, 1.)
+  );
+
+  // Reloading the mesh invalidates the cache
+  solver.mesh_loaded(mesh);
+  BOOST_CHECK_EQUAL(solver.element_matrix_cache().nb_stored(), 0u);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,114 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Benchmark of the proto assembly and the linear solve in UFEM"
+
+#include <boost/test/unit_test.hpp>
+
+#include "Common/Core.hpp"
+#include "Common/CRoot.hpp"
+#include "Common/CTimings.hpp"
+
+#include "Mesh/CDomain.hpp"
+#include "Mesh/Geometry.hpp"
+
+#include "Solver/CModel.hpp"
+
+#include "Solver/Actions/Proto/CProtoAction.hpp"
+#include "Solver/Actions/Proto/Expression.hpp"
+
+#include "Tools/MeshGeneration/MeshGeneration.hpp"
+#include "Tools/Testing/Benchmark.hpp"
+
+#include "UFEM/LinearSolver.hpp"
+
+using namespace CF;
+using namespace CF::Solver;
+using namespace CF::Solver::Actions;
+using namespace CF::Solver::Actions::Proto;
+using namespace CF::Common;
+using namespace CF::Mesh;
+using namespace CF::Tools::Testing;
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_GLOBAL_FIXTURE( BenchmarkOutput );
+
+BOOST_AUTO_TEST_SUITE( UFEMBenchmarkSuite )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Heat2D )
+{
+  CRoot& root = Core::instance().root();
+  BenchmarkResults& results = BenchmarkResults::instance();
+
+  // The per-action times are collected by the timings component
+  CTimings& timings = Core::instance().timings();
+  timings.configure_option("enabled", true);
+
+  const Uint nb_segments = 100 * results.scale();
+
+  // Setup a model
+  CModel& model = root.create_component<CModel>("Model");
+  CDomain& domain = model.create_domain("Domain");
+  UFEM::LinearSolver& solver = model.create_component<UFEM::LinearSolver>("Solver");
+
+  CEigenLSS& lss = model.create_component<CEigenLSS>("LSS");
+  lss.set_config_file(boost::unit_test::framework::master_test_suite().argv[1]);
+  solver.solve_action().configure_option("lss", lss.uri());
+
+  MeshTerm<0, ScalarField> temperature("Temperature", "T");
+
+  boost::mpl::vector1<Mesh::SF::Quad2DLagrangeP1> allowed_elements;
+
+  CProtoAction::Ptr assembly = create_proto_action
+  (
+    "Assembly",
+    elements_expression
+    (
+      allowed_elements,
+      group <<
+      (
+        _A = _0,
+        element_quadrature( _A(temperature) += transpose(nabla(temperature)) * nabla(temperature) ),
+        solver.system_matrix += _A
+      )
+    )
+  );
+
+  solver
+    << assembly
+    << solver.boundary_conditions()
+    << solver.solve_action()
+    << create_proto_action("Increment", nodes_expression(temperature += solver.solution(temperature)));
+
+  model.create_physics("CF.Physics.DynamicModel");
+
+  CMesh& mesh = domain.create_component<CMesh>("Mesh");
+  Tools::MeshGeneration::create_rectangle(mesh, 1., 1., nb_segments, nb_segments);
+
+  solver.boundary_conditions().add_constant_bc("left", "Temperature", 10.);
+  solver.boundary_conditions().add_constant_bc("right", "Temperature", 35.);
+
+  model.simulate();
+
+  const Uint nb_nodes = mesh.geometry().size();
+  results.add("Assembly", timings.data(*assembly).time, nb_nodes);
+  results.add("BoundaryConditions", timings.data(solver.boundary_conditions()).time, nb_nodes);
+  results.add("Solve", timings.data(solver.solve_action()).time, nb_nodes);
+  results.add("LSSMatrixFill", lss.time_matrix_fill, nb_nodes);
+  results.add("LSSSolve", lss.time_solve, nb_nodes);
+
+  timings.configure_option("enabled", false);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -7,6 +7,7 @@
 #include "Common/Signal.hpp"
 
 #include "Common/CAction.hpp"
+#include "Common/CTimings.hpp"
 #include "Common/FindComponents.hpp"
 
 #include "Common/LibCommon.hpp"
@@ -38,6 +39,7 @@ CAction& CAction::create_action(const std::string& action_provider,
 
 void CAction::signal_execute ( Common::SignalArgs& node )
 {
+  ScopedTimer timer(*this);
   this->execute();
 }
 
@@ -12,6 +12,7 @@
 #include "Common/OptionT.hpp"
 #include "Common/OptionURI.hpp"
 #include "Common/OptionComponent.hpp"
+#include "Common/CTimings.hpp"
 
 #include "CActionDirector.hpp"
 
@@ -51,6 +52,7 @@ void CActionDirector::execute()
     if(is_null(action))
       throw SetupError(FromHere(), "Component with name " + action_name + " is not an action in " + uri().string());
 
+    ScopedTimer timer(*action);
     action->execute();
   }
 }
@@ -95,6 +95,12 @@ CEnv::CEnv ( const std::string& name) : Component ( name )
       ->description("The log level for exceptions")
       ->mark_basic();
 
+  m_options.add_option< OptionT<bool> >("async_log", false)
+      ->pretty_name("Asynchronous Log")
+      ->description("If true, log messages to screen and file are written by a background thread.")
+      ->mark_basic()
+      ->attach_trigger(boost::bind(&CEnv::trigger_async_log,this));
+
   m_options.add_option< OptionT<Uint> >("log_level", 3)
       ->pretty_name("Log Level")
       ->description("The log level [SILENT=0, ERROR=1, WARNING=2, INFO=3, DEBUG=4, TRACE=5, VERBOSE=10")
@@ -124,8 +130,8 @@ void CEnv::trigger_only_cpu0_writes()
 
   CFerror.setFilterRankZero( opt );
   CFwarn.setFilterRankZero( opt );
-  CFinfo.setFilterRankZero( opt );
-  CFdebug.setFilterRankZero( opt );
+  CFinfoStream.setFilterRankZero( opt );
+  CFdebugStream.setFilterRankZero( opt );
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -179,5 +185,12 @@ void CEnv::trigger_log_level()
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void CEnv::trigger_async_log()
+{
+  Logger::instance().set_async(option("async_log").value<bool>());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 } // Common
 } // CF
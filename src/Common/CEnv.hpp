@@ -55,6 +55,8 @@ private: // functions
 
   void trigger_log_level();
 
+  void trigger_async_log();
+
 }; // CEnv
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,271 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <algorithm>
+#include <iomanip>
+#include <set>
+#include <sstream>
+
+#include "Common/Signal.hpp"
+#include "Common/OptionT.hpp"
+#include "Common/CBuilder.hpp"
+#include "Common/Core.hpp"
+#include "Common/Foreach.hpp"
+#include "Common/LibCommon.hpp"
+#include "Common/Log.hpp"
+#include "Common/CTimings.hpp"
+
+#include "Common/MPI/PE.hpp"
+
+namespace CF {
+namespace Common {
+
+////////////////////////////////////////////////////////////////////////////////
+
+Common::ComponentBuilder < CTimings, Component, LibCommon > CTimings_Builder;
+
+////////////////////////////////////////////////////////////////////////////////
+
+CTimings::CTimings ( const std::string& name) :
+  Component ( name ),
+  m_enabled(false)
+{
+  // properties
+  m_properties["brief"] = std::string("Timings");
+  m_properties["description"] = std::string("Collects timings of actions, loops and communication");
+
+  // options
+  m_options.add_option< OptionT<bool> >("enabled", m_enabled)
+      ->pretty_name("Enabled")
+      ->description("If true, the execution time of actions, loops and communication is recorded")
+      ->mark_basic()
+      ->attach_trigger(boost::bind(&CTimings::trigger_enabled,this));
+
+  m_options.add_option< OptionT<bool> >("report_at_exit", false)
+      ->pretty_name("Report At Exit")
+      ->description("If true, the report is printed when the runtime environment is terminated")
+      ->mark_basic();
+
+  // signals
+  regist_signal( "print_report" )
+      ->connect( boost::bind( &CTimings::signal_print_report, this, _1 ) )
+      ->description("Print the timings report to the log. This is a collective operation when running in parallel.")
+      ->pretty_name("Print Report");
+
+  regist_signal( "reset" )
+      ->connect( boost::bind( &CTimings::signal_reset, this, _1 ) )
+      ->description("Clear all recorded timings")
+      ->pretty_name("Reset");
+
+  signal("create_component")->hidden(true);
+  signal("rename_component")->hidden(true);
+  signal("delete_component")->hidden(true);
+  signal("move_component")->hidden(true);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+CTimings::~CTimings()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+TimingData& CTimings::data ( const Component& component, const std::string& label )
+{
+  if(label.empty())
+    return m_timings[component.uri().path()];
+
+  return m_timings[component.uri().path() + ":" + label];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void CTimings::reset()
+{
+  // Entries are zeroed rather than erased, since running timers may still refer to them
+  boost_foreach(TimingsT::value_type& entry, m_timings)
+  {
+    const bool running = entry.second.running;
+    entry.second = TimingData();
+    entry.second.running = running;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::string CTimings::report()
+{
+  Comm::PE& pe = Comm::PE::instance();
+  const bool is_parallel = pe.is_active() && pe.size() > 1;
+  const Uint nb_procs = is_parallel ? pe.size() : 1;
+
+  // Union of the paths over all ranks
+  std::vector<std::string> paths;
+  if(is_parallel)
+  {
+    std::vector<char> local_chars;
+    boost_foreach(const TimingsT::value_type& entry, m_timings)
+    {
+      local_chars.insert(local_chars.end(), entry.first.begin(), entry.first.end());
+      local_chars.push_back('\0');
+    }
+    if(local_chars.empty())
+      local_chars.push_back('\0');
+
+    std::vector<char> all_chars;
+    std::vector<int> recv_counts(nb_procs, -1);
+    pe.all_gather(local_chars, local_chars.size(), all_chars, recv_counts);
+
+    std::set<std::string> unique_paths;
+    const std::vector<char>::const_iterator chars_end = all_chars.end();
+    std::vector<char>::const_iterator begin = all_chars.begin();
+    while(begin != chars_end)
+    {
+      const std::vector<char>::const_iterator end = std::find(begin, chars_end, '\0');
+      if(end != begin)
+        unique_paths.insert(std::string(begin, end));
+      begin = end == chars_end ? end : end+1;
+    }
+    paths.assign(unique_paths.begin(), unique_paths.end());
+  }
+  else
+  {
+    boost_foreach(const TimingsT::value_type& entry, m_timings)
+      paths.push_back(entry.first);
+  }
+
+  const Uint nb_paths = paths.size();
+
+  // Local values, in the order of the paths
+  std::vector<Uint> local_calls(nb_paths, 0);
+  std::vector<Uint> local_bytes(nb_paths, 0);
+  std::vector<Real> local_times(nb_paths, 0.);
+  for(Uint i = 0; i != nb_paths; ++i)
+  {
+    TimingsT::const_iterator found = m_timings.find(paths[i]);
+    if(found == m_timings.end())
+      continue;
+    local_calls[i] = found->second.calls;
+    local_bytes[i] = found->second.bytes;
+    local_times[i] = found->second.time;
+  }
+
+  // Values of all ranks, stored rank by rank
+  std::vector<Uint> all_calls, all_bytes;
+  std::vector<Real> all_times;
+  if(is_parallel && nb_paths)
+  {
+    pe.all_gather(local_calls, all_calls);
+    pe.all_gather(local_bytes, all_bytes);
+    pe.all_gather(local_times, all_times);
+  }
+  else
+  {
+    all_calls = local_calls;
+    all_bytes = local_bytes;
+    all_times = local_times;
+  }
+
+  std::stringstream result;
+  result << "Timings on " << nb_procs << (nb_procs == 1 ? " process" : " processes") << ", times in seconds\n";
+  result << std::setw(60) << std::left << "path" << std::right
+         << std::setw(12) << "calls"
+         << std::setw(12) << "avg"
+         << std::setw(12) << "min"
+         << std::setw(12) << "max"
+         << std::setw(14) << "bytes" << "\n";
+
+  for(Uint i = 0; i != nb_paths; ++i)
+  {
+    Uint calls = 0;
+    Uint bytes = 0;
+    Real time_sum = 0.;
+    Real time_min = all_times[i];
+    Real time_max = all_times[i];
+    for(Uint rank = 0; rank != nb_procs; ++rank)
+    {
+      const Uint idx = rank*nb_paths + i;
+      calls += all_calls[idx];
+      bytes += all_bytes[idx];
+      time_sum += all_times[idx];
+      time_min = std::min(time_min, all_times[idx]);
+      time_max = std::max(time_max, all_times[idx]);
+    }
+
+    // Indent according to the depth in the component tree
+    const std::string& path = paths[i];
+    const Uint depth = std::count(path.begin(), path.end(), '/');
+    const std::size_t last_separator = path.find_last_of('/');
+    const std::string name = last_separator == std::string::npos ? path : path.substr(last_separator+1);
+    const std::string indented_name = std::string(2*(depth > 2 ? depth - 2 : 0), ' ') + name;
+
+    result << std::setw(60) << std::left << indented_name << std::right
+           << std::setw(12) << calls
+           << std::setw(12) << std::setprecision(4) << time_sum / static_cast<Real>(nb_procs)
+           << std::setw(12) << std::setprecision(4) << time_min
+           << std::setw(12) << std::setprecision(4) << time_max
+           << std::setw(14) << bytes << "\n";
+  }
+
+  return result.str();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void CTimings::signal_print_report ( SignalArgs& args )
+{
+  CFinfo << report() << CFendl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void CTimings::signal_reset ( SignalArgs& args )
+{
+  reset();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void CTimings::trigger_enabled()
+{
+  m_enabled = option("enabled").value<bool>();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+ScopedTimer::ScopedTimer ( const Component& component, const char* label ) :
+  m_data(0)
+{
+  CTimings& timings = Core::instance().timings();
+  if(!timings.is_enabled())
+    return;
+
+  TimingData& data = timings.data(component, is_null(label) ? std::string() : std::string(label));
+  if(data.running)
+    return;
+
+  m_data = &data;
+  m_data->running = true;
+  ++m_data->calls;
+  m_timer.reset(new Timer());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+ScopedTimer::~ScopedTimer()
+{
+  if(m_data)
+  {
+    m_data->time += m_timer->elapsed();
+    m_data->running = false;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // Common
+} // CF
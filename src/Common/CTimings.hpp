@@ -0,0 +1,152 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef CF_Common_CTimings_hpp
+#define CF_Common_CTimings_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <map>
+
+#include <boost/scoped_ptr.hpp>
+
+#include "Common/Component.hpp"
+#include "Common/Timer.hpp"
+
+namespace CF {
+namespace Common {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Statistics collected for a single timed component
+struct Common_API TimingData
+{
+  TimingData() : calls(0), time(0.), bytes(0), running(false) {}
+
+  /// Number of times the timed scope was entered
+  Uint calls;
+  /// Total wall time spent in the timed scope, in seconds
+  Real time;
+  /// Number of bytes communicated from within the timed scope
+  Uint bytes;
+  /// True while a ScopedTimer is recording into this data
+  bool running;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Collects the timings of the instrumented parts of the code (actions, loops and communication).
+/// Data is stored per component path, so the report follows the component tree. Timing is off by default,
+/// and when it is off a ScopedTimer costs only a check of a boolean.
+/// The component lives at //Root/Timings and can be accessed through Core::instance().timings()
+class Common_API CTimings : public Component {
+
+public: //typedefs
+
+  typedef boost::shared_ptr<CTimings> Ptr;
+  typedef boost::shared_ptr<CTimings const> ConstPtr;
+
+  /// Timing data, sorted by path
+  typedef std::map<std::string, TimingData> TimingsT;
+
+public: // functions
+
+  /// Contructor
+  /// @param name of the component
+  CTimings ( const std::string& name );
+
+  /// Virtual destructor
+  virtual ~CTimings();
+
+  /// Get the class name
+  static std::string type_name () { return "CTimings"; }
+
+  /// True if timings are collected
+  bool is_enabled() const { return m_enabled; }
+
+  /// Access to the statistics for the given component. An optional label distinguishes
+  /// several timed scopes within the same component.
+  TimingData& data(const Component& component, const std::string& label = std::string());
+
+  /// Access to the statistics for an arbitrary path
+  TimingData& data(const std::string& path) { return m_timings[path]; }
+
+  /// Read-only access to all collected data on this rank
+  const TimingsT& timings() const { return m_timings; }
+
+  /// Clear all collected data
+  void reset();
+
+  /// Build the report, sorted by component path and indented according to the depth in the tree.
+  /// When running in parallel, this is a collective operation and the time is given as min, max and average
+  /// over all ranks, while calls and bytes are summed. The same complete report is returned on every rank.
+  std::string report();
+
+  /// @name SIGNALS
+  //@{
+
+  /// Print the report to the log
+  void signal_print_report( SignalArgs& args );
+
+  /// Clear all collected data
+  void signal_reset( SignalArgs& args );
+
+  //@} END SIGNALS
+
+private: // functions
+
+  void trigger_enabled();
+
+private: // data
+
+  /// Cached value of the "enabled" option
+  bool m_enabled;
+
+  /// Collected data
+  TimingsT m_timings;
+
+}; // CTimings
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Times the scope in which it is created, adding the result to the statistics of the given component.
+/// Does nothing if timings are disabled, or if another timer for the same component and label is already running,
+/// so the same action can be timed both by its caller (e.g. CActionDirector) and by its own execute() without
+/// being counted twice.
+class Common_API ScopedTimer
+{
+public:
+  /// Start timing for the given component, with an optional label to distinguish between several timers for the same component
+  ScopedTimer(const Component& component, const char* label = 0);
+
+  /// Stops the timer and stores the result
+  ~ScopedTimer();
+
+  /// True if this timer records anything
+  bool is_active() const { return is_not_null(m_data); }
+
+  /// Count the given number of bytes as communicated in this scope
+  void add_bytes(const Uint nb_bytes)
+  {
+    if(m_data)
+      m_data->bytes += nb_bytes;
+  }
+
+private:
+  /// Data that gets updated, null if timing is disabled
+  TimingData* m_data;
+  /// Only created when timing is enabled
+  boost::scoped_ptr<Timer> m_timer;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // Common
+} // CF
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // CF_Common_CTimings_hpp
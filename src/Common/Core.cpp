@@ -21,6 +21,7 @@
 #include "Common/CFactories.hpp"
 #include "Common/CRoot.hpp"
 #include "Common/CEnv.hpp"
+#include "Common/CTimings.hpp"
 
 #include "Common/BuildInfo.hpp"
 #include "Common/CodeProfiler.hpp"
@@ -67,12 +68,14 @@ Core::Core()
   m_environment   = allocate_component<CEnv>( "Environment" );
   m_libraries     = allocate_component<CLibraries>( "Libraries" );
   m_factories     = allocate_component<CFactories>( "Factories" );
+  m_timings       = allocate_component<CTimings>( "Timings" );
 
   // this types must be registered immedietly on creation,
   // registration could be defered to after the Core has been inialized.
   RegistTypeInfo<CEnv,LibCommon>();
   RegistTypeInfo<CLibraries,LibCommon>();
   RegistTypeInfo<CFactories,LibCommon>();
+  RegistTypeInfo<CTimings,LibCommon>();
 
   // create the root component and its structure structure
   m_root = CRoot::create("Root");
@@ -84,6 +87,7 @@ Core::Core()
   m_root->add_component( m_environment ).mark_basic();
   m_root->add_component( m_libraries ).mark_basic();
   m_root->add_component( m_factories ).mark_basic();
+  m_root->add_component( m_timings ).mark_basic();
 
   CGroup::Ptr tools = m_root->create_component_ptr<CGroup>("Tools");
   tools->mark_basic();
@@ -130,6 +134,13 @@ void Core::initiate ( int argc, char** argv )
 
 void Core::terminate()
 {
+  // print the timings before the libraries go away
+  if( m_timings->option("report_at_exit").value<bool>() )
+  {
+    const std::string report = m_timings->report();
+    CFinfo << report << CFendl;
+  }
+
   // terminate all
 
   m_libraries->terminate_all_libraries();
@@ -192,6 +203,14 @@ Common::CGroup& Core::tools() const
 
 ////////////////////////////////////////////////////////////////////////////////
 
+Common::CTimings& Core::timings() const
+{
+  cf_assert(m_timings != nullptr);
+  return *m_timings;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void Core::set_profiler(const std::string & builder_name)
 {
   CodeProfiler::Ptr profiler =
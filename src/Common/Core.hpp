@@ -26,6 +26,7 @@ namespace Common {
   class CGroup;
   class CLibraries;
   class CFactories;
+  class CTimings;
   class NetworkInfo;
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -79,6 +80,10 @@ public: // methods
   /// @pre Core does not need to be initialized before
   Common::CGroup& tools() const;
 
+  /// Gets the CTimings
+  /// @pre Core does not need to be initialized before
+  Common::CTimings& timings() const;
+
   /// @brief Sets the profiler.
   /// @param profiler_name Profiler name
   /// @throw ValueNotFound if no such profiler was found
@@ -120,6 +125,8 @@ private: // data
   boost::shared_ptr< Common::CLibraries >   m_libraries;
   /// the CFactories unique object
   boost::shared_ptr< Common::CFactories >   m_factories;
+  /// the CTimings unique object
+  boost::shared_ptr< Common::CTimings >     m_timings;
   /// @brief The component tree root
   boost::shared_ptr< Common::CRoot >        m_root;
   /// The network information
@@ -22,6 +22,7 @@
 #include "Common/Core.hpp"
 #include "Common/CEnv.hpp"
 #include "Common/Log.hpp"
+#include "Common/LogAsyncWriter.hpp"
 #include "Common/MPI/PE.hpp"
 
 using namespace boost;
@@ -37,6 +38,9 @@ namespace Common {
 
 Logger::Logger()
 {
+  // the writer must outlive the streams, which flush on destruction
+  LogAsyncWriter::instance();
+
   // streams initialization
   m_streams[ERROR]   = new LogStream("Error",   ERROR);
   m_streams[WARNING] = new LogStream("Warning", WARNING);
@@ -73,8 +77,8 @@ void Logger::initiate()
 
   CFerror.setFilterRankZero( rank0 );
   CFwarn.setFilterRankZero( rank0 );
-  CFinfo.setFilterRankZero( rank0 );
-  CFdebug.setFilterRankZero( rank0 );
+  CFinfoStream.setFilterRankZero( rank0 );
+  CFdebugStream.setFilterRankZero( rank0 );
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -150,5 +154,23 @@ void Logger::set_log_level(const Uint log_level)
 
 //////////////////////////////////////////////////////////////////////////////
 
+bool Logger::is_enabled(LogLevel level)
+{
+  std::map<LogLevel, LogStream *>::iterator it = m_streams.find(level);
+  return it != m_streams.end() && it->second->is_enabled();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Logger::set_async(bool async)
+{
+  if(async)
+    LogAsyncWriter::instance().start();
+  else
+    LogAsyncWriter::instance().stop();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 } // Common
 } // CF
@@ -80,6 +80,19 @@ class Common_API Logger : public boost::noncopyable {
 
   void set_log_level(const Uint log_level);
 
+  /// @brief Checks whether messages of the given level reach any destination.
+
+  /// @param level The level of the message
+  /// @return Returns @c true if a message sent to the stream of that level would be output.
+  bool is_enabled(LogLevel level);
+
+  /// @brief Enables or disables writing screen and file output from a background thread.
+
+  /// When enabled, logging only costs the formatting of the message in the calling thread.
+  /// Disabling writes all pending messages before returning.
+  /// @param async If @c true, the background writer is started; otherwise, it is stopped.
+  void set_async(bool async);
+
   private :
 
   /// @brief Managed streams.
@@ -99,19 +112,31 @@ class Common_API Logger : public boost::noncopyable {
 // Logging macros
 ////////////////////////////////////////////////////////////////////////////////
 
-/// these are always defined
+/// true if messages of level n are output, use it to skip building messages that would be dropped
+#define CFLogEnabled(n) CF::Common::Logger::instance().is_enabled(n)
 
-#define CFinfo      CF::Common::Logger::instance().Info (FromHere())
+/// info and debug messages are only evaluated if they are output. The if/else form keeps the macros
+/// usable as the start of a stream expression and safe to use in an unbraced if/else.
+/// To configure these streams, use CFinfoStream and CFdebugStream, which are always evaluated.
+
+#define CFinfo      if ( !CFLogEnabled(CF::INFO) )  ; else CF::Common::Logger::instance().Info (FromHere())
 #define CFerror     CF::Common::Logger::instance().Error(FromHere())
 #define CFwarn      CF::Common::Logger::instance().Warn (FromHere())
-#define CFdebug     CF::Common::Logger::instance().Debug(FromHere())
+#define CFdebug     if ( !CFLogEnabled(CF::DEBUG) ) ; else CF::Common::Logger::instance().Debug(FromHere())
 #define CFflush     CF::Common::LogStream::ENDLINE
 #define CFendl      '\n' << CFflush
 
-#define CFLog(n,x)     CFinfo  << n << x << CFflush;
-#define CFLogInfo(x)   CFinfo  << x << CFflush;
-#define CFLogWarn(x)   CFwarn  << x << CFflush;
-#define CFLogError(x)  CFerror << x << CFflush;
+#define CFinfoStream   CF::Common::Logger::instance().getStream(CF::INFO)
+#define CFdebugStream  CF::Common::Logger::instance().getStream(CF::DEBUG)
+
+#define CFLog(n,x)     do { CFinfo  << n << x << CFflush; } while(0)
+
+/// these only evaluate their arguments if the message is output
+
+#define CFLogInfo(x)   do { if ( CFLogEnabled(CF::INFO) )    { CFinfo  << x << CFflush; } } while(0)
+#define CFLogWarn(x)   do { if ( CFLogEnabled(CF::WARNING) ) { CFwarn  << x << CFflush; } } while(0)
+#define CFLogError(x)  do { if ( CFLogEnabled(CF::ERROR) )   { CFerror << x << CFflush; } } while(0)
+#define CFLogDebug(x)  do { if ( CFLogEnabled(CF::DEBUG) )   { CFdebug << x << CFflush; } } while(0)
 
 ////////////////////////////////////////////////////////////////////////////////
 // Debugging macros
@@ -0,0 +1,201 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <ostream>
+
+#include <boost/bind.hpp>
+
+#include "Common/LogAsyncWriter.hpp"
+
+namespace CF {
+namespace Common {
+
+////////////////////////////////////////////////////////////////////////////////
+
+LogAsyncWriter::LogAsyncWriter() :
+  m_writing(false),
+  m_stop(false),
+  m_running(0)
+{
+}
+
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+LogAsyncWriter::~LogAsyncWriter()
+{
+  stop();
+}
+
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+LogAsyncWriter& LogAsyncWriter::instance()
+{
+  static LogAsyncWriter writer;
+  return writer;
+}
+
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+void LogAsyncWriter::start()
+{
+  boost::mutex::scoped_lock lock(m_mutex);
+
+  if(m_thread)
+    return;
+
+  m_stop = false;
+  m_thread.reset(new boost::thread(boost::bind(&LogAsyncWriter::run, this)));
+  ++m_running;
+}
+
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+void LogAsyncWriter::stop()
+{
+  {
+    boost::mutex::scoped_lock lock(m_mutex);
+    if(!m_thread)
+      return;
+    m_stop = true;
+  }
+
+  m_new_messages.notify_all();
+  m_thread->join();
+
+  // Messages may have arrived between the end of the thread and now
+  boost::mutex::scoped_lock lock(m_mutex);
+  write_messages(m_messages);
+  m_thread.reset();
+  m_stop = false;
+  --m_running;
+}
+
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+bool LogAsyncWriter::is_running() const
+{
+  boost::mutex::scoped_lock lock(m_mutex);
+  return m_thread.get() != NULL;
+}
+
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+void LogAsyncWriter::write(const boost::shared_ptr<std::ostream>& target, const std::string& message)
+{
+  if(!m_running)
+  {
+    *target << message;
+    return;
+  }
+
+  boost::mutex::scoped_lock lock(m_mutex);
+
+  // The writer may have stopped while waiting for the lock
+  if(!m_thread)
+  {
+    *target << message;
+    return;
+  }
+
+  m_messages.push_back(Message());
+  m_messages.back().target = target;
+  m_messages.back().text = message;
+
+  lock.unlock();
+  m_new_messages.notify_one();
+}
+
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+void LogAsyncWriter::flush(const boost::shared_ptr<std::ostream>& target)
+{
+  if(!m_running)
+    target->flush();
+}
+
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+void LogAsyncWriter::wait()
+{
+  boost::mutex::scoped_lock lock(m_mutex);
+  while(m_thread && (m_writing || !m_messages.empty()))
+    m_written.wait(lock);
+}
+
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+void LogAsyncWriter::run()
+{
+  std::vector<Message> messages;
+
+  while(true)
+  {
+    {
+      boost::mutex::scoped_lock lock(m_mutex);
+
+      m_writing = false;
+      m_written.notify_all();
+
+      while(m_messages.empty() && !m_stop)
+        m_new_messages.wait(lock);
+
+      if(m_messages.empty())
+        return;
+
+      // Take all messages at once, so the logging threads can continue filling an empty buffer
+      messages.swap(m_messages);
+      m_writing = true;
+    }
+
+    write_messages(messages);
+  }
+}
+
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+void LogAsyncWriter::write_messages(std::vector<Message>& messages)
+{
+  const Uint nb_messages = messages.size();
+  for(Uint i = 0; i != nb_messages; ++i)
+  {
+    *messages[i].target << messages[i].text;
+
+    // Flush only once for consecutive messages to the same destination
+    if(i+1 == nb_messages || messages[i+1].target != messages[i].target)
+      messages[i].target->flush();
+  }
+
+  messages.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::streamsize LogAsyncSink::write(const char_type * data, std::streamsize size)
+{
+  LogAsyncWriter::instance().write(m_target, std::string(data, size));
+  return size;
+}
+
+bool LogAsyncSink::flush()
+{
+  LogAsyncWriter::instance().flush(m_target);
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // Common
+} // CF
@@ -0,0 +1,150 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef CF_Common_LogAsyncWriter_hpp
+#define CF_Common_LogAsyncWriter_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <iosfwd>
+#include <vector>
+
+#include <boost/detail/atomic_count.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "Common/BoostIostreams.hpp"
+#include "Common/CF.hpp"
+#include "Common/CommonAPI.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace CF {
+namespace Common {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Writes log messages to their final destination from a background thread.
+
+/// When the writer is not running, messages are written immediately, without locking
+/// or flushing, just like writing to the stream itself. When it is
+/// running, the calling thread only appends the formatted message to a buffer,
+/// which is swapped out and written by the background thread. The lock is only
+/// held to append or swap, so the thread that logs never waits for the output itself.
+/// Messages are written in the order they were received.
+/// @see LogAsyncSink
+class Common_API LogAsyncWriter : public boost::noncopyable
+{
+  public:
+
+  /// @brief Gives the writer instance.
+  static LogAsyncWriter& instance();
+
+  /// @brief Starts the background thread. Does nothing if it is already running.
+  void start();
+
+  /// @brief Writes all pending messages and stops the background thread.
+  void stop();
+
+  /// @brief Checks whether the background thread is running.
+  bool is_running() const;
+
+  /// @brief Writes a message to the given stream, or queues it if the background thread is running.
+  /// @param target The stream to write to. It is kept alive until the message is written.
+  /// @param message The message
+  void write(const boost::shared_ptr<std::ostream>& target, const std::string& message);
+
+  /// @brief Flushes the given stream if the background thread is not running.
+  /// The background thread flushes each stream after writing the messages it picked up.
+  void flush(const boost::shared_ptr<std::ostream>& target);
+
+  /// @brief Blocks until all messages that were queued before the call are written.
+  void wait();
+
+  private:
+
+  /// A message, together with its destination
+  struct Message
+  {
+    boost::shared_ptr<std::ostream> target;
+    std::string text;
+  };
+
+  LogAsyncWriter();
+
+  ~LogAsyncWriter();
+
+  /// Main loop of the background thread
+  void run();
+
+  /// Write out the given messages
+  void write_messages(std::vector<Message>& messages);
+
+  /// Messages that were not picked up by the background thread yet
+  std::vector<Message> m_messages;
+
+  /// Protects the message buffer and the state flags
+  mutable boost::mutex m_mutex;
+
+  /// Signals new messages or a stop request to the background thread
+  boost::condition_variable m_new_messages;
+
+  /// Signals that the background thread wrote all messages it had picked up
+  boost::condition_variable m_written;
+
+  /// True while the background thread is writing messages
+  bool m_writing;
+
+  /// True if the background thread should stop
+  bool m_stop;
+
+  /// The background thread, null if not running
+  boost::scoped_ptr<boost::thread> m_thread;
+
+  /// 1 from the start of the background thread until all its messages are written after stopping,
+  /// so writing in synchronous mode can skip the lock
+  boost::detail::atomic_count m_running;
+
+}; // class LogAsyncWriter
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Boost.Iostreams sink that forwards everything to the LogAsyncWriter.
+class Common_API LogAsyncSink
+{
+  public:
+
+  typedef char char_type;
+  struct category : boost::iostreams::sink_tag, boost::iostreams::flushable_tag {};
+
+  /// @param target The stream the writer will write to
+  LogAsyncSink(const boost::shared_ptr<std::ostream>& target) : m_target(target) {}
+
+  /// @brief Passes the data on to the writer
+  /// @return Always returns @c size.
+  std::streamsize write(const char_type * data, std::streamsize size);
+
+  /// @brief Flushes the target stream, if the writer is not running
+  bool flush();
+
+  private:
+
+  boost::shared_ptr<std::ostream> m_target;
+
+}; // class LogAsyncSink
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // Common
+} // CF
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // CF_Common_LogAsyncWriter_hpp
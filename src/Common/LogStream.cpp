@@ -6,8 +6,11 @@
 
 #include <iostream>
 
+#include <boost/iostreams/stream.hpp>
+
 #include "Common/MPI/PE.hpp"
 #include "Common/Log.hpp"
+#include "Common/LogAsyncWriter.hpp"
 #include "Common/LogStream.hpp"
 #include "Common/LogLevelFilter.hpp"
 #include "Common/LogStampFilter.hpp"
@@ -19,6 +22,15 @@ using namespace CF;
 using namespace CF::Common;
 using namespace boost;
 
+namespace
+{
+  /// Deleter for streams that are not owned, such as std::cout
+  struct NoDelete
+  {
+    void operator()(const void*) const {}
+  };
+}
+
 LogStream::LogStream(const std::string & streamName, LogLevel level)
 : m_buffer(),
 m_streamName(streamName),
@@ -28,11 +40,11 @@ m_flushed(true)
   iostreams::filtering_ostream * stream;
   LogLevelFilter levelFilter(level);
 
-  // SCREEN
+  // SCREEN, written through the asynchronous writer when it is running
   stream = new iostreams::filtering_ostream();
   stream->push(levelFilter);
   stream->push(LogStampFilter(streamName));
-  stream->push(std::cout);
+  stream->push(LogAsyncSink(boost::shared_ptr<std::ostream>(&std::cout, NoDelete())));
   m_destinations[SCREEN] = stream;
 
   // FILE
@@ -227,6 +239,33 @@ LogLevel LogStream::get_filter(LogDestination destination) const
 //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
+bool LogStream::is_enabled() const
+{
+  std::map<LogDestination, iostreams::filtering_ostream *>::const_iterator it;
+
+  for(it = m_destinations.begin() ; it != m_destinations.end() ; it++)
+  {
+    if(!this->isDestinationUsed(it->first))
+      continue;
+
+    // the string buffer is only read by the forwarders
+    if(it->first == STRING && m_stringForwarders.empty())
+      continue;
+
+    if(it->first != SYNC_SCREEN && Comm::PE::instance().rank() != 0 && this->getFilterRankZero(it->first))
+      continue;
+
+    const LogLevelFilter& filter = this->getLevelFilter(it->first);
+    if(filter.get_log_level() >= static_cast<Uint>(filter.get_filter()))
+      return true;
+  }
+
+  return false;
+}
+
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
 void LogStream::useDestination(LogDestination destination, bool use)
 {
   m_usedDests[destination] = use;
@@ -315,7 +354,7 @@ void LogStream::setFile(const iostreams::file_descriptor_sink & fileDescr)
 
     stream->push(LogLevelFilter(m_filter_level));
     stream->push(LogStampFilter(m_streamName));
-    stream->push(fileDescr);
+    stream->push(LogAsyncSink(boost::shared_ptr<std::ostream>(new iostreams::stream<iostreams::file_descriptor_sink>(fileDescr))));
 
     m_destinations[FILE] = stream;
   }
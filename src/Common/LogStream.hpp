@@ -177,6 +177,13 @@ class Common_API LogStream
   /// @see LogLevelFilter
   LogLevel get_filter(LogDestination destination) const;
 
+  /// @brief Checks whether a message sent now would reach at least one destination.
+
+  /// This takes into account the level filters, the used destinations and the
+  /// filter on MPI rank zero. Use it to avoid formatting messages that would be dropped.
+  /// @return Returns @c true if a message would be forwarded to some destination.
+  bool is_enabled() const;
+
   /// @brief Modifies the use policy of a destination
 
   /// If @c destination is @c #FILE but @c #isFileOpen() returns @c false,
@@ -504,11 +504,17 @@ CF_COMMON_MPI_BUFFER_PACK_OPERATOR_VECTOR(std::string);
 CF_COMMON_MPI_BUFFER_PACK_OPERATOR_SUB_ARRAY(Uint);
 CF_COMMON_MPI_BUFFER_PACK_OPERATOR_SUB_ARRAY(int);
 CF_COMMON_MPI_BUFFER_PACK_OPERATOR_SUB_ARRAY(Real);
+#ifndef CF_REAL_IS_FLOAT
+CF_COMMON_MPI_BUFFER_PACK_OPERATOR_SUB_ARRAY(float);
+#endif
 CF_COMMON_MPI_BUFFER_PACK_OPERATOR_SUB_ARRAY(bool);
 
 CF_COMMON_MPI_BUFFER_PACK_OPERATOR_CONST_SUB_ARRAY(Uint);
 CF_COMMON_MPI_BUFFER_PACK_OPERATOR_CONST_SUB_ARRAY(int);
 CF_COMMON_MPI_BUFFER_PACK_OPERATOR_CONST_SUB_ARRAY(Real);
+#ifndef CF_REAL_IS_FLOAT
+CF_COMMON_MPI_BUFFER_PACK_OPERATOR_CONST_SUB_ARRAY(float);
+#endif
 CF_COMMON_MPI_BUFFER_PACK_OPERATOR_CONST_SUB_ARRAY(bool);
 
 CF_COMMON_MPI_BUFFER_UNPACK_OPERATOR(bool);
@@ -546,6 +552,9 @@ CF_COMMON_MPI_BUFFER_UNPACK_OPERATOR_VECTOR(std::string);
 CF_COMMON_MPI_BUFFER_UNPACK_OPERATOR_SUB_ARRAY(Uint);
 CF_COMMON_MPI_BUFFER_UNPACK_OPERATOR_SUB_ARRAY(int);
 CF_COMMON_MPI_BUFFER_UNPACK_OPERATOR_SUB_ARRAY(Real);
+#ifndef CF_REAL_IS_FLOAT
+CF_COMMON_MPI_BUFFER_UNPACK_OPERATOR_SUB_ARRAY(float);
+#endif
 CF_COMMON_MPI_BUFFER_UNPACK_OPERATOR_SUB_ARRAY(bool);
 
 #undef CF_COMMON_MPI_BUFFER_PACK_OPERATOR
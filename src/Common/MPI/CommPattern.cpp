@@ -6,11 +6,14 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <cstring>
+
 #include "Common/BoostAssertions.hpp"
 #include "Common/LibCommon.hpp"
 #include "Common/FindComponents.hpp"
 #include "Common/CBuilder.hpp"
 #include "Common/Log.hpp"
+#include "Common/CTimings.hpp"
 
 #include "Common/MPI/PE.hpp"
 #include "Common/MPI/CommPattern.hpp"
@@ -48,7 +51,9 @@ CommPattern::CommPattern(const std::string& name): Component(name), m_gid(new Co
   m_sendCount(Comm::PE::instance().size(),0),
   m_sendMap(0),
   m_recvCount(Comm::PE::instance().size(),0),
-  m_recvMap(0)
+  m_recvMap(0),
+  m_use_node_window(false),
+  m_node_item_size(0)
 {
   //self->regist_signal ( "update" , "Executes communication patterns on all the registered data.", "" )->connect ( boost::bind ( &CommPattern2::update, self, _1 ) );
   m_isUpToDate=false;
@@ -223,6 +228,8 @@ void CommPattern::setup()
 //PECheckPoint(100,"-- step 4 --:");
 //PEProcessSortedExecute(-1,PEDebugVector(m_sendMap,m_sendMap.size()));
 
+  setup_node_exchange();
+
   return;
   } // end fast
 
@@ -330,6 +337,72 @@ void CommPattern::synchronize_all()
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void CommPattern::setup_node_exchange()
+{
+  // the window is reallocated at the next synchronization, for the new maps
+  m_node_window.free();
+  m_node_item_size=0;
+  m_use_node_window=false;
+
+  // same on all processes, the offsets below are exchanged over all of them
+  if (!SharedWindow::is_supported()) return;
+
+  const CPint nproc=(CPint)Comm::PE::instance().size();
+  const std::vector<int>& node_ranks=Comm::PE::instance().node_ranks();
+
+  // send side: items for this node go to the window, ordered by destination
+  m_nodeSendMap.clear();
+  m_remoteSendMap.clear();
+  m_remoteSendCount.assign(nproc,0);
+  std::vector<CPint> send_offsets(nproc,0);
+  int send_begin=0;
+  for (int p=0; p<nproc; p++)
+  {
+    const int send_end=send_begin+m_sendCount[p];
+    if (node_ranks[p]>=0)
+    {
+      send_offsets[p]=(CPint)m_nodeSendMap.size();
+      m_nodeSendMap.insert(m_nodeSendMap.end(),m_sendMap.begin()+send_begin,m_sendMap.begin()+send_end);
+    }
+    else
+    {
+      m_remoteSendCount[p]=m_sendCount[p];
+      m_remoteSendMap.insert(m_remoteSendMap.end(),m_sendMap.begin()+send_begin,m_sendMap.begin()+send_end);
+    }
+    send_begin=send_end;
+  }
+
+  // receive side: one map per process on this node
+  std::vector<CPint> recv_offsets(nproc,0);
+  Comm::PE::instance().all_to_all(send_offsets,recv_offsets);
+
+  m_nodeRecvMaps.assign(Comm::PE::instance().node_size(),std::vector<CPint>());
+  m_nodeRecvOffset.assign(Comm::PE::instance().node_size(),0);
+  m_remoteRecvMap.clear();
+  m_remoteRecvCount.assign(nproc,0);
+  int recv_begin=0;
+  for (int p=0; p<nproc; p++)
+  {
+    const int recv_end=recv_begin+m_recvCount[p];
+    if (node_ranks[p]>=0)
+    {
+      m_nodeRecvMaps[node_ranks[p]].assign(m_recvMap.begin()+recv_begin,m_recvMap.begin()+recv_end);
+      m_nodeRecvOffset[node_ranks[p]]=recv_offsets[p];
+    }
+    else
+    {
+      m_remoteRecvCount[p]=m_recvCount[p];
+      m_remoteRecvMap.insert(m_remoteRecvMap.end(),m_recvMap.begin()+recv_begin,m_recvMap.begin()+recv_end);
+    }
+    recv_begin=recv_end;
+  }
+
+  // a process alone on its node has nothing to share
+  m_use_node_window=Comm::PE::instance().node_size()>1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void CommPattern::synchronize( const std::string& name )
 {
   CommWrapper& pobj = get_child(name).as_type<CommWrapper>();
@@ -348,6 +421,21 @@ void CommPattern::synchronize_this( const CommWrapper& pobj )
   {
 //      PEProcessSortedExecute(-1,std::cout << PERank << "   sync -> " <<  pobj.name() << "\n" << std::flush; );
 
+      ScopedTimer timer(pobj, "synchronize");
+      if (timer.is_active())
+      {
+        Uint nb_send = 0;
+        BOOST_FOREACH( const CPint count, m_use_node_window ? m_remoteSendCount : m_sendCount )
+          nb_send += count;
+        timer.add_bytes(nb_send*pobj.size_of()*pobj.stride());
+      }
+
+      if (m_use_node_window)
+      {
+        synchronize_through_node_window(pobj);
+        return;
+      }
+
       char* snd_data = (char*)pobj.pack(m_sendMap);
 
       char* rcv_data = Comm::PE::instance().all_to_all(snd_data,
@@ -367,6 +455,51 @@ void CommPattern::synchronize_this( const CommWrapper& pobj )
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void CommPattern::synchronize_through_node_window( const CommWrapper& pobj )
+{
+  const Uint item_size=pobj.size_of()*pobj.stride();
+
+  // the item size is the same on all processes, so they all reallocate together
+  if (item_size>m_node_item_size)
+  {
+    m_node_window.allocate(m_nodeSendMap.size()*item_size);
+    m_node_item_size=item_size;
+  }
+
+  // publish the items for this node
+  if (!m_nodeSendMap.empty())
+  {
+    char* node_data = (char*)pobj.pack(m_nodeSendMap);
+    std::memcpy(m_node_window.data(),node_data,m_nodeSendMap.size()*item_size);
+    delete[] node_data;
+  }
+  m_node_window.synchronize();
+
+  // messages only for the other nodes
+  char* snd_data = (char*)pobj.pack(m_remoteSendMap);
+  char* rcv_data = Comm::PE::instance().all_to_all(snd_data,
+                                                  &m_remoteSendCount[0],
+                                                  (char*)0,
+                                                  &m_remoteRecvCount[0],
+                                                  item_size);
+  pobj.unpack(rcv_data,m_remoteRecvMap);
+  delete[] snd_data;
+  delete[] rcv_data;
+
+  // read the items of the other processes on this node directly from their part of the window
+  const Uint node_size=m_nodeRecvMaps.size();
+  for (Uint r=0; r<node_size; r++)
+  {
+    if (!m_nodeRecvMaps[r].empty())
+      pobj.unpack(m_node_window.data(r)+m_nodeRecvOffset[r]*item_size,m_nodeRecvMaps[r]);
+  }
+
+  // nobody may overwrite its part before all others read it
+  m_node_window.synchronize();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void CommPattern::add(Uint gid, Uint rank)
 {
   if (m_isFreeze) throw Common::ShouldNotBeHere(FromHere(),"Wanted to add nodes to commpattern '" + name() + "' which is freezed.");
@@ -10,6 +10,7 @@
 #include "Common/Component.hpp"
 #include "Common/BoostArray.hpp"
 #include "Common/MPI/PE.hpp"
+#include "Common/MPI/SharedWindow.hpp"
 #include "Common/MPI/CommWrapper.hpp"
 #include "Common/MPI/CommWrapperMArray.hpp"
 
@@ -27,6 +28,8 @@ namespace Comm {
   For efficiency it works such a way that you submit your request via the constructor or the add/remove/move magic triangle and then call setup to modify the commpattern.
   The data needed to be kept synchronous can be registered via the insert function.
   The word node here means any kind of "point of storage", in this context it is not directly related with the computational mesh.
+  When MPI supports shared memory windows, the data exchanged between processes on the same compute node is copied
+  through a window shared by these processes, and only the data for other compute nodes is passed as messages.
 **/
 
 /**
@@ -268,6 +271,13 @@ protected: // helper function
 
 private:
 
+  /// split the send and receive maps in a part for the processes on this compute node,
+  /// exchanged through m_node_window, and a part for the processes on other nodes
+  void setup_node_exchange();
+
+  /// synchronize through m_node_window on this compute node, and through messages with the other nodes
+  void synchronize_through_node_window ( const CommWrapper& pobj );
+
   /// @name PROPERTIES
   //@{
 
@@ -311,6 +321,41 @@ private:
   /// this is the map of receiveing communication pattern
   std::vector< CPint > m_recvMap;
 
+  /// @name EXCHANGE THROUGH SHARED MEMORY ON THE COMPUTE NODE
+  //@{
+
+  /// true if data for the processes on this compute node goes through m_node_window
+  bool m_use_node_window;
+
+  /// window shared with the processes on this compute node, holding the items sent to them
+  SharedWindow m_node_window;
+
+  /// size in bytes of one item the window was allocated for, 0 if not allocated
+  Uint m_node_item_size;
+
+  /// items sent to processes on this compute node, ordered by destination
+  std::vector< CPint > m_nodeSendMap;
+
+  /// receive map per rank on this compute node
+  std::vector< std::vector< CPint > > m_nodeRecvMaps;
+
+  /// per rank on this compute node, position of the items for this process in its part of the window
+  std::vector< CPint > m_nodeRecvOffset;
+
+  /// process-wise counter of sending to other compute nodes, zero for this node
+  std::vector< CPint > m_remoteSendCount;
+
+  /// map of sending to other compute nodes
+  std::vector< CPint > m_remoteSendMap;
+
+  /// process-wise counter of receiving from other compute nodes, zero for this node
+  std::vector< CPint > m_remoteRecvCount;
+
+  /// map of receiving from other compute nodes
+  std::vector< CPint > m_remoteRecvMap;
+
+  //@} END EXCHANGE THROUGH SHARED MEMORY ON THE COMPUTE NODE
+
 }; // CommPattern
 
 ////////////////////////////////////////////////////////////////////////////////////////////
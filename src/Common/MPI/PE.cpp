@@ -4,9 +4,14 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <cstring>
+
+#include <boost/thread/thread.hpp>
+
 #include "Common/Log.hpp"
 
 #include "Common/BasicExceptions.hpp"
+#include "Common/ThreadPool.hpp"
 #include "Common/MPI/PE.hpp"
 
 //#include "Common/MPI/debug.hpp"
@@ -20,6 +25,9 @@ namespace Comm {
 PE::PE(int argc, char** args)
 {
   m_comm = nullptr;
+  m_node_comm = nullptr;
+  m_thread_support = MPI_THREAD_SINGLE;
+  m_nb_threads = 0;
   init(argc,args);
   m_current_status=WorkerStatus::NOT_RUNNING;
 }
@@ -29,6 +37,9 @@ PE::PE(int argc, char** args)
 PE::PE()
 {
   m_comm = nullptr;
+  m_node_comm = nullptr;
+  m_thread_support = MPI_THREAD_SINGLE;
+  m_nb_threads = 0;
   m_current_status = WorkerStatus::NOT_RUNNING;
 }
 
@@ -84,11 +95,56 @@ void PE::init(int argc, char** args)
 
   if( !is_initialized() && !is_finalized() ) // then initialize
   {
-    MPI_CHECK_RESULT(MPI_Init,(&argc,&args));
+    MPI_CHECK_RESULT(MPI_Init_thread,(&argc,&args,MPI_THREAD_FUNNELED,&m_thread_support));
     //  CFinfo << "MPI (version " <<  version() << ") -- initiated" << CFendl;
   }
+  else
+  {
+    MPI_CHECK_RESULT(MPI_Query_thread,(&m_thread_support));
+  }
 
   m_comm = MPI_COMM_WORLD;
+
+  if( m_node_comm == nullptr )
+  {
+    const int world_rank = static_cast<int>(rank());
+#if MPI_VERSION >= 3
+    MPI_CHECK_RESULT(MPI_Comm_split_type,(m_comm, MPI_COMM_TYPE_SHARED, world_rank, MPI_INFO_NULL, &m_node_comm));
+#else
+    // group the processes on the name of the processor they run on
+    char name[MPI_MAX_PROCESSOR_NAME];
+    std::memset(name, 0, MPI_MAX_PROCESSOR_NAME);
+    int name_length = 0;
+    MPI_CHECK_RESULT(MPI_Get_processor_name,(name, &name_length));
+
+    std::vector<char> all_names(MPI_MAX_PROCESSOR_NAME*size());
+    MPI_CHECK_RESULT(MPI_Allgather,(name, MPI_MAX_PROCESSOR_NAME, MPI_CHAR, &all_names[0], MPI_MAX_PROCESSOR_NAME, MPI_CHAR, m_comm));
+
+    int color = 0;
+    while( std::strncmp(name, &all_names[color*MPI_MAX_PROCESSOR_NAME], MPI_MAX_PROCESSOR_NAME) != 0 )
+      ++color;
+
+    MPI_CHECK_RESULT(MPI_Comm_split,(m_comm, color, world_rank, &m_node_comm));
+#endif
+
+    // translate all ranks to the node communicator, processes on other nodes become MPI_UNDEFINED
+    const int nb_procs = static_cast<int>(size());
+    std::vector<int> world_ranks(nb_procs);
+    for(int i = 0; i != nb_procs; ++i)
+      world_ranks[i] = i;
+    m_node_ranks.resize(nb_procs);
+
+    MPI_Group world_group, node_group;
+    MPI_CHECK_RESULT(MPI_Comm_group,(m_comm, &world_group));
+    MPI_CHECK_RESULT(MPI_Comm_group,(m_node_comm, &node_group));
+    MPI_CHECK_RESULT(MPI_Group_translate_ranks,(world_group, nb_procs, &world_ranks[0], node_group, &m_node_ranks[0]));
+    MPI_CHECK_RESULT(MPI_Group_free,(&world_group));
+    MPI_CHECK_RESULT(MPI_Group_free,(&node_group));
+
+    for(int i = 0; i != nb_procs; ++i)
+      if(m_node_ranks[i] == MPI_UNDEFINED)
+        m_node_ranks[i] = -1;
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -97,11 +153,15 @@ void PE::finalize()
 {
   if( is_initialized() && !is_finalized() ) // then finalized
   {
+    if( m_node_comm != nullptr )
+      MPI_CHECK_RESULT(MPI_Comm_free,(&m_node_comm));
     MPI_CHECK_RESULT(MPI_Finalize,());
     //  CFinfo << "MPI (version " <<  version() << ") -- finalized" << CFendl;
   }
 
   m_comm = nullptr;
+  m_node_comm = nullptr;
+  m_node_ranks.clear();
 
 //    boost::this_thread::sleep(boost::posix_time::milliseconds(100));
 //    int is_mpi_finalized;
@@ -151,6 +211,48 @@ Uint PE::size() const
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+
+Uint PE::node_rank() const
+{
+  if ( !is_active() ) return 0;
+  int irank;
+  MPI_CHECK_RESULT(MPI_Comm_rank,(m_node_comm,&irank));
+  return static_cast<Uint>(irank);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Uint PE::node_size() const
+{
+  if ( !is_active() ) return 1;
+  int nproc;
+  MPI_CHECK_RESULT(MPI_Comm_size,(m_node_comm,&nproc));
+  return static_cast<Uint>(nproc);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Uint PE::nb_threads() const
+{
+  if ( m_nb_threads != 0 ) return m_nb_threads;
+  const Uint nb_cores = boost::thread::hardware_concurrency();
+  return std::max(nb_cores / node_size(), 1u);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+ThreadPool& PE::thread_pool()
+{
+  const Uint nb_threads = this->nb_threads();
+  if( !m_thread_pool || m_thread_pool->size() != nb_threads )
+  {
+    m_thread_pool.reset(); // join the old threads first
+    m_thread_pool.reset(new ThreadPool(nb_threads));
+  }
+  return *m_thread_pool;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 void PE::change_status(WorkerStatus::Type status)
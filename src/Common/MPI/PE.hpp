@@ -10,6 +10,8 @@
 
 #include <mpi.h>
 
+#include <boost/scoped_ptr.hpp>
+
 #include "Common/StringConversion.hpp"
 #include "Common/WorkerStatus.hpp"
 
@@ -36,6 +38,8 @@
 namespace CF {
 namespace Common {
 
+class ThreadPool;
+
 /// @brief Classes offering a %MPI interface for %COOLFluiD
 namespace Comm {
 
@@ -64,10 +68,16 @@ public:
   /// @returns the generic communication channel
   Communicator communicator() { cf_assert( is_active() ); return m_comm; }
 
+  /// @returns the communicator of the processes on the same compute node
+  Communicator node_communicator() { cf_assert( is_active() ); return m_node_comm; }
+
   /// Returns the MPI version
   std::string version() const;
 
   /// Initialise the PE
+  /// MPI is initialized with MPI_THREAD_FUNNELED support, so threads may be used for computations,
+  /// as long as only the main thread communicates. A communicator for the processes that share
+  /// a compute node is created as well.
   /// @post will have a valid state
   void init(int argc=0, char** args=0);
   /// Free the PE, careful because some mpi-s fail upon re-init after a proper finalize
@@ -95,6 +105,31 @@ public:
   /// Return the number of processes, or 1 if is_init==0.
   Uint size() const;
 
+  /// Return the rank within the compute node, or 0 if is_init==0.
+  Uint node_rank() const;
+
+  /// Return the number of processes on this compute node, or 1 if is_init==0.
+  Uint node_size() const;
+
+  /// Rank on this compute node of each process, indexed by the rank in communicator(),
+  /// or -1 for the processes that run on other nodes. Empty if is_init==0.
+  const std::vector<int>& node_ranks() const { return m_node_ranks; }
+
+  /// Level of thread support provided by MPI (MPI_THREAD_SINGLE, MPI_THREAD_FUNNELED, ...)
+  int thread_support() const { return m_thread_support; }
+
+  /// Number of threads each process should use for loops that can be threaded.
+  /// Unless set explicitly, the cores of the compute node are divided between the processes running on it.
+  Uint nb_threads() const;
+
+  /// Set the number of threads each process should use. 0 restores the default.
+  void set_nb_threads(const Uint nb_threads) { m_nb_threads = nb_threads; }
+
+  /// Threads for the loops of this process, nb_threads() in size.
+  /// The pool is created on first use, and again after the number of threads changed.
+  /// Only the main thread should run tasks in it.
+  ThreadPool& thread_pool();
+
   /// Sets current process status.
   /// @param status New status
   /// @todo the name WorkerStatus is inappropriate, better to name it for example ProcessStatus
@@ -318,6 +353,16 @@ private:
 
   Communicator m_comm; ///< comm_world
 
+  Communicator m_node_comm; ///< processes on the same compute node
+
+  std::vector<int> m_node_ranks; ///< rank in m_node_comm of each process in m_comm, -1 if on another node
+
+  int m_thread_support; ///< thread support level provided by MPI
+
+  Uint m_nb_threads; ///< number of threads per process, 0 for the default
+
+  boost::scoped_ptr<ThreadPool> m_thread_pool; ///< threads used by the loops, created on demand
+
   WorkerStatus::Type m_current_status; ///< Current status, default value is @c #NOT_RUNNING.
 
 }; // PE
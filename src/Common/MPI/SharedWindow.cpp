@@ -0,0 +1,104 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include "Common/BasicExceptions.hpp"
+#include "Common/MPI/SharedWindow.hpp"
+
+namespace CF {
+namespace Common {
+namespace Comm {
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool SharedWindow::is_supported()
+{
+#if MPI_VERSION >= 3
+  return true;
+#else
+  return false;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+SharedWindow::SharedWindow()
+{
+#if MPI_VERSION >= 3
+  m_window = MPI_WIN_NULL;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+SharedWindow::~SharedWindow()
+{
+  free();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void SharedWindow::allocate(const Uint nb_bytes)
+{
+#if MPI_VERSION >= 3
+  free();
+
+  PE& pe = PE::instance();
+  char* local_data = nullptr;
+  MPI_CHECK_RESULT(MPI_Win_allocate_shared,(static_cast<MPI_Aint>(nb_bytes), 1, MPI_INFO_NULL, pe.node_communicator(), &local_data, &m_window));
+
+  // Passive target epoch for the lifetime of the window, synchronize() orders the accesses
+  MPI_CHECK_RESULT(MPI_Win_lock_all,(MPI_MODE_NOCHECK, m_window));
+
+  const Uint nb_procs = pe.node_size();
+  m_data.resize(nb_procs);
+  for(Uint i = 0; i != nb_procs; ++i)
+  {
+    MPI_Aint size = 0;
+    int disp_unit = 0;
+    MPI_CHECK_RESULT(MPI_Win_shared_query,(m_window, static_cast<int>(i), &size, &disp_unit, &m_data[i]));
+  }
+#else
+  throw NotSupported(FromHere(), "Shared memory windows require MPI 3, this is MPI " + PE::instance().version());
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void SharedWindow::free()
+{
+#if MPI_VERSION >= 3
+  if(m_window == MPI_WIN_NULL)
+    return;
+
+  // MPI_Finalize already released the window
+  if(PE::instance().is_active())
+  {
+    MPI_CHECK_RESULT(MPI_Win_unlock_all,(m_window));
+    MPI_CHECK_RESULT(MPI_Win_free,(&m_window));
+  }
+
+  m_window = MPI_WIN_NULL;
+#endif
+  m_data.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void SharedWindow::synchronize()
+{
+  cf_assert(is_allocated());
+#if MPI_VERSION >= 3
+  MPI_CHECK_RESULT(MPI_Win_sync,(m_window));
+  PE::instance().barrier(PE::instance().node_communicator());
+  MPI_CHECK_RESULT(MPI_Win_sync,(m_window));
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // namespace Comm
+} // namespace Common
+} // namespace CF
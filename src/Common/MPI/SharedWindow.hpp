@@ -0,0 +1,82 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef CF_Common_MPI_SharedWindow_hpp
+#define CF_Common_MPI_SharedWindow_hpp
+
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include "Common/MPI/PE.hpp"
+
+namespace CF {
+namespace Common {
+namespace Comm {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Memory shared by the processes of a compute node, through an MPI-3 shared memory window.
+
+/// Each process on the node allocates its own part of the window, and can read and write the parts
+/// of all other processes on the node directly, without any message passing. Writes become visible to
+/// the other processes after synchronize(), which must be called by all processes on the node.
+/// Windows are only available when MPI supports version 3 of the standard, check is_supported()
+/// and keep a message passing alternative otherwise.
+class Common_API SharedWindow : public boost::noncopyable
+{
+public:
+
+  /// True if shared memory windows are supported by the MPI implementation
+  static bool is_supported();
+
+  /// Construct an empty window
+  SharedWindow();
+
+  /// Frees the window, if it is allocated
+  ~SharedWindow();
+
+  /// Allocate the window. Collective over the processes of the compute node, that may each
+  /// request a different size. An existing window is freed first.
+  /// @param nb_bytes Size of the part of this process, in bytes
+  /// @throws NotSupported if the MPI implementation does not support shared memory windows
+  void allocate(const Uint nb_bytes);
+
+  /// Free the window. Collective over the processes of the compute node.
+  void free();
+
+  /// True if the window is allocated
+  bool is_allocated() const { return !m_data.empty(); }
+
+  /// Part of the window that belongs to the process with the given rank on the compute node
+  char* data(const Uint node_rank) const { cf_assert(node_rank < m_data.size()); return m_data[node_rank]; }
+
+  /// Part of the window that belongs to this process
+  char* data() const { return data(PE::instance().node_rank()); }
+
+  /// Make the data written by each process visible to all processes on the node,
+  /// and wait until all of them reach this point. Collective over the processes of the compute node.
+  void synchronize();
+
+private:
+
+#if MPI_VERSION >= 3
+  /// The window
+  MPI_Win m_window;
+#endif
+
+  /// Start of the part of each process on the node, empty if not allocated
+  std::vector<char*> m_data;
+
+}; // SharedWindow
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // namespace Comm
+} // namespace Common
+} // namespace CF
+
+#endif // CF_Common_MPI_SharedWindow_hpp
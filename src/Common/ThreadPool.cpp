@@ -0,0 +1,148 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <exception>
+
+#include <boost/bind.hpp>
+
+#include "Common/BasicExceptions.hpp"
+#include "Common/ThreadPool.hpp"
+
+namespace CF {
+namespace Common {
+
+////////////////////////////////////////////////////////////////////////////////
+
+ThreadPool::ThreadPool(const Uint nb_threads) :
+  m_task(nullptr),
+  m_nb_tasks(0),
+  m_next_task(0),
+  m_nb_done(0),
+  m_run(0),
+  m_stop(false)
+{
+  for(Uint i = 1; i < nb_threads; ++i)
+    m_threads.create_thread(boost::bind(&ThreadPool::work, this));
+}
+
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+ThreadPool::~ThreadPool()
+{
+  {
+    boost::mutex::scoped_lock lock(m_mutex);
+    m_stop = true;
+  }
+
+  m_start.notify_all();
+  m_threads.join_all();
+}
+
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+void ThreadPool::run(const Uint nb_tasks, const TaskT& task)
+{
+  if(nb_tasks == 0)
+    return;
+
+  // Nothing to hand out, run in the calling thread
+  if(nb_tasks == 1 || m_threads.size() == 0)
+  {
+    for(Uint i = 0; i != nb_tasks; ++i)
+      task(i);
+    return;
+  }
+
+  {
+    boost::mutex::scoped_lock lock(m_mutex);
+    m_task = &task;
+    m_nb_tasks = nb_tasks;
+    m_next_task = 0;
+    m_nb_done = 0;
+    m_error.clear();
+    ++m_run;
+  }
+
+  m_start.notify_all();
+
+  execute_tasks();
+
+  boost::mutex::scoped_lock lock(m_mutex);
+  while(m_nb_done != m_nb_tasks)
+    m_done.wait(lock);
+
+  m_task = nullptr;
+
+  if(!m_error.empty())
+    throw ParallelError(FromHere(), "Task in thread pool failed: " + m_error);
+}
+
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+void ThreadPool::work()
+{
+  Uint last_run = 0;
+
+  while(true)
+  {
+    {
+      boost::mutex::scoped_lock lock(m_mutex);
+      while(m_run == last_run && !m_stop)
+        m_start.wait(lock);
+
+      if(m_stop)
+        return;
+
+      last_run = m_run;
+    }
+
+    execute_tasks();
+  }
+}
+
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+void ThreadPool::execute_tasks()
+{
+  boost::mutex::scoped_lock lock(m_mutex);
+
+  // A thread that wakes up late may find the run finished already
+  while(m_task != nullptr && m_next_task != m_nb_tasks)
+  {
+    const Uint task_idx = m_next_task++;
+    const TaskT& task = *m_task;
+    lock.unlock();
+
+    std::string error;
+    try
+    {
+      task(task_idx);
+    }
+    catch(std::exception& e)
+    {
+      error = e.what();
+    }
+    catch(...)
+    {
+      error = "unknown exception";
+    }
+
+    lock.lock();
+    if(!error.empty() && m_error.empty())
+      m_error = error;
+    if(++m_nb_done == m_nb_tasks)
+      m_done.notify_all();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // Common
+} // CF
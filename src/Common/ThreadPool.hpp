@@ -0,0 +1,109 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef CF_Common_ThreadPool_hpp
+#define CF_Common_ThreadPool_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <string>
+
+#include <boost/function.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "Common/CF.hpp"
+#include "Common/CommonAPI.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace CF {
+namespace Common {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Fixed set of threads that execute numbered tasks for loop components.
+
+/// The threads are started once and wait between runs, so threaded loops that are executed
+/// every iteration do not pay for creating and joining threads. The calling thread takes part
+/// in each run, so a pool of size N uses N-1 background threads.
+/// Only one run can be active at a time, and only the thread that owns the pool should start it.
+/// @see Comm::PE::thread_pool()
+class Common_API ThreadPool : public boost::noncopyable
+{
+  public:
+
+  /// Type of a task. The argument is the task number, in [0, nb_tasks[
+  typedef boost::function<void (const Uint)> TaskT;
+
+  /// @param nb_threads Number of threads that execute tasks, including the calling thread
+  ThreadPool(const Uint nb_threads);
+
+  /// Stops and joins the background threads
+  ~ThreadPool();
+
+  /// Number of threads that execute tasks, including the calling thread
+  Uint size() const { return m_threads.size() + 1; }
+
+  /// @brief Executes task(i) for each i in [0, nb_tasks[, and returns when all tasks are done.
+  /// Tasks are handed out in increasing order to the first thread that is free.
+  /// If a task throws, the remaining tasks are still executed and a ParallelError with the
+  /// message of the first exception is thrown afterwards.
+  void run(const Uint nb_tasks, const TaskT& task);
+
+  private:
+
+  /// Main loop of the background threads
+  void work();
+
+  /// Execute tasks of the current run until none are left
+  void execute_tasks();
+
+  /// The background threads
+  boost::thread_group m_threads;
+
+  /// Protects the state of the current run
+  boost::mutex m_mutex;
+
+  /// Signals a new run or a stop request to the background threads
+  boost::condition_variable m_start;
+
+  /// Signals that all tasks of the current run are done
+  boost::condition_variable m_done;
+
+  /// Task of the current run, null between runs
+  const TaskT* m_task;
+
+  /// Number of tasks in the current run
+  Uint m_nb_tasks;
+
+  /// Next task that is not handed out yet
+  Uint m_next_task;
+
+  /// Number of tasks that are done
+  Uint m_nb_done;
+
+  /// Incremented for each run, so the background threads know a new run started
+  Uint m_run;
+
+  /// Message of the first exception thrown by a task in the current run
+  std::string m_error;
+
+  /// True if the background threads should stop
+  bool m_stop;
+
+}; // class ThreadPool
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // Common
+} // CF
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // CF_Common_ThreadPool_hpp
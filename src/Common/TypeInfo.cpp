@@ -52,6 +52,7 @@ TypeInfo::TypeInfo()
   regist<std::string>("string");
   regist<bool>("bool");
   regist<CF::Real>("real");
+  regist<float>("float");
   regist<Common::URI>("uri");
   regist<std::vector<int> >("array[integer]");
   regist<std::vector<Uint> >("array[unsigned]");
@@ -4,10 +4,12 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <map>
 #include <set>
 #include <boost/foreach.hpp>
 #include "Common/Log.hpp"
 #include "Common/CBuilder.hpp"
+#include "Common/MPI/PE.hpp"
 #include "Common/MPI/debug.hpp"
 #include "Common/FindComponents.hpp"
 #include "Common/Foreach.hpp"
@@ -19,9 +21,10 @@
 #include "Mesh/CMeshElements.hpp"
 #include "Mesh/CFaceCellConnectivity.hpp"
 #include "Mesh/CNodeElementConnectivity.hpp"
-#include "Mesh/CNodeFaceCellConnectivity.hpp"
 #include "Mesh/CCells.hpp"
 #include "Mesh/CMesh.hpp"
+#include "Mesh/FaceMatcher.hpp"
+#include "Math/Consts.hpp"
 #include "Math/Functions.hpp"
 
 //////////////////////////////////////////////////////////////////////////////
@@ -41,7 +44,8 @@ Common::ComponentBuilder < CBuildFaces, CMeshTransformer, LibActions> CBuildFace
 
 CBuildFaces::CBuildFaces( const std::string& name )
 : CMeshTransformer(name),
-  m_store_cell2face(false)
+  m_store_cell2face(false),
+  m_nb_threads(0)
 {
 
   m_properties["brief"] = std::string("Print information of the mesh");
@@ -57,6 +61,12 @@ CBuildFaces::CBuildFaces( const std::string& name )
       ->pretty_name("Store Cell to Face")
       ->mark_basic()
       ->link_to(&m_store_cell2face);
+
+  m_options.add_option( OptionT<Uint>::create("nb_threads", m_nb_threads) )
+      ->description("Number of threads used to match the faces of the elements.\n"
+                    "0 uses the number of threads per process given by the parallel environment")
+      ->pretty_name("Number of Threads")
+      ->link_to(&m_nb_threads);
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -101,50 +111,186 @@ void CBuildFaces::make_interfaces(Component& parent)
   cf_assert_desc("parent must be a CRegion or CMesh",
     is_not_null( parent.as_ptr<CMesh>() ) || is_not_null( parent.as_ptr<CRegion>() ) );
 
-  CElements::Ptr comp;
-  //std::cout << PERank << "make interfaces for " << parent.name() << std::endl;
-
   std::vector<CRegion::Ptr> regions = range_to_vector(find_components<CRegion>(parent));
-  const Uint n=regions.size();
-  if (n>1)
+  const Uint nb_regions=regions.size();
+  if (nb_regions < 2)
+    return;
+
+  // Regions with surface elements are boundaries, the faces of all other regions can form interfaces
+  std::vector<bool> is_bdry_region(nb_regions);
+  std::vector<bool> has_volume(nb_regions);
+  for (Uint r=0; r<nb_regions; ++r)
   {
-    //Uint nb_interfaces = factorial(n) / (2*factorial(n-2));
-    for (Uint i=0; i<n; ++i)
-    for (Uint j=i+1; j<n; ++j)
+    is_bdry_region[r] = find_components_with_filter<CElements>(*regions[r],IsElementsSurface()).size() != 0;
+    has_volume[r] = find_components_with_filter<CElements>(*regions[r],IsElementsVolume()).size() != 0;
+  }
+
+  // Put the faces at the boundary of every region in one hash table, so all regions are matched in a single pass
+  std::vector<CFaceCellConnectivity::Ptr> f2cs;
+  std::vector<Uint> f2c_region;
+  std::vector<boost::shared_ptr<CTable<Uint>::Buffer> > buf_f2c;
+  std::vector<boost::shared_ptr<CTable<Uint>::Buffer> > buf_fnb;
+  std::vector<boost::shared_ptr<CList<bool>::Buffer> >  buf_bdry;
+  FaceMatcher matcher;
+  std::vector<Uint> matcher_f2c;
+  std::vector<Uint> matcher_face;
+  for (Uint r=0; r<nb_regions; ++r)
+  {
+    if (is_bdry_region[r])
+      continue;
+
+    boost_foreach(CFaceCellConnectivity& f2c, find_components_recursively_with_tag<CFaceCellConnectivity>(*regions[r],Mesh::Tags::inner_faces()))
     {
-      //std::cout << PERank << "checking interface for " << regions[i]->name() << " to " << regions[j]->name() << std::endl;
+      const Uint f2c_idx = f2cs.size();
+      f2cs.push_back(f2c.as_ptr<CFaceCellConnectivity>());
+      f2c_region.push_back(r);
+      buf_f2c.push_back( boost::shared_ptr<CTable<Uint>::Buffer> ( new CTable<Uint>::Buffer(f2c.connectivity().create_buffer())));
+      buf_fnb.push_back( boost::shared_ptr<CTable<Uint>::Buffer> ( new CTable<Uint>::Buffer(f2c.face_number().create_buffer())));
+      buf_bdry.push_back( boost::shared_ptr<CList<bool>::Buffer> ( new CList<bool>::Buffer(f2c.is_bdry_face().create_buffer())));
+
+      // Faces with two cells are inside the region, and can't match anything else
+      for (Uint f=0; f<f2c.size(); ++f)
+      {
+        if (f2c.is_bdry_face()[f] == false)
+          continue;
+        matcher.add_face(f2c.face_nodes(f));
+        matcher_f2c.push_back(f2c_idx);
+        matcher_face.push_back(f);
+      }
+    }
+  }
+  matcher.match( m_nb_threads != 0 ? m_nb_threads : Comm::PE::instance().nb_threads() );
+
+  // Faces that were matched to a boundary element
+  std::vector<bool> matched_to_bdry(matcher.size(),false);
+
+  // Connect the boundary elements to the cells they are a face of
+  std::vector<Uint> face_nodes;
+  std::vector<Uint> elems(1);
+  for (Uint r=0; r<nb_regions; ++r)
+  {
+    if (!is_bdry_region[r])
+      continue;
 
-      if ( find_components_with_filter<CElements>(*regions[i],IsElementsSurface()).size() != 0 )
+    boost_foreach(CElements& bdry_faces, find_components<CElements>(*regions[r]))
+    {
+      CFaceCellConnectivity::Ptr bdry_face_to_cell = find_component_ptr<CFaceCellConnectivity>(bdry_faces);
+      if (is_null(bdry_face_to_cell))
       {
-        if ( find_components_with_filter<CElements>(*regions[j],IsElementsVolume()).size() !=0 )
-        {
-          //std::cout << PERank << "matching boundary face to cell for " << regions[i]->name() << " to " << regions[j]->name() << std::endl;
+        bdry_face_to_cell = bdry_faces.create_component_ptr<CFaceCellConnectivity>("cell_connectivity");
+        bdry_face_to_cell->configure_option("face_building_algorithm",true);
+      }
+
+      CTable<Uint>& bdry_face_connectivity = bdry_face_to_cell->connectivity();
+      CTable<Uint>& bdry_face_nb = bdry_face_to_cell->face_number();
+      CList<bool>& bdry_face_is_bdry = bdry_face_to_cell->is_bdry_face();
 
-          match_boundary(*regions[i],*regions[j]);
+      bdry_face_connectivity.set_row_size(1);
+      bdry_face_connectivity.resize(bdry_faces.size());
+      bdry_face_nb.resize(bdry_faces.size());
+      bdry_face_is_bdry.resize(bdry_faces.size());
+
+      for (Uint f2c_idx=0; f2c_idx<f2cs.size(); ++f2c_idx)
+      {
+        if (has_volume[f2c_region[f2c_idx]])
+        {
+          boost_foreach(Component::Ptr cells, f2cs[f2c_idx]->used())
+            bdry_face_to_cell->add_used(cells->as_type<CCells>());
         }
       }
-      else if ( find_components_with_filter<CElements>(*regions[j],IsElementsSurface()).size() != 0 )
+
+      Uint local_bdry_face_idx(0);
+      boost_foreach(CConnectivity::ConstRow bdry_face_nodes, bdry_faces.node_connectivity().array())
       {
-        if ( find_components_with_filter<CElements>(*regions[i],IsElementsVolume()).size() !=0 )
+        face_nodes.assign(bdry_face_nodes.begin(),bdry_face_nodes.end());
+        const Uint matched = matcher.find(face_nodes);
+        if (matched != Math::Consts::uint_max() && has_volume[f2c_region[matcher_f2c[matched]]])
         {
-          //std::cout << PERank << "matching boundary face to cell for " << regions[j]->name() << " to " << regions[i]->name() << std::endl;
-
-          match_boundary(*regions[j],*regions[i]);
+          const Uint f2c_idx = matcher_f2c[matched];
+          const Uint inner_face_idx = matcher_face[matched];
+          elems[0] = f2cs[f2c_idx]->connectivity()[inner_face_idx][0];
+
+          // Remove the match from the inner face connectivity and add it to the boundary
+          bdry_face_connectivity.set_row(local_bdry_face_idx,elems);
+          bdry_face_nb[local_bdry_face_idx] = f2cs[f2c_idx]->face_number()[inner_face_idx];
+          bdry_face_is_bdry[local_bdry_face_idx] = true;
+
+          buf_f2c[f2c_idx]->rm_row(inner_face_idx);
+          buf_fnb[f2c_idx]->rm_row(inner_face_idx);
+          buf_bdry[f2c_idx]->rm_row(inner_face_idx);
+          matched_to_bdry[matched] = true;
         }
+        ++local_bdry_face_idx;
       }
-      else
-      {
-        CRegion& interface = parent.create_component<CRegion>("interface_"+regions[i]->name()+"_to_"+regions[j]->name());
-        interface.add_tag( Mesh::Tags::interface() );
+    }
+  }
 
-        //std::cout << PERank << "creating face to cell for interfaces for " << regions[i]->name() << " to " << regions[j]->name() << std::endl;
-        CFaceCellConnectivity::Ptr f2c = match_faces(*regions[i],*regions[j]);
+  // Faces shared by two different regions, for each pair of regions
+  typedef std::map< std::pair<Uint,Uint>, std::vector<Uint> > InterfaceFacesT;
+  InterfaceFacesT interface_faces;
+  for (Uint face=0; face<matcher.size(); ++face)
+  {
+    const Uint matched = matcher.matched_face(face);
+    if (matched == Math::Consts::uint_max() || matched < face || matched_to_bdry[face] || matched_to_bdry[matched])
+      continue;
+
+    const Uint region1 = f2c_region[matcher_f2c[face]];
+    const Uint region2 = f2c_region[matcher_f2c[matched]];
+    if (region1 != region2)
+      interface_faces[std::make_pair(region1,region2)].push_back(face);
+  }
+
+  for (InterfaceFacesT::const_iterator it=interface_faces.begin(); it!=interface_faces.end(); ++it)
+  {
+    CRegion& region1 = *regions[it->first.first];
+    CRegion& region2 = *regions[it->first.second];
+    const std::vector<Uint>& faces = it->second;
+    const Uint nb_faces = faces.size();
+
+    CRegion& interface = parent.create_component<CRegion>("interface_"+region1.name()+"_to_"+region2.name());
+    interface.add_tag( Mesh::Tags::interface() );
 
-        build_face_elements(interface,*f2c,true);
+    CFaceCellConnectivity::Ptr f2c = allocate_component<CFaceCellConnectivity>("interface_connectivity");
+    f2c->configure_option("face_building_algorithm",true);
+    f2c->connectivity().resize(nb_faces);
+    f2c->face_number().resize(nb_faces);
+    f2c->is_bdry_face().resize(nb_faces);
 
+    for (Uint i=0; i<nb_faces; ++i)
+    {
+      const Uint face[2] = { faces[i], matcher.matched_face(faces[i]) };
+      for (Uint side=0; side<2; ++side)
+      {
+        const Uint f2c_idx = matcher_f2c[face[side]];
+        const Uint face_idx = matcher_face[face[side]];
+        f2c->connectivity()[i][side] = f2cs[f2c_idx]->connectivity()[face_idx][0];
+        f2c->face_number()[i][side] = f2cs[f2c_idx]->face_number()[face_idx][0];
+
+        // Remove the match from the inner face connectivity of the region
+        buf_f2c[f2c_idx]->rm_row(face_idx);
+        buf_fnb[f2c_idx]->rm_row(face_idx);
+        buf_bdry[f2c_idx]->rm_row(face_idx);
       }
+      f2c->is_bdry_face()[i] = false;
+    }
 
+    for (Uint f2c_idx=0; f2c_idx<f2cs.size(); ++f2c_idx)
+    {
+      if (f2c_region[f2c_idx] == it->first.first || f2c_region[f2c_idx] == it->first.second)
+      {
+        boost_foreach(Component::Ptr cells, f2cs[f2c_idx]->used())
+          f2c->add_used(cells->as_type<CCells>());
+      }
     }
+
+    build_face_elements(interface,*f2c,true);
+  }
+
+  for (Uint f2c_idx=0; f2c_idx<f2cs.size(); ++f2c_idx)
+  {
+    buf_f2c[f2c_idx]->flush();
+    buf_fnb[f2c_idx]->flush();
+    buf_bdry[f2c_idx]->flush();
   }
 }
 
@@ -166,6 +312,7 @@ void CBuildFaces::build_face_cell_connectivity_bottom_up(Component& parent)
       //std::cout << PERank << "building face_cell connectivity for region " << region.uri().path() << std::endl;
       CFaceCellConnectivity::Ptr face_to_cell = region.create_component_ptr<CFaceCellConnectivity>("face_to_cell");
       face_to_cell->configure_option("face_building_algorithm",true);
+      face_to_cell->configure_option("nb_threads",m_nb_threads);
       face_to_cell->add_tag(Mesh::Tags::inner_faces());
       face_to_cell->setup(region);
     }
@@ -327,320 +474,6 @@ void CBuildFaces::build_face_elements(CRegion& region, CFaceCellConnectivity& fa
 
 ////////////////////////////////////////////////////////////////////////////////
 
-CFaceCellConnectivity::Ptr CBuildFaces::match_faces(CRegion& region1, CRegion& region2)
-{
-  CMesh& mesh = *m_mesh.lock();
-  // interface connectivity
-  CFaceCellConnectivity::Ptr interface = allocate_component<CFaceCellConnectivity>("interface_connectivity");
-  interface->configure_option("face_building_algorithm",true);
-  CTable<Uint>::Buffer i2c = find_component_with_name<CTable<Uint> >(*interface,Mesh::Tags::connectivity_table()).create_buffer();
-  CTable<Uint>::Buffer fnb = find_component_with_name<CTable<Uint> >(*interface,"face_number").create_buffer();
-  CList<bool>::Buffer bdry = find_component_with_name<CList<bool> >(*interface,"is_bdry_face").create_buffer();
-
-  // unified face-cell-connectivity from left and right
-  CUnifiedData::Ptr Ufaces1 = allocate_component<CUnifiedData>("unified_faces1");
-  boost_foreach(CFaceCellConnectivity& inner_f2c, find_components_recursively_with_tag<CFaceCellConnectivity>(region1,Mesh::Tags::inner_faces()))
-    Ufaces1->add(inner_f2c);
-  CUnifiedData::Ptr Ufaces2 = allocate_component<CUnifiedData>("unified_faces2");
-  boost_foreach(CFaceCellConnectivity& inner_f2c, find_components_recursively_with_tag<CFaceCellConnectivity>(region2,Mesh::Tags::inner_faces()))
-    Ufaces2->add(inner_f2c);
-
-  // create buffers for each sub-face_cell_connectivity
-  std::vector<boost::shared_ptr<CTable<Uint>::Buffer> > buf_fnb1;
-  std::vector<boost::shared_ptr<CTable<Uint>::Buffer> > buf_fnb2;
-  std::vector<boost::shared_ptr<CList<bool>::Buffer> >  buf_bdryf1;
-  std::vector<boost::shared_ptr<CList<bool>::Buffer> >  buf_bdryf2;
-  std::vector<boost::shared_ptr<CTable<Uint>::Buffer> > buf_f2c1;
-  std::vector<boost::shared_ptr<CTable<Uint>::Buffer> > buf_f2c2;
-  std::vector<Uint> elems_1_start_idx;
-  std::vector<Uint> elems_2_start_idx;
-  Uint nb_elems(0);
-  boost_foreach(Component::Ptr faces1_comp, Ufaces1->components())
-  {
-    CFaceCellConnectivity& faces1 = faces1_comp->as_type<CFaceCellConnectivity>();
-    elems_1_start_idx.push_back(nb_elems);
-    buf_fnb1.push_back( boost::shared_ptr<CTable<Uint>::Buffer> ( new CTable<Uint>::Buffer(faces1.face_number().create_buffer())));
-    buf_bdryf1.push_back( boost::shared_ptr<CList<bool>::Buffer> ( new CList<bool>::Buffer(faces1.is_bdry_face().create_buffer())));
-    buf_f2c1.push_back( boost::shared_ptr<CTable<Uint>::Buffer> ( new CTable<Uint>::Buffer(faces1.connectivity().create_buffer())));
-    boost_foreach(Component::Ptr cells, faces1.used())
-      interface->add_used(cells->as_type<CCells>());
-    nb_elems += faces1.lookup().size();
-  }
-
-  boost_foreach(Component::Ptr faces2_comp, Ufaces2->components())
-  {
-    CFaceCellConnectivity& faces2 = faces2_comp->as_type<CFaceCellConnectivity>();
-    elems_2_start_idx.push_back(nb_elems);
-    buf_fnb2.push_back( boost::shared_ptr<CTable<Uint>::Buffer> ( new CTable<Uint>::Buffer(faces2.face_number().create_buffer())));
-    buf_bdryf2.push_back( boost::shared_ptr<CList<bool>::Buffer> ( new CList<bool>::Buffer(faces2.is_bdry_face().create_buffer())));
-    buf_f2c2.push_back( boost::shared_ptr<CTable<Uint>::Buffer> ( new CTable<Uint>::Buffer(faces2.connectivity().create_buffer())));
-    boost_foreach(Component::Ptr cells, faces2.used())
-      interface->add_used(cells->as_type<CCells>());
-    nb_elems += faces2.lookup().size();
-  }
-
-  // Build a node to face connectivity matching faces2
-  CNodeFaceCellConnectivity::Ptr node2faces2_ptr = allocate_component<CNodeFaceCellConnectivity>("node2faces");
-  CNodeFaceCellConnectivity& node2faces2 = *node2faces2_ptr;
-  boost_foreach(Component::Ptr f2c, Ufaces2->components())
-    node2faces2.face_cell_connectivity().add(f2c->as_type<CFaceCellConnectivity>()); // it is assumed this is only face types
-  node2faces2.set_nodes(mesh.geometry());
-  node2faces2.build_connectivity();
-
-  Uint f1(0);
-  Uint faces1_idx(0);
-  boost_foreach(Component::Ptr faces1_comp, Ufaces1->components())
-  {
-    CFaceCellConnectivity& faces1 = faces1_comp->as_type<CFaceCellConnectivity>();
-
-    std::vector<Uint> face_nodes;
-    std::vector<Uint> elems(2);
-    enum {LEFT=0,RIGHT=1};
-    Uint nb_matches(0);
-
-
-    for (Uint f1_idx = 0; f1_idx != faces1.size(); ++f1_idx)
-    {
-      face_nodes = faces1.face_nodes(f1);
-      const Uint nb_nodes_per_face = face_nodes.size();
-
-      std::map<Uint,Uint> found_faces;
-      std::map<Uint,Uint>::iterator not_found = found_faces.end();
-
-      bool match_found = false;
-      boost_foreach(const Uint face_node, face_nodes)
-      {
-        boost_foreach(const Uint f2, node2faces2.connectivity()[face_node])
-        {
-          std::map<Uint,Uint>::iterator it = found_faces.find(f2);
-          if ( it == not_found)
-          {
-            found_faces[f2]=1;
-          }
-          else
-          {
-            Uint& nb_faces = it->second;
-            ++nb_faces;
-            if (nb_faces == nb_nodes_per_face)
-            {
-              match_found = true;
-              Uint f2_idx;
-              Uint faces2_idx;
-              boost::tie(faces2_idx,f2_idx) = node2faces2.face_cell_connectivity().location_idx(f2);
-              CFaceCellConnectivity& faces2 = Ufaces2->components()[faces2_idx]->as_type<CFaceCellConnectivity>();
-              elems[LEFT]  = faces1.connectivity()[f1_idx][0] + elems_1_start_idx[faces1_idx];
-              elems[RIGHT] = faces2.connectivity()[f2_idx][0] + elems_2_start_idx[faces2_idx];
-
-              //std::cout << PERank << "match found: " << elems[LEFT] << " <--> " << elems[RIGHT] << std::endl;
-
-              // Remove matches from the 2 connectivity tables and add to the interface
-              i2c.add_row(elems);
-              fnb.add_row(buf_fnb1[faces1_idx]->get_row(f1_idx));
-              bdry.add_row(false);
-
-              buf_f2c1[faces1_idx]->rm_row(f1_idx);
-              buf_fnb1[faces1_idx]->rm_row(f1_idx);
-              buf_bdryf1[faces1_idx]->rm_row(f1_idx);
-              buf_f2c2[faces2_idx]->rm_row(f2_idx);
-              buf_fnb2[faces2_idx]->rm_row(f2_idx);
-              buf_bdryf2[faces2_idx]->rm_row(f2_idx);
-              //
-
-              ++nb_matches;
-              break;
-            }
-          }
-        }
-        if (match_found)
-          break;
-      }
-      ++f1;
-    }
-    ++faces1_idx;
-  }
-
-  return interface;
-}
-
-//////////////////////////////////////////////////////////////////////////////
-
-void CBuildFaces::match_boundary(CRegion& bdry_region, CRegion& inner_region)
-{
-  CMesh& mesh = *m_mesh.lock();
-  // unified face-cell-connectivity
-  CUnifiedData::Ptr unified_inner_faces_to_cells = allocate_component<CUnifiedData>("unified_inner_faces");
-  boost_foreach(CFaceCellConnectivity& f2c, find_components_recursively_with_tag<CFaceCellConnectivity>(inner_region,Mesh::Tags::inner_faces()))
-    unified_inner_faces_to_cells->add(f2c);
-
-  // create buffers for each face_cell_connectivity of unified_inner_faces_to_cells
-  std::vector<boost::shared_ptr<CTable<Uint>::Buffer> >  buf_vec_inner_face_nb;
-  std::vector<boost::shared_ptr<CList<bool>::Buffer> >  buf_vec_inner_face_is_bdry;
-  std::vector<boost::shared_ptr<CTable<Uint>::Buffer> > buf_vec_inner_face_connectivity;
-
-  boost_foreach(Component::Ptr inner_faces_comp, unified_inner_faces_to_cells->components())
-  {
-    CFaceCellConnectivity& inner_faces = inner_faces_comp->as_type<CFaceCellConnectivity>();
-    buf_vec_inner_face_nb.push_back( boost::shared_ptr<CTable<Uint>::Buffer> ( new CTable<Uint>::Buffer(inner_faces.face_number().create_buffer())));
-    buf_vec_inner_face_is_bdry.push_back( boost::shared_ptr<CList<bool>::Buffer> ( new CList<bool>::Buffer(inner_faces.is_bdry_face().create_buffer())));
-    buf_vec_inner_face_connectivity.push_back( boost::shared_ptr<CTable<Uint>::Buffer> ( new CTable<Uint>::Buffer(inner_faces.connectivity().create_buffer())));
-  }
-
-  // Build a node to face connectivity matching faces2
-  CNodeFaceCellConnectivity::Ptr nodes_to_inner_faces_ptr = allocate_component<CNodeFaceCellConnectivity>("node2faces");
-  CNodeFaceCellConnectivity& nodes_to_inner_faces = *nodes_to_inner_faces_ptr;
-  boost_foreach(Component::Ptr inner_f2c, unified_inner_faces_to_cells->components())
-    nodes_to_inner_faces.face_cell_connectivity().add(inner_f2c->as_type<CFaceCellConnectivity>());
-  nodes_to_inner_faces.set_nodes(mesh.geometry());
-  nodes_to_inner_faces.build_connectivity();
-
-  Uint unified_bdry_face_idx(0);
-  boost_foreach(CElements& bdry_faces, find_components<CElements>(bdry_region))
-  {
-    CFaceCellConnectivity::Ptr bdry_face_to_cell = find_component_ptr<CFaceCellConnectivity>(bdry_faces);
-    if (is_null(bdry_face_to_cell))
-    {
-      bdry_face_to_cell = bdry_faces.create_component_ptr<CFaceCellConnectivity>("cell_connectivity");
-      bdry_face_to_cell->configure_option("face_building_algorithm",true);
-    }
-
-    CTable<Uint>& bdry_face_connectivity = bdry_face_to_cell->connectivity();
-    CTable<Uint>& bdry_face_nb = bdry_face_to_cell->face_number();
-    CList<bool>& bdry_face_is_bdry = bdry_face_to_cell->is_bdry_face();
-
-    bdry_face_connectivity.set_row_size(1);
-    bdry_face_connectivity.resize(bdry_faces.size());
-    bdry_face_nb.resize(bdry_faces.size());
-    bdry_face_is_bdry.resize(bdry_faces.size());
-
-    std::vector<Uint> vec_inner_cells_start_idx;
-
-    boost_foreach(Component::Ptr inner_cells_comp, unified_inner_faces_to_cells->components())
-    {
-      CFaceCellConnectivity& inner_face_to_cells = inner_cells_comp->as_type<CFaceCellConnectivity>();
-      boost_foreach(Component::Ptr cells, inner_face_to_cells.used())
-        bdry_face_to_cell->add_used(cells->as_type<CCells>());
-    }
-
-    // initialize a row of size 1, in which connected cells will be stored, and copied into
-    // the bdry_face_connectivity table
-    std::vector<Uint> elems(1);
-
-    // initialize a counter for see if matches are found.
-    // A match is found if every node of a boundary face is also found in an inner_face
-    Uint nb_matches(0);
-
-    Uint local_bdry_face_idx(0);
-    boost_foreach(CConnectivity::ConstRow bdry_face_nodes, bdry_faces.node_connectivity().array())
-    {
-      const Uint nb_nodes_per_face = bdry_face_nodes.size();
-
-
-
-      std::map<Uint,Uint> found_faces;
-      std::map<Uint,Uint>::iterator not_found = found_faces.end();
-
-      bool match_found = false;
-      boost_foreach(const Uint bdry_face_node, bdry_face_nodes)
-      {
-        boost_foreach(const Uint unified_inner_face_idx, nodes_to_inner_faces.connectivity()[bdry_face_node])
-        {
-          std::map<Uint,Uint>::iterator it = found_faces.find(unified_inner_face_idx);
-          if ( it == not_found)
-          {
-            found_faces[unified_inner_face_idx]=1;
-            if (nb_nodes_per_face == 1)
-            {
-              match_found = true;
-
-              CFaceCellConnectivity::Ptr inner_faces_to_cells;
-              Uint inner_faces_comp_idx;
-              Uint inner_face_idx;
-              boost::tie(inner_faces_comp_idx,inner_face_idx) = nodes_to_inner_faces.face_cell_connectivity().location_idx(unified_inner_face_idx);
-              inner_faces_to_cells = unified_inner_faces_to_cells->components()[inner_faces_comp_idx]->as_ptr<CFaceCellConnectivity>();
-              elems[0] = inner_faces_to_cells->connectivity()[inner_face_idx][0];
-
-              //std::cout << PERank << "match found: " << unified_bdry_face_idx << " <--> " << elems[0] << std::endl;
-
-              // Remove matches from the inner_faces_connectivity tables and add to the boundary
-              bdry_face_connectivity.set_row(local_bdry_face_idx,elems);
-              bdry_face_nb[local_bdry_face_idx] = buf_vec_inner_face_nb[inner_faces_comp_idx]->get_row(inner_face_idx);
-              bdry_face_is_bdry[local_bdry_face_idx] = true;
-
-              buf_vec_inner_face_connectivity[inner_faces_comp_idx]->rm_row(inner_face_idx);
-              buf_vec_inner_face_nb[inner_faces_comp_idx]->rm_row(inner_face_idx);
-              buf_vec_inner_face_is_bdry[inner_faces_comp_idx]->rm_row(inner_face_idx);
-
-              ++nb_matches;
-              break;
-            }
-          }
-          else
-          {
-            Uint& nb_faces = it->second;
-            ++nb_faces;
-            if (nb_faces == nb_nodes_per_face)
-            {
-              match_found = true;
-              CFaceCellConnectivity::Ptr inner_faces_to_cells;
-              Uint inner_face_idx;
-              Uint inner_faces_comp_idx;
-              boost::tie(inner_faces_comp_idx,inner_face_idx) = nodes_to_inner_faces.face_cell_connectivity().location_idx(unified_inner_face_idx);
-              inner_faces_to_cells = unified_inner_faces_to_cells->components()[inner_faces_comp_idx]->as_ptr<CFaceCellConnectivity>();
-              elems[0] = inner_faces_to_cells->connectivity()[inner_face_idx][0];
-
-              // ----------- debug -----------
-              //Component::Ptr inner_cell_comp;
-              //Uint inner_cell_idx;
-              //boost::tie(inner_cell_comp,inner_cell_idx) = inner_faces_to_cells->lookup().location(inner_faces_to_cells->connectivity()[inner_face_idx][0]);
-              //std::cout << PERank << "match found: " << bdry_faces.parent().name() << "/" << bdry_faces.name() << "["<<local_bdry_face_idx<<"] <--> " << inner_cell_comp->parent().name()<<"/"<<inner_cell_comp->name()<<"["<<inner_cell_idx<<"]" << std::endl;
-              // -----------------------------
-
-               // RealMatrix cell_coordinates = inner_cell_comp->as_type<CElements>().get_coordinates(inner_cell_idx);
-               // RealVector face_coordinates = bdry_faces.get_coordinates(local_bdry_face_idx).row(0);
-               // bool match_found_double_check = false;
-               // for (Uint i=0; i<cell_coordinates.rows(); ++i)
-               // {
-               //   if (cell_coordinates.row(i) == face_coordinates.transpose())
-               //   {
-               //     match_found_double_check = true;
-               //     break;
-               //   }
-               // }
-               // cf_assert(match_found_double_check);
-
-              // Remove matches from the 2 connectivity tables and add to the interface
-              bdry_face_connectivity.set_row(local_bdry_face_idx,elems);
-              bdry_face_nb[local_bdry_face_idx] = buf_vec_inner_face_nb[inner_faces_comp_idx]->get_row(inner_face_idx);
-              bdry_face_is_bdry[local_bdry_face_idx] = true;
-
-              buf_vec_inner_face_connectivity[inner_faces_comp_idx]->rm_row(inner_face_idx);
-              buf_vec_inner_face_nb[inner_faces_comp_idx]->rm_row(inner_face_idx);
-              buf_vec_inner_face_is_bdry[inner_faces_comp_idx]->rm_row(inner_face_idx);
-
-              ++nb_matches;
-              break;
-            }
-          }
-        }
-        if (match_found)
-          break;
-      }
-      ++unified_bdry_face_idx;
-      ++local_bdry_face_idx;
-    }
-  }
-
-  for (Uint vec_idx=0; vec_idx<buf_vec_inner_face_connectivity.size(); ++vec_idx)
-  {
-    buf_vec_inner_face_connectivity[vec_idx]->flush();
-    buf_vec_inner_face_nb[vec_idx]->flush();
-    buf_vec_inner_face_is_bdry[vec_idx]->flush();
-  }
-
-}
-
-//////////////////////////////////////////////////////////////////////////////
-
 void CBuildFaces::build_cell_face_connectivity(Component& parent)
 {
   Component::Ptr cells;
@@ -53,15 +53,14 @@ public: // functions
   
 private: // functions
  
+  /// Connect the boundary elements to cells and create interface regions between the child regions of parent,
+  /// matching the faces of all child regions in a single pass
   void make_interfaces(Component& parent);
 
   void build_face_cell_connectivity_bottom_up(Component& parent);
   void build_faces_bottom_up(Component& parent);
 
   void build_face_elements(CRegion& in_region, CFaceCellConnectivity& from_face_to_cell, const bool inner);
-    
-  boost::shared_ptr<CFaceCellConnectivity> match_faces(CRegion& region1, CRegion& region2);
-  void match_boundary(CRegion& bdry_region, CRegion& region2);
 
   void build_cell_face_connectivity(Component& parent);
 
@@ -69,6 +68,9 @@ private: // data
 
   bool m_store_cell2face;
 
+  /// Number of threads used to match faces, 0 for the default of the parallel environment
+  Uint m_nb_threads;
+
 }; // end CBuildFaces
 
 
@@ -26,6 +26,7 @@
 #include "Common/MPI/debug.hpp"
 
 #include "Mesh/Actions/CGlobalNumbering.hpp"
+#include "Mesh/Actions/HashDirectory.hpp"
 #include "Mesh/CCellFaces.hpp"
 #include "Mesh/CRegion.hpp"
 #include "Mesh/Geometry.hpp"
@@ -160,18 +161,7 @@ void CGlobalNumbering::execute()
 
   // now renumber
 
-  //------------------------------------------------------------------------------
-  // create node_glb2loc mapping
   Geometry& nodes = mesh.geometry();
-  std::map<std::size_t,Uint> node_glb2loc;
-  Uint loc_node_idx(0);
-  boost_foreach(std::size_t hash, glb_node_hash.data())
-    node_glb2loc[hash]=loc_node_idx++;
-  std::map<std::size_t,Uint>::iterator node_glb2loc_it;
-  std::map<std::size_t,Uint>::iterator hash_not_found = node_glb2loc.end();
-
-  // Check if all nodes have been added to the map
-  cf_assert(loc_node_idx==nodes.size());
 
   //------------------------------------------------------------------------------
   // get tot nb of owned indexes and communicate
@@ -217,60 +207,42 @@ void CGlobalNumbering::execute()
   }
 
   //------------------------------------------------------------------------------
-  // add glb_idx to owned nodes, broadcast/receive glb_idx for ghost nodes
-
-  std::vector<size_t> node_from(nb_owned_nodes);
-  std::vector<Uint>   node_to(nb_owned_nodes);
+  // add glb_idx to owned nodes, look up glb_idx of ghost nodes at the home rank of their hash
 
   CList<Uint>& nodes_glb_idx = mesh.geometry().glb_idx();
   nodes_glb_idx.resize(nodes.size());
 
-  Uint cnt=0;
+  HashDirectory node_directory;
   Uint glb_id = start_id_per_proc[Comm::PE::instance().rank()];
   for (Uint i=0; i<nodes.size(); ++i)
   {
     if ( ! nodes.is_ghost(i) )
     {
       nodes_glb_idx[i] = glb_id++;
-      node_from[cnt] = glb_node_hash.data()[i];
-      node_to[cnt]   = nodes_glb_idx[i];
-      ++cnt;
+      node_directory.add_owned(glb_node_hash.data()[i], nodes_glb_idx[i]);
     }
     else
     {
       nodes_glb_idx[i] = uint_max();
+      node_directory.add_ghost(glb_node_hash.data()[i]);
     }
   }
 
-  for (Uint root=0; root<Comm::PE::instance().size(); ++root)
+  node_directory.resolve();
+
+  Uint ghost_idx(0);
+  for (Uint i=0; i<nodes.size(); ++i)
   {
-    std::vector<std::size_t> rcv_node_from(0);
-    Comm::PE::instance().broadcast(node_from,rcv_node_from,root);
-    std::vector<Uint>        rcv_node_to(0);
-    Comm::PE::instance().broadcast(node_to,rcv_node_to,root);
-    if (Comm::PE::instance().rank() != root)
+    if ( nodes.is_ghost(i) )
     {
-      for (Uint p=0; p<Comm::PE::instance().size(); ++p)
+      if ( node_directory.ghost_glb_idx()[ghost_idx] != uint_max() )
       {
-        if (p == Comm::PE::instance().rank())
-        {
-          Uint rcv_idx(0);
-          boost_foreach(const std::size_t node_hash, rcv_node_from)
-          {
-            node_glb2loc_it = node_glb2loc.find(node_hash);
-            if ( node_glb2loc_it != hash_not_found )
-            {
-              if (m_debug)
-                std::cout << "["<<Comm::PE::instance().rank() << "]  will change node "<< node_glb2loc_it->first << " (" << node_glb2loc_it->second << ") to " << rcv_node_to[rcv_idx] << std::endl;
-              nodes_glb_idx[node_glb2loc_it->second]=rcv_node_to[rcv_idx];
-              cf_assert(nodes.is_ghost(node_glb2loc_it->second));
-              nodes_rank[node_glb2loc_it->second]=root;
-            }
-            ++rcv_idx;
-          }
-          break;
-        }
+        if (m_debug)
+          std::cout << "["<<Comm::PE::instance().rank() << "]  will change node "<< glb_node_hash.data()[i] << " (" << i << ") to " << node_directory.ghost_glb_idx()[ghost_idx] << std::endl;
+        nodes_glb_idx[i] = node_directory.ghost_glb_idx()[ghost_idx];
+        nodes_rank[i] = node_directory.ghost_rank()[ghost_idx];
       }
+      ++ghost_idx;
     }
   }
 
@@ -288,91 +260,58 @@ void CGlobalNumbering::execute()
   }
 
   //------------------------------------------------------------------------------
-  // give glb idx to elements
+  // give glb idx to elements, ghost elements of all entities are looked up together
 
+  HashDirectory elem_directory;
   boost_foreach( CEntities& elements, find_components_recursively<CEntities>(mesh) )
   {
     std::vector<std::size_t>& glb_elem_hash = elements.get_child("glb_elem_hash").as_type<CVector_size_t>().data();
-    CList<Uint>& elem_rank = elements.rank();
-    elem_rank.resize(elements.size());
-
-    //------------------------------------------------------------------------------
-    // create elem_glb2loc mapping
-    Uint nb_owned_elems=0;
-    std::map<std::size_t,Uint> elem_glb2loc;
-    std::map<std::size_t,Uint>::iterator elem_glb2loc_it;
-    std::map<std::size_t,Uint>::iterator hash_not_found = elem_glb2loc.end();
-
-    for (Uint e=0; e<elements.size(); ++e)
-    {
-      elem_glb2loc [ glb_elem_hash[e] ] = e;
-      if ( ! elements.is_ghost(e) )
-        ++nb_owned_elems;
-    }
-
-
-    std::vector<size_t> send_hash(nb_owned_elems);
-    std::vector<Uint>   send_id(nb_owned_elems);
 
     CList<Uint>& elements_glb_idx = elements.glb_idx();
     elements_glb_idx.resize(elements.size());
     cf_assert(glb_elem_hash.size() == elements.size());
 
-    Uint cnt(0);
     for (Uint e=0; e<elements.size(); ++e)
     {
-      if (m_debug)
-        std::cout << "["<<Comm::PE::instance().rank() << "]  will change elem "<< glb_elem_hash[e] << " (" << elements.uri().path() << "["<<e<<"]) to " << glb_id << std::endl;
-
       if ( ! elements.is_ghost(e) )
       {
+        if (m_debug)
+          std::cout << "["<<Comm::PE::instance().rank() << "]  will change elem "<< glb_elem_hash[e] << " (" << elements.uri().path() << "["<<e<<"]) to " << glb_id << std::endl;
         elements_glb_idx[e] = glb_id++;
-        send_hash[cnt] = glb_elem_hash[e];
-        send_id[cnt]   = elements_glb_idx[e];
-        ++cnt;
+        elem_directory.add_owned(glb_elem_hash[e], elements_glb_idx[e]);
       }
       else
       {
         elements_glb_idx[e] = uint_max();
+        elem_directory.add_ghost(glb_elem_hash[e]);
       }
     } // end foreach elem_idx
-    cf_assert(cnt == nb_owned_elems);
+  } // end foreach elements
 
-    for (Uint root=0; root<Comm::PE::instance().size(); ++root)
+  elem_directory.resolve();
+
+  ghost_idx = 0;
+  boost_foreach( CEntities& elements, find_components_recursively<CEntities>(mesh) )
+  {
+    std::vector<std::size_t>& glb_elem_hash = elements.get_child("glb_elem_hash").as_type<CVector_size_t>().data();
+    CList<Uint>& elements_glb_idx = elements.glb_idx();
+    CList<Uint>& elem_rank = elements.rank();
+
+    for (Uint e=0; e<elements.size(); ++e)
     {
-      std::vector<std::size_t> recv_hash(0);
-      Comm::PE::instance().broadcast(send_hash,recv_hash,root);
-      std::vector<Uint>        recv_id(0);
-      Comm::PE::instance().broadcast(send_id,recv_id,root);
-      if (Comm::PE::instance().rank() != root)
+      if ( elements.is_ghost(e) )
       {
-        for (Uint p=0; p<Comm::PE::instance().size(); ++p)
+        if ( elem_directory.ghost_glb_idx()[ghost_idx] != uint_max() )
         {
-          if (p == Comm::PE::instance().rank())
-          {
-            Uint recv_idx(0);
-            boost_foreach(const std::size_t hash, recv_hash)
-            {
-              elem_glb2loc_it = elem_glb2loc.find(hash);
-              if ( elem_glb2loc_it != hash_not_found )
-              {
-                if (m_debug)
-                  std::cout << "["<<Comm::PE::instance().rank() << "]  will change elem "<< elem_glb2loc_it->first << " (" << elem_glb2loc_it->second << ") to " << recv_id[recv_idx] << std::endl;
-                elements_glb_idx[elem_glb2loc_it->second]=recv_id[recv_idx];
-                cf_assert(elements.is_ghost(elem_glb2loc_it->second));
-                elem_rank[elem_glb2loc_it->second]=root;
-              }
-              ++recv_idx;
-            }
-            break;
-          }
+          if (m_debug)
+            std::cout << "["<<Comm::PE::instance().rank() << "]  will change elem "<< glb_elem_hash[e] << " (" << elements.uri().path() << "["<<e<<"]) to " << elem_directory.ghost_glb_idx()[ghost_idx] << std::endl;
+          elements_glb_idx[e] = elem_directory.ghost_glb_idx()[ghost_idx];
+          elem_rank[e] = elem_directory.ghost_rank()[ghost_idx];
         }
+        ++ghost_idx;
       }
-    } // end foreach broadcasting process
-
-
-
-  } // end foreach elements
+    }
+  }
 
 
   // In debug mode, check if no hashes are duplicated
@@ -26,6 +26,7 @@
 #include "Common/MPI/debug.hpp"
 
 #include "Mesh/Actions/CGlobalNumberingElements.hpp"
+#include "Mesh/Actions/HashDirectory.hpp"
 #include "Mesh/CCellFaces.hpp"
 #include "Mesh/CRegion.hpp"
 #include "Mesh/Geometry.hpp"
@@ -146,9 +147,27 @@ void CGlobalNumberingElements::execute()
   //------------------------------------------------------------------------------
   // get tot nb of owned indexes and communicate
 
+  // Ownership is given by the element ranks. If they were never set, all elements are owned by this rank,
+  // and then all of them get a new global index as before ghosts were taken into account.
   Uint tot_nb_owned_ids=0;
   boost_foreach( CEntities& elements, find_components_recursively<CElements>(mesh) )
-    tot_nb_owned_ids += elements.size();
+  {
+    CList<Uint>& elem_rank = elements.rank();
+    if (elem_rank.size() != elements.size())
+    {
+      if (elem_rank.size() != 0)
+        throw SetupError(FromHere(), "Elements "+elements.uri().path()+" have "+to_str(elem_rank.size())+" ranks for "+to_str(elements.size())+" elements");
+      elem_rank.resize(elements.size());
+      for (Uint e=0; e<elements.size(); ++e)
+        elem_rank[e] = Comm::PE::instance().rank();
+    }
+
+    for (Uint e=0; e<elements.size(); ++e)
+    {
+      if ( ! elements.is_ghost(e) )
+        ++tot_nb_owned_ids;
+    }
+  }
 
   std::vector<Uint> nb_ids_per_proc(Comm::PE::instance().size());
   //boost::MPI::communicator world;
@@ -165,7 +184,8 @@ void CGlobalNumberingElements::execute()
 
 
   //------------------------------------------------------------------------------
-  // give glb idx to elements
+  // give glb idx to owned elements, look up glb_idx of ghost elements at the home rank of their hash
+  HashDirectory directory;
   Uint glb_id=start_id_per_proc[Comm::PE::instance().rank()];
   boost_foreach( CEntities& elements, find_components_recursively<CElements>(mesh) )
   {
@@ -175,10 +195,39 @@ void CGlobalNumberingElements::execute()
     cf_assert(glb_elem_hash.size() == elements.size());
     for (Uint e=0; e<elements.size(); ++e)
     {
-      if (m_debug)
-        std::cout << "["<<Comm::PE::instance().rank() << "]  will change elem "<< glb_elem_hash[e] << " (" << elements.uri().path() << "["<<e<<"]) to " << glb_id << std::endl;
-      elements_glb_idx[e] = glb_id;
-      ++glb_id;
+      if ( ! elements.is_ghost(e) )
+      {
+        if (m_debug)
+          std::cout << "["<<Comm::PE::instance().rank() << "]  will change elem "<< glb_elem_hash[e] << " (" << elements.uri().path() << "["<<e<<"]) to " << glb_id << std::endl;
+        elements_glb_idx[e] = glb_id++;
+        directory.add_owned(glb_elem_hash[e], elements_glb_idx[e]);
+      }
+      else
+      {
+        directory.add_ghost(glb_elem_hash[e]);
+      }
+    }
+  }
+
+  directory.resolve();
+
+  Uint ghost_idx=0;
+  boost_foreach( CEntities& elements, find_components_recursively<CElements>(mesh) )
+  {
+    CList<Uint>& elements_glb_idx = elements.glb_idx();
+    CList<Uint>& elem_rank = elements.rank();
+    const std::vector<std::size_t>& glb_elem_hash = elements.get_child("glb_elem_hash").as_type<CVector_size_t>().data();
+    for (Uint e=0; e<elements.size(); ++e)
+    {
+      if ( elements.is_ghost(e) )
+      {
+        if ( directory.ghost_glb_idx()[ghost_idx] == uint_max() )
+          throw ValueNotFound(FromHere(), "Ghost elem "+elements.uri().path()+"["+to_str(e)+"] with hash "+to_str(glb_elem_hash[e])
+                                          +" is not owned by rank "+to_str(elem_rank[e])+" or any other rank");
+        elements_glb_idx[e] = directory.ghost_glb_idx()[ghost_idx];
+        elem_rank[e] = directory.ghost_rank()[ghost_idx];
+        ++ghost_idx;
+      }
     }
   }
 
@@ -34,6 +34,9 @@ namespace Actions {
 /// - id 25 must belong to process 3
 /// - id 12 must belong to process 2
 /// - ...
+/// Only owned elements are numbered, according to the element ranks. Ghost elements get the global index
+/// and rank of the owning element, found by hash; a ghost without owner is an error.
+/// Elements without ranks are all owned by the current process.
 /// @author Willem Deconinck
 class Mesh_Actions_API CGlobalNumberingElements : public CMeshTransformer
 {
@@ -26,6 +26,7 @@
 #include "Common/MPI/debug.hpp"
 
 #include "Mesh/Actions/CGlobalNumberingNodes.hpp"
+#include "Mesh/Actions/HashDirectory.hpp"
 #include "Mesh/CCellFaces.hpp"
 #include "Mesh/CRegion.hpp"
 #include "Mesh/Geometry.hpp"
@@ -134,16 +135,6 @@ void CGlobalNumberingNodes::execute()
 
   // now renumber
 
-  //------------------------------------------------------------------------------
-  // create node_glb2loc mapping
-  std::map<std::size_t,Uint> node_glb2loc;
-  Uint loc_node_idx(0);
-  boost_foreach(std::size_t hash, glb_node_hash.data())
-    node_glb2loc[hash]=loc_node_idx++;
-  std::map<std::size_t,Uint>::iterator node_glb2loc_it;
-  std::map<std::size_t,Uint>::iterator hash_not_found = node_glb2loc.end();
-
-
   //------------------------------------------------------------------------------
   // get tot nb of owned indexes and communicate
 
@@ -184,60 +175,41 @@ void CGlobalNumberingNodes::execute()
 
 
   //------------------------------------------------------------------------------
-  // add glb_idx to owned nodes, broadcast/receive glb_idx for ghost nodes
-
-  std::vector<size_t> node_from(nodes.size()-nb_ghost);
-  std::vector<Uint>   node_to(nodes.size()-nb_ghost);
+  // add glb_idx to owned nodes, look up glb_idx of ghost nodes at the home rank of their hash
 
   CList<Uint>& nodes_glb_idx = mesh.geometry().glb_idx();
   nodes_glb_idx.resize(nodes.size());
 
-  Uint cnt=0;
+  HashDirectory directory;
   Uint glb_id = start_id_per_proc[Comm::PE::instance().rank()];
   for (Uint i=0; i<nodes.size(); ++i)
   {
     if ( ! nodes.is_ghost(i) )
     {
       nodes_glb_idx[i] = glb_id++;
-      node_from[cnt] = glb_node_hash.data()[i];
-      node_to[cnt]   = nodes_glb_idx[i];
-      ++cnt;
+      directory.add_owned(glb_node_hash.data()[i], nodes_glb_idx[i]);
+    }
+    else
+    {
+      directory.add_ghost(glb_node_hash.data()[i]);
     }
   }
 
-  for (Uint root=0; root<Comm::PE::instance().size(); ++root)
+  directory.resolve();
+
+  Uint ghost_idx(0);
+  for (Uint i=0; i<nodes.size(); ++i)
   {
-    //std::vector<std::size_t> rcv_node_from = MPI::broadcast(node_from, root);
-    //std::vector<Uint>        rcv_node_to   = MPI::broadcast(node_to, root);
-    // PECheckPoint(100,"001");
-    std::vector<std::size_t> rcv_node_from(0);//node_from.size());
-    Comm::PE::instance().broadcast(node_from,rcv_node_from,root);
-    //PECheckPoint(100,"002");
-    std::vector<Uint>        rcv_node_to(0);//node_to.size());
-    Comm::PE::instance().broadcast(node_to,rcv_node_to,root);
-    //PECheckPoint(100,"003");
-    if (Comm::PE::instance().rank() != root)
+    if ( nodes.is_ghost(i) )
     {
-      for (Uint p=0; p<Comm::PE::instance().size(); ++p)
+      if ( directory.ghost_glb_idx()[ghost_idx] != uint_max() )
       {
-        if (p == Comm::PE::instance().rank())
-        {
-          Uint rcv_idx(0);
-          boost_foreach(const std::size_t node_hash, rcv_node_from)
-          {
-            node_glb2loc_it = node_glb2loc.find(node_hash);
-            if ( node_glb2loc_it != hash_not_found )
-            {
-              if (m_debug)
-                std::cout << "["<<Comm::PE::instance().rank() << "]  will change node "<< node_glb2loc_it->first << " (" << node_glb2loc_it->second << ") to " << rcv_node_to[rcv_idx] << std::endl;
-              nodes_glb_idx[node_glb2loc_it->second]=rcv_node_to[rcv_idx];
-              nodes_rank[node_glb2loc_it->second]=root;
-            }
-            ++rcv_idx;
-          }
-          break;
-        }
+        if (m_debug)
+          std::cout << "["<<Comm::PE::instance().rank() << "]  will change node "<< glb_node_hash.data()[i] << " (" << i << ") to " << directory.ghost_glb_idx()[ghost_idx] << std::endl;
+        nodes_glb_idx[i] = directory.ghost_glb_idx()[ghost_idx];
+        nodes_rank[i] = directory.ghost_rank()[ghost_idx];
       }
+      ++ghost_idx;
     }
   }
 
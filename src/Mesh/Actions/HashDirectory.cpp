@@ -0,0 +1,191 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <algorithm>
+
+#include "Common/Foreach.hpp"
+#include "Common/MPI/PE.hpp"
+
+#include "Math/Consts.hpp"
+
+#include "Mesh/Actions/HashDirectory.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace CF {
+namespace Mesh {
+namespace Actions {
+
+  using namespace Common;
+  using namespace Math::Consts;
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace detail
+{
+  /// Directory entry, stored at the home rank of the hash
+  struct DirectoryEntry
+  {
+    std::size_t hash;
+    Uint glb_idx;
+    Uint rank;
+  };
+
+  /// Order directory entries on their hash
+  struct DirectoryEntryLess
+  {
+    bool operator()(const DirectoryEntry& a, const DirectoryEntry& b) const { return a.hash < b.hash; }
+    bool operator()(const DirectoryEntry& a, const std::size_t b) const { return a.hash < b; }
+  };
+
+  /// Start of the data for each rank, in a buffer with nb_items[rank] items per rank
+  std::vector<int> displacements(const std::vector<int>& nb_items)
+  {
+    std::vector<int> result(nb_items.size(), 0);
+    for (Uint p=1; p<nb_items.size(); ++p)
+      result[p] = result[p-1] + nb_items[p-1];
+    return result;
+  }
+
+  /// Send the items in send, grouped per destination rank with send_n[rank] items each,
+  /// and receive the items sent to this rank into recv. If recv_n does not have an entry
+  /// for each rank, the number of received items is communicated first.
+  template <typename T>
+  void exchange(const std::vector<T>& send, const std::vector<int>& send_n, std::vector<T>& recv, std::vector<int>& recv_n, const int stride=1)
+  {
+    if ( Comm::PE::instance().is_active() )
+    {
+      recv.clear();
+      if (recv_n.size() != send_n.size())
+        recv_n.assign(send_n.size(), -1);
+      Comm::PE::instance().all_to_all(send, send_n, recv, recv_n, stride);
+    }
+    else
+    {
+      recv = send;
+      recv_n = send_n;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void HashDirectory::add_owned(const std::size_t hash, const Uint glb_idx)
+{
+  m_owned_hash.push_back(hash);
+  m_owned_glb_idx.push_back(glb_idx);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void HashDirectory::add_ghost(const std::size_t hash)
+{
+  m_ghost_hash.push_back(hash);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void HashDirectory::resolve()
+{
+  const Uint nb_procs = Comm::PE::instance().is_active() ? Comm::PE::instance().size() : 1u;
+
+  //------------------------------------------------------------------------------
+  // register the owned entities at their home rank, as (hash, glb_idx) pairs
+
+  std::vector<int> send_n(nb_procs, 0);
+  boost_foreach(const std::size_t hash, m_owned_hash)
+    ++send_n[home_rank(hash, nb_procs)];
+
+  std::vector<int> send_pos = detail::displacements(send_n);
+  std::vector<std::size_t> send_owned(2*m_owned_hash.size());
+  for (Uint i=0; i<m_owned_hash.size(); ++i)
+  {
+    const int pos = send_pos[home_rank(m_owned_hash[i], nb_procs)]++;
+    send_owned[2*pos]   = m_owned_hash[i];
+    send_owned[2*pos+1] = m_owned_glb_idx[i];
+  }
+
+  std::vector<std::size_t> recv_owned;
+  std::vector<int> recv_n;
+  detail::exchange(send_owned, send_n, recv_owned, recv_n, 2);
+
+  // the directory part this rank is home to, sorted on hash for lookup
+  std::vector<detail::DirectoryEntry> directory(recv_owned.size()/2);
+  Uint entry_idx=0;
+  for (Uint p=0; p<nb_procs; ++p)
+  {
+    for (int i=0; i<recv_n[p]; ++i, ++entry_idx)
+    {
+      directory[entry_idx].hash    = recv_owned[2*entry_idx];
+      directory[entry_idx].glb_idx = static_cast<Uint>(recv_owned[2*entry_idx+1]);
+      directory[entry_idx].rank    = p;
+    }
+  }
+  std::sort(directory.begin(), directory.end(), detail::DirectoryEntryLess());
+
+  //------------------------------------------------------------------------------
+  // query the home rank of each ghost
+
+  send_n.assign(nb_procs, 0);
+  boost_foreach(const std::size_t hash, m_ghost_hash)
+    ++send_n[home_rank(hash, nb_procs)];
+
+  send_pos = detail::displacements(send_n);
+  std::vector<int> query_pos(m_ghost_hash.size());
+  std::vector<std::size_t> send_query(m_ghost_hash.size());
+  for (Uint i=0; i<m_ghost_hash.size(); ++i)
+  {
+    query_pos[i] = send_pos[home_rank(m_ghost_hash[i], nb_procs)]++;
+    send_query[query_pos[i]] = m_ghost_hash[i];
+  }
+
+  std::vector<std::size_t> recv_query;
+  std::vector<int> recv_query_n;
+  detail::exchange(send_query, send_n, recv_query, recv_query_n);
+
+  //------------------------------------------------------------------------------
+  // answer the queries with (glb_idx, rank) pairs, in the order they were received
+
+  std::vector<Uint> send_reply(2*recv_query.size());
+  for (Uint i=0; i<recv_query.size(); ++i)
+  {
+    std::vector<detail::DirectoryEntry>::const_iterator entry =
+        std::lower_bound(directory.begin(), directory.end(), recv_query[i], detail::DirectoryEntryLess());
+    if (entry != directory.end() && entry->hash == recv_query[i])
+    {
+      send_reply[2*i]   = entry->glb_idx;
+      send_reply[2*i+1] = entry->rank;
+    }
+    else
+    {
+      send_reply[2*i]   = uint_max();
+      send_reply[2*i+1] = uint_max();
+    }
+  }
+
+  // the number of replies from each rank is the number of queries sent to it
+  std::vector<Uint> recv_reply;
+  std::vector<int> recv_reply_n(send_n);
+  detail::exchange(send_reply, recv_query_n, recv_reply, recv_reply_n, 2);
+
+  m_ghost_glb_idx.resize(m_ghost_hash.size());
+  m_ghost_rank.resize(m_ghost_hash.size());
+  for (Uint i=0; i<m_ghost_hash.size(); ++i)
+  {
+    m_ghost_glb_idx[i] = recv_reply[2*query_pos[i]];
+    m_ghost_rank[i]    = recv_reply[2*query_pos[i]+1];
+  }
+
+  m_owned_hash.clear();
+  m_owned_glb_idx.clear();
+  m_ghost_hash.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // Actions
+} // Mesh
+} // CF
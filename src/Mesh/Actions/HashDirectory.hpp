@@ -0,0 +1,86 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef CF_Mesh_HashDirectory_hpp
+#define CF_Mesh_HashDirectory_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+
+#include "Common/CF.hpp"
+
+#include "Mesh/Actions/LibActions.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace CF {
+namespace Mesh {
+namespace Actions {
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// @brief Distributed directory to find the global index and owner of ghost entities
+///
+/// Entities are identified by a hash. Each hash has a home rank (hash % nb_procs),
+/// which holds the global index and owning rank for all hashes it is home to.
+/// Owners register their entities at the home rank, and ghosts query it, so
+/// that communication and memory per rank scale with the number of local
+/// entities rather than the global number of entities.
+///
+/// Usage:
+/// @code
+/// HashDirectory directory;
+/// directory.add_owned(hash_a, glb_idx_a);
+/// directory.add_ghost(hash_b);
+/// directory.resolve(); // collective
+/// directory.ghost_glb_idx()[0]; // global index of hash_b, uint_max() if not found
+/// @endcode
+class Mesh_Actions_API HashDirectory
+{
+public: // functions
+
+  /// Register an entity owned by this rank
+  void add_owned(const std::size_t hash, const Uint glb_idx);
+
+  /// Register a ghost entity that needs its global index and owner resolved
+  void add_ghost(const std::size_t hash);
+
+  /// Register the owned entities at their home rank and look up the ghost entities.
+  /// This is a collective operation, and clears the registered entities afterwards.
+  void resolve();
+
+  /// Global index of each ghost, in the order they were added. uint_max() if not found.
+  const std::vector<Uint>& ghost_glb_idx() const { return m_ghost_glb_idx; }
+
+  /// Owning rank of each ghost, in the order they were added. uint_max() if not found.
+  const std::vector<Uint>& ghost_rank() const { return m_ghost_rank; }
+
+private: // functions
+
+  /// Rank that holds the directory entry for the given hash
+  Uint home_rank(const std::size_t hash, const Uint nb_procs) const { return hash % nb_procs; }
+
+private: // data
+
+  std::vector<std::size_t> m_owned_hash;
+  std::vector<Uint> m_owned_glb_idx;
+  std::vector<std::size_t> m_ghost_hash;
+
+  std::vector<Uint> m_ghost_glb_idx;
+  std::vector<Uint> m_ghost_rank;
+
+}; // end HashDirectory
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // Actions
+} // Mesh
+} // CF
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // CF_Mesh_HashDirectory_hpp
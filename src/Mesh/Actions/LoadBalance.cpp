@@ -7,6 +7,9 @@
 
 #include "Common/CBuilder.hpp"
 #include "Common/Log.hpp"
+#include "Common/OptionT.hpp"
+#include "Common/Foreach.hpp"
+#include "Common/FindComponents.hpp"
 
 #include "Common/MPI/PE.hpp"
 
@@ -44,6 +47,14 @@ LoadBalance::LoadBalance( const std::string& name )
   add_static_component(*m_partitioner);
 
   m_partitioner->configure_option("graph_package", std::string("PHG"));
+
+  m_options.add_option< OptionT<bool> >("use_weights", false)
+      ->description("Weight the elements by the cost measured during the element loops")
+      ->pretty_name("Use Weights");
+
+  m_options.add_option< OptionT<std::string> >("approach", std::string("PARTITION"))
+      ->description("PARTITION to partition from scratch, REPARTITION to rebalance an already distributed mesh")
+      ->pretty_name("Approach");
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -70,8 +81,14 @@ void LoadBalance::execute()
 
 
     CFinfo << "  + partitioning and migrating" << CFendl;
+    m_partitioner->configure_option("use_weights", m_options["use_weights"].value<bool>());
+    m_partitioner->configure_option("approach", m_options["approach"].value<std::string>());
     m_partitioner->transform(mesh);
 
+    // measured costs refer to the elements before migration
+    boost_foreach(CEntities& entities, find_components_recursively<CEntities>(mesh.topology()))
+      entities.reset_cost();
+
     CFinfo << "  + growing overlap layer" << CFendl;
     build_component_abstract_type<CMeshTransformer>("CF.Mesh.Actions.GrowOverlap","grow_overlap")->transform(mesh);
 
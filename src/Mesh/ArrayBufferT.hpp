@@ -9,7 +9,9 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
 #include <deque>
+#include <vector>
 
 #include <boost/foreach.hpp>
 
@@ -30,8 +32,9 @@ namespace Mesh {
 /// This class allows to interface this table by using a buffer.
 ///
 /// The idea is to add and remove rows from the table through this buffer.
-/// The table is resized when the buffer is full, and values are copied from
-/// the buffer into the table.
+/// Added rows are stored in a single arena that grows geometrically, starting
+/// from the buffer size. On flush, the table is resized once and the rows are
+/// copied from the arena into the table.
 ///
 /// First entry that is removed from the array using rm_row(), will also be the first to be filled
 /// when non-empty buffers are flushed. So in order of removal.
@@ -58,21 +61,25 @@ public: // typedef
 
 private:
 
-  struct Buffer
+  struct Arena
   {
-    Buffer() {}
-    Buffer(const Uint size, const Uint nb_cols) { resize(size,nb_cols); }
+    Arena() : nb_used(0) {}
     Array_t rows;
     std::vector<bool> is_not_empty;
-    void resize(const Uint size, const Uint nb_cols)
+    /// number of rows handed out by add_row
+    Uint nb_used;
+    /// grow to at least min_size rows, or double the size, keeping the contents
+    void grow(const Uint min_size, const Uint nb_cols)
     {
-      rows.resize(boost::extents[size][nb_cols]);
-      is_not_empty.resize(size);
-      is_not_empty.assign(size,false);
+      const Uint new_size = std::max(min_size, 2*size());
+      rows.resize(boost::extents[new_size][nb_cols]);
+      is_not_empty.resize(new_size,false);
     }
-    void reset()
+    void clear(const Uint nb_cols)
     {
-      is_not_empty.assign(size(),false);
+      rows.resize(boost::extents[0][nb_cols]);
+      is_not_empty.clear();
+      nb_used = 0;
     }
     Uint size() const { return rows.size(); }
   };
@@ -99,11 +106,11 @@ public: // functions
   /// 2 cases:
   /// - Array has to expand
   ///   - resize array
-  ///   - copy all non-empty buffer entries in sequence to array entries marked to be removed (first one removed, is first one refilled)
-  ///   - copy all non-empty buffer entries in sequence to array entries in the expanded part
+  ///   - copy all non-empty arena entries in sequence to array entries marked to be removed (first one removed, is first one refilled)
+  ///   - copy all non-empty arena entries in sequence to array entries in the expanded part
   /// - Array has to shrink
-  ///   - copy all non-empty buffer entries in sequence to array entries marked to be removed (lower indices first)
-  ///   - swap entries in the array starting from the index old_array_size to remaining empty array entries in the new array
+  ///   - copy all non-empty arena entries in sequence to array entries marked to be removed (first one removed, is first one refilled)
+  ///   - in one pass, move entries from index new_size onwards into the remaining empty array entries below new_size
   ///   - resize array
 
   void flush();
@@ -140,39 +147,28 @@ public: // functions
   /// @return the array that the buffer operates on
   Array_t& get_appointed() {return m_array;}
 
-  /// @return total number of allocated rows, including all buffers and the array
-  Uint total_allocated();
+  /// @return total number of allocated rows, including the arena and the array
+  Uint total_allocated() const { return m_array.size() + m_arena.size(); }
 
-  /// @return the number of buffers that are created
-  Uint buffers_count() const { return m_buffers.size(); }
+  /// @return the number of buffers that are created, 1 if the arena is allocated
+  Uint buffers_count() const { return m_arena.size() ? 1u : 0u; }
 
   /// increase the size of the array, only to be used when going to write directly in array
   void increase_array_size(const size_t increase);
 
 private: // functions
 
-  /// Create a new buffer, allocate it with m_buffersize, and fill m_new_buffer_rows with the new ones.
-  void add_buffer();
-
   bool is_array_row_empty(const Uint row) const
   {
-    return (std::find(m_empty_array_rows.begin(),m_empty_array_rows.end(),row) != m_empty_array_rows.end());
+    return row < m_is_empty_array_row.size() && m_is_empty_array_row[row];
   }
 
   void reset()
   {
-    m_buffers.resize(0);
-    m_new_buffer_rows.clear();
-//    Uint idx = m_array.size();
-//    BOOST_FOREACH(Buffer& buffer, m_buffers)
-//    {
-//       buffer.reset();
-//       m_new_buffer_rows.push_back(idx++);
-//    }
-
+    m_arena.clear(m_nbCols);
     m_new_array_rows.clear();
     m_empty_array_rows.clear();
-    m_empty_buffer_rows.clear();
+    m_is_empty_array_row.clear();
   }
 
   std::string string();
@@ -185,25 +181,22 @@ private: // data
   /// the number of columns of the array
   Uint m_nbCols;
 
-  /// The size newly created buffers will have
+  /// The size the arena is first allocated with
   /// @note it is safe to change in the middle of buffer operations
   Uint m_buffersize;
 
-  /// vector of temporary buffers
-  std::vector<Buffer> m_buffers;
+  /// storage of the rows added to the buffer, indexed from the array size onwards
+  Arena m_arena;
 
-  /// storage of removed array rows
+  /// storage of removed array rows, in order of removal
   std::deque<Uint> m_empty_array_rows;
 
+  /// flags marking removed array rows, for constant time lookup
+  std::vector<bool> m_is_empty_array_row;
+
   /// storage of array rows where rows can be added directly using add_row_directly
   std::deque<Uint> m_new_array_rows;
 
-  /// storage of removed buffer rows
-  std::deque<Uint> m_empty_buffer_rows;
-
-  /// storage of buffer rows where rows can be added
-  std::deque<Uint> m_new_buffer_rows;
-
 }; // ConnectivityTable
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -227,90 +220,67 @@ ArrayBufferT<T>::~ArrayBufferT()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-template<typename T>
-inline Uint ArrayBufferT<T>::total_allocated()
-{
-  Uint allocated=m_array.size();
-  BOOST_FOREACH(const Buffer& buffer, m_buffers)
-    allocated += buffer.size();
-  return allocated;
-}
-
-////////////////////////////////////////////////////////////////////////////////
-
 template<typename T>
 void ArrayBufferT<T>::flush()
 {
+  const Uint old_array_size = m_array.size();
 
-  // get total number of allocated rows
-  Uint allocated_size = total_allocated();
-  Uint old_array_size = m_array.size();
+  // get number of non-empty rows in the arena
+  Uint nb_arena_rows = 0;
+  for (Uint row_idx=0; row_idx<m_arena.size(); ++row_idx)
+    if (m_arena.is_not_empty[row_idx])
+      ++nb_arena_rows;
 
-  // get total number of empty rows
-  Uint nb_emptyRows = m_empty_array_rows.size() + m_empty_buffer_rows.size() + m_new_buffer_rows.size();
-  Uint new_size = allocated_size-nb_emptyRows;
+  const Uint new_size = old_array_size - m_empty_array_rows.size() + nb_arena_rows;
 
   if (new_size > old_array_size)
   {
-    // make m_array bigger
+    // make m_array bigger, in one go
     m_array.resize(boost::extents[new_size][m_nbCols]);
 
-    // copy each buffer into the array
+    // copy the arena into the array
     Uint array_idx=old_array_size;
-    BOOST_FOREACH (Buffer& buffer, m_buffers)
+    for (Uint row_idx=0; row_idx<m_arena.size(); ++row_idx)
     {
-      for (Uint row_idx=0; row_idx<buffer.size(); ++row_idx)
+      if (m_arena.is_not_empty[row_idx])   // for each non-empty row in the arena
       {
-        SubArray_t row = buffer.rows[row_idx];
-        if (buffer.is_not_empty[row_idx])   // for each non-empty row from all buffers
+        // first find empty rows inside the old part array
+        if (!m_empty_array_rows.empty())
+        {
+          m_array[m_empty_array_rows.front()] = m_arena.rows[row_idx];
+          m_empty_array_rows.pop_front();
+        }
+        else // then select the new array rows to be filled
         {
-          // first find empty rows inside the old part array
-          if (!m_empty_array_rows.empty())
-          {
-            SubArray_t empty_array_row = get_row(m_empty_array_rows.front());
-            m_empty_array_rows.pop_front();
-            empty_array_row = row;
-          }
-          else // then select the new array rows to be filled
-          {
-            cf_assert(array_idx < m_array.size());
-            SubArray_t empty_array_row=m_array[array_idx++];
-            empty_array_row = row;
-          }
+          cf_assert(array_idx < m_array.size());
+          m_array[array_idx++] = m_arena.rows[row_idx];
         }
       }
     }
   }
   else // More rows to be removed than added, now we need to swap rows
   {
-    // copy all buffer rows in the m_array
-    BOOST_FOREACH (Buffer& buffer, m_buffers)
+    // copy all arena rows in the m_array
+    for (Uint row_idx=0; row_idx<m_arena.size(); ++row_idx)
     {
-      for (Uint row_idx=0; row_idx<buffer.size(); ++row_idx)
+      if (m_arena.is_not_empty[row_idx])   // for each non-empty row in the arena
       {
-        SubArray_t row = buffer.rows[row_idx];
-        if (buffer.is_not_empty[row_idx])   // for each non-empty row from all buffers
-        {
-          Uint empty_array_row_idx = m_empty_array_rows.front();
-          m_empty_array_rows.pop_front();
-          SubArray_t empty_array_row = get_row(empty_array_row_idx);
-          empty_array_row = row;
-        }
+        const Uint empty_array_row_idx = m_empty_array_rows.front();
+        m_empty_array_rows.pop_front();
+        m_is_empty_array_row[empty_array_row_idx] = false;
+        m_array[empty_array_row_idx] = m_arena.rows[row_idx];
       }
     }
-    Uint full_row_idx = new_size;
-    // The part of the table with rows > new_size will be deallocated
+
+    // The part of the table with rows >= new_size will be deallocated
     // The empty rows from the allocated part must be swapped with filled
-    // rows from the part that will be deallocated
-    Uint nb_empty_rows = m_empty_array_rows.size();
-    for (Uint e=0; e<nb_empty_rows; ++e)
+    // rows from the part that will be deallocated, which is done in one pass
+    Uint full_row_idx = new_size;
+    BOOST_FOREACH(const Uint empty_row_idx, m_empty_array_rows)
     {
-      Uint empty_row_idx = m_empty_array_rows[e];
       // swap only necessary if the empty row is in the allocated part
       if (empty_row_idx < new_size)
       {
-        // swap this empty row with a full one in the part that will be deallocated
-
         // 1) find next full row
         cf_assert(full_row_idx<m_array.size());
         while(is_array_row_empty(full_row_idx))
@@ -320,7 +290,6 @@ void ArrayBufferT<T>::flush()
         }
 
         // 2) swap them
-        cf_assert(empty_row_idx<m_array.size());
         m_array[empty_row_idx] = m_array[full_row_idx];
         full_row_idx++;
       }
@@ -330,7 +299,7 @@ void ArrayBufferT<T>::flush()
     m_array.resize(boost::extents[new_size][m_nbCols]);
   }
 
-  // clear all buffers
+  // clear the arena
   reset();
 }
 
@@ -339,21 +308,12 @@ void ArrayBufferT<T>::flush()
 template<typename T>
 inline typename ArrayBufferT<T>::SubArray_t ArrayBufferT<T>::get_row(const Uint idx)
 {
-  Uint cummulative_size = m_array.size();
-  if (idx < cummulative_size)
-  {
+  const Uint array_size = m_array.size();
+  if (idx < array_size)
     return m_array[idx];
-  }
-  else
-  {
-    BOOST_FOREACH(Buffer& buffer, m_buffers)
-    {
-      if (idx<cummulative_size+buffer.size())
-        return buffer.rows[idx-cummulative_size];
-      cummulative_size += buffer.size();
-    }
-  }
-  throw Common::BadValue(FromHere(),"Trying to access index that is not allocated: ["+Common::to_str(idx)+">="+Common::to_str(cummulative_size)+"]");
+  if (idx < array_size + m_arena.size())
+    return m_arena.rows[idx-array_size];
+  throw Common::BadValue(FromHere(),"Trying to access index that is not allocated: ["+Common::to_str(idx)+">="+Common::to_str(total_allocated())+"]");
   return m_array[0];
 }
 
@@ -371,29 +331,16 @@ inline void ArrayBufferT<T>::increase_array_size(const size_t increase)
   }
 }
 
-//////////////////////////////////////////////////////////////////////
-
-template<typename T>
-inline void ArrayBufferT<T>::add_buffer()
-{
-  Uint idx = total_allocated();
-  m_buffers.push_back(Buffer(m_buffersize,m_nbCols));
-  for (Uint i=0; i<m_buffersize; ++i)
-    m_new_buffer_rows.push_back(idx++);
-  cf_assert(total_allocated()==idx);
-}
-
 //////////////////////////////////////////////////////////////////////////////
 
 template<typename T>
 template<typename vectorType>
 inline Uint ArrayBufferT<T>::add_row(const vectorType& row)
 {
-  if (m_new_buffer_rows.empty())
-    add_buffer(); // will make a whole lot of new new_buffer_rows
-  Uint idx = m_new_buffer_rows.front();
+  if (m_arena.nb_used == m_arena.size())
+    m_arena.grow(m_buffersize,m_nbCols);
+  const Uint idx = m_array.size() + m_arena.nb_used++;
   set_row(idx,row);
-  m_new_buffer_rows.pop_front();
   return idx;
 }
 
@@ -417,27 +364,25 @@ template<typename vectorType>
 inline void ArrayBufferT<T>::set_row(const Uint array_idx, const vectorType& row)
 {
   cf_assert(row.size() == m_nbCols);
-  Uint cummulative_size = m_array.size();
-  if (array_idx < cummulative_size)
+  const Uint array_size = m_array.size();
+  if (array_idx < array_size)
   {
     for (Uint i=0; i<row.size(); ++i)
       m_array[array_idx][i] = row[i];
-    m_empty_array_rows.erase(std::find(m_empty_array_rows.begin(),m_empty_array_rows.end(),array_idx));
+    if (is_array_row_empty(array_idx))
+    {
+      m_is_empty_array_row[array_idx] = false;
+      m_empty_array_rows.erase(std::find(m_empty_array_rows.begin(),m_empty_array_rows.end(),array_idx));
+    }
     return;
   }
-  else
+  else if (array_idx < array_size + m_arena.size())
   {
-    BOOST_FOREACH(Buffer& buffer, m_buffers)
-    {
-      if (array_idx<cummulative_size+buffer.size())
-      {
-        for (Uint i=0; i<row.size(); ++i)
-          buffer.rows[array_idx-cummulative_size][i]=row[i];
-        buffer.is_not_empty[array_idx-cummulative_size]=true;
-        return;
-      }
-      cummulative_size += buffer.size();
-    }
+    const Uint arena_idx = array_idx-array_size;
+    for (Uint i=0; i<row.size(); ++i)
+      m_arena.rows[arena_idx][i]=row[i];
+    m_arena.is_not_empty[arena_idx]=true;
+    return;
   }
   throw Common::BadValue(FromHere(),"Trying to access index that is not allocated");
 }
@@ -447,25 +392,22 @@ inline void ArrayBufferT<T>::set_row(const Uint array_idx, const vectorType& row
 template<typename T>
 inline void ArrayBufferT<T>::rm_row(const Uint array_idx)
 {
-  Uint cummulative_size = m_array.size();
-  if (array_idx < cummulative_size)
+  const Uint array_size = m_array.size();
+  if (array_idx < array_size)
   {
-    m_empty_array_rows.push_back(array_idx);
+    if (!is_array_row_empty(array_idx))
+    {
+      if (m_is_empty_array_row.size() < array_size)
+        m_is_empty_array_row.resize(array_size,false);
+      m_is_empty_array_row[array_idx] = true;
+      m_empty_array_rows.push_back(array_idx);
+    }
     return;
   }
-  else
+  else if (array_idx < array_size + m_arena.size())
   {
-    m_empty_buffer_rows.push_back(array_idx);
-
-    BOOST_FOREACH(Buffer& buffer, m_buffers)
-    {
-      if (array_idx<cummulative_size+buffer.size())
-      {
-        buffer.is_not_empty[array_idx-cummulative_size]=false;
-        return;
-      }
-      cummulative_size += buffer.size();
-    }
+    m_arena.is_not_empty[array_idx-array_size]=false;
+    return;
   }
   throw Common::BadValue(FromHere(),"Trying to access index that is not allocated");
 }
@@ -503,31 +445,28 @@ inline std::string ArrayBufferT<T>::string()
     }
   }
   Uint s=m_array.size();
-  for (Uint b=0; b<m_buffers.size(); ++b)
+  str += "    ----arena----\n";
+  for (Uint i=0; i<m_arena.size(); ++i)
   {
-    str += "    ----buffer["+to_str(b)+"]----\n";
-    for (Uint i=0; i<m_buffers[b].size(); ++i)
+    str += "    " + to_str(s) + ":    ";
+    if (i >= m_arena.nb_used)
     {
-      str += "    " + to_str(s) + ":    ";
-      if ( std::find(m_empty_buffer_rows.begin(),m_empty_buffer_rows.end(),s) != m_empty_buffer_rows.end())
-      {
-        str += "X   ( ";
-        for (Uint j=0; j<m_buffers[b].rows[i].size(); ++j)
-          str += to_str(m_buffers[b].rows[i][j]) + " ";
-        str += ")\n";
-      }
-      else if( std::find(m_new_buffer_rows.begin(),m_new_buffer_rows.end(),s) != m_new_buffer_rows.end())
-      {
-        str += "\n";
-      }
-      else
-      {
-        for (Uint j=0; j<m_buffers[b].rows[i].size(); ++j)
-          str += to_str(m_buffers[b].rows[i][j]) + " ";
-        str += "\n";
-      }
-      ++s;
+      str += "\n";
+    }
+    else if (!m_arena.is_not_empty[i])
+    {
+      str += "X   ( ";
+      for (Uint j=0; j<m_arena.rows[i].size(); ++j)
+        str += to_str(m_arena.rows[i][j]) + " ";
+      str += ")\n";
+    }
+    else
+    {
+      for (Uint j=0; j<m_arena.rows[i].size(); ++j)
+        str += to_str(m_arena.rows[i][j]) + " ";
+      str += "\n";
     }
+    ++s;
   }
   return str;
 }
@@ -0,0 +1,326 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <boost/tokenizer.hpp>
+
+#include "Common/BoostFilesystem.hpp"
+#include "Common/CBuilder.hpp"
+#include "Common/FindComponents.hpp"
+#include "Common/Log.hpp"
+#include "Common/StringConversion.hpp"
+
+#include "Common/MPI/CommPattern.hpp"
+#include "Common/MPI/PE.hpp"
+
+#include "Mesh/CElements.hpp"
+#include "Mesh/CMesh.hpp"
+#include "Mesh/CMeshElements.hpp"
+#include "Mesh/CRegion.hpp"
+#include "Mesh/Field.hpp"
+#include "Mesh/Geometry.hpp"
+
+#include "Mesh/Binary/CReader.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace CF {
+namespace Mesh {
+namespace Binary {
+
+  using namespace Common;
+
+////////////////////////////////////////////////////////////////////////////////
+
+CF::Common::ComponentBuilder < Binary::CReader, CMeshReader, LibBinary> aBinaryReader_Builder;
+
+//////////////////////////////////////////////////////////////////////////////
+
+CReader::CReader( const std::string& name )
+: CMeshReader(name),
+  Shared()
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+std::vector<std::string> CReader::get_extensions()
+{
+  std::vector<std::string> extensions;
+  extensions.push_back(".cfbin");
+  return extensions;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void CReader::do_read_mesh_into(const URI& file, CMesh& mesh)
+{
+  const Uint rank = Comm::PE::instance().is_active() ? Comm::PE::instance().rank() : 0;
+
+  const boost::filesystem::path index_path(file.path());
+  boost::filesystem::fstream index_file;
+  index_file.open(index_path, std::ios_base::in | std::ios_base::binary);
+  if (!index_file) // doesnt exist so throw exception
+  {
+     throw boost::filesystem::filesystem_error( index_path.string() + " does not exist", boost::system::error_code() );
+  }
+  Uint nb_procs, nb_nodes, nb_elements;
+  read_index(index_file, index_path.string(), rank, nb_procs, nb_nodes, nb_elements);
+  index_file.close();
+
+  const boost::filesystem::path path = rank_path(index_path, rank);
+  boost::filesystem::fstream data_file;
+  data_file.open(path, std::ios_base::in | std::ios_base::binary);
+  if (!data_file) // doesnt exist so throw exception
+  {
+     throw boost::filesystem::filesystem_error( path.string() + " does not exist", boost::system::error_code() );
+  }
+
+  read_header(data_file, path.string());
+  const Uint file_rank = read_uint(data_file);
+  if(file_rank != rank)
+    throw FileFormatError(FromHere(), path.string() + " contains the data for rank " + to_str(file_rank) + " instead of rank " + to_str(rank));
+  const Uint file_nb_procs = read_uint(data_file);
+  if(file_nb_procs != nb_procs)
+    throw FileFormatError(FromHere(), path.string() + " was written using " + to_str(file_nb_procs) + " processes, but the index lists " + to_str(nb_procs) + " processes");
+  const Uint dimension = read_uint(data_file);
+  if(dimension < 1 || dimension > 3)
+    throw FileFormatError(FromHere(), path.string() + " has invalid mesh dimension " + to_str(dimension));
+
+  mesh.initialize_nodes(0, dimension);
+
+  read_field_group(data_file, mesh, &mesh.geometry());
+  if(mesh.geometry().size() != nb_nodes)
+    throw FileFormatError(FromHere(), path.string() + " contains " + to_str(mesh.geometry().size()) + " nodes, but the index lists " + to_str(nb_nodes) + " nodes for rank " + to_str(rank));
+
+  const Uint file_nb_elements = read_elements(data_file, mesh);
+  if(file_nb_elements != nb_elements)
+    throw FileFormatError(FromHere(), path.string() + " contains " + to_str(file_nb_elements) + " elements, but the index lists " + to_str(nb_elements) + " elements for rank " + to_str(rank));
+
+  const Uint nb_field_groups = read_uint(data_file);
+  for(Uint i = 0; i != nb_field_groups; ++i)
+    read_field_group(data_file, mesh, 0);
+
+  if(data_file.peek() != std::char_traits<char>::eof())
+    throw FileFormatError(FromHere(), path.string() + " contains unexpected data after the last field group");
+
+  data_file.close();
+
+  mesh.elements().update();
+  mesh.update_statistics();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void CReader::read_index(std::istream& file, const std::string& file_name, const Uint rank, Uint& nb_procs, Uint& nb_nodes, Uint& nb_elements)
+{
+  read_header(file, file_name);
+
+  nb_procs = Comm::PE::instance().is_active() ? Comm::PE::instance().size() : 1;
+  const Uint file_nb_procs = read_uint(file);
+  if(file_nb_procs != nb_procs)
+    throw FileFormatError(FromHere(), file_name + " was written using " + to_str(file_nb_procs) + " processes, but it is read using " + to_str(nb_procs) + " processes");
+
+  for(Uint i = 0; i != nb_procs; ++i)
+  {
+    const Uint rank_nb_nodes = read_uint(file);
+    const Uint rank_nb_elements = read_uint(file);
+    if(i == rank)
+    {
+      nb_nodes = rank_nb_nodes;
+      nb_elements = rank_nb_elements;
+    }
+  }
+
+  if(file.peek() != std::char_traits<char>::eof())
+    throw FileFormatError(FromHere(), file_name + " contains unexpected data after the index");
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+Uint CReader::read_elements(std::istream& file, CMesh& mesh)
+{
+  Uint total_nb_elems = 0;
+  const Uint nb_element_blocks = read_uint(file);
+  for(Uint block = 0; block != nb_element_blocks; ++block)
+  {
+    const std::string path = read_string(file);
+    const std::string entities_type = read_string(file);
+    const std::string explicit_entities_type = read_string(file);
+    const std::string etype_name = read_string(file);
+
+    std::vector<std::string> space_names;
+    std::vector<std::string> shape_function_names;
+    const Uint nb_spaces = read_uint(file);
+    for(Uint i = 0; i != nb_spaces; ++i)
+    {
+      space_names.push_back(read_string(file));
+      shape_function_names.push_back(read_string(file));
+    }
+
+    const Uint nb_elems = read_uint(file);
+    const Uint nb_elem_nodes = read_uint(file);
+
+    const std::size_t separator = path.find_last_of('/');
+    const std::string region_path = separator == std::string::npos ? std::string() : path.substr(0, separator);
+    const std::string elements_name = separator == std::string::npos ? path : path.substr(separator+1);
+    CRegion& region = create_region(mesh, region_path);
+
+    // Restore the concrete type if its size follows from the connectivity table. Otherwise it needs data that is not in the
+    // checkpoint, so the explicit type is used instead.
+    CEntities::Ptr entities = build_component_abstract_type<CEntities>(entities_type, elements_name);
+    region.add_component(entities);
+    entities->initialize(etype_name, mesh.geometry());
+    entities->as_type<CElements>().node_connectivity().set_row_size(nb_elem_nodes);
+    entities->as_type<CElements>().node_connectivity().resize(nb_elems);
+    if(entities->size() != nb_elems)
+    {
+      CFdebug << "Restoring " << region.uri().string() << "/" << elements_name << " as " << explicit_entities_type << " instead of " << entities_type << CFendl;
+      region.remove_component(elements_name);
+      entities = build_component_abstract_type<CEntities>(explicit_entities_type, elements_name);
+      region.add_component(entities);
+      entities->initialize(etype_name, mesh.geometry());
+    }
+    CElements& elements = entities->as_type<CElements>();
+
+    for(Uint i = 0; i != nb_spaces; ++i)
+    {
+      if(!elements.exists_space(space_names[i]))
+        elements.create_space(space_names[i], shape_function_names[i]);
+    }
+
+    if(elements.element_type().nb_nodes() != nb_elem_nodes)
+      throw FileFormatError(FromHere(), "Elements " + path + " have " + to_str(nb_elem_nodes) + " nodes per element in the checkpoint, but element type " + etype_name + " has " + to_str(elements.element_type().nb_nodes()));
+
+    CConnectivity& connectivity = elements.node_connectivity();
+    connectivity.set_row_size(nb_elem_nodes);
+    connectivity.resize(nb_elems);
+    read_data(file, connectivity.array().data(), nb_elems*nb_elem_nodes*sizeof(Uint));
+
+    const Uint nb_nodes = mesh.geometry().size();
+    for(Uint elem = 0; elem != nb_elems; ++elem)
+    {
+      for(Uint i = 0; i != nb_elem_nodes; ++i)
+      {
+        if(connectivity[elem][i] >= nb_nodes)
+          throw FileFormatError(FromHere(), "Element " + to_str(elem) + " of " + path + " refers to node " + to_str(connectivity[elem][i]) + ", but there are only " + to_str(nb_nodes) + " nodes");
+      }
+    }
+
+    read_list(file, elements.glb_idx());
+    read_list(file, elements.rank());
+    if(elements.glb_idx().size() != nb_elems || elements.rank().size() != nb_elems)
+      throw FileFormatError(FromHere(), "Global indices or ranks for " + path + " don't match the number of elements " + to_str(nb_elems));
+
+    total_nb_elems += nb_elems;
+  }
+
+  return total_nb_elems;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void CReader::read_field_group(std::istream& file, CMesh& mesh, FieldGroup* field_group)
+{
+  const std::string name = read_string(file);
+  const FieldGroup::Basis::Type basis = FieldGroup::Basis::to_enum(read_string(file));
+  const std::string space = read_string(file);
+  const std::string topology_path = read_string(file);
+  const Uint size = read_uint(file);
+
+  if(is_null(field_group))
+  {
+    // The connectivity in the space is rebuilt here, and it determines the size of the group
+    field_group = &mesh.create_field_group(name, basis, space, create_region(mesh, topology_path));
+    if(field_group->size() != size)
+      throw FileFormatError(FromHere(), "Field group " + name + " has size " + to_str(size) + " in the checkpoint, but the restored mesh gives size " + to_str(field_group->size()));
+  }
+  else
+  {
+    field_group->resize(size);
+  }
+
+  read_list(file, field_group->glb_idx());
+  read_list(file, field_group->rank());
+
+  const Uint nb_fields = read_uint(file);
+  for(Uint i = 0; i != nb_fields; ++i)
+  {
+    const std::string field_name = read_string(file);
+    const std::string description = read_string(file);
+    const bool is_parallel = read_uint(file);
+    const Uint row_size = read_uint(file);
+    const Uint value_size = read_uint(file);
+
+    if(value_size == sizeof(Real))
+      read_field<Field>(file, mesh, *field_group, field_name, description, is_parallel, row_size);
+    else if(value_size == sizeof(float))
+      read_field<SinglePrecisionField>(file, mesh, *field_group, field_name, description, is_parallel, row_size);
+    else
+      throw FileFormatError(FromHere(), "Field " + field_name + " has values of " + to_str(value_size) + " bytes, which is not a supported precision");
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+template<typename FieldType>
+void CReader::read_field(std::istream& file, CMesh& mesh, FieldGroup& field_group, const std::string& field_name, const std::string& description, const bool is_parallel, const Uint row_size)
+{
+  typedef typename FieldType::value_type ValueT;
+
+  // Some fields, such as the coordinates, are created together with the field group
+  Component::Ptr existing_field = field_group.get_child_ptr(field_name);
+  FieldType& field = is_not_null(existing_field) ? existing_field->as_type<FieldType>() : field_group.create_field<FieldType>(field_name, description);
+  if(field.row_size() != row_size)
+    throw FileFormatError(FromHere(), "Field " + field_name + " has row size " + to_str(row_size) + " in the checkpoint, but " + to_str(field.row_size()) + " after restoring");
+
+  if(field.layout() == CTable<ValueT>::ROW_MAJOR)
+  {
+    read_data(file, field.array().data(), field.size()*row_size*sizeof(ValueT));
+  }
+  else
+  {
+    // the file format is row major
+    typename CTable<ValueT>::ArrayT row_major(boost::extents[field.size()][row_size]);
+    read_data(file, row_major.data(), field.size()*row_size*sizeof(ValueT));
+    field.array() = row_major;
+  }
+
+  if(is_parallel && Comm::PE::instance().is_active())
+  {
+    Component::Ptr comm_pattern = mesh.get_child_ptr("comm_pattern_node_based");
+    if(is_null(comm_pattern))
+      field.parallelize();
+    else
+      field.parallelize_with(comm_pattern->as_type<Comm::CommPattern>());
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+CRegion& CReader::create_region(CMesh& mesh, const std::string& relative_path)
+{
+  typedef boost::tokenizer<boost::char_separator<char> > Tokenizer;
+  boost::char_separator<char> sep("/");
+  Tokenizer tokens(relative_path, sep);
+
+  CRegion* region = &mesh.topology();
+  for (Tokenizer::iterator tok_iter = tokens.begin(); tok_iter != tokens.end(); ++tok_iter)
+  {
+    const std::string name = *tok_iter;
+    Component::Ptr new_region = region->get_child_ptr(name);
+    if (is_null(new_region))
+      region = &region->create_component<CRegion>(name);
+    else
+      region = &new_region->as_type<CRegion>();
+  }
+  return *region;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // Binary
+} // Mesh
+} // CF
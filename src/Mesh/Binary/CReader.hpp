@@ -0,0 +1,79 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef CF_Mesh_Binary_CReader_hpp
+#define CF_Mesh_Binary_CReader_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Mesh/CMeshReader.hpp"
+
+#include "Mesh/Binary/LibBinary.hpp"
+#include "Mesh/Binary/Shared.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace CF {
+namespace Mesh {
+  class FieldGroup;
+namespace Binary {
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// This class restores a mesh from a checkpoint written by the binary CWriter. Each rank reads only its own
+/// file, so the number of processes must be the same as when the checkpoint was written. Since the partitioning,
+/// the global numbering and the ghost information are stored, no repartitioning or renumbering is needed.
+class Binary_API CReader : public CMeshReader, public Shared
+{
+public: // typedefs
+
+  typedef boost::shared_ptr<CReader> Ptr;
+  typedef boost::shared_ptr<CReader const> ConstPtr;
+
+public: // functions
+  /// constructor
+  CReader( const std::string& name );
+
+  /// Gets the Class name
+  static std::string type_name() { return "CReader"; }
+
+  virtual std::string get_format() { return "Binary"; }
+
+  virtual std::vector<std::string> get_extensions();
+
+private: // functions
+
+  virtual void do_read_mesh_into(const Common::URI& fp, CMesh& mesh);
+
+  /// Read the index and check it against the current number of processes.
+  /// Returns the number of processes, and the number of nodes and elements stored for this rank
+  void read_index(std::istream& file, const std::string& file_name, const Uint rank, Uint& nb_procs, Uint& nb_nodes, Uint& nb_elements);
+
+  /// Read all element blocks, returning the total number of elements
+  Uint read_elements(std::istream& file, CMesh& mesh);
+
+  /// Read a field group. If field_group is null, it is created, otherwise the existing group (i.e. the geometry) is filled
+  void read_field_group(std::istream& file, CMesh& mesh, FieldGroup* field_group);
+
+  /// Read the values of a field, creating it if it doesn't exist in the field group yet
+  template<typename FieldType>
+  void read_field(std::istream& file, CMesh& mesh, FieldGroup& field_group, const std::string& field_name, const std::string& description, const bool is_parallel, const Uint row_size);
+
+  /// Find or create the region with the given path relative to the topology
+  CRegion& create_region(CMesh& mesh, const std::string& relative_path);
+
+}; // end CReader
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // Binary
+} // Mesh
+} // CF
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // CF_Mesh_Binary_CReader_hpp
@@ -0,0 +1,270 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include "Common/BoostFilesystem.hpp"
+#include "Common/Foreach.hpp"
+#include "Common/MPI/PE.hpp"
+#include "Common/CBuilder.hpp"
+#include "Common/CFactories.hpp"
+#include "Common/CFactory.hpp"
+#include "Common/Core.hpp"
+#include "Common/FindComponents.hpp"
+
+#include "Math/VariablesDescriptor.hpp"
+
+#include "Mesh/Binary/CWriter.hpp"
+#include "Mesh/CElements.hpp"
+#include "Mesh/CMesh.hpp"
+#include "Mesh/CRegion.hpp"
+#include "Mesh/CSpace.hpp"
+#include "Mesh/ElementType.hpp"
+#include "Mesh/Geometry.hpp"
+#include "Mesh/Field.hpp"
+#include "Mesh/ShapeFunction.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+using namespace CF::Common;
+
+namespace CF {
+namespace Mesh {
+namespace Binary {
+
+////////////////////////////////////////////////////////////////////////////////
+
+Common::ComponentBuilder < Binary::CWriter, CMeshWriter, LibBinary> aBinaryWriter_Builder;
+
+//////////////////////////////////////////////////////////////////////////////
+
+CWriter::CWriter( const std::string& name )
+: CMeshWriter(name)
+{
+
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+std::vector<std::string> CWriter::get_extensions()
+{
+  std::vector<std::string> extensions;
+  extensions.push_back(".cfbin");
+  return extensions;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void CWriter::write_from_to(const CMesh& mesh, const URI& file_path)
+{
+  m_mesh = mesh.as_ptr<CMesh>().get();
+
+  const bool is_parallel = Comm::PE::instance().is_active();
+  const Uint rank = is_parallel ? Comm::PE::instance().rank() : 0;
+
+  // Sizes that go into the index
+  Uint nb_elements = 0;
+  boost_foreach(const CElements& elements, find_components_recursively<CElements>(mesh.topology()))
+    nb_elements += elements.size();
+
+  std::vector<Uint> nb_nodes_per_rank(1, mesh.geometry().size());
+  std::vector<Uint> nb_elements_per_rank(1, nb_elements);
+  if(is_parallel)
+  {
+    Comm::PE::instance().all_gather(mesh.geometry().size(), nb_nodes_per_rank);
+    Comm::PE::instance().all_gather(nb_elements, nb_elements_per_rank);
+  }
+
+  const boost::filesystem::path index_path(file_path.path());
+
+  if(rank == 0)
+  {
+    boost::filesystem::fstream index_file;
+    index_file.open(index_path, std::ios_base::out | std::ios_base::binary);
+    if (!index_file) // didn't open so throw exception
+    {
+       throw boost::filesystem::filesystem_error( index_path.string() + " failed to open",
+                                                  boost::system::error_code() );
+    }
+    write_index(index_file, nb_nodes_per_rank, nb_elements_per_rank);
+    index_file.close();
+  }
+
+  const boost::filesystem::path path = rank_path(index_path, rank);
+  boost::filesystem::fstream file;
+  file.open(path, std::ios_base::out | std::ios_base::binary);
+  if (!file) // didn't open so throw exception
+  {
+     throw boost::filesystem::filesystem_error( path.string() + " failed to open",
+                                                boost::system::error_code() );
+  }
+
+  write_header(file);
+  write_uint(file, rank);
+  write_uint(file, nb_nodes_per_rank.size());
+  write_uint(file, mesh.dimension());
+
+  // The geometry comes first, since the elements refer to it
+  write_field_group(file, mesh, mesh.geometry());
+
+  write_elements(file, mesh);
+
+  std::vector<const FieldGroup*> field_groups;
+  boost_foreach(const FieldGroup& field_group, find_components<FieldGroup>(mesh))
+  {
+    if(&field_group != &mesh.geometry())
+      field_groups.push_back(&field_group);
+  }
+
+  write_uint(file, field_groups.size());
+  boost_foreach(const FieldGroup* field_group, field_groups)
+    write_field_group(file, mesh, *field_group);
+
+  file.close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void CWriter::write_index(std::ostream& file, const std::vector<Uint>& nb_nodes, const std::vector<Uint>& nb_elements)
+{
+  write_header(file);
+
+  const Uint nb_procs = nb_nodes.size();
+  write_uint(file, nb_procs);
+  for(Uint i = 0; i != nb_procs; ++i)
+  {
+    write_uint(file, nb_nodes[i]);
+    write_uint(file, nb_elements[i]);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void CWriter::write_elements(std::ostream& file, const CMesh& mesh)
+{
+  std::vector<const CElements*> elements_list;
+  boost_foreach(const CElements& elements, find_components_recursively<CElements>(mesh.topology()))
+    elements_list.push_back(&elements);
+
+  write_uint(file, elements_list.size());
+  boost_foreach(const CElements* elements_ptr, elements_list)
+  {
+    const CElements& elements = *elements_ptr;
+    const ElementType& etype = elements.element_type();
+
+    write_string(file, relative_path(elements, mesh.topology()));
+
+    // The concrete type is restored if it can be rebuilt from the explicit connectivity. Types that need
+    // more data than what is stored here, such as implicitly stored structured elements, fall back to the second type
+    write_string(file, entities_builder_name(elements));
+    write_string(file, etype.dimensionality() == etype.dimension()-1 ? "CF.Mesh.CFaces" : "CF.Mesh.CCells");
+    write_string(file, etype.builder_name());
+
+    // Spaces other than the ones created by default
+    std::vector<const CSpace*> spaces;
+    for(Uint space_idx = 0; elements.exists_space(space_idx); ++space_idx)
+    {
+      if(space_idx != CEntities::MeshSpaces::SPACE0 && space_idx != CEntities::MeshSpaces::MESH_NODES)
+        spaces.push_back(&elements.space(space_idx));
+    }
+    write_uint(file, spaces.size());
+    boost_foreach(const CSpace* space, spaces)
+    {
+      write_string(file, space->name());
+      write_string(file, space->shape_function().derived_type_name());
+    }
+
+    const Uint nb_elems = elements.size();
+    const Uint nb_elem_nodes = etype.nb_nodes();
+    write_uint(file, nb_elems);
+    write_uint(file, nb_elem_nodes);
+
+    const CConnectivity& connectivity = elements.node_connectivity();
+    if(connectivity.size() == nb_elems && connectivity.row_size() == nb_elem_nodes)
+    {
+      write_data(file, connectivity.array().data(), nb_elems*nb_elem_nodes*sizeof(Uint));
+    }
+    else // connectivity is not stored explicitly, so go through get_nodes
+    {
+      write_uint(file, nb_elems*nb_elem_nodes*sizeof(Uint));
+      for(Uint elem = 0; elem != nb_elems; ++elem)
+      {
+        const CConnectivity::ConstRow row = elements.get_nodes(elem);
+        for(Uint i = 0; i != nb_elem_nodes; ++i)
+          write_uint(file, row[i]);
+      }
+    }
+
+    write_list(file, elements.glb_idx());
+    write_list(file, elements.rank());
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void CWriter::write_field_group(std::ostream& file, const CMesh& mesh, const FieldGroup& field_group)
+{
+  write_string(file, field_group.name());
+  write_string(file, FieldGroup::Basis::to_str(field_group.basis()));
+  write_string(file, field_group.space());
+  write_string(file, relative_path(field_group.topology(), mesh.topology()));
+  write_uint(file, field_group.size());
+  write_list(file, field_group.glb_idx());
+  write_list(file, field_group.rank());
+
+  // Node-based fields that were parallelized are parallelized again upon restart
+  Component::ConstPtr comm_pattern = mesh.get_child_ptr("comm_pattern_node_based");
+
+  const Uint nb_fields = find_components<Field>(field_group).size() + find_components<SinglePrecisionField>(field_group).size();
+  write_uint(file, nb_fields);
+  boost_foreach(const Field& field, find_components<Field>(field_group))
+    write_field(file, field, &field_group == &mesh.geometry() && is_not_null(comm_pattern) && is_not_null(comm_pattern->get_child_ptr(field.name())));
+  boost_foreach(const SinglePrecisionField& field, find_components<SinglePrecisionField>(field_group))
+    write_field(file, field, &field_group == &mesh.geometry() && is_not_null(comm_pattern) && is_not_null(comm_pattern->get_child_ptr(field.name())));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template<typename FieldType>
+void CWriter::write_field(std::ostream& file, const FieldType& field, const bool is_parallel)
+{
+  typedef typename FieldType::value_type ValueT;
+
+  write_string(file, field.name());
+  write_string(file, field.descriptor().description());
+  write_uint(file, is_parallel);
+  write_uint(file, field.row_size());
+  write_uint(file, sizeof(ValueT));
+  if(field.layout() == CTable<ValueT>::ROW_MAJOR)
+  {
+    write_data(file, field.array().data(), field.size()*field.row_size()*sizeof(ValueT));
+  }
+  else
+  {
+    // the file format is row major
+    typename CTable<ValueT>::ArrayT row_major(boost::extents[field.size()][field.row_size()]);
+    row_major = field.array();
+    write_data(file, row_major.data(), field.size()*field.row_size()*sizeof(ValueT));
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::string CWriter::entities_builder_name(const CEntities& entities)
+{
+  const std::string concrete_type = entities.derived_type_name();
+  CFactory::Ptr factory = Core::instance().factories().get_factory<CEntities>();
+  boost_foreach(const CBuilder& builder, find_components_recursively<CBuilder>(*factory))
+  {
+    if(builder.builder_concrete_type_name() == concrete_type)
+      return builder.name();
+  }
+  throw ValueNotFound(FromHere(), "No builder for entities of type " + concrete_type + " found while writing " + entities.uri().string());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // Binary
+} // Mesh
+} // CF
@@ -0,0 +1,77 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef CF_Mesh_Binary_CWriter_hpp
+#define CF_Mesh_Binary_CWriter_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Mesh/CMeshWriter.hpp"
+
+#include "Mesh/Binary/LibBinary.hpp"
+#include "Mesh/Binary/Shared.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace CF {
+namespace Mesh {
+  class CEntities;
+  class FieldGroup;
+namespace Binary {
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// This class writes a checkpoint of the mesh, containing the complete topology, all field groups
+/// and all fields, regardless of the "fields" option. Each rank writes its own part of the mesh
+/// to a separate file without any communication except for the gathering of the sizes that go into the index.
+class Binary_API CWriter : public CMeshWriter, public Shared
+{
+public: // typedefs
+
+    typedef boost::shared_ptr<CWriter> Ptr;
+    typedef boost::shared_ptr<CWriter const> ConstPtr;
+
+public: // functions
+
+  /// constructor
+  CWriter( const std::string& name );
+
+  /// Gets the Class name
+  static std::string type_name() { return "CWriter"; }
+
+  virtual void write_from_to(const CMesh& mesh, const Common::URI& file);
+
+  virtual std::string get_format() { return "Binary"; }
+
+  virtual std::vector<std::string> get_extensions();
+
+private: // functions
+
+  void write_index(std::ostream& file, const std::vector<Uint>& nb_nodes, const std::vector<Uint>& nb_elements);
+
+  void write_elements(std::ostream& file, const CMesh& mesh);
+
+  void write_field_group(std::ostream& file, const CMesh& mesh, const FieldGroup& field_group);
+
+  /// Write a field, with the size of its values so single precision fields are restored as such
+  template<typename FieldType>
+  void write_field(std::ostream& file, const FieldType& field, const bool is_parallel);
+
+  /// Name of the builder for the concrete type of the given entities, e.g. CF.Mesh.CCells
+  std::string entities_builder_name(const CEntities& entities);
+
+}; // end CWriter
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // Binary
+} // Mesh
+} // CF
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // CF_Mesh_Binary_CWriter_hpp
@@ -0,0 +1,31 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include "Common/RegistLibrary.hpp"
+
+#include "Mesh/Binary/LibBinary.hpp"
+
+namespace CF {
+namespace Mesh {
+namespace Binary {
+
+CF::Common::RegistLibrary<LibBinary> libBinary;
+
+////////////////////////////////////////////////////////////////////////////////
+
+void LibBinary::initiate_impl()
+{
+}
+
+void LibBinary::terminate_impl()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // Binary
+} // Mesh
+} // CF
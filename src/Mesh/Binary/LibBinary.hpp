@@ -0,0 +1,88 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef CF_LibBinary_hpp
+#define CF_LibBinary_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Common/CLibrary.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Define the macro Binary_API
+/// @note build system defines COOLFLUID_MESH_BINARY_EXPORTS when compiling Binary files
+#ifdef COOLFLUID_MESH_BINARY_EXPORTS
+#   define Binary_API      CF_EXPORT_API
+#   define Binary_TEMPLATE
+#else
+#   define Binary_API      CF_IMPORT_API
+#   define Binary_TEMPLATE CF_TEMPLATE_EXTERN
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace CF {
+namespace Mesh {
+  
+/// @brief Library for checkpointing meshes and fields in a native binary format
+namespace Binary {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Class defines the native binary mesh format operations
+class Binary_API LibBinary :
+    public Common::CLibrary
+{
+public:
+
+  typedef boost::shared_ptr<LibBinary> Ptr;
+  typedef boost::shared_ptr<LibBinary const> ConstPtr;
+
+  /// Constructor
+  LibBinary ( const std::string& name) : Common::CLibrary(name) {   }
+
+  /// @return string of the library namespace
+  static std::string library_namespace() { return "CF.Mesh.Binary"; }
+
+  /// Static function that returns the library name.
+  /// Must be implemented for CLibrary registration
+  /// @return name of the library
+  static std::string library_name() { return "Binary"; }
+
+  /// Static function that returns the description of the library.
+  /// Must be implemented for CLibrary registration
+  /// @return description of the library
+
+  static std::string library_description()
+  {
+    return "This library implements the native binary checkpoint format for meshes and fields.";
+  }
+
+  /// Gets the Class name
+  static std::string type_name() { return "LibBinary"; }
+
+protected:
+
+  /// initiate library
+  virtual void initiate_impl();
+
+  /// terminate library
+  virtual void terminate_impl();
+
+}; // end LibBinary
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // Binary
+} // Mesh
+} // CF
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // CF_LibBinary_hpp
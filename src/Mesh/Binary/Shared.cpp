@@ -0,0 +1,155 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <cstring>
+#include <iostream>
+
+#include "Common/BasicExceptions.hpp"
+#include "Common/StringConversion.hpp"
+
+#include "Mesh/CRegion.hpp"
+
+#include "Mesh/Binary/Shared.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace CF {
+namespace Mesh {
+namespace Binary {
+
+using namespace Common;
+
+//////////////////////////////////////////////////////////////////////////////
+
+const char Shared::magic[8] = {'C','F','3','B','I','N','\0','\0'};
+
+//////////////////////////////////////////////////////////////////////////////
+
+boost::filesystem::path Shared::rank_path(const boost::filesystem::path& index_path, const Uint rank)
+{
+  return index_path.parent_path() / ( boost::filesystem::basename(index_path) + "_P" + to_str(rank) + boost::filesystem::extension(index_path) );
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Shared::write_header(std::ostream& file)
+{
+  file.write(magic, sizeof(magic));
+  write_uint(file, version);
+  write_uint(file, sizeof(Uint));
+  write_uint(file, sizeof(Real));
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Shared::read_header(std::istream& file, const std::string& file_name)
+{
+  char file_magic[sizeof(magic)];
+  file.read(file_magic, sizeof(magic));
+  if(!file || std::memcmp(file_magic, magic, sizeof(magic)) != 0)
+    throw FileFormatError(FromHere(), file_name + " is not a binary checkpoint file");
+
+  const Uint file_version = read_uint(file);
+  if(file_version != version)
+    throw FileFormatError(FromHere(), file_name + " has version " + to_str(file_version) + ", expected version " + to_str(version));
+
+  const Uint uint_size = read_uint(file);
+  const Uint real_size = read_uint(file);
+  if(uint_size != sizeof(Uint) || real_size != sizeof(Real))
+    throw FileFormatError(FromHere(), file_name + " was written with sizeof(Uint) = " + to_str(uint_size) + " and sizeof(Real) = " + to_str(real_size)
+                                      + ", but this build uses " + to_str(sizeof(Uint)) + " and " + to_str(sizeof(Real)));
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Shared::write_uint(std::ostream& file, const Uint value)
+{
+  file.write(reinterpret_cast<const char*>(&value), sizeof(Uint));
+}
+
+Uint Shared::read_uint(std::istream& file)
+{
+  Uint value;
+  file.read(reinterpret_cast<char*>(&value), sizeof(Uint));
+  if(!file)
+    throw FileFormatError(FromHere(), "Unexpected end of binary checkpoint file");
+  return value;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Shared::write_string(std::ostream& file, const std::string& str)
+{
+  write_uint(file, str.size());
+  file.write(str.data(), str.size());
+}
+
+std::string Shared::read_string(std::istream& file)
+{
+  const Uint length = read_uint(file);
+  std::string result(length, ' ');
+  if(length)
+    file.read(&result[0], length);
+  if(!file)
+    throw FileFormatError(FromHere(), "Unexpected end of binary checkpoint file");
+  return result;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Shared::write_data(std::ostream& file, const void* data, const Uint nb_bytes)
+{
+  write_uint(file, nb_bytes);
+  if(nb_bytes)
+    file.write(static_cast<const char*>(data), nb_bytes);
+}
+
+void Shared::read_data(std::istream& file, void* data, const Uint nb_bytes)
+{
+  const Uint stored_bytes = read_uint(file);
+  if(stored_bytes != nb_bytes)
+    throw FileFormatError(FromHere(), "Data block of " + to_str(stored_bytes) + " bytes found in binary checkpoint file, expected " + to_str(nb_bytes) + " bytes");
+  if(nb_bytes)
+    file.read(static_cast<char*>(data), nb_bytes);
+  if(!file)
+    throw FileFormatError(FromHere(), "Unexpected end of binary checkpoint file");
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Shared::write_list(std::ostream& file, const CList<Uint>& list)
+{
+  const Uint list_size = list.size();
+  write_uint(file, list_size);
+  write_data(file, list.array().data(), list_size*sizeof(Uint));
+}
+
+void Shared::read_list(std::istream& file, CList<Uint>& list)
+{
+  const Uint list_size = read_uint(file);
+  list.resize(list_size);
+  read_data(file, list.array().data(), list_size*sizeof(Uint));
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+std::string Shared::relative_path(const Component& component, const CRegion& topology)
+{
+  std::string result;
+  const Component* current = &component;
+  while(current != &topology)
+  {
+    result = result.empty() ? current->name() : current->name() + "/" + result;
+    current = &current->parent();
+  }
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // Binary
+} // Mesh
+} // CF
@@ -0,0 +1,93 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef CF_Mesh_Binary_Shared_hpp
+#define CF_Mesh_Binary_Shared_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <iosfwd>
+#include <string>
+
+#include "Common/BoostFilesystem.hpp"
+
+#include "Mesh/CList.hpp"
+
+#include "Mesh/Binary/LibBinary.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace CF {
+namespace Common { class Component; }
+namespace Mesh {
+  class CRegion;
+namespace Binary {
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// This class defines the binary checkpoint format common functionality.
+/// A checkpoint consists of an index file, written by rank 0, that contains the number of
+/// processes and the number of nodes and elements on each of them, and one data file per rank,
+/// named as the index file with "_P<rank>" appended to the basename. The reader checks each data file
+/// against the index, so files from different checkpoints or truncated files are detected. All data is written in the native
+/// representation of the machine, so restarting is only supported on a machine with the same
+/// endianness and the same size for Uint and Real.
+class Binary_API Shared
+{
+public:
+
+  /// Gets the Class name
+  static std::string type_name() { return "Shared"; }
+
+  /// Path of the data file for the given rank, based on the path of the index file
+  static boost::filesystem::path rank_path(const boost::filesystem::path& index_path, const Uint rank);
+
+protected:
+
+  /// Written at the start of each file
+  static const char magic[8];
+
+  /// Increase this when the layout changes
+  static const Uint version = 3;
+
+  /// Write the header, consisting of the magic string, the version and the size of the basic types
+  static void write_header(std::ostream& file);
+
+  /// Read and check the header
+  static void read_header(std::istream& file, const std::string& file_name);
+
+  static void write_uint(std::ostream& file, const Uint value);
+  static Uint read_uint(std::istream& file);
+
+  static void write_string(std::ostream& file, const std::string& str);
+  static std::string read_string(std::istream& file);
+
+  /// Write a raw block of data, preceded by its size in bytes
+  static void write_data(std::ostream& file, const void* data, const Uint nb_bytes);
+
+  /// Read a raw block of data that was written with write_data. The stored size must match nb_bytes.
+  static void read_data(std::istream& file, void* data, const Uint nb_bytes);
+
+  /// Write the size of a list, followed by its data
+  static void write_list(std::ostream& file, const CList<Uint>& list);
+
+  /// Read a list that was written with write_list, resizing it as needed
+  static void read_list(std::istream& file, CList<Uint>& list);
+
+  /// Path of the given component relative to the topology, i.e. the path that is stored in the file
+  static std::string relative_path(const Common::Component& component, const CRegion& topology);
+
+}; // end Shared
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // Binary
+} // Mesh
+} // CF
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // CF_Mesh_Binary_Shared_hpp
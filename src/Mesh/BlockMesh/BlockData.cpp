@@ -8,6 +8,8 @@
 #include "Common/Exception.hpp"
 
 #include "Mesh/BlockMesh/BlockData.hpp"
+#include "Mesh/BlockMesh/BlockDataDetail.hpp"
+#include "Mesh/BlockMesh/CStructuredElements.hpp"
 #include "Mesh/BlockMesh/WriteDict.hpp"
 
 #include "Mesh/CTable.hpp"
@@ -45,10 +47,8 @@ bool BlockData::operator==(const BlockData& other) const
 }
 
 
-/// Some helper functions for mesh building
 namespace detail {
 
-/// Creates a mesh containing only the blocks
 void create_block_mesh(const BlockData& block_data, CMesh& mesh, std::map<std::string, std::string>& patch_types)
 {
   // root region and coordinates
@@ -157,300 +157,271 @@ std::pair<Uint,Uint> dimensionality(const Uint nb_elements, const CFaceConnectiv
   return std::make_pair(DIM_3D, 0);
 }
 
-/// looks up node indices based on structured block indices
-struct NodeIndices
+NodeIndices::NodeIndices(const CFaceConnectivity& face_connectivity, const BlockData& block_data) : m_face_connectivity(face_connectivity), m_block_data(block_data)
 {
-  typedef std::vector<Uint> IndicesT;
-  typedef std::vector<Uint> CountsT;
-  typedef boost::multi_array<bool, 2> Bools2T;
-
-  // Intersection of planes
-  enum Bounds { XY = 3, XZ = 4, YZ = 5, XYZ = 6 };
-
-  NodeIndices(const CFaceConnectivity& face_connectivity, const BlockData& block_data) : m_face_connectivity(face_connectivity), m_block_data(block_data)
-  {
-    const Uint nb_blocks = m_block_data.block_subdivisions.size();
-    bounded.resize(boost::extents[nb_blocks][7]);
-    block_first_nodes.reserve(nb_blocks + 1);
-    block_first_nodes.push_back(0);
-    for(Uint block = 0; block != nb_blocks; ++block)
-    {
-      const BlockData::CountsT& segments = m_block_data.block_subdivisions[block];
-      const Uint x_segs = segments[XX];
-      const Uint y_segs = segments[YY];
-      const Uint z_segs = segments[ZZ];
-
-      const Uint XPOS = Hexa3DLagrangeP1::XPOS;
-      const Uint YPOS = Hexa3DLagrangeP1::YPOS;
-      const Uint ZPOS = Hexa3DLagrangeP1::ZPOS;
-
-      bounded[block][XX] = m_face_connectivity.adjacent_element(block, XPOS).first->element_type().dimensionality() == DIM_2D;
-      bounded[block][YY] = m_face_connectivity.adjacent_element(block, YPOS).first->element_type().dimensionality() == DIM_2D;
-      bounded[block][ZZ] = m_face_connectivity.adjacent_element(block, ZPOS).first->element_type().dimensionality() == DIM_2D;
-      bounded[block][XY] = bounded[block][XX] && bounded[block][YY];
-      bounded[block][XZ] = bounded[block][XX] && bounded[block][ZZ];
-      bounded[block][YZ] = bounded[block][YY] && bounded[block][ZZ];
-      bounded[block][XYZ] = bounded[block][XX] && bounded[block][YY] && bounded[block][ZZ];
-
-      const Uint nb_nodes = x_segs*y_segs*z_segs +
-                            bounded[block][XX]*y_segs*z_segs +
-                            bounded[block][YY]*x_segs*z_segs +
-                            bounded[block][ZZ]*x_segs*y_segs +
-                            bounded[block][XY]*z_segs +
-                            bounded[block][XZ]*y_segs +
-                            bounded[block][YZ]*x_segs +
-                            bounded[block][XYZ];
-
-      block_first_nodes.push_back(block_first_nodes.back() + nb_nodes);
-    }
-  }
-
-  /// Look up the global node index of node (i, j, k) in block
-  /// @param block The block index
-  /// @param i Node index in the X direction
-  /// @param j Node index in the Y direction
-  /// @param k Node index in the Z direction
-  Uint operator()(const Uint block, const Uint i, const Uint j, const Uint k)
+  const Uint nb_blocks = m_block_data.block_subdivisions.size();
+  bounded.resize(boost::extents[nb_blocks][7]);
+  block_first_nodes.reserve(nb_blocks + 1);
+  block_first_nodes.push_back(0);
+  for(Uint block = 0; block != nb_blocks; ++block)
   {
-    cf_assert(block < m_block_data.block_subdivisions.size());
-
     const BlockData::CountsT& segments = m_block_data.block_subdivisions[block];
     const Uint x_segs = segments[XX];
     const Uint y_segs = segments[YY];
     const Uint z_segs = segments[ZZ];
-    const Uint nb_internal_nodes = x_segs*y_segs*z_segs;
 
     const Uint XPOS = Hexa3DLagrangeP1::XPOS;
     const Uint YPOS = Hexa3DLagrangeP1::YPOS;
     const Uint ZPOS = Hexa3DLagrangeP1::ZPOS;
 
-    cf_assert(i <= x_segs);
-    cf_assert(j <= y_segs);
-    cf_assert(k <= z_segs);
+    bounded[block][XX] = m_face_connectivity.adjacent_element(block, XPOS).first->element_type().dimensionality() == DIM_2D;
+    bounded[block][YY] = m_face_connectivity.adjacent_element(block, YPOS).first->element_type().dimensionality() == DIM_2D;
+    bounded[block][ZZ] = m_face_connectivity.adjacent_element(block, ZPOS).first->element_type().dimensionality() == DIM_2D;
+    bounded[block][XY] = bounded[block][XX] && bounded[block][YY];
+    bounded[block][XZ] = bounded[block][XX] && bounded[block][ZZ];
+    bounded[block][YZ] = bounded[block][YY] && bounded[block][ZZ];
+    bounded[block][XYZ] = bounded[block][XX] && bounded[block][YY] && bounded[block][ZZ];
+
+    const Uint nb_nodes = x_segs*y_segs*z_segs +
+                          bounded[block][XX]*y_segs*z_segs +
+                          bounded[block][YY]*x_segs*z_segs +
+                          bounded[block][ZZ]*x_segs*y_segs +
+                          bounded[block][XY]*z_segs +
+                          bounded[block][XZ]*y_segs +
+                          bounded[block][YZ]*x_segs +
+                          bounded[block][XYZ];
+
+    block_first_nodes.push_back(block_first_nodes.back() + nb_nodes);
+  }
+}
+
+Uint NodeIndices::operator()(const Uint block, const Uint i, const Uint j, const Uint k) const
+{
+  cf_assert(block < m_block_data.block_subdivisions.size());
+
+  const BlockData::CountsT& segments = m_block_data.block_subdivisions[block];
+  const Uint x_segs = segments[XX];
+  const Uint y_segs = segments[YY];
+  const Uint z_segs = segments[ZZ];
+  const Uint nb_internal_nodes = x_segs*y_segs*z_segs;
+
+  const Uint XPOS = Hexa3DLagrangeP1::XPOS;
+  const Uint YPOS = Hexa3DLagrangeP1::YPOS;
+  const Uint ZPOS = Hexa3DLagrangeP1::ZPOS;
 
+  cf_assert(i <= x_segs);
+  cf_assert(j <= y_segs);
+  cf_assert(k <= z_segs);
+
+
+  // blocks contain their own nodes, except for XPOS, YPOS and ZPOS planes
+  if(i != x_segs && j != y_segs && k != z_segs)
+  {
+    const Uint retval = block_first_nodes[block] + i + j*x_segs + k*x_segs*y_segs;
+    cf_assert(retval < block_first_nodes.back());
+    return retval;
+  }
 
-    // blocks contain their own nodes, except for XPOS, YPOS and ZPOS planes
-    if(i != x_segs && j != y_segs && k != z_segs)
+  // XPOS plane
+  if(i == x_segs && j != y_segs && k != z_segs)
+  {
+    if(!bounded[block][XX])
+    {
+      const Uint adj_block = m_face_connectivity.adjacent_element(block, XPOS).second;
+      const BlockData::CountsT& adj_segs = m_block_data.block_subdivisions[adj_block];
+      const Uint retval = block_first_nodes[adj_block] + j*adj_segs[XX] + k*adj_segs[XX]*adj_segs[YY];
+      cf_assert(retval < block_first_nodes.back());
+      return retval;
+    }
+    else
     {
-      const Uint retval = block_first_nodes[block] + i + j*x_segs + k*x_segs*y_segs;
+      const Uint retval = block_first_nodes[block] + nb_internal_nodes + j + k*y_segs;
       cf_assert(retval < block_first_nodes.back());
       return retval;
     }
+  }
 
-    // XPOS plane
-    if(i == x_segs && j != y_segs && k != z_segs)
+  // YPOS plane
+  if(i != x_segs && j == y_segs && k != z_segs)
+  {
+    if(!bounded[block][YY])
+    {
+      const Uint adj_block = m_face_connectivity.adjacent_element(block, YPOS).second;
+      const BlockData::CountsT& adj_segs = m_block_data.block_subdivisions[adj_block];
+      const Uint retval = block_first_nodes[adj_block] + i + k*adj_segs[XX]*adj_segs[YY];
+      cf_assert(retval < block_first_nodes.back());
+      return retval;
+    }
+    else
+    {
+      const Uint retval = block_first_nodes[block] + nb_internal_nodes + bounded[block][XX]*y_segs*z_segs + i + k*x_segs;
+      cf_assert(retval < block_first_nodes.back());
+      return retval;
+    }
+  }
+
+  // ZPOS plane
+  if(i != x_segs && j != y_segs && k == z_segs)
+  {
+    if(!bounded[block][ZZ])
+    {
+      const Uint adj_block = m_face_connectivity.adjacent_element(block, ZPOS).second;
+      const BlockData::CountsT& adj_segs = m_block_data.block_subdivisions[adj_block];
+      const Uint retval = block_first_nodes[adj_block] + i + j*adj_segs[XX];
+      cf_assert(retval < block_first_nodes.back());
+      return retval;
+    }
+    else
+    {
+      const Uint retval = block_first_nodes[block] + nb_internal_nodes + bounded[block][XX]*y_segs*z_segs + bounded[block][YY]*x_segs*z_segs + i + j*x_segs;
+      cf_assert(retval < block_first_nodes.back());
+      return retval;
+    }
+  }
+
+  // XPOS and YPOS intersection
+  if(i == x_segs && j == y_segs && k != z_segs)
+  {
+    if(!bounded[block][XY])
     {
       if(!bounded[block][XX])
       {
-        const Uint adj_block = m_face_connectivity.adjacent_element(block, XPOS).second;
-        const BlockData::CountsT& adj_segs = m_block_data.block_subdivisions[adj_block];
-        const Uint retval = block_first_nodes[adj_block] + j*adj_segs[XX] + k*adj_segs[XX]*adj_segs[YY];
+        const Uint x_adj = m_face_connectivity.adjacent_element(block, XPOS).second;
+        const Uint retval = operator()(x_adj, 0, j, k);
         cf_assert(retval < block_first_nodes.back());
         return retval;
       }
       else
       {
-        const Uint retval = block_first_nodes[block] + nb_internal_nodes + j + k*y_segs;
+        const Uint y_adj = m_face_connectivity.adjacent_element(block, YPOS).second;
+        const Uint retval = operator()(y_adj, i, 0, k);
         cf_assert(retval < block_first_nodes.back());
         return retval;
       }
     }
+    else
+    {
+      const Uint retval = block_first_nodes[block] + nb_internal_nodes +
+             bounded[block][XX]*y_segs*z_segs +
+             bounded[block][YY]*x_segs*z_segs +
+             bounded[block][ZZ]*x_segs*y_segs +
+             k;
+      cf_assert(retval < block_first_nodes.back());
+      return retval;
+    }
+  }
 
-    // YPOS plane
-    if(i != x_segs && j == y_segs && k != z_segs)
+  // XPOS and ZPOS intersection
+  if(i == x_segs && j != y_segs && k == z_segs)
+  {
+    if(!bounded[block][XZ])
     {
-      if(!bounded[block][YY])
+      if(!bounded[block][XX])
       {
-        const Uint adj_block = m_face_connectivity.adjacent_element(block, YPOS).second;
-        const BlockData::CountsT& adj_segs = m_block_data.block_subdivisions[adj_block];
-        const Uint retval = block_first_nodes[adj_block] + i + k*adj_segs[XX]*adj_segs[YY];
+        const Uint x_adj = m_face_connectivity.adjacent_element(block, XPOS).second;
+        const Uint retval = operator()(x_adj, 0, j, k);
         cf_assert(retval < block_first_nodes.back());
         return retval;
       }
       else
       {
-        const Uint retval = block_first_nodes[block] + nb_internal_nodes + bounded[block][XX]*y_segs*z_segs + i + k*x_segs;
+        const Uint z_adj = m_face_connectivity.adjacent_element(block, ZPOS).second;
+        const Uint retval = operator()(z_adj, i, j, 0);
         cf_assert(retval < block_first_nodes.back());
         return retval;
       }
     }
+    else
+    {
+      const Uint retval = block_first_nodes[block] + nb_internal_nodes +
+             bounded[block][XX]*y_segs*z_segs +
+             bounded[block][YY]*x_segs*z_segs +
+             bounded[block][ZZ]*x_segs*y_segs +
+             bounded[block][XY]*z_segs +
+             j;
+      cf_assert(retval < block_first_nodes.back());
+      return retval;
+    }
+  }
 
-    // ZPOS plane
-    if(i != x_segs && j != y_segs && k == z_segs)
+  // YPOS and ZPOS intersection
+  if(i != x_segs && j == y_segs && k == z_segs)
+  {
+    if(!bounded[block][YZ])
     {
-      if(!bounded[block][ZZ])
+      if(!bounded[block][YY])
       {
-        const Uint adj_block = m_face_connectivity.adjacent_element(block, ZPOS).second;
-        const BlockData::CountsT& adj_segs = m_block_data.block_subdivisions[adj_block];
-        const Uint retval = block_first_nodes[adj_block] + i + j*adj_segs[XX];
+        const Uint y_adj = m_face_connectivity.adjacent_element(block, YPOS).second;
+        const Uint retval = operator()(y_adj, i, 0, k);
         cf_assert(retval < block_first_nodes.back());
         return retval;
       }
       else
       {
-        const Uint retval = block_first_nodes[block] + nb_internal_nodes + bounded[block][XX]*y_segs*z_segs + bounded[block][YY]*x_segs*z_segs + i + j*x_segs;
+        const Uint z_adj = m_face_connectivity.adjacent_element(block, ZPOS).second;
+        const Uint retval = operator()(z_adj, i, j, 0);
         cf_assert(retval < block_first_nodes.back());
         return retval;
       }
     }
-
-    // XPOS and YPOS intersection
-    if(i == x_segs && j == y_segs && k != z_segs)
+    else
     {
-      if(!bounded[block][XY])
-      {
-        if(!bounded[block][XX])
-        {
-          const Uint x_adj = m_face_connectivity.adjacent_element(block, XPOS).second;
-          const Uint retval = operator()(x_adj, 0, j, k);
-          cf_assert(retval < block_first_nodes.back());
-          return retval;
-        }
-        else
-        {
-          const Uint y_adj = m_face_connectivity.adjacent_element(block, YPOS).second;
-          const Uint retval = operator()(y_adj, i, 0, k);
-          cf_assert(retval < block_first_nodes.back());
-          return retval;
-        }
-      }
-      else
-      {
-        const Uint retval = block_first_nodes[block] + nb_internal_nodes +
-               bounded[block][XX]*y_segs*z_segs +
-               bounded[block][YY]*x_segs*z_segs +
-               bounded[block][ZZ]*x_segs*y_segs +
-               k;
-        cf_assert(retval < block_first_nodes.back());
-        return retval;
-      }
+      const Uint retval = block_first_nodes[block] + nb_internal_nodes +
+             bounded[block][XX]*y_segs*z_segs +
+             bounded[block][YY]*x_segs*z_segs +
+             bounded[block][ZZ]*x_segs*y_segs +
+             bounded[block][XY]*z_segs +
+             bounded[block][XZ]*y_segs +
+             i;
+      cf_assert(retval < block_first_nodes.back());
+      return retval;
     }
+  }
 
-    // XPOS and ZPOS intersection
-    if(i == x_segs && j != y_segs && k == z_segs)
+  // XPOS, YPOS and ZPOS intersection
+  if(i == x_segs && j == y_segs && k == z_segs)
+  {
+    if(!bounded[block][XYZ])
     {
-      if(!bounded[block][XZ])
-      {
-        if(!bounded[block][XX])
-        {
-          const Uint x_adj = m_face_connectivity.adjacent_element(block, XPOS).second;
-          const Uint retval = operator()(x_adj, 0, j, k);
-          cf_assert(retval < block_first_nodes.back());
-          return retval;
-        }
-        else
-        {
-          const Uint z_adj = m_face_connectivity.adjacent_element(block, ZPOS).second;
-          const Uint retval = operator()(z_adj, i, j, 0);
-          cf_assert(retval < block_first_nodes.back());
-          return retval;
-        }
-      }
-      else
+      if(!bounded[block][XX])
       {
-        const Uint retval = block_first_nodes[block] + nb_internal_nodes +
-               bounded[block][XX]*y_segs*z_segs +
-               bounded[block][YY]*x_segs*z_segs +
-               bounded[block][ZZ]*x_segs*y_segs +
-               bounded[block][XY]*z_segs +
-               j;
+        const Uint x_adj = m_face_connectivity.adjacent_element(block, XPOS).second;
+        const Uint retval = operator()(x_adj, 0, j, k);
         cf_assert(retval < block_first_nodes.back());
         return retval;
       }
-    }
-
-    // YPOS and ZPOS intersection
-    if(i != x_segs && j == y_segs && k == z_segs)
-    {
-      if(!bounded[block][YZ])
-      {
-        if(!bounded[block][YY])
-        {
-          const Uint y_adj = m_face_connectivity.adjacent_element(block, YPOS).second;
-          const Uint retval = operator()(y_adj, i, 0, k);
-          cf_assert(retval < block_first_nodes.back());
-          return retval;
-        }
-        else
-        {
-          const Uint z_adj = m_face_connectivity.adjacent_element(block, ZPOS).second;
-          const Uint retval = operator()(z_adj, i, j, 0);
-          cf_assert(retval < block_first_nodes.back());
-          return retval;
-        }
-      }
-      else
+      if(!bounded[block][YY])
       {
-        const Uint retval = block_first_nodes[block] + nb_internal_nodes +
-               bounded[block][XX]*y_segs*z_segs +
-               bounded[block][YY]*x_segs*z_segs +
-               bounded[block][ZZ]*x_segs*y_segs +
-               bounded[block][XY]*z_segs +
-               bounded[block][XZ]*y_segs +
-               i;
+        const Uint y_adj = m_face_connectivity.adjacent_element(block, YPOS).second;
+        const Uint retval = operator()(y_adj, i, 0, k);
         cf_assert(retval < block_first_nodes.back());
         return retval;
       }
-    }
-
-    // XPOS, YPOS and ZPOS intersection
-    if(i == x_segs && j == y_segs && k == z_segs)
-    {
-      if(!bounded[block][XYZ])
-      {
-        if(!bounded[block][XX])
-        {
-          const Uint x_adj = m_face_connectivity.adjacent_element(block, XPOS).second;
-          const Uint retval = operator()(x_adj, 0, j, k);
-          cf_assert(retval < block_first_nodes.back());
-          return retval;
-        }
-        if(!bounded[block][YY])
-        {
-          const Uint y_adj = m_face_connectivity.adjacent_element(block, YPOS).second;
-          const Uint retval = operator()(y_adj, i, 0, k);
-          cf_assert(retval < block_first_nodes.back());
-          return retval;
-        }
-        if(!bounded[block][ZZ])
-        {
-          const Uint z_adj = m_face_connectivity.adjacent_element(block, ZPOS).second;
-          const Uint retval = operator()(z_adj, i, j, 0);
-          cf_assert(retval < block_first_nodes.back());
-          return retval;
-        }
-      }
-      else
+      if(!bounded[block][ZZ])
       {
-        const Uint retval = block_first_nodes[block] + nb_internal_nodes +
-              bounded[block][XX]*y_segs*z_segs +
-              bounded[block][YY]*x_segs*z_segs +
-              bounded[block][ZZ]*x_segs*y_segs +
-              bounded[block][XY]*z_segs +
-              bounded[block][XZ]*y_segs +
-              bounded[block][YZ]*x_segs;
+        const Uint z_adj = m_face_connectivity.adjacent_element(block, ZPOS).second;
+        const Uint retval = operator()(z_adj, i, j, 0);
         cf_assert(retval < block_first_nodes.back());
         return retval;
       }
     }
-
-    throw ShouldNotBeHere(FromHere(), "Bad node index combination");
+    else
+    {
+      const Uint retval = block_first_nodes[block] + nb_internal_nodes +
+            bounded[block][XX]*y_segs*z_segs +
+            bounded[block][YY]*x_segs*z_segs +
+            bounded[block][ZZ]*x_segs*y_segs +
+            bounded[block][XY]*z_segs +
+            bounded[block][XZ]*y_segs +
+            bounded[block][YZ]*x_segs;
+      cf_assert(retval < block_first_nodes.back());
+      return retval;
+    }
   }
 
-  /// Index of the first node in the global node array for each block. The last element is actually the total
-  /// number of nodes in the mesh
-  IndicesT block_first_nodes;
-
-  /// For each block, indicate if it is bounded by a boundary patch, in the X, Y, Z, XY, XZ, YZ and XYZ directions
-  Bools2T bounded;
-
-private:
-  const CFaceConnectivity& m_face_connectivity;
-  const BlockData& m_block_data;
-
-};
+  throw ShouldNotBeHere(FromHere(), "Bad node index combination");
+}
 
-/// Create the first step length and expansion rations in each direction
 void create_mapped_coords(const Uint segments, BlockData::GradingT::const_iterator gradings, CTable<Real>::ArrayT& mapped_coords)
 {
   const Real eps = 150*std::numeric_limits<Real>::epsilon();
@@ -484,9 +455,39 @@ void create_mapped_coords(const Uint segments, BlockData::GradingT::const_iterat
   }
 }
 
-} // detail
+void block_mapped_coords(const CTable<Real>::ArrayT& ksi, const CTable<Real>::ArrayT& eta, const CTable<Real>::ArrayT& zta, const Uint i, const Uint j, const Uint k, Hexa3DLagrangeP1::MappedCoordsT& mapped_coords)
+{
+  Real w[4][3]; // weights for each edge
+  Real w_mag[3]; // Magnitudes of the weights
+
+  // Weights are calculating according to the BlockMesh algorithm
+  w[0][KSI] = (1. - ksi[i][0])*(1. - eta[j][0])*(1. - zta[k][0]) + (1. + ksi[i][0])*(1. - eta[j][1])*(1. - zta[k][1]);
+  w[1][KSI] = (1. - ksi[i][1])*(1. + eta[j][0])*(1. - zta[k][3]) + (1. + ksi[i][1])*(1. + eta[j][1])*(1. - zta[k][2]);
+  w[2][KSI] = (1. - ksi[i][2])*(1. + eta[j][3])*(1. + zta[k][3]) + (1. + ksi[i][2])*(1. + eta[j][2])*(1. + zta[k][2]);
+  w[3][KSI] = (1. - ksi[i][3])*(1. - eta[j][3])*(1. + zta[k][0]) + (1. + ksi[i][3])*(1. - eta[j][2])*(1. + zta[k][1]);
+  w_mag[KSI] = (w[0][KSI] + w[1][KSI] + w[2][KSI] + w[3][KSI]);
+
+  w[0][ETA] = (1. - eta[j][0])*(1. - ksi[i][0])*(1. - zta[k][0]) + (1. + eta[j][0])*(1. - ksi[i][1])*(1. - zta[k][3]);
+  w[1][ETA] = (1. - eta[j][1])*(1. + ksi[i][0])*(1. - zta[k][1]) + (1. + eta[j][1])*(1. + ksi[i][1])*(1. - zta[k][2]);
+  w[2][ETA] = (1. - eta[j][2])*(1. + ksi[i][3])*(1. + zta[k][1]) + (1. + eta[j][2])*(1. + ksi[i][2])*(1. + zta[k][2]);
+  w[3][ETA] = (1. - eta[j][3])*(1. - ksi[i][3])*(1. + zta[k][0]) + (1. + eta[j][3])*(1. - ksi[i][2])*(1. + zta[k][3]);
+  w_mag[ETA] = (w[0][ETA] + w[1][ETA] + w[2][ETA] + w[3][ETA]);
+
+  w[0][ZTA] = (1. - zta[k][0])*(1. - ksi[i][0])*(1. - eta[j][0]) + (1. + zta[k][0])*(1. - ksi[i][3])*(1. - eta[j][3]);
+  w[1][ZTA] = (1. - zta[k][1])*(1. + ksi[i][0])*(1. - eta[j][1]) + (1. + zta[k][1])*(1. + ksi[i][3])*(1. - eta[j][2]);
+  w[2][ZTA] = (1. - zta[k][2])*(1. + ksi[i][1])*(1. + eta[j][1]) + (1. + zta[k][2])*(1. + ksi[i][2])*(1. + eta[j][2]);
+  w[3][ZTA] = (1. - zta[k][3])*(1. - ksi[i][1])*(1. + eta[j][0]) + (1. + zta[k][3])*(1. - ksi[i][2])*(1. + eta[j][3]);
+  w_mag[ZTA] = (w[0][ZTA] + w[1][ZTA] + w[2][ZTA] + w[3][ZTA]);
+
+  // Get the mapped coordinates of the node
+  mapped_coords[KSI] = (w[0][KSI]*ksi[i][0] + w[1][KSI]*ksi[i][1] + w[2][KSI]*ksi[i][2] + w[3][KSI]*ksi[i][3]) / w_mag[KSI];
+  mapped_coords[ETA] = (w[0][ETA]*eta[j][0] + w[1][ETA]*eta[j][1] + w[2][ETA]*eta[j][2] + w[3][ETA]*eta[j][3]) / w_mag[ETA];
+  mapped_coords[ZTA] = (w[0][ZTA]*zta[k][0] + w[1][ZTA]*zta[k][1] + w[2][ZTA]*zta[k][2] + w[3][ZTA]*zta[k][3]) / w_mag[ZTA];
+}
 
-void build_mesh(const BlockData& block_data, CMesh& mesh)
+/// Implementation of build_mesh and build_structured_mesh. If structured is true, the volume elements
+/// are stored in a CStructuredElements component and no volume connectivity table is built
+void build_mesh(const BlockData& block_data, CMesh& mesh, const bool structured)
 {
   const Uint nb_procs = Comm::PE::instance().size();
   const Uint rank = Comm::PE::instance().rank();
@@ -543,6 +544,9 @@ void build_mesh(const BlockData& block_data, CMesh& mesh)
   // Get the dimensionality info
   const std::pair<Uint,Uint> dims = detail::dimensionality(block_data.block_distribution.back(), volume_to_face_connectivity, patch_types);
 
+  if(structured && dims.first != DIM_3D)
+    throw NotImplemented(FromHere(), "Structured block storage is only supported for 3D meshes");
+
   // 3D helper mesh in case we have a non-3D problem
   CMesh::Ptr tmp_mesh3d;
   if(dims.first == DIM_2D)
@@ -563,9 +567,21 @@ void build_mesh(const BlockData& block_data, CMesh& mesh)
   mesh_nodes_comp.resize(nodes_end - nodes_begin);
 
   // Create the volume cells connectivity
-  CElements& volume_elements = root_region.create_region("volume").create_elements("CF.Mesh.SF.Hexa3DLagrangeP1", mesh_nodes_comp);
-  volume_elements.node_connectivity().resize(elements_dist[rank+1]-elements_dist[rank]);
-  CTable<Uint>::ArrayT& volume_connectivity = volume_elements.node_connectivity().array();
+  CRegion& volume_region = root_region.create_region("volume");
+  if(structured)
+  {
+    CStructuredElements& structured_elements = volume_region.create_component<CStructuredElements>("elements_CF.Mesh.SF.Hexa3DLagrangeP1");
+    structured_elements.add_tag("GeometryElements");
+    structured_elements.initialize("CF.Mesh.SF.Hexa3DLagrangeP1", mesh_nodes_comp);
+    structured_elements.initialize_blocks(block_data);
+  }
+  else
+  {
+    volume_region.create_elements("CF.Mesh.SF.Hexa3DLagrangeP1", mesh_nodes_comp).node_connectivity().resize(elements_dist[rank+1]-elements_dist[rank]);
+  }
+
+  // Accessing the connectivity of structured elements would store it, so it is only used in the explicit case
+  CTable<Uint>::ArrayT* volume_connectivity = structured ? 0 : &find_component<CElements>(volume_region).node_connectivity().array();
 
   // Fill the volume arrays
   Uint element_idx = 0; // global element index
@@ -582,38 +598,14 @@ void build_mesh(const BlockData& block_data, CMesh& mesh)
     detail::create_mapped_coords(segments[YY], gradings.begin() + 4, eta);
     detail::create_mapped_coords(segments[ZZ], gradings.begin() + 8, zta);
 
-    Real w[4][3]; // weights for each edge
-    Real w_mag[3]; // Magnitudes of the weights
     for(Uint k = 0; k <= segments[ZZ]; ++k)
     {
       for(Uint j = 0; j <= segments[YY]; ++j)
       {
         for(Uint i = 0; i <= segments[XX]; ++i)
         {
-          // Weights are calculating according to the BlockMesh algorithm
-          w[0][KSI] = (1. - ksi[i][0])*(1. - eta[j][0])*(1. - zta[k][0]) + (1. + ksi[i][0])*(1. - eta[j][1])*(1. - zta[k][1]);
-          w[1][KSI] = (1. - ksi[i][1])*(1. + eta[j][0])*(1. - zta[k][3]) + (1. + ksi[i][1])*(1. + eta[j][1])*(1. - zta[k][2]);
-          w[2][KSI] = (1. - ksi[i][2])*(1. + eta[j][3])*(1. + zta[k][3]) + (1. + ksi[i][2])*(1. + eta[j][2])*(1. + zta[k][2]);
-          w[3][KSI] = (1. - ksi[i][3])*(1. - eta[j][3])*(1. + zta[k][0]) + (1. + ksi[i][3])*(1. - eta[j][2])*(1. + zta[k][1]);
-          w_mag[KSI] = (w[0][KSI] + w[1][KSI] + w[2][KSI] + w[3][KSI]);
-
-          w[0][ETA] = (1. - eta[j][0])*(1. - ksi[i][0])*(1. - zta[k][0]) + (1. + eta[j][0])*(1. - ksi[i][1])*(1. - zta[k][3]);
-          w[1][ETA] = (1. - eta[j][1])*(1. + ksi[i][0])*(1. - zta[k][1]) + (1. + eta[j][1])*(1. + ksi[i][1])*(1. - zta[k][2]);
-          w[2][ETA] = (1. - eta[j][2])*(1. + ksi[i][3])*(1. + zta[k][1]) + (1. + eta[j][2])*(1. + ksi[i][2])*(1. + zta[k][2]);
-          w[3][ETA] = (1. - eta[j][3])*(1. - ksi[i][3])*(1. + zta[k][0]) + (1. + eta[j][3])*(1. - ksi[i][2])*(1. + zta[k][3]);
-          w_mag[ETA] = (w[0][ETA] + w[1][ETA] + w[2][ETA] + w[3][ETA]);
-
-          w[0][ZTA] = (1. - zta[k][0])*(1. - ksi[i][0])*(1. - eta[j][0]) + (1. + zta[k][0])*(1. - ksi[i][3])*(1. - eta[j][3]);
-          w[1][ZTA] = (1. - zta[k][1])*(1. + ksi[i][0])*(1. - eta[j][1]) + (1. + zta[k][1])*(1. + ksi[i][3])*(1. - eta[j][2]);
-          w[2][ZTA] = (1. - zta[k][2])*(1. + ksi[i][1])*(1. + eta[j][1]) + (1. + zta[k][2])*(1. + ksi[i][2])*(1. + eta[j][2]);
-          w[3][ZTA] = (1. - zta[k][3])*(1. - ksi[i][1])*(1. + eta[j][0]) + (1. + zta[k][3])*(1. - ksi[i][2])*(1. + eta[j][3]);
-          w_mag[ZTA] = (w[0][ZTA] + w[1][ZTA] + w[2][ZTA] + w[3][ZTA]);
-
-          // Get the mapped coordinates of the node to add
           SF::MappedCoordsT mapped_coords;
-          mapped_coords[KSI] = (w[0][KSI]*ksi[i][0] + w[1][KSI]*ksi[i][1] + w[2][KSI]*ksi[i][2] + w[3][KSI]*ksi[i][3]) / w_mag[KSI];
-          mapped_coords[ETA] = (w[0][ETA]*eta[j][0] + w[1][ETA]*eta[j][1] + w[2][ETA]*eta[j][2] + w[3][ETA]*eta[j][3]) / w_mag[ETA];
-          mapped_coords[ZTA] = (w[0][ZTA]*zta[k][0] + w[1][ZTA]*zta[k][1] + w[2][ZTA]*zta[k][2] + w[3][ZTA]*zta[k][3]) / w_mag[ZTA];
+          detail::block_mapped_coords(ksi, eta, zta, i, j, k, mapped_coords);
 
           SF::ShapeFunctionsT sf;
           SF::shape_function_value(mapped_coords, sf);
@@ -634,14 +626,17 @@ void build_mesh(const BlockData& block_data, CMesh& mesh)
       }
     }
 
-    // Fill the volume connectivity table
+    // Fill the volume connectivity table, unless it is computed on the fly
+    if(structured)
+      continue;
+
     for(Uint k = 0; k != segments[ZZ]; ++k)
     {
       for(Uint j = 0; j != segments[YY]; ++j)
       {
         for(Uint i = 0; i != segments[XX]; ++i)
         {
-          CTable<Uint>::Row element_connectivity = volume_connectivity[element_idx++];
+          CTable<Uint>::Row element_connectivity = (*volume_connectivity)[element_idx++];
           element_connectivity[0] = nodes(block, i  , j  , k  );
           element_connectivity[1] = nodes(block, i+1, j  , k  );
           element_connectivity[2] = nodes(block, i+1, j+1, k  );
@@ -945,6 +940,18 @@ void build_mesh(const BlockData& block_data, CMesh& mesh)
   }
 }
 
+} // detail
+
+void build_mesh(const BlockData& block_data, CMesh& mesh)
+{
+  detail::build_mesh(block_data, mesh, false);
+}
+
+void build_structured_mesh(const BlockData& block_data, CMesh& mesh)
+{
+  detail::build_mesh(block_data, mesh, true);
+}
+
 void partition_blocks(const BlockData& blocks_in, const Uint nb_partitions, const CoordXYZ direction, BlockData& blocks_out)
 {
   // Create a mesh for the serial blocks
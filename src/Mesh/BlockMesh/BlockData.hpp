@@ -67,6 +67,12 @@ struct BlockMesh_API BlockData
 /// @param mesh Stores the generated mesh
 void BlockMesh_API build_mesh(const CF::Mesh::BlockMesh::BlockData& block_data, CF::Mesh::CMesh& mesh);
 
+/// Same as build_mesh, but the volume blocks are stored implicitly in a CStructuredElements component,
+/// so the volume connectivity table is only built if an algorithm accesses it. Only 3D meshes are supported.
+/// @param block_data Description of the structured blocks that make up the grid
+/// @param mesh Stores the generated mesh
+void BlockMesh_API build_structured_mesh(const CF::Mesh::BlockMesh::BlockData& block_data, CF::Mesh::CMesh& mesh);
+
 /// Partition a mesh along the X, Y or Z axis into the given number of partitions
 /// Partitioning ensures that processor boundaries lie on a boundary between blocks
 void BlockMesh_API partition_blocks(const BlockData& blocks_in, const Uint nb_partitions, const CoordXYZ direction, BlockData& blocks_out);
@@ -0,0 +1,76 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef CF_Mesh_BlockMesh_BlockDataDetail_hpp
+#define CF_Mesh_BlockMesh_BlockDataDetail_hpp
+
+#include <map>
+
+#include "Common/BoostArray.hpp"
+
+#include "Mesh/CTable.hpp"
+#include "Mesh/ConnectivityData.hpp"
+#include "Mesh/BlockMesh/BlockData.hpp"
+#include "Mesh/SF/Hexa3DLagrangeP1.hpp"
+
+namespace CF {
+namespace Mesh {
+namespace BlockMesh {
+
+/// Helper functions for mesh building, shared between the explicit and the structured block meshes
+namespace detail {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Creates a mesh containing only the blocks
+void create_block_mesh(const BlockData& block_data, CMesh& mesh, std::map<std::string, std::string>& patch_types);
+
+/// looks up node indices based on structured block indices
+struct NodeIndices
+{
+  typedef std::vector<Uint> IndicesT;
+  typedef std::vector<Uint> CountsT;
+  typedef boost::multi_array<bool, 2> Bools2T;
+
+  // Intersection of planes
+  enum Bounds { XY = 3, XZ = 4, YZ = 5, XYZ = 6 };
+
+  NodeIndices(const CFaceConnectivity& face_connectivity, const BlockData& block_data);
+
+  /// Look up the global node index of node (i, j, k) in block
+  /// @param block The block index
+  /// @param i Node index in the X direction
+  /// @param j Node index in the Y direction
+  /// @param k Node index in the Z direction
+  Uint operator()(const Uint block, const Uint i, const Uint j, const Uint k) const;
+
+  /// Index of the first node in the global node array for each block. The last element is actually the total
+  /// number of nodes in the mesh
+  IndicesT block_first_nodes;
+
+  /// For each block, indicate if it is bounded by a boundary patch, in the X, Y, Z, XY, XZ, YZ and XYZ directions
+  Bools2T bounded;
+
+private:
+  const CFaceConnectivity& m_face_connectivity;
+  const BlockData& m_block_data;
+
+};
+
+/// Create the first step length and expansion rations in each direction
+void create_mapped_coords(const Uint segments, BlockData::GradingT::const_iterator gradings, CTable<Real>::ArrayT& mapped_coords);
+
+/// Compute the mapped coordinates of node (i, j, k) in a block, using the mapped coordinates along each edge as computed by create_mapped_coords
+void block_mapped_coords(const CTable<Real>::ArrayT& ksi, const CTable<Real>::ArrayT& eta, const CTable<Real>::ArrayT& zta, const Uint i, const Uint j, const Uint k, SF::Hexa3DLagrangeP1::MappedCoordsT& mapped_coords);
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // detail
+} // BlockMesh
+} // Mesh
+} // CF
+
+#endif /* CF_Mesh_BlockMesh_BlockDataDetail_hpp */
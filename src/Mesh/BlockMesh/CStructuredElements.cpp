@@ -0,0 +1,387 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <algorithm>
+
+#include <boost/bind.hpp>
+
+#include "Common/BasicExceptions.hpp"
+#include "Common/CBuilder.hpp"
+#include "Common/FindComponents.hpp"
+
+#include "Common/MPI/PE.hpp"
+
+#include "Mesh/CMesh.hpp"
+#include "Mesh/CSpace.hpp"
+#include "Mesh/ElementData.hpp"
+#include "Mesh/Geometry.hpp"
+
+#include "Mesh/BlockMesh/BlockDataDetail.hpp"
+#include "Mesh/BlockMesh/CStructuredElements.hpp"
+
+namespace CF {
+namespace Mesh {
+namespace BlockMesh {
+
+using namespace Common;
+using namespace CF::Mesh::SF;
+
+////////////////////////////////////////////////////////////////////////////////
+
+Common::ComponentBuilder < CStructuredElements, CEntities, LibBlockMesh > CStructuredElements_Builder;
+
+////////////////////////////////////////////////////////////////////////////////
+
+class CStructuredElements::Implementation
+{
+public:
+  Implementation() :
+    blocks_begin(0),
+    blocks_end(0),
+    block_faces(0),
+    connectivity_stored(false)
+  {
+    block_first_elements.push_back(0);
+  }
+
+  void initialize(const BlockData& data)
+  {
+    const Uint rank = Comm::PE::instance().rank();
+    cf_assert(data.block_distribution.size() == Comm::PE::instance().size()+1);
+
+    block_data = data;
+    blocks_begin = block_data.block_distribution[rank];
+    blocks_end = block_data.block_distribution[rank+1];
+
+    // Coarse mesh with one element per block, used to find the connectivity between the blocks
+    block_mesh = allocate_component<CMesh>("block_mesh");
+    std::map<std::string, std::string> patch_types;
+    detail::create_block_mesh(block_data, *block_mesh, patch_types);
+
+    const CElements& block_elements = find_component_recursively_with_name<CElements>(*block_mesh, "elements_CF.Mesh.SF.Hexa3DLagrangeP1");
+    block_faces = &find_component<CFaceConnectivity>(block_elements);
+    block_connectivity = &block_elements.node_connectivity();
+    block_coordinates = &block_elements.geometry().coordinates();
+    nodes.reset(new detail::NodeIndices(*block_faces, block_data));
+
+    // Element offsets and mapped coordinates along the edges, for each local block
+    const Uint nb_local_blocks = blocks_end - blocks_begin;
+    block_first_elements.assign(1, 0);
+    block_first_elements.reserve(nb_local_blocks+1);
+    ksi.resize(nb_local_blocks);
+    eta.resize(nb_local_blocks);
+    zta.resize(nb_local_blocks);
+    for(Uint block = blocks_begin; block != blocks_end; ++block)
+    {
+      const BlockData::CountsT& segments = block_data.block_subdivisions[block];
+      const BlockData::GradingT& gradings = block_data.block_gradings[block];
+      block_first_elements.push_back(block_first_elements.back() + segments[XX]*segments[YY]*segments[ZZ]);
+
+      const Uint local_block = block - blocks_begin;
+      detail::create_mapped_coords(segments[XX], gradings.begin(), ksi[local_block]);
+      detail::create_mapped_coords(segments[YY], gradings.begin() + 4, eta[local_block]);
+      detail::create_mapped_coords(segments[ZZ], gradings.begin() + 8, zta[local_block]);
+    }
+  }
+
+  void element_ijk(const Uint elem_idx, Uint& block, Uint& i, Uint& j, Uint& k) const
+  {
+    cf_assert(elem_idx < block_first_elements.back());
+    const Uint local_block = std::upper_bound(block_first_elements.begin(), block_first_elements.end(), elem_idx) - block_first_elements.begin() - 1;
+    block = blocks_begin + local_block;
+
+    const BlockData::CountsT& segments = block_data.block_subdivisions[block];
+    const Uint local_elem = elem_idx - block_first_elements[local_block];
+    i = local_elem % segments[XX];
+    j = (local_elem / segments[XX]) % segments[YY];
+    k = local_elem / (segments[XX]*segments[YY]);
+  }
+
+  Uint element_index(const Uint block, const Uint i, const Uint j, const Uint k) const
+  {
+    cf_assert(block >= blocks_begin && block < blocks_end);
+    const BlockData::CountsT& segments = block_data.block_subdivisions[block];
+    cf_assert(i < segments[XX] && j < segments[YY] && k < segments[ZZ]);
+    return block_first_elements[block - blocks_begin] + i + j*segments[XX] + k*segments[XX]*segments[YY];
+  }
+
+  /// Node indices in the same order as in build_mesh
+  template<typename RowT>
+  void element_nodes(const Uint elem_idx, RowT row) const
+  {
+    Uint block, i, j, k;
+    element_ijk(elem_idx, block, i, j, k);
+    row[0] = (*nodes)(block, i  , j  , k  );
+    row[1] = (*nodes)(block, i+1, j  , k  );
+    row[2] = (*nodes)(block, i+1, j+1, k  );
+    row[3] = (*nodes)(block, i  , j+1, k  );
+    row[4] = (*nodes)(block, i  , j  , k+1);
+    row[5] = (*nodes)(block, i+1, j  , k+1);
+    row[6] = (*nodes)(block, i+1, j+1, k+1);
+    row[7] = (*nodes)(block, i  , j+1, k+1);
+  }
+
+  /// Element in the adjacent block, or the end index if there is no local neighbour
+  Uint adjacent_block_element(const Uint block, const Uint face, const Uint i, const Uint j, const Uint k) const
+  {
+    const CFaceConnectivity::ElementReferenceT adjacent = block_faces->adjacent_element(block, face);
+    if(adjacent.first->element_type().dimensionality() != DIM_3D)
+      return block_first_elements.back();
+
+    const Uint adj_block = adjacent.second;
+    if(adj_block < blocks_begin || adj_block >= blocks_end)
+      return block_first_elements.back();
+
+    // Blocks are assumed to be aligned, as in detail::NodeIndices
+    const BlockData::CountsT& adj_segs = block_data.block_subdivisions[adj_block];
+    switch(face)
+    {
+      case Hexa3DLagrangeP1::XNEG:
+        return element_index(adj_block, adj_segs[XX]-1, j, k);
+      case Hexa3DLagrangeP1::XPOS:
+        return element_index(adj_block, 0, j, k);
+      case Hexa3DLagrangeP1::YNEG:
+        return element_index(adj_block, i, adj_segs[YY]-1, k);
+      case Hexa3DLagrangeP1::YPOS:
+        return element_index(adj_block, i, 0, k);
+      case Hexa3DLagrangeP1::ZNEG:
+        return element_index(adj_block, i, j, adj_segs[ZZ]-1);
+      case Hexa3DLagrangeP1::ZPOS:
+        return element_index(adj_block, i, j, 0);
+      default:
+        throw ShouldNotBeHere(FromHere(), "Invalid face index");
+    }
+  }
+
+  Uint adjacent_element(const Uint elem_idx, const Uint face) const
+  {
+    Uint block, i, j, k;
+    element_ijk(elem_idx, block, i, j, k);
+    const BlockData::CountsT& segments = block_data.block_subdivisions[block];
+
+    switch(face)
+    {
+      case Hexa3DLagrangeP1::XNEG:
+        return i != 0 ? elem_idx - 1 : adjacent_block_element(block, face, i, j, k);
+      case Hexa3DLagrangeP1::XPOS:
+        return i != segments[XX]-1 ? elem_idx + 1 : adjacent_block_element(block, face, i, j, k);
+      case Hexa3DLagrangeP1::YNEG:
+        return j != 0 ? elem_idx - segments[XX] : adjacent_block_element(block, face, i, j, k);
+      case Hexa3DLagrangeP1::YPOS:
+        return j != segments[YY]-1 ? elem_idx + segments[XX] : adjacent_block_element(block, face, i, j, k);
+      case Hexa3DLagrangeP1::ZNEG:
+        return k != 0 ? elem_idx - segments[XX]*segments[YY] : adjacent_block_element(block, face, i, j, k);
+      case Hexa3DLagrangeP1::ZPOS:
+        return k != segments[ZZ]-1 ? elem_idx + segments[XX]*segments[YY] : adjacent_block_element(block, face, i, j, k);
+      default:
+        throw ShouldNotBeHere(FromHere(), "Invalid face index");
+    }
+  }
+
+  void compute_node_coordinates(const Uint block, const Uint i, const Uint j, const Uint k, RealVector& coords) const
+  {
+    cf_assert(block >= blocks_begin && block < blocks_end);
+    const Uint local_block = block - blocks_begin;
+
+    Hexa3DLagrangeP1::NodeMatrixT block_nodes;
+    fill(block_nodes, *block_coordinates, (*block_connectivity)[block]);
+
+    Hexa3DLagrangeP1::MappedCoordsT mapped_coords;
+    detail::block_mapped_coords(ksi[local_block], eta[local_block], zta[local_block], i, j, k, mapped_coords);
+
+    Hexa3DLagrangeP1::ShapeFunctionsT sf;
+    Hexa3DLagrangeP1::shape_function_value(mapped_coords, sf);
+
+    coords.resize(DIM_3D);
+    coords = (sf * block_nodes).transpose();
+  }
+
+  BlockData block_data;
+  Uint blocks_begin;
+  Uint blocks_end;
+
+  /// Mesh with one hexahedron per block
+  CMesh::Ptr block_mesh;
+  const CFaceConnectivity* block_faces;
+  const CTable<Uint>* block_connectivity;
+  const CTable<Real>* block_coordinates;
+  boost::scoped_ptr<detail::NodeIndices> nodes;
+
+  /// Local index of the first element of each local block, the last element is the total number of elements
+  std::vector<Uint> block_first_elements;
+
+  /// Mapped coordinates along the edges of each local block
+  std::vector<CTable<Real>::ArrayT> ksi, eta, zta;
+
+  /// True once the connectivity table was filled
+  bool connectivity_stored;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+CStructuredElements::CStructuredElements ( const std::string& name ) :
+  CElements ( name ),
+  m_implementation(new Implementation())
+{
+  properties()["brief"] = std::string("Hexahedral elements stored implicitly as structured blocks");
+  properties()["description"] = std::string("Element connectivity and neighbours are computed from the block subdivisions,\n")
+  +std::string("so no connectivity table needs to be stored");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+CStructuredElements::~CStructuredElements()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void CStructuredElements::initialize_blocks(const BlockData& block_data)
+{
+  m_implementation->initialize(block_data);
+
+  // Only store the connectivity table when some algorithm asks for it
+  const boost::weak_ptr<CStructuredElements const> self = as_ptr<CStructuredElements>();
+  space(MeshSpaces::MESH_NODES).set_connectivity_builder(boost::bind(&CStructuredElements::fill_connectivity, self, _1));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Uint CStructuredElements::size() const
+{
+  return m_implementation->block_first_elements.back();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+RealMatrix CStructuredElements::get_coordinates(const Uint elem_idx) const
+{
+  RealMatrix elem_coords(Hexa3DLagrangeP1::nb_nodes, geometry().coordinates().row_size());
+  put_coordinates(elem_coords, elem_idx);
+  return elem_coords;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void CStructuredElements::put_coordinates(RealMatrix& elem_coords, const Uint elem_idx) const
+{
+  const CTable<Real>& coords_table = geometry().coordinates();
+  Uint elem_nodes[Hexa3DLagrangeP1::nb_nodes];
+  m_implementation->element_nodes(elem_idx, elem_nodes);
+
+  const Uint nb_nodes=elem_coords.rows();
+  const Uint dim=elem_coords.cols();
+
+  for(Uint node = 0; node != nb_nodes; ++node)
+    for (Uint d=0; d<dim; ++d)
+      elem_coords(node,d) = coords_table[elem_nodes[node]][d];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Uint CStructuredElements::nb_blocks() const
+{
+  return m_implementation->blocks_end - m_implementation->blocks_begin;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Uint CStructuredElements::first_block() const
+{
+  return m_implementation->blocks_begin;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+const std::vector<Uint>& CStructuredElements::block_subdivisions(const Uint block) const
+{
+  return m_implementation->block_data.block_subdivisions[block];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void CStructuredElements::element_ijk(const Uint elem_idx, Uint& block, Uint& i, Uint& j, Uint& k) const
+{
+  m_implementation->element_ijk(elem_idx, block, i, j, k);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Uint CStructuredElements::element_index(const Uint block, const Uint i, const Uint j, const Uint k) const
+{
+  return m_implementation->element_index(block, i, j, k);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Uint CStructuredElements::node_index(const Uint block, const Uint i, const Uint j, const Uint k) const
+{
+  return (*m_implementation->nodes)(block, i, j, k);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Uint CStructuredElements::adjacent_element(const Uint elem_idx, const Uint face) const
+{
+  return m_implementation->adjacent_element(elem_idx, face);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void CStructuredElements::compute_node_coordinates(const Uint block, const Uint i, const Uint j, const Uint k, RealVector& coords) const
+{
+  m_implementation->compute_node_coordinates(block, i, j, k, coords);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void CStructuredElements::make_connectivity(CTable<Uint>& connectivity) const
+{
+  const Uint nb_elems = size();
+  connectivity.set_row_size(Hexa3DLagrangeP1::nb_nodes);
+  connectivity.resize(nb_elems);
+  for(Uint elem = 0; elem != nb_elems; ++elem)
+    m_implementation->element_nodes(elem, connectivity[elem]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void CStructuredElements::fill_connectivity(const boost::weak_ptr<CStructuredElements const>& elements, CConnectivity& connectivity)
+{
+  const CStructuredElements::ConstPtr self = elements.lock();
+  if(is_null(self))
+    throw SetupError(FromHere(), "Structured elements for connectivity " + connectivity.uri().string() + " no longer exist");
+
+  self->make_connectivity(connectivity);
+  self->m_implementation->connectivity_stored = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool CStructuredElements::is_connectivity_stored() const
+{
+  return m_implementation->connectivity_stored;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Uint CStructuredElements::block_first_node(const Uint block) const
+{
+  return m_implementation->nodes->block_first_nodes[block];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void CStructuredElements::element_nodes(const Uint elem_idx, Uint* nodes) const
+{
+  m_implementation->element_nodes(elem_idx, nodes);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // BlockMesh
+} // Mesh
+} // CF
@@ -0,0 +1,158 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef CF_Mesh_BlockMesh_CStructuredElements_hpp
+#define CF_Mesh_BlockMesh_CStructuredElements_hpp
+
+#include <boost/scoped_ptr.hpp>
+
+#include "Mesh/CElements.hpp"
+
+#include "Mesh/BlockMesh/LibBlockMesh.hpp"
+
+namespace CF {
+namespace Mesh {
+namespace BlockMesh {
+
+struct BlockData;
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Hexahedral volume elements that are stored implicitly as a set of structured blocks.
+/// Only the block subdivisions and gradings are kept: the element connectivity, the neighbours
+/// and the mapped node positions are obtained by index arithmetic on (block, i, j, k).
+/// The node_connectivity() table is only filled the first time it is accessed, so generic algorithms
+/// keep working, while algorithms that use for_each_element or the index functions never store it.
+class BlockMesh_API CStructuredElements : public CElements {
+
+public: // typedefs
+
+  typedef boost::shared_ptr<CStructuredElements> Ptr;
+  typedef boost::shared_ptr<CStructuredElements const> ConstPtr;
+
+public: // functions
+
+  /// Contructor
+  /// @param name of the component
+  CStructuredElements ( const std::string& name );
+
+  /// Virtual destructor
+  virtual ~CStructuredElements();
+
+  /// Get the class name
+  static std::string type_name () { return "CStructuredElements"; }
+
+  /// Set up the block structure. Only the blocks assigned to this rank in block_data.block_distribution
+  /// are represented. Node indices are numbered in the same way as in build_mesh
+  void initialize_blocks(const BlockData& block_data);
+
+  /// Number of elements in all blocks on this rank
+  virtual Uint size() const;
+
+  virtual RealMatrix get_coordinates(const Uint elem_idx) const;
+
+  virtual void put_coordinates(RealMatrix& coordinates, const Uint elem_idx) const;
+
+  /// Number of blocks on this rank
+  Uint nb_blocks() const;
+
+  /// Global index of the first block on this rank
+  Uint first_block() const;
+
+  /// Subdivisions of the given (global) block index, along X, Y and Z
+  const std::vector<Uint>& block_subdivisions(const Uint block) const;
+
+  /// Convert a local element index to the global block index and the structured indices inside the block
+  void element_ijk(const Uint elem_idx, Uint& block, Uint& i, Uint& j, Uint& k) const;
+
+  /// Local element index of element (i, j, k) in the given global block index
+  Uint element_index(const Uint block, const Uint i, const Uint j, const Uint k) const;
+
+  /// Node index of node (i, j, k) in the given global block index
+  Uint node_index(const Uint block, const Uint i, const Uint j, const Uint k) const;
+
+  /// Local index of the element that is adjacent to elem_idx across the given face (numbered as in Hexa3DLagrangeP1::FaceNumbering).
+  /// Returns size() if the face is on a boundary patch or if the neighbour is located on another rank
+  Uint adjacent_element(const Uint elem_idx, const Uint face) const;
+
+  /// Compute the coordinates of node (i, j, k) in the given block from the block gradings,
+  /// without using the coordinates stored in the geometry
+  void compute_node_coordinates(const Uint block, const Uint i, const Uint j, const Uint k, RealVector& coords) const;
+
+  /// Store the element to node connectivity explicitly in the given table, i.e. the table
+  /// that would have been built by build_mesh
+  void make_connectivity(CTable<Uint>& connectivity) const;
+
+  /// True if the node_connectivity() table was filled, because some algorithm accessed it
+  bool is_connectivity_stored() const;
+
+  /// Index of the first node of the given (global) block. Node (i, j, k) of the block has index
+  /// first_node + i + j*segments[XX] + k*segments[XX]*segments[YY], unless it lies on the positive X, Y or Z face of the block.
+  Uint block_first_node(const Uint block) const;
+
+  /// Loop over the elements of the given (global) block in (i, j, k) order, calling functor(elem_idx, nodes)
+  /// for each element, with nodes an array of the 8 node indices, in the order of Hexa3DLagrangeP1.
+  /// Nodes are obtained by adding constant strides to the first node of the element, except for the
+  /// elements on the positive faces of the block, which use the node lookup.
+  /// No connectivity table is needed, and the loop can be called from several threads at once.
+  template<typename FunctorT>
+  void for_each_element(const Uint block, FunctorT& functor) const
+  {
+    const std::vector<Uint>& segments = block_subdivisions(block);
+    const Uint stride_y = segments[XX];
+    const Uint stride_z = segments[XX]*segments[YY];
+    const Uint first_node = block_first_node(block);
+
+    Uint nodes[8];
+    Uint elem_idx = element_index(block, 0, 0, 0);
+    for(Uint k = 0; k != segments[ZZ]; ++k)
+    {
+      for(Uint j = 0; j != segments[YY]; ++j)
+      {
+        const bool interior_jk = (j+1 != segments[YY]) && (k+1 != segments[ZZ]);
+        for(Uint i = 0; i != segments[XX]; ++i, ++elem_idx)
+        {
+          if(interior_jk && i+1 != segments[XX])
+          {
+            const Uint n0 = first_node + i + j*stride_y + k*stride_z;
+            nodes[0] = n0;
+            nodes[1] = n0 + 1;
+            nodes[2] = n0 + 1 + stride_y;
+            nodes[3] = n0 + stride_y;
+            nodes[4] = n0 + stride_z;
+            nodes[5] = n0 + 1 + stride_z;
+            nodes[6] = n0 + 1 + stride_y + stride_z;
+            nodes[7] = n0 + stride_y + stride_z;
+          }
+          else
+          {
+            element_nodes(elem_idx, nodes);
+          }
+          functor(elem_idx, static_cast<const Uint*>(nodes));
+        }
+      }
+    }
+  }
+
+  /// Compute the 8 node indices of the given element, without using the connectivity table
+  void element_nodes(const Uint elem_idx, Uint* nodes) const;
+
+private:
+  /// Fills the connectivity table of the given elements when it is first accessed.
+  /// The elements are held through a weak pointer, so a space that outlives them can't call into a deleted object
+  static void fill_connectivity(const boost::weak_ptr<CStructuredElements const>& elements, CConnectivity& connectivity);
+
+  class Implementation;
+  boost::scoped_ptr<Implementation> m_implementation;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // BlockMesh
+} // Mesh
+} // CF
+
+#endif // CF_Mesh_BlockMesh_CStructuredElements_hpp
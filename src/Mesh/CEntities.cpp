@@ -43,7 +43,8 @@ CEntities::MeshSpaces::Convert::Convert()
 ////////////////////////////////////////////////////////////////////////////////
 
 CEntities::CEntities ( const std::string& name ) :
-  Component ( name )
+  Component ( name ),
+  m_cost(0.)
 {
   mark_basic();
   properties()["brief"] = std::string("Holds information of elements of one type");
@@ -10,6 +10,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "Common/EnumT.hpp"
+#include "Common/Timer.hpp"
 
 #include "Math/MatrixTypes.hpp"
 #include "Mesh/LibMesh.hpp"
@@ -130,6 +131,19 @@ public: // functions
 
   void signature_create_space ( Common::SignalArgs& node);
 
+  /// Add measured work for a loop over these entities, e.g. the wall time in seconds.
+  /// Used to weigh the entities when load balancing.
+  void add_cost(const Real cost) { m_cost += cost; }
+
+  /// Total work measured since the last reset_cost()
+  Real cost() const { return m_cost; }
+
+  /// Work measured per entity since the last reset_cost(), zero if there are no entities
+  Real cost_per_entity() const { return size() ? m_cost / static_cast<Real>(size()) : 0.; }
+
+  /// Restart the measurement of the work
+  void reset_cost() { m_cost = 0.; }
+
 protected: // data
 
   boost::shared_ptr<ElementType> m_element_type;
@@ -144,6 +158,24 @@ protected: // data
 
   boost::shared_ptr<CList<Uint> > m_rank;
 
+  /// Measured work, see add_cost()
+  Real m_cost;
+
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Adds the wall time spent in its scope to the cost of the given entities
+class ScopedCostTimer
+{
+public:
+  ScopedCostTimer(CEntities& entities) : m_entities(entities) {}
+
+  ~ScopedCostTimer() { m_entities.add_cost(m_timer.elapsed()); }
+
+private:
+  CEntities& m_entities;
+  Common::Timer m_timer;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -12,11 +12,13 @@
 #include "Common/CLink.hpp"
 #include "Common/Log.hpp"
 #include "Common/CBuilder.hpp"
+#include "Common/MPI/PE.hpp"
 
 #include "Math/MatrixTypes.hpp"
 #include "Math/Consts.hpp"
 
 #include "Mesh/CFaceCellConnectivity.hpp"
+#include "Mesh/FaceMatcher.hpp"
 #include "Mesh/CNodeElementConnectivity.hpp"
 #include "Mesh/CDynTable.hpp"
 #include "Mesh/Geometry.hpp"
@@ -37,13 +39,19 @@ Common::ComponentBuilder < CFaceCellConnectivity , Component, LibMesh > CFaceCel
 CFaceCellConnectivity::CFaceCellConnectivity ( const std::string& name ) :
   Component(name),
   m_nb_faces(0),
-  m_face_building_algorithm(false)
+  m_face_building_algorithm(false),
+  m_nb_threads(0)
 {
 
   options().add_option< OptionT<bool> >("face_building_algorithm", m_face_building_algorithm)
       ->link_to(&m_face_building_algorithm)
       ->description("Improves efficiency for face building algorithm");
 
+  options().add_option< OptionT<Uint> >("nb_threads", m_nb_threads)
+      ->link_to(&m_nb_threads)
+      ->description("Number of threads used to match the faces of the elements.\n"
+                    "0 uses the number of threads per process given by the parallel environment");
+
   m_used_components = create_static_component_ptr<CGroup>("used_components");
   m_connectivity = create_static_component_ptr<CTable<Uint> >(Mesh::Tags::connectivity_table());
   m_face_nb_in_elem = create_static_component_ptr<CTable<Uint> >("face_number");
@@ -116,15 +124,9 @@ void CFaceCellConnectivity::build_connectivity()
   }
 
   // declartions
-  m_connectivity->resize(0);
-  CTable<Uint>::Buffer f2c = m_connectivity->create_buffer();
-  CTable<Uint>::Buffer face_number = m_face_nb_in_elem->create_buffer();
-  CList<bool>::Buffer is_bdry_face = m_is_bdry_face->create_buffer();
   Geometry& nodes = find_parent_component<CMesh>(*used()[0]).geometry();
   Uint tot_nb_nodes = nodes.size();
-  std::vector < std::vector<Uint> > mapNodeFace(tot_nb_nodes);
   std::vector<Uint> face_nodes;  face_nodes.reserve(100);
-  std::vector<Uint> dummy_row(2, Math::Consts::uint_max());
   Uint max_nb_faces(0);
 
   // calculate max_nb_faces
@@ -159,16 +161,13 @@ void CFaceCellConnectivity::build_connectivity()
     }
   }
 
-  // Declarations to save frequent allocations in the loop algorithm
+  // Collect the faces of every element, keeping track of the element and the face number in the element
+  FaceMatcher matcher;
+  matcher.reserve(max_nb_faces, 4*max_nb_faces);
+  std::vector<Uint> element_of_face;  element_of_face.reserve(max_nb_faces);
+  std::vector<Uint> number_of_face;   number_of_face.reserve(max_nb_faces);
   Uint nb_inner_faces = 0;
-  Uint nb_matched_nodes = 1;
-  Uint face_node_idx;
-  Uint face_node;
-  Uint face;
-  Uint connected_face;
-  Uint node;
   Uint nb_nodes;
-  bool found_face = false;
   Component::Ptr elem_location_comp;
   Uint elem_location_idx;
 
@@ -190,7 +189,10 @@ void CFaceCellConnectivity::build_connectivity()
     {
       if ( is_not_null(is_bdry_elem) )
         if ( (*is_bdry_elem)[loc_elem_idx] == false )
+        {
+          ++loc_elem_idx;
           continue;
+        }
 
       Uint mesh_elements_idx = m_mesh_elements->unified_idx(elements,loc_elem_idx);
 
@@ -206,98 +208,66 @@ void CFaceCellConnectivity::build_connectivity()
         face_nodes.resize(nb_nodes);
         Uint i(0);
         boost_foreach(const Uint face_node_idx, elements.element_type().face_connectivity().face_node_range(face_idx))
-            face_nodes[i++] = elem[face_node_idx];
-
-
-        // consider the first node belonging to the current face
-        // check if you find a face ID shared between all the other
-        // nodes building a face
-        node = face_nodes[0];
-        cf_assert(node<tot_nb_nodes);
-
-        found_face = false;
-        // search for matching face if they are registered to the node yet
-        boost_foreach( face, mapNodeFace[node] )
         {
-          nb_matched_nodes = 1;
-          if (nb_nodes > 1)
-          {
-            for (face_node_idx=1; face_node_idx!=nb_nodes; ++face_node_idx)
-            {
-              boost_foreach (connected_face, mapNodeFace[face_nodes[face_node_idx]])
-              {
-                if (connected_face == face)
-                {
-                  ++nb_matched_nodes;
-                  break;
-                }
-              }
-
-
-              if (nb_matched_nodes == nb_nodes) // face matches the nodes
-              {
-                // the corresponding face already exists, meaning
-                // that the face is an internal one, shared by two elements
-                // here you set the second element (==state) neighbor of the face
-                found_face = true;
-                //(*m_connectivity)[elemID][iFace] = currFaceID;
-                f2c.get_row(face)[1]=mesh_elements_idx;
-                face_number.get_row(face)[1]=face_idx;
-                is_bdry_face.get_row(face)=false;
-                // since it has two neighbor cells,
-                // this face is surely NOT a boundary face
-                // m_isBFace[currFaceID] = false;
-
-                // increment number of inner faces (they always have 2 states)
-                ++nb_inner_faces;
-                break;
-              }
-            }
-          }
-          else // this only applies to the 1D case
-          {
-            // the corresponding faceID already exists, meaning
-            // that the face is an internal one, shared by two elements
-            // here you set the second element (==state) neighbor of the face
-            found_face = true;
-            //(*elem_to_face)[elemID][iFace] = currFaceID;
-            f2c.get_row(face)[1]=mesh_elements_idx;
-            face_number.get_row(face)[1]=face_idx;
-            is_bdry_face.get_row(face)=false;
-
-            // increment number of inner faces (they always have 2 states)
-            ++nb_inner_faces;
-            break;
-          }
-        }
-        if (found_face == false)
-        {
-          // a new face has been found
-          // add the ID of the new face in the corresponding nodes
-          // referencing it
-          boost_foreach (face_node, face_nodes)
-          {
-            mapNodeFace[face_node].push_back(m_nb_faces);
-          }
-
-          // increment the number of faces
-          dummy_row[0]=mesh_elements_idx;
-          f2c.add_row(dummy_row);
-
-          dummy_row[0]=face_idx;
-          face_number.add_row(dummy_row);
-
-          is_bdry_face.add_row(true);
-          ++m_nb_faces;
+          cf_assert(elem[face_node_idx]<tot_nb_nodes);
+          face_nodes[i++] = elem[face_node_idx];
         }
+
+        matcher.add_face(face_nodes);
+        element_of_face.push_back(mesh_elements_idx);
+        number_of_face.push_back(face_idx);
       }
       ++loc_elem_idx;
     } // end foreach element
   } // end foreach elements component
 
-  f2c.flush();
-  face_number.flush();
-  is_bdry_face.flush();
+  matcher.match( m_nb_threads != 0 ? m_nb_threads : Comm::PE::instance().nb_threads() );
+
+  // Each face is created by the first element that has it, in element order.
+  // If another element has the same face, it is the second neighbor and the face is an inner face.
+  const Uint nb_element_faces = matcher.size();
+  for (Uint f=0; f!=nb_element_faces; ++f)
+  {
+    const Uint matched = matcher.matched_face(f);
+    if (matched == Math::Consts::uint_max() || matched > f)
+      ++m_nb_faces;
+  }
+
+  m_connectivity->resize(m_nb_faces);
+  m_face_nb_in_elem->resize(m_nb_faces);
+  m_is_bdry_face->resize(m_nb_faces);
+  CTable<Uint>& f2c = *m_connectivity;
+  CTable<Uint>& face_number = *m_face_nb_in_elem;
+  CList<bool>& is_bdry_face = *m_is_bdry_face;
+
+  Uint face = 0;
+  for (Uint f=0; f!=nb_element_faces; ++f)
+  {
+    const Uint matched = matcher.matched_face(f);
+    if (matched != Math::Consts::uint_max() && matched < f)
+      continue;
+
+    f2c[face][0] = element_of_face[f];
+    face_number[face][0] = number_of_face[f];
+    if (matched == Math::Consts::uint_max())
+    {
+      f2c[face][1] = Math::Consts::uint_max();
+      face_number[face][1] = Math::Consts::uint_max();
+      is_bdry_face[face] = true;
+    }
+    else
+    {
+      // since it has two neighbor cells,
+      // this face is surely NOT a boundary face
+      f2c[face][1] = element_of_face[matched];
+      face_number[face][1] = number_of_face[matched];
+      is_bdry_face[face] = false;
+
+      // increment number of inner faces (they always have 2 states)
+      ++nb_inner_faces;
+    }
+    ++face;
+  }
 
   // CFinfo << "Total nb faces [" << m_nb_faces << "]" << CFendl;
   // CFinfo << "Inner nb faces [" << nb_inner_faces << "]" << CFendl;
@@ -325,7 +295,7 @@ void CFaceCellConnectivity::build_connectivity()
 
           CCells& elems = elem_location_comp->as_type<CCells>();
           CList<bool>& is_bdry_elem = elems.get_child("is_bdry").as_type< CList<bool> >();
-          is_bdry_elem[elem_location_idx] = is_bdry_elem[elem_location_idx] || is_bdry_face.get_row(f) ;
+          is_bdry_elem[elem_location_idx] = is_bdry_elem[elem_location_idx] || is_bdry_face[f] ;
         }
       }
     }
@@ -109,6 +109,9 @@ private: // data
 
   bool m_face_building_algorithm;
 
+  /// Number of threads used to match faces, 0 for the default of the parallel environment
+  Uint m_nb_threads;
+
 }; // CFaceCellConnectivity
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -7,6 +7,7 @@
 #include <boost/algorithm/string/replace.hpp>
 #include <boost/foreach.hpp>
 #include <boost/progress.hpp>
+#include <boost/cstdint.hpp>
 
 #include "Common/BoostFilesystem.hpp"
 
@@ -16,6 +17,7 @@
 #include "Common/FindComponents.hpp"
 #include "Common/BasicExceptions.hpp"
 #include "Common/StringConversion.hpp"
+#include "Common/MPI/PE.hpp"
 
 #include "Mesh/CMesh.hpp"
 #include "Mesh/CRegion.hpp"
@@ -44,6 +46,23 @@ CReader::CReader(const std::string& name)
       ->description("Treat Sections of lower dimensionality as BC. "
                         "This means no BCs from cgns will be read");
 
+  m_options.add_option< OptionT<Uint> >( "chunk_size", 100000u )
+      ->description("Number of elements read from the file at once")
+      ->pretty_name("Chunk Size");
+
+  m_options.add_option< OptionT<bool> >( "read_distributed", false )
+      ->description("If true, each rank reads a part of the unstructured zones. "
+                    "Otherwise every rank reads the complete mesh, which is owned by rank 0")
+      ->pretty_name("Read Distributed");
+
+  m_properties["brief"] = std::string("CGNS file mesh reader component");
+  m_properties["description"] = std::string("By default every rank reads the complete file, and all nodes and elements are owned by rank 0.\n"
+                                            "With the read_distributed option, unstructured zones are read in parallel: each rank reads a contiguous part "
+                                            "of every element section and coordinate array, and receives the coordinates "
+                                            "of the other nodes it needs from the rank that read them. "
+                                            "Structured zones are still read completely by every rank, and are owned by rank 0. "
+                                            "A partitioner should be used afterwards to obtain a good distribution.\n");
+
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -62,6 +81,11 @@ void CReader::do_read_mesh_into(const URI& file, CMesh& mesh)
   // Set the internal mesh pointer
   m_mesh = mesh.as_ptr<CMesh>();
 
+  // Each rank reads a part of the unstructured zones, or all ranks read everything as part 0
+  const bool distributed = option("read_distributed").value<bool>() && Comm::PE::instance().is_active();
+  m_part     = distributed ? Comm::PE::instance().rank() : 0u;
+  m_nb_parts = distributed ? Comm::PE::instance().size() : 1u;
+
   // open file in read mode
   CALL_CGNS(cg_open(file.path().c_str(),CG_MODE_READ,&m_file.idx));
 
@@ -158,15 +182,18 @@ void CReader::read_zone(CRegion& parent_region)
     this_region.add_tag("grid_zone");
     m_zone_map[m_zone.idx] = &this_region;
 
-    // read coordinates in this zone
-    for (int i=1; i<=m_zone.nbGrids; ++i)
-      read_coordinates_unstructured(this_region);
+    m_zone.nodes = &m_mesh->geometry();
+    m_zone.nodes_start_idx = m_zone.nodes->size();
 
-    // read sections (or subregions) in this zone
-    m_global_to_region.reserve(m_zone.total_nbElements);
+    // read sections (or subregions) in this zone, the connectivity refers to
+    // the node numbering of the file until the coordinates are read
+    m_global_to_region.reserve(slice_begin(m_zone.total_nbElements,m_part+1)-slice_begin(m_zone.total_nbElements,m_part));
     for (m_section.idx=1; m_section.idx<=m_zone.nbSections; ++m_section.idx)
       read_section(this_region);
 
+    // read coordinates in this zone, only the first grid is used
+    read_coordinates_unstructured(this_region);
+
 //    // Only read boco's if sections are not defined as BC's
 //    if (!option("SectionsAreBCs")->value<bool>())
 //    {
@@ -186,6 +213,10 @@ void CReader::read_zone(CRegion& parent_region)
     // truely deallocate the global_to_region vector
     m_global_to_region.resize(0);
     std::vector<Region_TableIndex_pair>().swap (m_global_to_region);
+    m_section_slices.clear();
+
+    // All elements in the zone were read by this rank, boundary elements of other ranks were skipped
+    set_element_ranks(this_region, m_part);
 
 
 
@@ -241,6 +272,9 @@ void CReader::read_zone(CRegion& parent_region)
     for (m_boco.idx=1; m_boco.idx<=m_zone.nbBocos; ++m_boco.idx)
       read_boco_structured(this_region);
 
+    // The zone is read by every rank, so only rank 0 owns it, and it is ghost elsewhere
+    set_element_ranks(this_region, 0u);
+
   }
 
 
@@ -256,59 +290,122 @@ void CReader::read_coordinates_unstructured(CRegion& parent_region)
 
   CFinfo << "creating coordinates in " << parent_region.uri().string() << CFendl;
 
-  Geometry& nodes = m_mesh->geometry();
-  m_zone.nodes = &nodes;
-  m_zone.nodes_start_idx = nodes.size();
-
-  // read coordinates
-  int one = 1;
-  Real *xCoord;
-  Real *yCoord;
-  Real *zCoord;
-  switch (m_zone.coord_dim)
+  Geometry& nodes = *m_zone.nodes;
+  const Uint start_idx = m_zone.nodes_start_idx;
+  const Uint dim = m_zone.coord_dim;
+
+  // this rank reads a contiguous range of the nodes
+  const Uint nb_nodes = m_zone.total_nbVertices;
+  const Uint owned_begin = slice_begin(nb_nodes,m_part);
+  const Uint owned_end = slice_begin(nb_nodes,m_part+1);
+  const Uint nb_owned = owned_end - owned_begin;
+
+  // nodes used by the elements of this rank, but read by another rank
+  std::vector<Uint> ghosts;
+  BOOST_FOREACH(CElements& elements, find_components_recursively<CElements>(parent_region))
   {
-    case 3:
-      zCoord = new Real[m_zone.total_nbVertices];
-      CALL_CGNS(cg_coord_read(m_file.idx,m_base.idx,m_zone.idx, "CoordinateZ", RealDouble, &one, &m_zone.total_nbVertices, zCoord));
-    case 2:
-      yCoord = new Real[m_zone.total_nbVertices];
-      CALL_CGNS(cg_coord_read(m_file.idx,m_base.idx,m_zone.idx, "CoordinateY", RealDouble, &one, &m_zone.total_nbVertices, yCoord));
-    case 1:
-      xCoord = new Real[m_zone.total_nbVertices];
-      CALL_CGNS(cg_coord_read(m_file.idx,m_base.idx,m_zone.idx, "CoordinateX", RealDouble, &one, &m_zone.total_nbVertices, xCoord));
+    CConnectivity& node_connectivity = elements.node_connectivity();
+    for (Uint e=0; e<node_connectivity.size(); ++e)
+    {
+      for (Uint n=0; n<node_connectivity.row_size(); ++n)
+      {
+        const Uint node = node_connectivity[e][n];
+        if (node < owned_begin || node >= owned_end)
+          ghosts.push_back(node);
+      }
+    }
   }
+  std::sort(ghosts.begin(),ghosts.end());
+  ghosts.erase(std::unique(ghosts.begin(),ghosts.end()),ghosts.end());
 
-  m_mesh->initialize_nodes(m_zone.total_nbVertices, (Uint)m_zone.coord_dim);
+  m_mesh->initialize_nodes(start_idx+nb_owned+ghosts.size(), dim);
 
   CTable<Real>& coords = nodes.coordinates();
   CList<Uint>& rank = nodes.rank();
-  //  CTable<Real>::Buffer buffer = nodes.coordinates().create_buffer();
-  //buffer.increase_array_size(m_zone.total_nbVertices);
-  //std::vector<Real> row(m_zone.coord_dim);
-  for (int i=0; i<m_zone.total_nbVertices; ++i)
+
+  // read the owned range of every coordinate array
+  const char* coord_names[3] = {"CoordinateX","CoordinateY","CoordinateZ"};
+  int range_min = owned_begin+1; // +1 because cgns has index-base 1 instead of 0
+  int range_max = owned_end;
+  std::vector<Real> coord_buffer(nb_owned);
+  for (Uint d=0; d<dim; ++d)
   {
-    switch (m_zone.coord_dim)
-    {
-      case 3:
-        coords[i][2] = zCoord[i];
-       case 2:
-        coords[i][1] = yCoord[i];
-       case 1:
-        coords[i][0] = xCoord[i];
-     }
-    rank[i] = 0;
+    if (nb_owned)
+      CALL_CGNS(cg_coord_read(m_file.idx,m_base.idx,m_zone.idx, coord_names[d], RealDouble, &range_min, &range_max, &coord_buffer[0]));
+    for (Uint i=0; i<nb_owned; ++i)
+      coords[start_idx+i][d] = coord_buffer[i];
   }
+  for (Uint i=0; i<nb_owned; ++i)
+    rank[start_idx+i] = m_part;
 
-  switch (m_zone.coord_dim)
+  // get the ghost coordinates from the ranks that read them
+  if (m_nb_parts > 1)
   {
-    case 3:
-      delete_ptr_array(zCoord);
-    case 2:
-      delete_ptr_array(yCoord);
-    case 1:
-      delete_ptr_array(xCoord);
+    // ghosts are sorted, so they are grouped per part already
+    std::vector<int> send_n(m_nb_parts,0);
+    std::vector<Uint> ghost_part(ghosts.size());
+    for (Uint g=0; g<ghosts.size(); ++g)
+    {
+      ghost_part[g] = part_of_obj(nb_nodes,ghosts[g]);
+      ++send_n[ghost_part[g]];
+    }
+
+    std::vector<Uint> requested;
+    std::vector<int> recv_n(m_nb_parts,-1);
+    Comm::PE::instance().all_to_all(ghosts,send_n,requested,recv_n);
+
+    std::vector<Real> send_coords(requested.size()*dim);
+    for (Uint r=0; r<requested.size(); ++r)
+    {
+      cf_assert(requested[r] >= owned_begin && requested[r] < owned_end);
+      for (Uint d=0; d<dim; ++d)
+        send_coords[r*dim+d] = coords[start_idx+requested[r]-owned_begin][d];
+    }
+
+    std::vector<Real> recv_coords;
+    std::vector<int> recv_coords_n(send_n);
+    Comm::PE::instance().all_to_all(send_coords,recv_n,recv_coords,recv_coords_n,dim);
+
+    for (Uint g=0; g<ghosts.size(); ++g)
+    {
+      for (Uint d=0; d<dim; ++d)
+        coords[start_idx+nb_owned+g][d] = recv_coords[g*dim+d];
+      rank[start_idx+nb_owned+g] = ghost_part[g];
+    }
   }
 
+  renumber_nodes_unstructured(parent_region,owned_begin,owned_end,ghosts);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void CReader::renumber_nodes_unstructured(CRegion& parent_region, const Uint owned_begin, const Uint owned_end, const std::vector<Uint>& ghosts)
+{
+  const Uint start_idx = m_zone.nodes_start_idx;
+  const Uint nb_owned = owned_end - owned_begin;
+
+  // Owned nodes come first, followed by the ghost nodes in sorted order
+  BOOST_FOREACH(CElements& elements, find_components_recursively<CElements>(parent_region))
+  {
+    CConnectivity& node_connectivity = elements.node_connectivity();
+    for (Uint e=0; e<node_connectivity.size(); ++e)
+    {
+      for (Uint n=0; n<node_connectivity.row_size(); ++n)
+      {
+        const Uint node = node_connectivity[e][n];
+        if (node >= owned_begin && node < owned_end)
+        {
+          node_connectivity[e][n] = start_idx + node - owned_begin;
+        }
+        else
+        {
+          const Uint ghost_idx = std::lower_bound(ghosts.begin(),ghosts.end(),node) - ghosts.begin();
+          cf_assert(ghost_idx < ghosts.size() && ghosts[ghost_idx] == node);
+          node_connectivity[e][n] = start_idx + nb_owned + ghost_idx;
+        }
+      }
+    }
+  }
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -343,6 +440,11 @@ void CReader::read_coordinates_structured(CRegion& parent_region)
 
   CTable<Real>& coords = nodes.coordinates();
   m_mesh->initialize_nodes(m_zone.total_nbVertices,m_zone.coord_dim);
+
+  // Structured zones are read by every rank, and owned by rank 0
+  CList<Uint>& rank = nodes.rank();
+  for (Uint node=m_zone.nodes_start_idx; node<nodes.size(); ++node)
+    rank[node] = 0u;
   Uint n(0);
   switch (m_zone.coord_dim)
   {
@@ -415,7 +517,23 @@ void CReader::read_section(CRegion& parent_region)
   CRegion& this_region = parent_region.create_region(m_section.name);
 
   Geometry& all_nodes = *m_zone.nodes;
-  Uint start_idx = m_zone.nodes_start_idx;
+
+  // This rank reads a contiguous part of the section, in chunks
+  const Uint nb_elems = m_section.eEnd - m_section.eBegin + 1;
+  const Uint begin = slice_begin(nb_elems,m_part);
+  const Uint end = slice_begin(nb_elems,m_part+1);
+  const Uint chunk_size = std::max(option("chunk_size").value<Uint>(),1u);
+
+  SectionSlice slice;
+  slice.region = &this_region;
+  slice.eBegin = m_section.eBegin;
+  slice.eEnd = m_section.eEnd;
+  slice.first_element = m_section.eBegin + begin;
+  slice.nb_elements = end - begin;
+  slice.offset = m_global_to_region.size();
+  m_section_slices.push_back(slice);
+
+  std::vector<int> element_nodes;
 
   if (m_section.type == MIXED)
   {
@@ -423,84 +541,85 @@ void CReader::read_section(CRegion& parent_region)
     std::map<std::string,CElements::Ptr> elements = create_cells_in_region(this_region,all_nodes,get_supported_element_types());
     std::map<std::string,CTable<Uint>::Buffer::Ptr> buffer = create_connectivity_buffermap(elements);
 
-    // Handle each element of this section separately to see in which CElements component it will be written
-    for (int elem=m_section.eBegin;elem<=m_section.eEnd;++elem)
-    {
-      // Read the amount of nodes this 1 element contains
-      CALL_CGNS(cg_ElementPartialSize(m_file.idx,m_base.idx,m_zone.idx,m_section.idx,elem,elem,&m_section.elemNodeCount));
-      m_section.elemNodeCount--; // subtract 1 as there is one index too many storing the element type
+    // Number of nodes and CF element type of each cgns element type in this section
+    std::map<ElementType_t,std::pair<int,std::string> > etypes;
 
-      // Storage for element type (index 0) and element nodes (index 1->elemNodeCount)
-      int elemNodes[1][1+m_section.elemNodeCount];
+    std::vector<Uint> row;
+    for (Uint chunk_begin=begin; chunk_begin<end; chunk_begin+=chunk_size)
+    {
+      const int first = m_section.eBegin + chunk_begin;
+      const int last = m_section.eBegin + std::min(end,chunk_begin+chunk_size) - 1;
 
-      // Read nodes of 1 element
-      CALL_CGNS(cg_elements_partial_read(m_file.idx,m_base.idx,m_zone.idx,m_section.idx,elem,elem,*elemNodes,&m_section.parentData));
+      // Read the element types and nodes of all elements in the chunk
+      CALL_CGNS(cg_ElementPartialSize(m_file.idx,m_base.idx,m_zone.idx,m_section.idx,first,last,&m_section.elemDataSize));
+      element_nodes.resize(m_section.elemDataSize);
+      read_elements_partial(first,last,element_nodes);
 
-      // Store the cgns element type
-      ElementType_t etype_cgns = static_cast<ElementType_t>(elemNodes[0][0]);
+      // Each element is stored as its cgns element type followed by its nodes
+      Uint pos=0;
+      for (int elem=first; elem<=last; ++elem)
+      {
+        const ElementType_t etype_cgns = static_cast<ElementType_t>(element_nodes[pos++]);
 
-      // Put the element nodes in a vector
-      std::vector<Uint> row(m_section.elemNodeCount);
-      for (int n=1;n<=m_section.elemNodeCount;++n)  // n=0 is the cell type
-        row[n-1]=start_idx+(elemNodes[0][n]-1); // -1 because cgns has index-base 1 instead of 0
+        std::map<ElementType_t,std::pair<int,std::string> >::iterator etype = etypes.find(etype_cgns);
+        if (etype == etypes.end())
+        {
+          int nb_nodes;
+          CALL_CGNS(cg_npe(etype_cgns,&nb_nodes));
+          // Convert the cgns element type to the CF element type
+          const std::string etype_CF = m_elemtype_CGNS_to_CF[etype_cgns]+ to_str<int>(m_base.phys_dim)+"DLagrangeP1";
+          etype = etypes.insert(std::make_pair(etype_cgns,std::make_pair(nb_nodes,etype_CF))).first;
+        }
+        const int nb_nodes = etype->second.first;
+        const std::string& etype_CF = etype->second.second;
 
-      // Convert the cgns element type to the CF element type
-      const std::string& etype_CF = m_elemtype_CGNS_to_CF[etype_cgns]+ to_str<int>(m_base.phys_dim)+"DLagrangeP1";
+        // Put the element nodes in a vector, in the node numbering of the file
+        row.resize(nb_nodes);
+        for (int n=0; n<nb_nodes; ++n)
+          row[n] = element_nodes[pos++]-1; // -1 because cgns has index-base 1 instead of 0
 
-      // Add the nodes to the correct CElements component using its buffer
-      Uint table_idx = buffer[etype_CF]->add_row(row);
+        // Add the nodes to the correct CElements component using its buffer
+        Uint table_idx = buffer[etype_CF]->add_row(row);
 
-      // Store the global element number to a pair of (region , local element number)
-      m_global_to_region.push_back(Region_TableIndex_pair(find_component_ptr_with_name<CElements>(this_region, etype_CF),table_idx));
-    } // for elem
+        // Store the global element number to a pair of (region , local element number)
+        m_global_to_region.push_back(Region_TableIndex_pair(elements[etype_CF],table_idx));
+      } // for elem
+    } // for chunk
   } // if mixed
   else // Single element type in this section
   {
     // Read the number of nodes in this section
     CALL_CGNS(cg_npe(m_section.type,&m_section.elemNodeCount));
 
-    // Read the size of all elements
-    CALL_CGNS(cg_ElementDataSize(m_file.idx,m_base.idx,m_zone.idx,m_section.idx,&m_section.elemDataSize	));
-
-    // Calculate the number of elements
-    int nbElems = m_section.elemDataSize/m_section.elemNodeCount;
-
-
     // Convert the CGNS element type to the CF element type
     const std::string& etype_CF = m_elemtype_CGNS_to_CF[m_section.type]+to_str<int>(m_base.phys_dim)+"DLagrangeP1";
 
     // Create element component in this region for this CF element type, automatically creates connectivity_table
-    this_region.create_elements(etype_CF,all_nodes);
-
-    CElements& element_region= *this_region.get_child_ptr("elements_"+etype_CF)->as_ptr<CElements>();
-
-    // Create a buffer for this element component, to start filling in the elements we will read.
-    CConnectivity& node_connectivity = element_region.node_connectivity();
-
-    // Create storage for element nodes
-    int* elemNodes = new int [m_section.elemDataSize];
-
-    // Read in the element nodes
-    cg_elements_read	(m_file.idx,m_base.idx,m_zone.idx,m_section.idx, elemNodes,&m_section.parentData);
+    CElements& element_region = this_region.create_elements(etype_CF,all_nodes);
+    CElements::Ptr element_region_ptr = element_region.as_ptr<CElements>();
 
     // --------------------------------------------- Fill connectivity table
-    std::vector<Uint> coords_added;
-    std::vector<Uint> row(m_section.elemNodeCount);
-    node_connectivity.resize(nbElems);
+    CConnectivity& node_connectivity = element_region.node_connectivity();
+    node_connectivity.resize(end-begin);
 
-    for (int elem=0; elem<nbElems; ++elem) //, ++progress)
+    for (Uint chunk_begin=begin; chunk_begin<end; chunk_begin+=chunk_size)
     {
-      for (int node=0;node<m_section.elemNodeCount;++node)
-        node_connectivity[elem][node] = start_idx + elemNodes[node+elem*m_section.elemNodeCount]-1;  // -1 because cgns has index-base 1 instead of 0;
-
-      // Store the global element number to a pair of (region , local element number)
-      m_global_to_region.push_back(Region_TableIndex_pair(boost::dynamic_pointer_cast<CElements>(element_region.shared_from_this()),elem));
-    } // for elem
+      const Uint chunk_end = std::min(end,chunk_begin+chunk_size);
 
+      // Read in the element nodes
+      element_nodes.resize((chunk_end-chunk_begin)*m_section.elemNodeCount);
+      read_elements_partial(m_section.eBegin+chunk_begin,m_section.eBegin+chunk_end-1,element_nodes);
 
+      Uint pos=0;
+      for (Uint elem=chunk_begin-begin; elem<chunk_end-begin; ++elem)
+      {
+        for (int node=0;node<m_section.elemNodeCount;++node)
+          node_connectivity[elem][node] = element_nodes[pos++]-1;  // -1 because cgns has index-base 1 instead of 0;
 
-    // Delete storage for element nodes
-    delete_ptr(elemNodes);
+        // Store the global element number to a pair of (region , local element number)
+        m_global_to_region.push_back(Region_TableIndex_pair(element_region_ptr,elem));
+      } // for elem
+    } // for chunk
   } // else not mixed
 
   remove_empty_element_regions(this_region);
@@ -521,6 +640,19 @@ void CReader::read_section(CRegion& parent_region)
 
 //////////////////////////////////////////////////////////////////////////////
 
+void CReader::set_element_ranks(CRegion& zone_region, const Uint owner)
+{
+  BOOST_FOREACH(CElements& elements, find_components_recursively<CElements>(zone_region))
+  {
+    CList<Uint>& rank = elements.rank();
+    rank.resize(elements.size());
+    for (Uint e=0; e<elements.size(); ++e)
+      rank[e] = owner;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 void CReader::create_structured_elements(CRegion& parent_region)
 {
   Geometry& nodes = *m_zone.nodes;
@@ -631,20 +763,9 @@ void CReader::read_boco_unstructured(CRegion& parent_region)
       if (m_zone.type != Unstructured)
         throw NotSupported(FromHere(),"CGNS: Boundary with pointset_type \"ElementRange\" is only supported for Unstructured grids");
 
-      // First do some simple checks to see if an entire region can be taken as a BC.
-      CElements::Ptr first_elements = m_global_to_region[boco_elems[0]-1].first;
-      CElements::Ptr last_elements = m_global_to_region[boco_elems[1]-1].first;
-      if (&first_elements->parent() == &last_elements->parent())
-      {
-        CRegion::Ptr group_region = first_elements->parent().as_ptr<CRegion>();
-        Uint prev_elm_count = group_region->properties().check("previous_elem_count") ? group_region->properties().value<Uint>("previous_elem_count") : 0;
-        if (group_region->recursive_elements_count() == prev_elm_count + Uint(boco_elems[1]-boco_elems[0]+1))
-        {
-          group_region->properties()["cgns_section_name"] = group_region->name();
-          group_region->rename(m_boco.name);
-          break;
-        }
-      }
+      // First check if an entire section can be taken as a BC.
+      if (rename_section_as_boco(boco_elems[0],boco_elems[1]))
+        break;
 
 
       // Create a region inside mesh/regions/bc-regions with the name of the cgns boco.
@@ -655,13 +776,16 @@ void CReader::read_boco_unstructured(CRegion& parent_region)
       std::map<std::string,CElements::Ptr> elements = create_faces_in_region(this_region,nodes,get_supported_element_types());
       std::map<std::string,CTable<Uint>::Buffer::Ptr> buffer = create_connectivity_buffermap(elements);
 
-      for (int global_element=boco_elems[0]-1;global_element<boco_elems[1];++global_element)
+      for (int global_element=boco_elems[0];global_element<=boco_elems[1];++global_element)
       {
-        // Check which region this global_element belongs to
-        CElements::Ptr element_region = m_global_to_region[global_element].first;
+        // Check which region this global_element belongs to, skip it if it is read by another rank
+        const Region_TableIndex_pair element = find_local_element(global_element);
+        CElements::Ptr element_region = element.first;
+        if (is_null(element_region))
+          continue;
 
         // Check the local element number in this region
-        Uint local_element = m_global_to_region[global_element].second;
+        Uint local_element = element.second;
 
         // Add the local element to the correct CElements component through its buffer
         buffer[element_region->element_type().builder_name()]->add_row(element_region->node_connectivity()[local_element]);
@@ -680,20 +804,9 @@ void CReader::read_boco_unstructured(CRegion& parent_region)
       if (m_zone.type != Unstructured)
         throw NotSupported(FromHere(),"CGNS: Boundary with pointset_type \"ElementList\" is only supported for Unstructured grids");
 
-      // First do some simple checks to see if an entire region can be taken as a BC.
-      CElements::Ptr first_elements = m_global_to_region[boco_elems[0]-1].first;
-      CElements::Ptr last_elements = m_global_to_region[boco_elems[m_boco.nBC_elem-1]-1].first;
-      if (&first_elements->parent() == &last_elements->parent())
-      {
-        CRegion::Ptr group_region = first_elements->parent().as_ptr<CRegion>();
-        Uint prev_elm_count = group_region->properties().check("previous_elem_count") ? group_region->properties().value<Uint>("previous_elem_count") : 0;
-        if (group_region->recursive_elements_count() == prev_elm_count + Uint(boco_elems[m_boco.nBC_elem-1]-boco_elems[0]+1))
-        {
-          group_region->properties()["cgns_section_name"] = group_region->name();
-          group_region->rename(m_boco.name);
-          break;
-        }
-      }
+      // First check if an entire section can be taken as a BC.
+      if (rename_section_as_boco(boco_elems[0],boco_elems[m_boco.nBC_elem-1]))
+        break;
 
       // Create a region inside mesh/regions/bc-regions with the name of the cgns boco.
       CRegion& this_region = parent_region.create_region(m_boco.name);
@@ -705,13 +818,14 @@ void CReader::read_boco_unstructured(CRegion& parent_region)
 
       for (int i=0; i<m_boco.nBC_elem; ++i)
       {
-        Uint global_element = boco_elems[i]-1;
-
-        // Check which region this global_element belongs to
-        CElements::Ptr element_region = m_global_to_region[global_element].first;
+        // Check which region this global_element belongs to, skip it if it is read by another rank
+        const Region_TableIndex_pair element = find_local_element(boco_elems[i]);
+        CElements::Ptr element_region = element.first;
+        if (is_null(element_region))
+          continue;
 
         // Check the local element number in this region
-        Uint local_element = m_global_to_region[global_element].second;
+        Uint local_element = element.second;
 
         // Add the local element to the correct CElements component through its buffer
         buffer[element_region->element_type().builder_name()]->add_row(element_region->node_connectivity()[local_element]);
@@ -899,6 +1013,65 @@ void CReader::read_boco_structured(CRegion& parent_region)
 
 //////////////////////////////////////////////////////////////////////////////
 
+void CReader::read_elements_partial(const int first, const int last, std::vector<int>& element_nodes)
+{
+  // parent data is not used, but it is read together with the elements if the section has it
+  std::vector<int> parent_data(m_section.parentFlag ? 4*(last-first+1) : 0);
+  CALL_CGNS(cg_elements_partial_read(m_file.idx,m_base.idx,m_zone.idx,m_section.idx,first,last,&element_nodes[0],
+                                     parent_data.empty() ? 0 : &parent_data[0]));
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+Uint CReader::slice_begin(const Uint nb_objects, const Uint part) const
+{
+  return static_cast<Uint>( static_cast<boost::uint64_t>(nb_objects) * part / m_nb_parts );
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+Uint CReader::part_of_obj(const Uint nb_objects, const Uint obj) const
+{
+  Uint part = static_cast<Uint>( static_cast<boost::uint64_t>(obj) * m_nb_parts / nb_objects );
+  while (part > 0 && slice_begin(nb_objects,part) > obj)
+    --part;
+  while (part+1 < m_nb_parts && slice_begin(nb_objects,part+1) <= obj)
+    ++part;
+  return part;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+CReader::Region_TableIndex_pair CReader::find_local_element(const int global_element) const
+{
+  BOOST_FOREACH(const SectionSlice& slice, m_section_slices)
+  {
+    if (global_element >= slice.first_element && global_element < slice.first_element + static_cast<int>(slice.nb_elements))
+      return m_global_to_region[slice.offset + global_element - slice.first_element];
+  }
+  return Region_TableIndex_pair(CElements::Ptr(),0);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+bool CReader::rename_section_as_boco(const int first, const int last)
+{
+  // The global element ranges of the sections are known on every rank, so all ranks take the same decision
+  BOOST_FOREACH(const SectionSlice& slice, m_section_slices)
+  {
+    if (slice.eBegin == first && slice.eEnd == last)
+    {
+      CRegion& group_region = *slice.region;
+      group_region.properties()["cgns_section_name"] = group_region.name();
+      group_region.rename(m_boco.name);
+      return true;
+    }
+  }
+  return false;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 Uint CReader::get_total_nbElements()
 {
   Uint nbElements = 0;
@@ -36,6 +36,22 @@ private: // typedefs
 
   typedef std::pair<boost::shared_ptr<CElements>,Uint> Region_TableIndex_pair;
 
+  /// The part of a section read by this rank
+  struct SectionSlice
+  {
+    /// region created for the section
+    CRegion* region;
+    /// global element range of the whole section, as in the file
+    int eBegin;
+    int eEnd;
+    /// global element number of the first element read by this rank
+    int first_element;
+    /// number of elements read by this rank
+    Uint nb_elements;
+    /// index of the first element of the slice in m_global_to_region
+    Uint offset;
+  };
+
 public: // functions
 
   /// Contructor
@@ -58,11 +74,28 @@ private: // functions
   void read_coordinates_unstructured(CRegion& parent_region);
   void read_coordinates_structured(CRegion& parent_region);
   void read_section(CRegion& parent_region);
+  void read_elements_partial(const int first, const int last, std::vector<int>& element_nodes);
+  void renumber_nodes_unstructured(CRegion& parent_region, const Uint owned_begin, const Uint owned_end, const std::vector<Uint>& ghosts);
   void create_structured_elements(CRegion& parent_region);
+  /// Set the rank of all elements in the given zone to owner
+  void set_element_ranks(CRegion& zone_region, const Uint owner);
   void read_boco_unstructured(CRegion& parent_region);
   void read_boco_structured(CRegion& parent_region);
   Uint get_total_nbElements();
 
+  /// First index of the contiguous slice of nb_objects that is read by the given part
+  Uint slice_begin(const Uint nb_objects, const Uint part) const;
+
+  /// Part that reads the given object
+  Uint part_of_obj(const Uint nb_objects, const Uint obj) const;
+
+  /// Element read by this rank, with a null region if it is read by another rank
+  Region_TableIndex_pair find_local_element(const int global_element) const;
+
+  /// Rename the region of the section with exactly the given global element range to the current boco name
+  /// @return true if such a section exists
+  bool rename_section_as_boco(const int first, const int last);
+
   Uint structured_node_idx(Uint i, Uint j, Uint k)
   {
     return i + j*m_zone.nbVertices[XX] + k*m_zone.nbVertices[XX]*m_zone.nbVertices[YY];
@@ -74,10 +107,16 @@ private: // functions
 
 private: // data
 
+  /// Elements read by this rank, for each slice in m_section_slices
   std::vector<Region_TableIndex_pair> m_global_to_region;
+  std::vector<SectionSlice> m_section_slices;
   boost::shared_ptr<CMesh> m_mesh;
   Uint m_coord_start_idx;
 
+  /// Part of the file read by this rank, and the number of parts
+  Uint m_part;
+  Uint m_nb_parts;
+
 }; // end CReader
 
 
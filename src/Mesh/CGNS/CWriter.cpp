@@ -4,18 +4,32 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <algorithm>
+
+#include "coolfluid-packages.hpp"
+
 #include "Common/BoostFilesystem.hpp"
 
+#include "Common/BasicExceptions.hpp"
 #include "Common/Log.hpp"
 #include "Common/CBuilder.hpp"
+#include "Common/OptionT.hpp"
 #include "Common/FindComponents.hpp"
+#include "Common/StringConversion.hpp"
+
+#include "Common/MPI/PE.hpp"
 
 #include "Mesh/CGNS/CWriter.hpp"
 #include "Mesh/CMesh.hpp"
 #include "Mesh/CTable.hpp"
 #include "Mesh/CRegion.hpp"
+#include "Mesh/Field.hpp"
 #include "Mesh/Geometry.hpp"
 
+#ifdef CF_HAVE_CGNS_PARALLEL
+#include <pcgnslib.h>
+#endif
+
 //////////////////////////////////////////////////////////////////////////////
 
 using namespace CF::Common;
@@ -31,11 +45,39 @@ Common::ComponentBuilder < CGNS::CWriter, CMeshWriter, LibCGNS > aCGNSWriter_Bui
 
 //////////////////////////////////////////////////////////////////////////////
 
+namespace detail {
+
+/// Gather the values of all ranks on rank 0, in rank order. Nothing is communicated in a serial run.
+/// @return true on the rank that writes the values
+template <typename T>
+bool gather_on_writer(std::vector<T>& values)
+{
+  Comm::PE& pe = Comm::PE::instance();
+  if (!pe.is_active() || pe.size() == 1)
+    return true;
+
+  std::vector<T> gathered;
+  std::vector<int> counts(pe.size(), -1);
+  pe.gather(values, static_cast<int>(values.size()), gathered, counts, 0);
+  if (pe.rank() != 0)
+    return false;
+
+  values.swap(gathered);
+  return true;
+}
+
+} // detail
+
+//////////////////////////////////////////////////////////////////////////////
+
 CWriter::CWriter( const std::string& name )
 : CMeshWriter(name),
-  Shared()
+  Shared(),
+  m_collective(false)
 {
-
+  m_options.add_option< OptionT<bool> >("write_solution", false)
+      ->description("Write the point-based fields given in the \"fields\" option as a vertex FlowSolution in each zone")
+      ->pretty_name("Write Solution");
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -52,9 +94,15 @@ std::vector<std::string> CWriter::get_extensions()
 void CWriter::write_from_to(const CMesh& mesh, const URI& path)
 {
   m_mesh = mesh.as_ptr_checked<CMesh>().get();
+  update_single_precision_fields();
 
   m_fileBasename = path.base_name(); // filename without extension
 
+  if (Comm::PE::instance().is_active() && Comm::PE::instance().size() > 1)
+  {
+    write_parallel(path);
+    return;
+  }
 
   CFdebug << "Opening file " << path.path() << CFendl;
   CALL_CGNS(cg_open(path.path().c_str(),CG_MODE_WRITE,&m_file.idx));
@@ -92,9 +140,7 @@ void CWriter::write_zone(const CRegion& region)
 
   m_zone.coord_dim = m_mesh->dimension();
 
-  m_zone.total_nbVertices = 0;
-  BOOST_FOREACH(const CTable<Real>& coordinates, find_components_recursively_with_tag<CTable<Real> >(m_mesh->geometry(),Mesh::Tags::coordinates()))
-    m_zone.total_nbVertices += coordinates.size();
+  number_zone_nodes(region);
 
   m_zone.nbElements = region.recursive_elements_count();
 
@@ -108,81 +154,7 @@ void CWriter::write_zone(const CRegion& region)
   CFdebug << "Writing zone " << m_zone.name << CFendl;
   CALL_CGNS(cg_zone_write(m_file.idx,m_base.idx,m_zone.name.c_str(),size[0],Unstructured,&m_zone.idx));
 
-  Real* xCoord(NULL);
-  Real* yCoord(NULL);
-  Real* zCoord(NULL);
-
-  switch (m_zone.coord_dim)
-  {
-    case 3:
-      zCoord = new Real[m_zone.total_nbVertices];
-    case 2:
-      yCoord = new Real[m_zone.total_nbVertices];
-    case 1:
-      xCoord = new Real[m_zone.total_nbVertices];
-  }
-
-  Uint idx=0;
-  BOOST_FOREACH(const CTable<Real>& coordinates, find_components_recursively_with_tag<CTable<Real> >(m_mesh->geometry(),Mesh::Tags::coordinates()))
-  {
-    m_global_start_idx[&coordinates] = idx;
-
-    switch (m_zone.coord_dim)
-    {
-      case 3:
-      {
-        BOOST_FOREACH(CTable<Real>::ConstRow node, coordinates.array())
-        {
-          xCoord[idx] = node[XX];
-          yCoord[idx] = node[YY];
-          zCoord[idx] = node[ZZ];
-          idx++;
-        }
-        break;
-      }
-      case 2:
-      {
-        BOOST_FOREACH(CTable<Real>::ConstRow node, coordinates.array())
-        {
-          xCoord[idx] = node[XX];
-          yCoord[idx] = node[YY];
-          idx++;
-        }
-        break;
-      }
-      case 1:
-      {
-        BOOST_FOREACH(CTable<Real>::ConstRow node, coordinates.array())
-          xCoord[idx++] = node[XX];
-        break;
-      }
-    }
-  }
-
-
-  int cgns_coord_idx;
-
-  switch (m_zone.coord_dim)
-  {
-    case 3:
-    {
-      CFdebug << "Writing CoordinateZ" << CFendl;
-      CALL_CGNS(cg_coord_write(m_file.idx,m_base.idx,m_zone.idx,RealDouble,"CoordinateZ",zCoord,&cgns_coord_idx));
-      delete_ptr(zCoord);
-    }
-    case 2:
-    {
-      CFdebug << "Writing CoordinateY" << CFendl;
-      CALL_CGNS(cg_coord_write(m_file.idx,m_base.idx,m_zone.idx,RealDouble,"CoordinateY",yCoord,&cgns_coord_idx));
-      delete_ptr(yCoord);
-    }
-    case 1:
-    {
-      CFdebug << "Writing CoordinateX" << CFendl;
-      CALL_CGNS(cg_coord_write(m_file.idx,m_base.idx,m_zone.idx,RealDouble,"CoordinateX",xCoord,&cgns_coord_idx));
-      delete_ptr(xCoord);
-    }
-  }
+  write_zone_coordinates();
 
   GroupsMapType grouped_elements_map;
   BOOST_FOREACH(const CElements& elements, find_components_recursively<CElements>(region))
@@ -197,6 +169,7 @@ void CWriter::write_zone(const CRegion& region)
     write_section(grouped_elements.second);
   }
 
+  write_solution(true);
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -254,7 +227,6 @@ void CWriter::write_section(const GroupedElements& grouped_elements)
 
         ElementType_t type = m_elemtype_CF_to_CGNS[builder_name[elements->element_type().derived_type_name()]];
         const CConnectivity::ArrayT& connectivity_table = elements->node_connectivity().array();
-        int start_idx = m_global_start_idx[&elements->geometry().coordinates()];
 
         int* elemNodes = new int [nbElems*(m_section.elemNodeCount+1)];
         for (int iElem=0; iElem<nbElems; ++iElem)
@@ -262,7 +234,7 @@ void CWriter::write_section(const GroupedElements& grouped_elements)
           elemNodes[0 + iElem*(m_section.elemNodeCount+1)] = type;
           for (int iNode=0; iNode<m_section.elemNodeCount; ++iNode)
           {
-            elemNodes[1+iNode+ iElem*(m_section.elemNodeCount+1)] = start_idx+connectivity_table[iElem][iNode]+1;
+            elemNodes[1+iNode+ iElem*(m_section.elemNodeCount+1)] = m_zone_node_idx[connectivity_table[iElem][iNode]];
           }
         }
 
@@ -282,14 +254,13 @@ void CWriter::write_section(const GroupedElements& grouped_elements)
       m_section.nbBdry = 0; // unsorted boundary
 
       const CConnectivity::ArrayT& connectivity_table = elements.node_connectivity().array();
-      int start_idx = m_global_start_idx[&elements.geometry().coordinates()];
 
       int* elemNodes = new int [nbElems*m_section.elemNodeCount];
       for (int iElem=0; iElem<nbElems; ++iElem)
       {
         for (int iNode=0; iNode<m_section.elemNodeCount; ++iNode)
         {
-          elemNodes[iNode+iElem*m_section.elemNodeCount] = start_idx + connectivity_table[iElem][iNode]+1;
+          elemNodes[iNode+iElem*m_section.elemNodeCount] = m_zone_node_idx[connectivity_table[iElem][iNode]];
         }
       }
 
@@ -317,6 +288,482 @@ void CWriter::write_section(const GroupedElements& grouped_elements)
 
 }
 
+/////////////////////////////////////////////////////////////////////////////
+
+void CWriter::number_zone_nodes(const CRegion& zone)
+{
+  const Geometry& geometry = m_mesh->geometry();
+  const Uint nb_nodes = geometry.size();
+  const bool parallel = Comm::PE::instance().is_active() && Comm::PE::instance().size() > 1;
+
+  // Nodes used by the elements of the zone, only the owned elements are written in parallel
+  std::vector<bool> used(nb_nodes, false);
+  BOOST_FOREACH(const CElements& elements, find_components_recursively<CElements>(zone))
+  {
+    const CConnectivity& connectivity = elements.node_connectivity();
+    for (Uint elem=0; elem<elements.size(); ++elem)
+    {
+      if (parallel && elements.is_ghost(elem))
+        continue;
+      for (Uint n=0; n<connectivity.row_size(); ++n)
+        used[connectivity[elem][n]] = true;
+    }
+  }
+
+  m_zone_node_idx.assign(nb_nodes, 0);
+  m_zone_nodes.nodes.clear();
+  m_zone_nodes.start = 1;
+
+  if (!parallel)
+  {
+    for (Uint node=0; node<nb_nodes; ++node)
+    {
+      if (used[node])
+      {
+        m_zone_nodes.nodes.push_back(node);
+        m_zone_node_idx[node] = m_zone_nodes.nodes.size();
+      }
+    }
+    m_zone.total_nbVertices = m_zone_nodes.nodes.size();
+    return;
+  }
+
+  Comm::PE& pe = Comm::PE::instance();
+  const Uint nb_procs = pe.size();
+  const CList<Uint>& glb_idx = geometry.glb_idx();
+  const CList<Uint>& owner = geometry.rank();
+
+  // Used ghost nodes are numbered by their owner, so ask the owners to include them
+  std::vector< std::pair<Uint,Uint> > ghosts; // (owner, node)
+  std::vector< std::pair<Uint,Uint> > owned;  // (global index, node)
+  for (Uint node=0; node<nb_nodes; ++node)
+  {
+    if (geometry.is_ghost(node))
+    {
+      if (used[node])
+        ghosts.push_back(std::make_pair(owner[node], node));
+    }
+    else
+    {
+      owned.push_back(std::make_pair(glb_idx[node], node));
+    }
+  }
+  std::sort(ghosts.begin(), ghosts.end());
+  std::sort(owned.begin(), owned.end());
+
+  std::vector<Uint> requests(ghosts.size());
+  std::vector<int> send_n(nb_procs, 0);
+  for (Uint g=0; g<ghosts.size(); ++g)
+  {
+    requests[g] = glb_idx[ghosts[g].second];
+    ++send_n[ghosts[g].first];
+  }
+
+  std::vector<Uint> requested;
+  std::vector<int> recv_n(nb_procs, -1);
+  pe.all_to_all(requests, send_n, requested, recv_n);
+
+  std::vector<Uint> requested_nodes(requested.size());
+  for (Uint r=0; r<requested.size(); ++r)
+  {
+    std::vector< std::pair<Uint,Uint> >::const_iterator found = std::lower_bound(owned.begin(), owned.end(), std::make_pair(requested[r], Uint(0)));
+    if (found == owned.end() || found->first != requested[r])
+      throw ValueNotFound(FromHere(), "Node with global index " + to_str(requested[r]) + " is not owned by rank " + to_str(pe.rank()));
+    requested_nodes[r] = found->second;
+    used[found->second] = true;
+  }
+
+  // Used owned nodes are numbered in order of global index, and the ranks follow each other
+  for (Uint i=0; i<owned.size(); ++i)
+  {
+    if (used[owned[i].second])
+      m_zone_nodes.nodes.push_back(owned[i].second);
+  }
+
+  std::vector<Uint> nb_zone_nodes;
+  pe.all_gather(static_cast<Uint>(m_zone_nodes.nodes.size()), nb_zone_nodes);
+  m_zone.total_nbVertices = 0;
+  for (Uint p=0; p<nb_procs; ++p)
+  {
+    if (p == pe.rank())
+      m_zone_nodes.start = m_zone.total_nbVertices + 1;
+    m_zone.total_nbVertices += nb_zone_nodes[p];
+  }
+
+  for (Uint i=0; i<m_zone_nodes.nodes.size(); ++i)
+    m_zone_node_idx[m_zone_nodes.nodes[i]] = m_zone_nodes.start + i;
+
+  // Return the numbers of the requested nodes
+  std::vector<int> replies(requested_nodes.size());
+  for (Uint r=0; r<requested_nodes.size(); ++r)
+    replies[r] = m_zone_node_idx[requested_nodes[r]];
+
+  std::vector<int> ghost_idx;
+  pe.all_to_all(replies, recv_n, ghost_idx, send_n);
+  for (Uint g=0; g<ghosts.size(); ++g)
+    m_zone_node_idx[ghosts[g].second] = ghost_idx[g];
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void CWriter::write_parallel(const URI& path)
+{
+  Comm::PE& pe = Comm::PE::instance();
+  const Uint rank = pe.rank();
+  const Uint nb_procs = pe.size();
+
+  // Zones and sections, with for each section the number of owned elements and the number of element types
+  const CRegion& base_region = m_mesh->topology();
+  std::vector<const CRegion*> zones;
+  BOOST_FOREACH(const CRegion& zone_region, find_components<CRegion>(base_region))
+    zones.push_back(&zone_region);
+
+  std::vector<GroupsMapType> zone_sections(zones.size());
+  std::vector<Uint> section_info;
+  for (Uint z=0; z<zones.size(); ++z)
+  {
+    BOOST_FOREACH(const CElements& elements, find_components_recursively<CElements>(*zones[z]))
+      zone_sections[z][elements.parent().uri().path()].push_back(elements.as_ptr<CElements const>());
+
+    BOOST_FOREACH(const GroupsMapType::value_type& grouped_elements, zone_sections[z])
+    {
+      Uint nb_owned_elems = 0;
+      BOOST_FOREACH(CElements::ConstPtr elements, grouped_elements.second)
+      {
+        for (Uint elem=0; elem<elements->size(); ++elem)
+          if (!elements->is_ghost(elem))
+            ++nb_owned_elems;
+      }
+      section_info.push_back(nb_owned_elems);
+      section_info.push_back(grouped_elements.second.size());
+    }
+  }
+
+  const Uint info_size = section_info.size();
+  std::vector<Uint> info_sizes;
+  pe.all_gather(info_size, info_sizes);
+  boost_foreach(const Uint other_info_size, info_sizes)
+  {
+    if (other_info_size != info_size)
+      throw SetupError(FromHere(), "Parallel CGNS output requires the same zones and sections on all ranks, but rank " + to_str(rank) + " has " + to_str(info_size/2) + " sections while another rank has " + to_str(other_info_size/2));
+  }
+
+  std::vector<Uint> all_section_info;
+  pe.all_gather(section_info, all_section_info);
+
+  // Global section sizes and the offset of this rank in each section
+  const Uint nb_sections = info_size/2;
+  std::vector<int> section_size(nb_sections, 0);
+  std::vector<int> rank_offset(nb_sections, 0);
+  std::vector<bool> is_mixed(nb_sections, false);
+  for (Uint p=0; p<nb_procs; ++p)
+  {
+    for (Uint s=0; s<nb_sections; ++s)
+    {
+      const int nb_elems = all_section_info[p*info_size + 2*s];
+      if (p < rank)
+        rank_offset[s] += nb_elems;
+      section_size[s] += nb_elems;
+      if (all_section_info[p*info_size + 2*s + 1] != 1)
+        is_mixed[s] = true;
+    }
+  }
+
+  m_base.name = base_region.name();
+  m_base.cell_dim = m_mesh->dimensionality();
+  m_base.phys_dim = m_mesh->dimension();
+
+  // With a CGNS library built on parallel HDF5, all ranks open the file at once, create the nodes collectively
+  // and write their own data independently. This is not possible for mixed sections, since the parallel API
+  // only supports fixed size element types.
+  // Otherwise the serial CGNS library does not allow concurrent access, so only rank 0 opens the file,
+  // creates the nodes and writes the data that the other ranks send to it.
+  m_collective = false;
+#ifdef CF_HAVE_CGNS_PARALLEL
+  m_collective = std::find(is_mixed.begin(), is_mixed.end(), true) == is_mixed.end();
+#endif
+  const bool create = m_collective || (rank == 0);
+
+#ifdef CF_HAVE_CGNS_PARALLEL
+  if (m_collective)
+  {
+    CFdebug << "Opening file " << path.path() << " on all ranks" << CFendl;
+    CALL_CGNS(cgp_mpi_comm(pe.communicator()));
+    CALL_CGNS(cgp_pio_mode(CGP_INDEPENDENT));
+    CALL_CGNS(cgp_open(path.path().c_str(), CG_MODE_WRITE, &m_file.idx));
+  }
+  else
+#endif
+  if (create)
+  {
+    CFdebug << "Opening file " << path.path() << CFendl;
+    CALL_CGNS(cg_open(path.path().c_str(), CG_MODE_WRITE, &m_file.idx));
+  }
+
+  // Nodes are created in the same order on all ranks, so the indices are known
+  m_base.idx = 1;
+  if (create)
+    CALL_CGNS(cg_base_write(m_file.idx,m_base.name.c_str(),m_base.cell_dim,m_base.phys_dim,&m_base.idx));
+
+  Uint s = 0;
+  for (Uint z=0; z<zones.size(); ++z)
+  {
+    const Uint zone_end = s + zone_sections[z].size();
+
+    m_zone.name = zones[z]->name();
+    m_zone.coord_dim = m_mesh->dimension();
+    number_zone_nodes(*zones[z]);
+    m_zone.nbElements = 0;
+    for (Uint zs=s; zs<zone_end; ++zs)
+      m_zone.nbElements += section_size[zs];
+    m_zone.nbBdryVertices = 0;
+
+    m_zone.idx = z+1;
+    if (create)
+    {
+      int size[3][1];
+      size[0][0] = m_zone.total_nbVertices;
+      size[1][0] = m_zone.nbElements;
+      size[2][0] = m_zone.nbBdryVertices;
+
+      CFdebug << "Writing zone " << m_zone.name << CFendl;
+      CALL_CGNS(cg_zone_write(m_file.idx,m_base.idx,m_zone.name.c_str(),size[0],Unstructured,&m_zone.idx));
+    }
+
+    write_zone_coordinates();
+
+    int section_start = 1;
+    int section_idx = 1;
+    BOOST_FOREACH(const GroupsMapType::value_type& grouped_elements, zone_sections[z])
+    {
+      // Sections that are empty on all ranks are not written
+      if (section_size[s] != 0)
+      {
+        m_section.idx = section_idx++;
+        write_parallel_section(grouped_elements.second, section_start, section_size[s], section_start + rank_offset[s], is_mixed[s], create);
+        section_start += section_size[s];
+      }
+      ++s;
+    }
+
+    write_solution(create);
+  }
+
+#ifdef CF_HAVE_CGNS_PARALLEL
+  if (m_collective)
+  {
+    CFdebug << "Closing file " << path.path() << " on all ranks" << CFendl;
+    CALL_CGNS(cgp_close(m_file.idx));
+  }
+  else
+#endif
+  if (create)
+  {
+    CFdebug << "Closing file " << path.path() << CFendl;
+    CALL_CGNS(cg_close(m_file.idx));
+  }
+  m_collective = false;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void CWriter::write_zone_coordinates()
+{
+  static const char* coord_names[3] = {"CoordinateX", "CoordinateY", "CoordinateZ"};
+
+  const CTable<Real>& coordinates = m_mesh->geometry().coordinates();
+  const Uint nb_nodes = m_zone_nodes.nodes.size();
+  std::vector<Real> buffer;
+  int cgns_coord_idx;
+
+  for (int d=0; d<m_zone.coord_dim; ++d)
+  {
+    buffer.resize(nb_nodes);
+    for (Uint i=0; i<nb_nodes; ++i)
+      buffer[i] = coordinates[m_zone_nodes.nodes[i]][d];
+
+#ifdef CF_HAVE_CGNS_PARALLEL
+    if (m_collective)
+    {
+      CALL_CGNS(cgp_coord_write(m_file.idx,m_base.idx,m_zone.idx,RealDouble,coord_names[d],&cgns_coord_idx));
+      if (nb_nodes != 0)
+      {
+        cgsize_t range_min = m_zone_nodes.start;
+        cgsize_t range_max = m_zone_nodes.start + nb_nodes - 1;
+        CALL_CGNS(cgp_coord_write_data(m_file.idx,m_base.idx,m_zone.idx,cgns_coord_idx,&range_min,&range_max,&buffer[0]));
+      }
+      continue;
+    }
+#endif
+    // All nodes of the zone, in the order of the zone numbering
+    if (detail::gather_on_writer(buffer) && !buffer.empty())
+    {
+      CFdebug << "Writing " << coord_names[d] << CFendl;
+      CALL_CGNS(cg_coord_write(m_file.idx,m_base.idx,m_zone.idx,RealDouble,coord_names[d],&buffer[0],&cgns_coord_idx));
+    }
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void CWriter::write_parallel_section(const GroupedElements& grouped_elements, const int section_start, const int section_size,
+                                     const int rank_start, const bool is_mixed, const bool create_section)
+{
+  const int section_end = section_start + section_size - 1;
+
+  m_section.name = grouped_elements[0]->parent().name();
+  m_section.type = is_mixed ? MIXED : cgns_element_type(*grouped_elements[0]);
+
+  if (create_section)
+  {
+    // If this region is a surface, it must be a boundary condition.
+    // Thus create the boundary condition as an element range (no extra storage)
+    if (IsElementsSurface()(*grouped_elements[0]))
+    {
+      m_boco.name = m_section.name;
+      m_section.name = m_section.name + "_bc";
+      int range[2];
+      range[0] = section_start;
+      range[1] = section_end;
+      CFdebug << "Writing boco " << m_boco.name << CFendl;
+      CALL_CGNS(cg_boco_write(m_file.idx,m_base.idx,m_zone.idx,m_boco.name.c_str(),BCTypeNull,ElementRange,2,range,&m_boco.idx));
+    }
+
+    CFdebug << "Writing section " << m_section.name << CFendl;
+#ifdef CF_HAVE_CGNS_PARALLEL
+    if (m_collective)
+    {
+      CALL_CGNS(cgp_section_write(m_file.idx,m_base.idx,m_zone.idx,m_section.name.c_str(),m_section.type,section_start,section_end,0,&m_section.idx));
+    }
+    else
+#endif
+    {
+      CALL_CGNS(cg_section_partial_write(m_file.idx,m_base.idx,m_zone.idx,m_section.name.c_str(),m_section.type,section_start,section_end,0,&m_section.idx));
+    }
+  }
+
+  // The owned elements of this rank, with the nodes in the zone numbering
+  std::vector<int> elem_nodes;
+  int nb_owned_elems = 0;
+  BOOST_FOREACH(CElements::ConstPtr elements, grouped_elements)
+  {
+    const Uint nb_elems = elements->size();
+    const ElementType_t type = cgns_element_type(*elements);
+    const CConnectivity& connectivity = elements->node_connectivity();
+
+    for (Uint elem=0; elem<nb_elems; ++elem)
+    {
+      if (elements->is_ghost(elem))
+        continue;
+
+      if (is_mixed)
+        elem_nodes.push_back(type);
+      for (Uint n=0; n<connectivity.row_size(); ++n)
+        elem_nodes.push_back(m_zone_node_idx[connectivity[elem][n]]);
+      ++nb_owned_elems;
+    }
+  }
+
+#ifdef CF_HAVE_CGNS_PARALLEL
+  if (m_collective)
+  {
+    if (nb_owned_elems != 0)
+    {
+      const std::vector<cgsize_t> cgns_elem_nodes(elem_nodes.begin(), elem_nodes.end());
+      CALL_CGNS(cgp_elements_write_data(m_file.idx,m_base.idx,m_zone.idx,m_section.idx,rank_start,rank_start+nb_owned_elems-1,&cgns_elem_nodes[0]));
+    }
+    return;
+  }
+#endif
+  // The ranks follow each other in the section
+  if (detail::gather_on_writer(elem_nodes))
+    CALL_CGNS(cg_elements_partial_write(m_file.idx,m_base.idx,m_zone.idx,m_section.idx,section_start,section_end,&elem_nodes[0]));
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void CWriter::write_solution(const bool create_solution)
+{
+  if (!option("write_solution").value<bool>())
+    return;
+
+  std::vector<const Field*> fields;
+  boost_foreach(boost::weak_ptr<Field> field_ptr, m_fields)
+  {
+    const Field& field = *field_ptr.lock();
+
+    // must be point based and stored with the mesh nodes
+    if (field.basis() == FieldGroup::Basis::POINT_BASED && &field.field_group() == &m_mesh->geometry())
+      fields.push_back(&field);
+  }
+
+  if (fields.empty())
+    return;
+
+  int sol_idx = 1;
+  if (create_solution)
+  {
+    CFdebug << "Writing solution for zone " << m_zone.name << CFendl;
+    CALL_CGNS(cg_sol_write(m_file.idx,m_base.idx,m_zone.idx,"FlowSolution",Vertex,&sol_idx));
+  }
+
+  static const char* component_names[3] = {"X", "Y", "Z"};
+
+  const Uint nb_nodes = m_zone_nodes.nodes.size();
+  std::vector<Real> buffer;
+  int cgns_field_idx;
+  boost_foreach(const Field* field, fields)
+  {
+    for (Uint var=0; var<field->nb_vars(); ++var)
+    {
+      const Uint var_begin = field->var_index(var);
+      const Uint var_length = static_cast<Uint>(field->var_length(var));
+      for (Uint component=0; component<var_length; ++component)
+      {
+        std::string name = field->var_name(var);
+        if (var_length > 1)
+          name += var_length <= DIM_3D ? std::string(component_names[component]) : to_str(component);
+
+        buffer.resize(nb_nodes);
+        for (Uint i=0; i<nb_nodes; ++i)
+          buffer[i] = (*field)[m_zone_nodes.nodes[i]][var_begin+component];
+
+#ifdef CF_HAVE_CGNS_PARALLEL
+        if (m_collective)
+        {
+          CALL_CGNS(cgp_field_write(m_file.idx,m_base.idx,m_zone.idx,sol_idx,RealDouble,name.c_str(),&cgns_field_idx));
+          if (nb_nodes != 0)
+          {
+            cgsize_t range_min = m_zone_nodes.start;
+            cgsize_t range_max = m_zone_nodes.start + nb_nodes - 1;
+            CALL_CGNS(cgp_field_write_data(m_file.idx,m_base.idx,m_zone.idx,sol_idx,cgns_field_idx,&range_min,&range_max,&buffer[0]));
+          }
+          continue;
+        }
+#endif
+        if (detail::gather_on_writer(buffer) && !buffer.empty())
+          CALL_CGNS(cg_field_write(m_file.idx,m_base.idx,m_zone.idx,sol_idx,RealDouble,name.c_str(),&buffer[0],&cgns_field_idx));
+      }
+    }
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+ElementType_t CWriter::cgns_element_type(const CElements& elements)
+{
+  if (m_builder_names.empty())
+  {
+    CFactory& sf_factory = *Core::instance().factories().get_factory<ElementType>();
+    boost_foreach(CBuilder& sf_builder, find_components_recursively<CBuilder>( sf_factory ) )
+    {
+      ElementType::Ptr sf = sf_builder.build("sf")->as_ptr<ElementType>();
+      m_builder_names[sf->derived_type_name()] = sf_builder.name();
+    }
+  }
+  return m_elemtype_CF_to_CGNS[m_builder_names[elements.element_type().derived_type_name()]];
+}
+
 //////////////////////////////////////////////////////////////////////////////
 
 
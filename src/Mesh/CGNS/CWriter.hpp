@@ -41,6 +41,15 @@ private : // typedefs
   typedef std::vector<boost::shared_ptr<CElements const> > GroupedElements;
   typedef std::map<std::string, GroupedElements > GroupsMapType;
 
+  /// Contiguous range of node indices in the current zone, written by this process
+  struct NodeRange
+  {
+    /// First (1-based) index in the zone
+    int start;
+    /// Local node indices that are written in the range
+    std::vector<Uint> nodes;
+  };
+
 public: // functions
 
   /// constructor
@@ -65,11 +74,57 @@ private: // functions
 
 //  void write_boco(const GroupedElements& grouped_elements);
 
+  /// Number the nodes used by the elements of a zone, in the order they are stored in the file.
+  /// Each zone only stores the nodes it uses. In parallel, the used nodes are numbered by their owner, rank by rank,
+  /// and the numbers of used ghost nodes are requested from their owner.
+  /// Fills m_zone_nodes, m_zone_node_idx and the number of vertices of m_zone.
+  /// @param zone The zone region
+  void number_zone_nodes(const CRegion& zone);
+
+  /// Write the mesh into a single file when running in parallel. Each rank contributes its owned nodes and elements,
+  /// at the position given by the zone numbering. Ghost nodes and elements are skipped.
+  /// If the CGNS library provides parallel I/O (CF_HAVE_CGNS_PARALLEL), the file is opened by all ranks at once,
+  /// the base, zones, sections, bocos and solutions are created collectively and every rank writes its own ranges.
+  /// Mixed sections are not supported by the parallel CGNS API, so otherwise only rank 0 opens the file with the
+  /// serial library, and the data of the other ranks is gathered on rank 0 one array at a time.
+  void write_parallel(const Common::URI& path);
+
+  /// Write the coordinates of the nodes of the current zone
+  void write_zone_coordinates();
+
+  /// Write the owned elements of one section in parallel
+  /// @param grouped_elements The elements in the section
+  /// @param section_start First (1-based) element index of the section in the zone
+  /// @param section_size Number of elements in the section, on all ranks
+  /// @param rank_start First (1-based) element index written by this rank
+  /// @param is_mixed True if the section has more than one element type on any rank
+  /// @param create_section True on the ranks that create the section
+  void write_parallel_section(const GroupedElements& grouped_elements, const int section_start, const int section_size,
+                              const int rank_start, const bool is_mixed, const bool create_section);
+
+  /// Write the point-based fields that were set using the "fields" option as a vertex-based FlowSolution
+  /// of the current zone, if the "write_solution" option is set. Only the nodes in m_zone_nodes are written.
+  /// @param create_solution True on the ranks that create the solution node
+  void write_solution(const bool create_solution);
+
+  /// The CGNS element type for the given elements
+  ElementType_t cgns_element_type(const CElements& elements);
+
 private: // data
 
   std::string m_fileBasename;
 
-  std::map<const CTable<Real>*, Uint> m_global_start_idx;
+  /// Nodes of the current zone written by this process
+  NodeRange m_zone_nodes;
+
+  /// (1-based) index in the current zone for each node, or 0 if the zone does not use the node
+  std::vector<int> m_zone_node_idx;
+
+  /// Element type builder name for each element type name
+  std::map<std::string,std::string> m_builder_names;
+
+  /// True while all ranks write at once through the parallel CGNS library
+  bool m_collective;
 
 }; // end CWriter
 
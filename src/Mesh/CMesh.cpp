@@ -12,6 +12,8 @@
 
 #include "Common/CBuilder.hpp"
 #include "Common/CLink.hpp"
+#include "Common/Core.hpp"
+#include "Common/EventHandler.hpp"
 #include "Common/Foreach.hpp"
 #include "Common/FindComponents.hpp"
 #include "Common/OptionT.hpp"
@@ -34,6 +36,7 @@
 #include "Mesh/MeshMetadata.hpp"
 #include "Mesh/CCells.hpp"
 #include "Mesh/CFaces.hpp"
+#include "Mesh/CList.hpp"
 
 namespace CF {
 namespace Mesh {
@@ -71,6 +74,8 @@ CMesh::CMesh ( const std::string& name  ) :
   m_nodes = create_static_component_ptr<Geometry>(Mesh::Tags::nodes());
   m_nodes->add_tag(Mesh::Tags::nodes());
 
+  Core::instance().event_handler().connect_to_event("mesh_loaded", this, &CMesh::on_mesh_changed_event);
+  Core::instance().event_handler().connect_to_event("mesh_changed", this, &CMesh::on_mesh_changed_event);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -103,6 +108,29 @@ void CMesh::initialize_nodes(const Uint nb_nodes, const Uint dimension)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void CMesh::clear_used_nodes()
+{
+  // Collect first, since removing components invalidates the range
+  std::vector<CList<Uint>::Ptr> node_lists;
+  boost_foreach(CList<Uint>& node_list, find_components_recursively_with_tag<CList<Uint> >(topology(), Mesh::Tags::nodes_used()))
+    node_lists.push_back(node_list.as_ptr<CList<Uint> >());
+
+  boost_foreach(CList<Uint>::Ptr node_list, node_lists)
+    node_list->parent().remove_component(*node_list);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void CMesh::on_mesh_changed_event( SignalArgs& args )
+{
+  SignalOptions options( args );
+
+  if (options.value<URI>("mesh_uri") == uri())
+    clear_used_nodes();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void CMesh::update_statistics()
 {
   cf_assert(m_dimension == geometry().coordinates().row_size() );
@@ -87,6 +87,15 @@ public: // functions
   /// will among others set the coordinate dimension for the nodes
   void initialize_nodes(const Uint nb_nodes, const Uint dimension);
 
+  /// Remove the cached lists of used nodes (see CEntities::used_nodes) in the topology,
+  /// so they get rebuilt the next time they are requested
+  void clear_used_nodes();
+
+private: // functions
+
+  /// Clears the cached node lists when this mesh was loaded or changed
+  void on_mesh_changed_event( Common::SignalArgs& args );
+
 private: // data
 
   Uint m_dimension;
@@ -25,6 +25,7 @@
 #include "Mesh/CMeshPartitioner.hpp"
 #include "Mesh/CDynTable.hpp"
 #include "Mesh/Geometry.hpp"
+#include "Mesh/FieldGroup.hpp"
 #include "Mesh/CRegion.hpp"
 #include "Mesh/Manipulations.hpp"
 #include "Mesh/CMeshElements.hpp"
@@ -42,7 +43,9 @@ namespace Mesh {
 CMeshPartitioner::CMeshPartitioner ( const std::string& name ) :
     CMeshTransformer(name),
     m_base(0),
-    m_nb_parts(Comm::PE::instance().size())
+    m_nb_parts(Comm::PE::instance().size()),
+    m_use_weights(false),
+    m_mean_cost(0.)
 {
   m_options.add_option<OptionT <Uint> >("nb_parts", m_nb_parts)
       ->description("Total number of partitions (e.g. number of processors)")
@@ -50,6 +53,11 @@ CMeshPartitioner::CMeshPartitioner ( const std::string& name ) :
       ->link_to(&m_nb_parts)
       ->mark_basic();
 
+  m_options.add_option<OptionT <bool> >("use_weights", m_use_weights)
+      ->description("Weight the elements by the cost measured during the element loops")
+      ->pretty_name("Use Weights")
+      ->link_to(&m_use_weights);
+
   m_global_to_local = create_static_component_ptr<CMap<Uint,Uint> >("global_to_local");
   m_lookup = create_static_component_ptr<CUnifiedData >("lookup");
 
@@ -125,6 +133,19 @@ void CMeshPartitioner::initialize(CMesh& mesh)
 
   Uint tot_nb_owned_obj = tot_nb_owned_nodes + tot_nb_owned_elems;
 
+  // mean cost per element over all processors, used to normalize the weights
+  m_mean_cost = 0.;
+  if (m_use_weights)
+  {
+    Real cost[2] = {0., static_cast<Real>(tot_nb_owned_elems)};
+    boost_foreach( CElements& elements, find_components_recursively<CElements>(mesh) )
+      cost[0] += elements.cost();
+    Real glb_cost[2];
+    Comm::PE::instance().all_reduce(Comm::plus(), cost, 2, glb_cost);
+    if (glb_cost[1] > 0.)
+      m_mean_cost = glb_cost[0] / glb_cost[1];
+  }
+
   std::vector<Uint> nb_nodes_per_proc(Comm::PE::instance().size());
   std::vector<Uint> nb_elems_per_proc(Comm::PE::instance().size());
   std::vector<Uint> nb_obj_per_proc(Comm::PE::instance().size());
@@ -445,6 +466,19 @@ void CMeshPartitioner::migrate()
   // ----------------------------------------------------------------------------
   // ----------------------------------------------------------------------------
 
+  // -----------------------------------------------------------------------------
+  // STORE ELEMENT-BASED FIELD VALUES WITH THEIR ELEMENTS
+
+  std::vector<FieldGroup*> element_field_groups;
+  boost_foreach(FieldGroup& field_group, find_components<FieldGroup>(mesh))
+  {
+    if (field_group.basis() != FieldGroup::Basis::POINT_BASED)
+    {
+      store_element_field_values(field_group);
+      element_field_groups.push_back(&field_group);
+    }
+  }
+
   PackUnpackNodes node_manipulation(nodes);
 
   // -----------------------------------------------------------------------------
@@ -689,6 +723,12 @@ void CMeshPartitioner::migrate()
   mesh.update_statistics();
   mesh.elements().reset();
   mesh.elements().update();
+
+  // -----------------------------------------------------------------------------
+  // PUT BACK THE ELEMENT-BASED FIELD VALUES
+
+  boost_foreach(FieldGroup* field_group, element_field_groups)
+    restore_element_field_values(*field_group);
 }
 
 //////////////////////////////////////////////////////////////////////////////
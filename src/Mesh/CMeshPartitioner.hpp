@@ -98,6 +98,15 @@ public: // functions
   template <typename VectorT>
   void list_of_connected_procs_in_part(const Uint part, VectorT& proc_per_neighbor) const;
 
+  /// Weights of the objects, in the same order as list_of_objects_owned_by_part().
+  /// Elements are weighted by their measured cost relative to the mean cost
+  /// per element, nodes have unit weight.
+  template <typename VectorT>
+  void list_of_object_weights(const Uint part, VectorT& weights) const;
+
+  /// True if the objects are weighted by their measured cost
+  bool use_weights() const { return m_use_weights; }
+
 
 public: // functions
 
@@ -150,6 +159,10 @@ private: // data
 
   Uint m_nb_owned_obj;
 
+  bool m_use_weights;
+
+  /// global mean of the measured cost per element
+  Real m_mean_cost;
 
   Common::CMap<Uint,Uint>::Ptr m_global_to_local;
 
@@ -290,6 +303,32 @@ void CMeshPartitioner::list_of_connected_procs_in_part(const Uint part, VectorT&
 
 //////////////////////////////////////////////////////////////////////////////
 
+template <typename VectorT>
+void CMeshPartitioner::list_of_object_weights(const Uint part, VectorT& weights) const
+{
+  // declaration for boost::tie
+  Common::Component::Ptr comp;
+  Uint loc_idx;
+
+  Uint idx=0;
+  foreach_container((const Uint glb_obj)(const Uint loc_obj),*m_global_to_local)
+  {
+    if (part_of_obj(glb_obj) == part)
+    {
+      weights[idx] = 1.;
+      boost::tie(comp,loc_idx) = m_lookup->location(loc_obj);
+      if (CElements::Ptr elements = comp->as_ptr<CElements>())
+      {
+        if (m_mean_cost > 0. && elements->cost() > 0.)
+          weights[idx] = elements->cost_per_entity() / m_mean_cost;
+      }
+      ++idx;
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 } // Mesh
 } // CF
 
@@ -76,6 +76,9 @@ void CMeshTransformer::transform(CMesh& mesh)
 {
   set_mesh(mesh);
   execute();
+
+  // the transformation may have added or removed elements
+  mesh.clear_used_nodes();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
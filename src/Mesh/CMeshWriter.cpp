@@ -15,6 +15,7 @@
 #include "Mesh/MeshMetadata.hpp"
 #include "Mesh/Geometry.hpp"
 #include "Mesh/Field.hpp"
+#include "Mesh/ElementData.hpp"
 
 namespace CF {
 namespace Mesh {
@@ -61,9 +62,25 @@ void CMeshWriter::config_fields()
   m_options["fields"].put_value(field_uris);
 
   m_fields.resize(0);
+  m_single_precision_fields.resize(0);
   boost_foreach ( const URI& uri, field_uris)
   {
-    m_fields.push_back(access_component_ptr_checked(uri)->as_ptr_checked<Field>());
+    Component::Ptr comp = access_component_ptr_checked(uri);
+
+    // Single precision fields are written through a Real copy, refreshed before each write
+    if ( SinglePrecisionField::Ptr single_field = comp->as_ptr<SinglePrecisionField>() )
+    {
+      Field::Ptr copy = allocate_component<Field>(single_field->name());
+      copy->set_field_group(single_field->field_group());
+      copy->set_topology(single_field->topology());
+      copy->set_basis(single_field->basis());
+      copy->set_descriptor(single_field->descriptor());
+      m_single_precision_fields.push_back(std::make_pair(boost::weak_ptr<SinglePrecisionField>(single_field), copy));
+      m_fields.push_back(copy);
+      continue;
+    }
+
+    m_fields.push_back(comp->as_ptr_checked<Field>());
     if ( is_null(m_fields.back().lock()) )
       throw ValueNotFound(FromHere(),"Invalid URI ["+uri.string()+"]");
   }
@@ -74,12 +91,26 @@ void CMeshWriter::config_fields()
 void CMeshWriter::set_fields(const std::vector<Field::Ptr>& fields)
 {
   m_fields.resize(0);
+  m_single_precision_fields.resize(0);
   boost_foreach( Field::Ptr field, fields )
     m_fields.push_back(field);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void CMeshWriter::update_single_precision_fields()
+{
+  typedef std::pair< boost::weak_ptr<SinglePrecisionField>, Field::Ptr > FieldPairT;
+  boost_foreach( const FieldPairT& field_pair, m_single_precision_fields )
+  {
+    if ( field_pair.first.expired() )
+      throw SetupError(FromHere(), "Single precision field " + field_pair.second->name() + " to write by " + uri().string() + " was removed");
+    convert(*field_pair.second, *field_pair.first.lock());
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 CMeshWriter::~CMeshWriter()
 {
 }
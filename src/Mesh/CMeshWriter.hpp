@@ -23,6 +23,7 @@ namespace Mesh {
 
   class Geometry;
   class Field;
+  class SinglePrecisionField;
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -70,6 +71,12 @@ private: // functions
 
   void config_fields();
 
+protected: // functions
+
+  /// Copy the values of the single precision fields given in the "fields" option to their Real copies in m_fields.
+  /// Writers call this before writing the fields.
+  void update_single_precision_fields();
+
 protected: // classes
 
   class IsGroup
@@ -91,6 +98,11 @@ protected:
 
   std::vector<boost::weak_ptr<Field> > m_fields;
 
+private:
+
+  /// Single precision fields to write, each with the Real copy in m_fields that the writers read
+  std::vector< std::pair< boost::weak_ptr<SinglePrecisionField>, boost::shared_ptr<Field> > > m_single_precision_fields;
+
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -30,7 +30,8 @@ Common::ComponentBuilder < CSpace, Component, LibMesh > CSpace_Builder;
 
 CSpace::CSpace ( const std::string& name ) :
   Component ( name ),
-  m_is_proxy(false)
+  m_is_proxy(false),
+  m_connectivity_built(false)
 {
   mark_basic();
 
@@ -70,6 +71,27 @@ void CSpace::configure_shape_function()
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void CSpace::set_connectivity_builder(const boost::function<void (CConnectivity&)>& builder)
+{
+  boost::mutex::scoped_lock lock(m_connectivity_mutex);
+  m_connectivity_builder = builder;
+  m_connectivity_built = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void CSpace::build_connectivity() const
+{
+  boost::mutex::scoped_lock lock(m_connectivity_mutex);
+  if(m_connectivity_built)
+    return;
+
+  m_connectivity_builder(*m_connectivity);
+  m_connectivity_built = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 bool CSpace::is_bound_to_fields() const
 {
   return m_bound_fields->is_linked();
@@ -9,6 +9,9 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <boost/function.hpp>
+#include <boost/thread/mutex.hpp>
+
 #include "Mesh/LibMesh.hpp"
 #include "Mesh/ShapeFunction.hpp"
 #include "Mesh/CEntities.hpp"
@@ -60,12 +63,20 @@ public: // functions
   Uint nb_states() const { return shape_function().nb_nodes(); }
 
   /// Return the node_connectivity table
-  /// @pre node connectivity must have been created beforehand
-  CConnectivity& connectivity() { return *m_connectivity; }
+  /// @pre node connectivity must have been created beforehand, or a connectivity builder must be set
+  CConnectivity& connectivity() { if(!m_connectivity_builder.empty()) build_connectivity(); return *m_connectivity; }
 
   /// Return the node_connectivity table
-  /// @pre node connectivity must have been created beforehand
-  const CConnectivity& connectivity() const { return *m_connectivity; }
+  /// @pre node connectivity must have been created beforehand, or a connectivity builder must be set
+  const CConnectivity& connectivity() const { if(!m_connectivity_builder.empty()) build_connectivity(); return *m_connectivity; }
+
+  /// Set a function that fills the connectivity table the first time it is accessed.
+  /// This is used by entities that can compute their connectivity on the fly, so the table is
+  /// only stored when an algorithm needs it. Filling the table is thread-safe: once a builder is set,
+  /// every access to the connectivity checks if it was filled while holding a lock, so algorithms that
+  /// access it in a tight loop should keep a reference to the table.
+  /// The builder must be set during setup, before any thread accesses the connectivity.
+  void set_connectivity_builder(const boost::function<void (CConnectivity&)>& builder);
 
   CConnectivity::ConstRow indexes_for_element(const Uint elem_idx) const;
 
@@ -88,6 +99,9 @@ private: // functions
   /// Configuration option trigger for the shape function
   void configure_shape_function();
 
+  /// Fill the connectivity table using the connectivity builder, if this was not done yet
+  void build_connectivity() const;
+
 protected: // data
 
   /// Shape function of this space
@@ -109,6 +123,15 @@ private: // data
 
   bool m_is_proxy;
   Uint m_elem_start_idx;
+
+  /// Fills the connectivity on first access, if set
+  boost::function<void (CConnectivity&)> m_connectivity_builder;
+
+  /// True once the connectivity builder was called, only accessed while holding m_connectivity_mutex
+  mutable bool m_connectivity_built;
+
+  /// Makes sure the connectivity builder is called only once when several threads access the connectivity
+  mutable boost::mutex m_connectivity_mutex;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -24,6 +24,8 @@ Common::ComponentBuilder < CTable<int>, Component, LibMesh >  CTable_int_Builder
 
 Common::ComponentBuilder < CTable<Real>, Component, LibMesh > CTable_Real_Builder;
 
+Common::ComponentBuilder < CTable<float>, Component, LibMesh > CTable_float_Builder;
+
 Common::ComponentBuilder < CTable<std::string>, Component, LibMesh > CTable_string_Builder;
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -52,6 +54,12 @@ std::ostream& operator<<(std::ostream& os, const CTable<Real>::ConstRow row)
   return os;
 }
 
+std::ostream& operator<<(std::ostream& os, const CTable<float>::ConstRow row)
+{
+  print_vector(os, row);
+  return os;
+}
+
 std::ostream& operator<<(std::ostream& os, const CTable<std::string>::ConstRow row)
 {
   print_vector(os, row);
@@ -124,6 +132,22 @@ std::ostream& operator<<(std::ostream& os, const CTable<Real>& table)
   return os;
 }
 
+std::ostream& operator<<(std::ostream& os, const CTable<float>& table)
+{
+  if (table.size())
+    os << "\n";
+  Uint i=0;
+  boost_foreach(CTable<float>::ConstRow row, table.array())
+  {
+    os << "  " << i << ":  ";
+    boost_foreach(const float entry, row)
+      os << entry << " ";
+    os << "\n";
+    ++i;
+  }
+  return os;
+}
+
 std::ostream& operator<<(std::ostream& os, const CTable<std::string>& table)
 {
   if (table.size())
@@ -9,6 +9,8 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <new>
+
 #include "Common/Component.hpp"
 
 #include "Mesh/ArrayBufferT.hpp"
@@ -24,7 +26,10 @@ namespace Mesh {
 /// @brief Component holding a 2 dimensional array of a templated type
 ///
 /// The internal structure is that of a boost::multi_array,
-/// so storage is contingent in memory for reducing cache missing
+/// so storage is contingent in memory for reducing cache missing.
+/// By default rows are contiguous (row-major). The layout can be switched
+/// to column-major, so each column is contiguous and loops over a single
+/// column can vectorize. Row access through operator[] works in both layouts.
 //
 /// The table can be filled through a buffer. The buffer avoids
 /// the typical reallocation in a std::vector. Flushing the buffer
@@ -55,9 +60,18 @@ public: // typedefs
   /// @brief the const type of a row in the internal structure of the table
   typedef const typename boost::const_subarray_gen<ArrayT,1>::type ConstRow;
 
+  /// @brief the type of a column in the internal structure of the table
+  typedef typename ArrayT::template array_view<1>::type Column;
+
+  /// @brief the const type of a column in the internal structure of the table
+  typedef typename ArrayT::template const_array_view<1>::type ConstColumn;
+
   /// @brief the type of the buffer used to interact with the table
   typedef ArrayBufferT<ValueT> Buffer;
 
+  /// @brief the memory layout of the table
+  enum Layout { ROW_MAJOR, COLUMN_MAJOR };
+
   /// @brief boost::shared_ptr shortcut of this component
   typedef boost::shared_ptr<CTable> Ptr;
 
@@ -92,6 +106,34 @@ public: // functions
     m_array.resize(boost::extents[nb_rows][row_size()]);
   }
 
+  /// Change the memory layout of the table, keeping its contents.
+  /// Buffers created before this call remain valid.
+  /// If memory runs out, the exception propagates and the table is either unchanged or empty.
+  /// @param[in] layout ROW_MAJOR to store rows contiguously, COLUMN_MAJOR to store columns contiguously
+  void set_layout(const Layout layout)
+  {
+    if(layout == this->layout())
+      return;
+
+    // Copy the contents first, the table is unchanged if this throws
+    const ArrayT copy(m_array);
+
+    // multi_array keeps its storage order on assignment and resize, and has no swap, so the array is
+    // rebuilt in place to keep its address, which is referenced by the buffers. The rebuilt array has
+    // no rows, so constructing it allocates no elements. The resize builds the storage in a temporary
+    // and swaps it in, so the array stays valid if it throws.
+    m_array.~ArrayT();
+    if(layout == COLUMN_MAJOR)
+      new (&m_array) ArrayT(boost::extents[0][copy.shape()[1]], boost::fortran_storage_order());
+    else
+      new (&m_array) ArrayT(boost::extents[0][copy.shape()[1]], boost::c_storage_order());
+    m_array.resize(boost::extents[copy.shape()[0]][copy.shape()[1]]);
+    m_array = copy;
+  }
+
+  /// The current memory layout of the table
+  Layout layout() const { return m_array.storage_order().ordering(0) == 0 ? COLUMN_MAJOR : ROW_MAJOR; }
+
   /// Modifiable access to the internal structure
   /// @return A reference to the array data
   ArrayT& array() { return m_array; }
@@ -127,6 +169,14 @@ public: // functions
   /// @return A const row of the underlying array
   ConstRow operator[](const Uint idx) const { return m_array[idx]; }
 
+  /// Modifiable access to a table-column. The column is contiguous in memory if the layout is COLUMN_MAJOR
+  /// @return A mutable view on the given column
+  Column column(const Uint idx) { return m_array[boost::indices[range()][idx]]; }
+
+  /// Non-modifiable access to a table-column. The column is contiguous in memory if the layout is COLUMN_MAJOR
+  /// @return A const view on the given column
+  ConstColumn column(const Uint idx) const { return m_array[boost::indices[range()][idx]]; }
+
   /// Number of rows, excluding rows that may be in the buffer
   /// @return The number of local rows in the array
   Uint size() const { return m_array.size(); }
@@ -195,18 +245,20 @@ public: // functions
   /// U = c
   CTable& operator =(const value_type& c)
   {
-    for (Uint i=0; i<size(); ++i)
-      for (Uint j=0; j<row_size(); ++j)
-        array()[i][j] = c;
+    value_type* data = m_array.data();
+    const Uint nb_entries = m_array.num_elements();
+    for (Uint i=0; i<nb_entries; ++i)
+      data[i] = c;
     return *this;
   }
 
   /// U += c
   CTable& operator +=(const value_type& c)
   {
-    for (Uint i=0; i<size(); ++i)
-      for (Uint j=0; j<row_size(); ++j)
-        array()[i][j] += c;
+    value_type* data = m_array.data();
+    const Uint nb_entries = m_array.num_elements();
+    for (Uint i=0; i<nb_entries; ++i)
+      data[i] += c;
     return *this;
   }
 
@@ -215,18 +267,30 @@ public: // functions
   {
     cf_assert(size() == U.size());
     cf_assert(row_size() == U.row_size());
-    for (Uint i=0; i<size(); ++i)
-      for (Uint j=0; j<row_size(); ++j)
-        array()[i][j] += U.array()[i][j];
+    if (layout() == U.layout())
+    {
+      value_type* data = m_array.data();
+      const value_type* other_data = U.array().data();
+      const Uint nb_entries = m_array.num_elements();
+      for (Uint i=0; i<nb_entries; ++i)
+        data[i] += other_data[i];
+    }
+    else
+    {
+      for (Uint i=0; i<size(); ++i)
+        for (Uint j=0; j<row_size(); ++j)
+          array()[i][j] += U.array()[i][j];
+    }
     return *this;
   }
 
   /// U -= c
   CTable& operator -=(const value_type& c)
   {
-    for (Uint i=0; i<size(); ++i)
-      for (Uint j=0; j<row_size(); ++j)
-        array()[i][j] -= c;
+    value_type* data = m_array.data();
+    const Uint nb_entries = m_array.num_elements();
+    for (Uint i=0; i<nb_entries; ++i)
+      data[i] -= c;
     return *this;
   }
 
@@ -235,18 +299,30 @@ public: // functions
   {
     cf_assert(size() == U.size());
     cf_assert(row_size() == U.row_size());
-    for (Uint i=0; i<size(); ++i)
-      for (Uint j=0; j<row_size(); ++j)
-        array()[i][j] -= U.array()[i][j];
+    if (layout() == U.layout())
+    {
+      value_type* data = m_array.data();
+      const value_type* other_data = U.array().data();
+      const Uint nb_entries = m_array.num_elements();
+      for (Uint i=0; i<nb_entries; ++i)
+        data[i] -= other_data[i];
+    }
+    else
+    {
+      for (Uint i=0; i<size(); ++i)
+        for (Uint j=0; j<row_size(); ++j)
+          array()[i][j] -= U.array()[i][j];
+    }
     return *this;
   }
 
   /// U *= c
   CTable& operator *=(const value_type& c)
   {
-    for (Uint i=0; i<size(); ++i)
-      for (Uint j=0; j<row_size(); ++j)
-        array()[i][j] *= c;
+    value_type* data = m_array.data();
+    const Uint nb_entries = m_array.num_elements();
+    for (Uint i=0; i<nb_entries; ++i)
+      data[i] *= c;
     return *this;
   }
 
@@ -273,9 +349,10 @@ public: // functions
   /// U /= c
   CTable& operator /=(const value_type& c)
   {
-    for (Uint i=0; i<size(); ++i)
-      for (Uint j=0; j<row_size(); ++j)
-        array()[i][j] /= c;
+    value_type* data = m_array.data();
+    const Uint nb_entries = m_array.num_elements();
+    for (Uint i=0; i<nb_entries; ++i)
+      data[i] /= c;
     return *this;
   }
 
@@ -323,6 +400,11 @@ public: // functions
   // friend istream& operator >> (istream& in,  CTable& U);
 
 
+private: // functions
+
+  /// Range over all indices of a dimension
+  static typename ArrayT::index_range range() { return typename ArrayT::index_range(); }
+
 private: // data
 
   /// storage of the array
@@ -335,12 +417,14 @@ std::ostream& operator<<(std::ostream& os, const CTable<bool>::ConstRow row);
 std::ostream& operator<<(std::ostream& os, const CTable<Uint>::ConstRow row);
 std::ostream& operator<<(std::ostream& os, const CTable<int>::ConstRow row);
 std::ostream& operator<<(std::ostream& os, const CTable<Real>::ConstRow row);
+std::ostream& operator<<(std::ostream& os, const CTable<float>::ConstRow row);
 std::ostream& operator<<(std::ostream& os, const CTable<std::string>::ConstRow row);
 
 std::ostream& operator<<(std::ostream& os, const CTable<bool>& table);
 std::ostream& operator<<(std::ostream& os, const CTable<Uint>& table);
 std::ostream& operator<<(std::ostream& os, const CTable<int>& table);
 std::ostream& operator<<(std::ostream& os, const CTable<Real>& table);
+std::ostream& operator<<(std::ostream& os, const CTable<float>& table);
 std::ostream& operator<<(std::ostream& os, const CTable<std::string>& table);
 
 ////////////////////////////////////////////////////////////////////////////////
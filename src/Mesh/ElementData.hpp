@@ -24,44 +24,63 @@ namespace Mesh {
 ////////////////////////////////////////////////////////////////////////////////
 
 /// Fill STL-vector like per-node data storage
-template<typename NodeValuesT, typename RowT>
-void fill(NodeValuesT& to_fill, const CTable<Real>& data_array, const RowT& element_row, const Uint start=0)
+/// The data may be stored in a different precision (i.e. a SinglePrecisionField), it is converted to Real on the fly
+template<typename NodeValuesT, typename ValueT, typename RowT>
+void fill(NodeValuesT& to_fill, const CTable<ValueT>& data_array, const RowT& element_row, const Uint start=0)
 {
   const Uint nb_nodes = element_row.size();
   const Uint dim = data_array.row_size();
   const Uint end = start+dim;
   for(Uint node = 0; node != nb_nodes; ++node)
   {
-    const CTable<Real>::ConstRow data_row = data_array[element_row[node]];
+    const typename CTable<ValueT>::ConstRow data_row = data_array[element_row[node]];
     for(Uint j = start; j != end; ++j)
-      to_fill[node][j-start] = data_row[j];
+      to_fill[node][j-start] = static_cast<Real>(data_row[j]);
   }
 }
 
 /// Fill static sized matrices
-template<typename RowT, int NbRows, int NbCols>
-void fill(Eigen::Matrix<Real, NbRows, NbCols>& to_fill, const CTable<Real>& data_array, const RowT& element_row, const Uint start=0)
+template<typename ValueT, typename RowT, int NbRows, int NbCols>
+void fill(Eigen::Matrix<Real, NbRows, NbCols>& to_fill, const CTable<ValueT>& data_array, const RowT& element_row, const Uint start=0)
 {
   for(int node = 0; node != NbRows; ++node)
   {
-    const CTable<Real>::ConstRow data_row = data_array[element_row[node]];
+    const typename CTable<ValueT>::ConstRow data_row = data_array[element_row[node]];
     for(Uint j = 0; j != NbCols; ++j)
-      to_fill(node, j) = data_row[j+start];
+      to_fill(node, j) = static_cast<Real>(data_row[j+start]);
   }
 }
 
 /// Fill dynamic matrices
-template<typename RowT>
-void fill(RealMatrix& to_fill, const CTable<Real>& data_array, const RowT& element_row, const Uint start=0)
+template<typename ValueT, typename RowT>
+void fill(RealMatrix& to_fill, const CTable<ValueT>& data_array, const RowT& element_row, const Uint start=0)
 {
   const Uint nb_nodes = element_row.size();
   const Uint dim = data_array.row_size();
   const Uint end = start+dim;
   for(Uint node = 0; node != nb_nodes; ++node)
   {
-    const CTable<Real>::ConstRow data_row = data_array[element_row[node]];
+    const typename CTable<ValueT>::ConstRow data_row = data_array[element_row[node]];
     for(Uint j = start; j != end; ++j)
-      to_fill(node, j-start) = data_row[j];
+      to_fill(node, j-start) = static_cast<Real>(data_row[j]);
+  }
+}
+
+/// Copy a table into a table of a different precision, with the same dimensions
+/// Use it to keep a single precision copy of field data that is only read, halving the memory traffic
+template<typename ToT, typename FromT>
+void convert(CTable<ToT>& to, const CTable<FromT>& from)
+{
+  to.set_row_size(from.row_size());
+  to.resize(from.size());
+  const Uint nb_rows = from.size();
+  const Uint row_size = from.row_size();
+  for(Uint i = 0; i != nb_rows; ++i)
+  {
+    const typename CTable<FromT>::ConstRow from_row = from[i];
+    typename CTable<ToT>::Row to_row = to[i];
+    for(Uint j = 0; j != row_size; ++j)
+      to_row[j] = static_cast<ToT>(from_row[j]);
   }
 }
 
@@ -0,0 +1,199 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <algorithm>
+
+#include <boost/bind.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "Math/Consts.hpp"
+
+#include "Mesh/FaceMatcher.hpp"
+
+namespace CF {
+namespace Mesh {
+
+////////////////////////////////////////////////////////////////////////////////
+
+FaceMatcher::FaceMatcher() :
+  m_nb_threads(1)
+{
+  clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FaceMatcher::clear()
+{
+  m_nodes.clear();
+  m_offsets.assign(1, 0);
+  m_hashes.clear();
+  m_matches.clear();
+  m_owned_faces.clear();
+  m_tables.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FaceMatcher::reserve(const Uint nb_faces, const Uint nb_nodes)
+{
+  m_offsets.reserve(nb_faces+1);
+  m_nodes.reserve(nb_nodes);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Uint FaceMatcher::add_face(const std::vector<Uint>& nodes)
+{
+  const Uint begin = m_nodes.size();
+  m_nodes.insert(m_nodes.end(), nodes.begin(), nodes.end());
+  std::sort(m_nodes.begin() + begin, m_nodes.end());
+  m_offsets.push_back(m_nodes.size());
+  return size() - 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Uint FaceMatcher::size() const
+{
+  return m_offsets.size() - 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FaceMatcher::match(const Uint nb_threads)
+{
+  const Uint nb_faces = size();
+  m_nb_threads = std::max(1u, std::min(nb_threads, nb_faces));
+  m_hashes.resize(nb_faces);
+  m_matches.assign(nb_faces, Math::Consts::uint_max());
+  m_owned_faces.assign(m_nb_threads, std::vector< std::vector<Uint> >(m_nb_threads));
+  m_tables.assign(m_nb_threads, std::vector<Uint>());
+
+  if(m_nb_threads == 1)
+  {
+    hash_range(0, 0, nb_faces);
+    match_owned(0);
+    return;
+  }
+
+  // Hash contiguous blocks of faces
+  boost::thread_group hashers;
+  for(Uint i = 0; i != m_nb_threads; ++i)
+    hashers.create_thread(boost::bind(&FaceMatcher::hash_range, this, i, (nb_faces * i) / m_nb_threads, (nb_faces * (i+1)) / m_nb_threads));
+  hashers.join_all();
+
+  // Matching faces have the same hash, so each thread can match the faces it owns independently
+  boost::thread_group matchers;
+  for(Uint i = 0; i != m_nb_threads; ++i)
+    matchers.create_thread(boost::bind(&FaceMatcher::match_owned, this, i));
+  matchers.join_all();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Uint FaceMatcher::matched_face(const Uint face) const
+{
+  cf_assert(face < m_matches.size());
+  return m_matches[face];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Uint FaceMatcher::find(const std::vector<Uint>& nodes) const
+{
+  if(m_tables.empty() || nodes.empty())
+    return Math::Consts::uint_max();
+
+  std::vector<Uint> sorted_nodes(nodes);
+  std::sort(sorted_nodes.begin(), sorted_nodes.end());
+  const std::size_t hash = boost::hash_range(sorted_nodes.begin(), sorted_nodes.end());
+
+  const std::vector<Uint>& table = m_tables[hash % m_nb_threads];
+  return table[find_slot(table, hash, &sorted_nodes[0], sorted_nodes.size())];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FaceMatcher::hash_range(const Uint block, const Uint begin, const Uint end)
+{
+  std::vector< std::vector<Uint> >& owned_faces = m_owned_faces[block];
+  for(Uint thread = 0; thread != m_nb_threads; ++thread)
+    owned_faces[thread].reserve((end - begin) / m_nb_threads + 1);
+
+  for(Uint face = begin; face != end; ++face)
+  {
+    const std::size_t hash = boost::hash_range(m_nodes.begin() + m_offsets[face], m_nodes.begin() + m_offsets[face+1]);
+    m_hashes[face] = hash;
+    owned_faces[hash % m_nb_threads].push_back(face);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FaceMatcher::match_owned(const Uint thread)
+{
+  Uint nb_owned = 0;
+  for(Uint block = 0; block != m_nb_threads; ++block)
+    nb_owned += m_owned_faces[block][thread].size();
+
+  // Keep the load factor below one half, with a power of two size so the probing can wrap around using a mask
+  Uint table_size = 2;
+  while(table_size < 2*nb_owned)
+    table_size *= 2;
+
+  std::vector<Uint>& table = m_tables[thread];
+  table.assign(table_size, Math::Consts::uint_max());
+
+  // The blocks cover the faces in order, so the first face with a given set of nodes is inserted first
+  for(Uint block = 0; block != m_nb_threads; ++block)
+  {
+    const std::vector<Uint>& owned_faces = m_owned_faces[block][thread];
+    const Uint nb_block_faces = owned_faces.size();
+    for(Uint i = 0; i != nb_block_faces; ++i)
+    {
+      const Uint face = owned_faces[i];
+      const Uint slot = find_slot(table, m_hashes[face], &m_nodes[m_offsets[face]], m_offsets[face+1] - m_offsets[face]);
+      const Uint first_face = table[slot];
+      if(first_face == Math::Consts::uint_max())
+      {
+        table[slot] = face;
+      }
+      else
+      {
+        m_matches[face] = first_face;
+        m_matches[first_face] = face;
+      }
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Uint FaceMatcher::find_slot(const std::vector<Uint>& table, const std::size_t hash, const Uint* nodes, const Uint nb_nodes) const
+{
+  const Uint mask = table.size() - 1;
+  Uint slot = (hash / m_nb_threads) & mask;
+  while(true)
+  {
+    const Uint face = table[slot];
+    if(face == Math::Consts::uint_max())
+      return slot;
+
+    if(m_hashes[face] == hash
+      && m_offsets[face+1] - m_offsets[face] == nb_nodes
+      && std::equal(nodes, nodes + nb_nodes, m_nodes.begin() + m_offsets[face]))
+      return slot;
+
+    slot = (slot + 1) & mask;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // Mesh
+} // CF
@@ -0,0 +1,96 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef CF_Mesh_FaceMatcher_hpp
+#define CF_Mesh_FaceMatcher_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+
+#include "Mesh/LibMesh.hpp"
+
+namespace CF {
+namespace Mesh {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Finds faces that have the same nodes, regardless of the node order.
+/// Faces are added one by one, and get consecutive indices. After match() is called, each face is paired
+/// with the first face that was added with the same nodes. The sorted nodes are hashed into flat open-addressing
+/// tables, one for each thread. Each thread owns the faces with a different hash value, so matching needs no locks.
+class Mesh_API FaceMatcher
+{
+public:
+  FaceMatcher();
+
+  /// Remove all faces
+  void clear();
+
+  /// Reserve storage for the given number of faces and the total number of nodes over these faces
+  void reserve(const Uint nb_faces, const Uint nb_nodes);
+
+  /// Add a face with the given nodes
+  /// @return the index of the new face
+  Uint add_face(const std::vector<Uint>& nodes);
+
+  /// Number of faces that were added
+  Uint size() const;
+
+  /// Pair up faces with the same nodes, using nb_threads threads
+  void match(const Uint nb_threads = 1);
+
+  /// The face that has the same nodes as the given face, or Math::Consts::uint_max() if the face is unique.
+  /// If more than two faces share their nodes, the first one is paired with the last one.
+  /// @pre match() was called
+  Uint matched_face(const Uint face) const;
+
+  /// Look up the first face that has the given nodes
+  /// @return the face index, or Math::Consts::uint_max() if no face has these nodes
+  /// @pre match() was called
+  Uint find(const std::vector<Uint>& nodes) const;
+
+private:
+  /// Hash the faces in [begin, end[, and sort them into the lists of faces owned by each thread
+  void hash_range(const Uint block, const Uint begin, const Uint end);
+
+  /// Match the faces owned by the given thread
+  void match_owned(const Uint thread);
+
+  /// Table slot where the face with the given hash is stored, or where it should be inserted
+  Uint find_slot(const std::vector<Uint>& table, const std::size_t hash, const Uint* nodes, const Uint nb_nodes) const;
+
+  /// Number of threads used in the last call to match()
+  Uint m_nb_threads;
+
+  /// Sorted nodes of all faces, one after the other
+  std::vector<Uint> m_nodes;
+
+  /// Start of the nodes of each face in m_nodes, with the end as last value
+  std::vector<Uint> m_offsets;
+
+  /// Hash of the sorted nodes of each face
+  std::vector<std::size_t> m_hashes;
+
+  /// Matched face for each face
+  std::vector<Uint> m_matches;
+
+  /// Faces owned by each thread, for each block of faces that was hashed, in increasing order.
+  /// Indexed as m_owned_faces[block][thread], so the hashing threads don't share any list.
+  std::vector< std::vector< std::vector<Uint> > > m_owned_faces;
+
+  /// Open-addressing hash table for each thread, holding the index of the first face with each set of nodes
+  std::vector< std::vector<Uint> > m_tables;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // Mesh
+} // CF
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // CF_Mesh_FaceMatcher_hpp
@@ -37,115 +37,111 @@ namespace Mesh {
 
 Common::ComponentBuilder < Field, Component, LibMesh >  Field_Builder;
 
+Common::ComponentBuilder < SinglePrecisionField, Component, LibMesh >  SinglePrecisionField_Builder;
+
 ////////////////////////////////////////////////////////////////////////////////////////////
 
-Field::Field ( const std::string& name  ) :
-  CTable<Real> ( name ),
+template <typename ValueT>
+FieldT<ValueT>::FieldT ( const std::string& name  ) :
+  CTable<ValueT> ( name ),
   m_basis(FieldGroup::Basis::INVALID)
 {
-  mark_basic();
-
-//  m_options.add_option<OptionArrayT<std::string> >("var_names", std::vector<std::string>(1,name))
-//      ->description("Names of the variables")
-//      ->pretty_name("Variable Names")
-//      ->attach_trigger ( boost::bind ( &Field::config_var_names, this ) )
-//      ->mark_basic();
-//  config_var_names();
-
-//  m_options.add_option<OptionArrayT<std::string> >("var_types", std::vector<std::string>(1,"scalar"))
-//      ->description("Types of the variables")
-//      ->attach_trigger ( boost::bind ( &Field::config_var_types,   this ) )
-//      ->mark_basic()
-//      ->restricted_list() = boost::assign::list_of
-//        (std::string("scalar"))
-//        (std::string("vector2D"))
-//        (std::string("vector3D"))
-//        (std::string("tensor2D"))
-//        (std::string("tensor3D"));
-//  config_var_types();
-
+  this->mark_basic();
 
+  this->m_options.template add_option< OptionT<bool> >("column_major", false)
+      ->description("Store each variable component contiguously, so loops over a single column vectorize")
+      ->pretty_name("Column Major")
+      ->attach_trigger ( boost::bind ( &FieldT::config_layout, this ) );
 }
 
 
-Field::~Field() {}
-
-
-void Field::config_var_types()
-{
-}
+template <typename ValueT>
+FieldT<ValueT>::~FieldT() {}
 
+////////////////////////////////////////////////////////////////////////////////
 
-void Field::config_var_names()
+template <typename ValueT>
+void FieldT<ValueT>::config_layout()
 {
+  this->set_layout(this->option("column_major").template value<bool>() ? CTable<ValueT>::COLUMN_MAJOR : CTable<ValueT>::ROW_MAJOR);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void Field::set_topology(CRegion& region)
+template <typename ValueT>
+void FieldT<ValueT>::set_topology(CRegion& region)
 {
   m_topology = region.as_ptr<CRegion>();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-Uint Field::nb_vars() const
+template <typename ValueT>
+Uint FieldT<ValueT>::nb_vars() const
 {
   return descriptor().nb_vars();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-bool Field::has_variable(const std::string& vname) const
+template <typename ValueT>
+bool FieldT<ValueT>::has_variable(const std::string& vname) const
 {
   return descriptor().has_variable(vname);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-std::string Field::var_name(Uint var_nb) const
+template <typename ValueT>
+std::string FieldT<ValueT>::var_name(Uint var_nb) const
 {
   return descriptor().user_variable_name(var_nb);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-Uint Field::var_number ( const std::string& vname ) const
+template <typename ValueT>
+Uint FieldT<ValueT>::var_number ( const std::string& vname ) const
 {
   return descriptor().var_number(vname);
 }
 
 //////////////////////////////////////////////////////////////////////////////
 
-Uint Field::var_index ( const std::string& vname ) const
+template <typename ValueT>
+Uint FieldT<ValueT>::var_index ( const std::string& vname ) const
 {
   return descriptor().offset(vname);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-Uint Field::var_index ( const Uint var_nb ) const
+template <typename ValueT>
+Uint FieldT<ValueT>::var_index ( const Uint var_nb ) const
 {
   return descriptor().offset(var_nb);
 }
 
 //////////////////////////////////////////////////////////////////////////////
 
-Field::VarType Field::var_length(const Uint var_nb) const
+template <typename ValueT>
+typename FieldT<ValueT>::VarType FieldT<ValueT>::var_length(const Uint var_nb) const
 {
-  return (Field::VarType)descriptor().var_length(var_nb);
+  return (VarType)descriptor().var_length(var_nb);
 }
 
 //////////////////////////////////////////////////////////////////////////////
 
-Field::VarType Field::var_length ( const std::string& vname ) const
+template <typename ValueT>
+typename FieldT<ValueT>::VarType FieldT<ValueT>::var_length ( const std::string& vname ) const
 {
-  return (Field::VarType)descriptor().var_length(vname);
+  return (VarType)descriptor().var_length(vname);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-CRegion& Field::topology() const
+template <typename ValueT>
+CRegion& FieldT<ValueT>::topology() const
 {
   cf_assert(m_topology.expired() == false);
   return *m_topology.lock();
@@ -153,14 +149,16 @@ CRegion& Field::topology() const
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void Field::set_field_group(FieldGroup& field_group)
+template <typename ValueT>
+void FieldT<ValueT>::set_field_group(FieldGroup& field_group)
 {
   m_field_group = field_group.as_ptr<FieldGroup>();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-FieldGroup& Field::field_group() const
+template <typename ValueT>
+FieldGroup& FieldT<ValueT>::field_group() const
 {
   cf_assert(m_field_group.expired() == false);
   return *m_field_group.lock();
@@ -168,36 +166,41 @@ FieldGroup& Field::field_group() const
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void Field::resize(const Uint size)
+template <typename ValueT>
+void FieldT<ValueT>::resize(const Uint size)
 {
-  set_row_size(descriptor().size());
-  CTable<Real>::resize(size);
+  this->set_row_size(descriptor().size());
+  CTable<ValueT>::resize(size);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-CTable<Uint>::ConstRow Field::indexes_for_element(const CEntities& elements, const Uint idx) const
+template <typename ValueT>
+CTable<Uint>::ConstRow FieldT<ValueT>::indexes_for_element(const CEntities& elements, const Uint idx) const
 {
   return field_group().indexes_for_element(elements,idx);
 }
 
 
-CTable<Uint>::ConstRow Field::indexes_for_element(const Uint unified_idx) const
+template <typename ValueT>
+CTable<Uint>::ConstRow FieldT<ValueT>::indexes_for_element(const Uint unified_idx) const
 {
   return field_group().indexes_for_element(unified_idx);
 }
 
 
-CommPattern& Field::parallelize_with(CommPattern& comm_pattern)
+template <typename ValueT>
+CommPattern& FieldT<ValueT>::parallelize_with(CommPattern& comm_pattern)
 {
   cf_assert_desc("Only point-based fields supported now", m_basis == FieldGroup::Basis::POINT_BASED);
   m_comm_pattern = comm_pattern.as_ptr<CommPattern>();
-  comm_pattern.insert(name(), array(), true);
+  comm_pattern.insert(this->name(), this->array(), true);
   return comm_pattern;
 }
 
 
-CommPattern& Field::parallelize()
+template <typename ValueT>
+CommPattern& FieldT<ValueT>::parallelize()
 {
   if ( !m_comm_pattern.expired() ) // return if already parallel
     return *m_comm_pattern.lock();
@@ -205,13 +208,13 @@ CommPattern& Field::parallelize()
   // Extract gid from the nodes.glb_idx()  for only the nodes in the region the fields will use.
   std::vector<Uint> gid;
   std::vector<Uint> ranks;
-  gid.reserve( size() );
-  ranks.reserve( size() );
+  gid.reserve( this->size() );
+  ranks.reserve( this->size() );
 
   CMesh& mesh = find_parent_component<CMesh>(*this);
-  cf_assert_desc("["+to_str(glb_idx().size())+"!="+to_str(size())+"]",glb_idx().size() == size());
-  cf_assert_desc("["+to_str(rank().size())+"!="+to_str(size())+"]",rank().size() == size());
-  for (Uint node=0; node<size(); ++node)
+  cf_assert_desc("["+to_str(glb_idx().size())+"!="+to_str(this->size())+"]",glb_idx().size() == this->size());
+  cf_assert_desc("["+to_str(rank().size())+"!="+to_str(this->size())+"]",rank().size() == this->size());
+  for (Uint node=0; node<this->size(); ++node)
   {
     gid.push_back( glb_idx()[node] );
     ranks.push_back( rank()[node] );
@@ -228,32 +231,56 @@ CommPattern& Field::parallelize()
 }
 
 
-void Field::synchronize()
+template <typename ValueT>
+void FieldT<ValueT>::synchronize()
 {
   if ( !m_comm_pattern.expired() )
-    m_comm_pattern.lock()->synchronize( name() );
+    m_comm_pattern.lock()->synchronize( this->name() );
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 
-void Field::set_descriptor(Math::VariablesDescriptor& descriptor)
+template <typename ValueT>
+void FieldT<ValueT>::set_descriptor(Math::VariablesDescriptor& descriptor)
 {
   if (Math::VariablesDescriptor::Ptr old_descriptor = find_component_ptr<Math::VariablesDescriptor>(*this))
-    remove_component(*old_descriptor);
+    this->remove_component(*old_descriptor);
   m_descriptor = descriptor.as_ptr<Math::VariablesDescriptor>();
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 
-void Field::create_descriptor(const std::string& description, const Uint dimension)
+template <typename ValueT>
+void FieldT<ValueT>::create_descriptor(const std::string& description, const Uint dimension)
 {
   if (Math::VariablesDescriptor::Ptr old_descriptor = find_component_ptr<Math::VariablesDescriptor>(*this))
-    remove_component(*old_descriptor);
-  m_descriptor = create_component_ptr<Math::VariablesDescriptor>("description");
+    this->remove_component(*old_descriptor);
+  m_descriptor = this->template create_component_ptr<Math::VariablesDescriptor>("description");
   descriptor().set_variables(description,dimension);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 
+template class FieldT<Real>;
+template class FieldT<float>;
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+Field::Field ( const std::string& name ) : FieldT<Real>(name)
+{
+}
+
+Field::~Field() {}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+SinglePrecisionField::SinglePrecisionField ( const std::string& name ) : FieldT<float>(name)
+{
+}
+
+SinglePrecisionField::~SinglePrecisionField() {}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
 } // Mesh
 } // CF
@@ -25,19 +25,22 @@ namespace Math { class VariablesDescriptor; }
 namespace Mesh {
 
   class CRegion;
+  class Field;
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 
 /// Field component class
 /// This class stores fields which can be applied
 /// to fields (Field)
+/// The values are stored with type ValueT, see Field and SinglePrecisionField.
 /// @author Willem Deconinck, Tiago Quintino
-class Mesh_API Field : public CTable<Real> {
+template <typename ValueT>
+class Mesh_API FieldT : public CTable<ValueT> {
 
 public: // typedefs
 
-  typedef boost::shared_ptr<Field> Ptr;
-  typedef boost::shared_ptr<Field const> ConstPtr;
+  typedef boost::shared_ptr<FieldT> Ptr;
+  typedef boost::shared_ptr<FieldT const> ConstPtr;
 
   enum VarType { SCALAR=1, VECTOR_2D=2, VECTOR_3D=3, TENSOR_2D=4, TENSOR_3D=9};
 
@@ -45,13 +48,10 @@ public: // functions
 
   /// Contructor
   /// @param name of the component
-  Field ( const std::string& name );
+  FieldT ( const std::string& name );
 
   /// Virtual destructor
-  virtual ~Field();
-
-  /// Get the class name
-  static std::string type_name () { return "Field"; }
+  virtual ~FieldT();
 
   FieldGroup::Basis::Type basis() const { return m_basis; }
 
@@ -125,8 +125,8 @@ public: // functions
 
 private:
 
-  void config_var_names();
-  void config_var_types();
+  /// Apply the "column_major" option to the table layout
+  void config_layout();
 
   FieldGroup::Basis::Type m_basis;
   boost::weak_ptr<CRegion> m_topology;
@@ -139,6 +139,57 @@ private:
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 
+/// Field with its values stored as Real
+class Mesh_API Field : public FieldT<Real> {
+
+public: // typedefs
+
+  typedef boost::shared_ptr<Field> Ptr;
+  typedef boost::shared_ptr<Field const> ConstPtr;
+
+public: // functions
+
+  /// Contructor
+  /// @param name of the component
+  Field ( const std::string& name );
+
+  /// Virtual destructor
+  virtual ~Field();
+
+  /// Get the class name
+  static std::string type_name () { return "Field"; }
+
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+/// Field with its values stored in single precision.
+/// Meant for data that does not need the precision of Real, such as wave speeds and update coefficients,
+/// to halve the memory traffic of the loops that read it. Element kernels read it as Real through Mesh::fill.
+/// Writers that only handle Field output a Real copy, see CMeshWriter.
+class Mesh_API SinglePrecisionField : public FieldT<float> {
+
+public: // typedefs
+
+  typedef boost::shared_ptr<SinglePrecisionField> Ptr;
+  typedef boost::shared_ptr<SinglePrecisionField const> ConstPtr;
+
+public: // functions
+
+  /// Contructor
+  /// @param name of the component
+  SinglePrecisionField ( const std::string& name );
+
+  /// Virtual destructor
+  virtual ~SinglePrecisionField();
+
+  /// Get the class name
+  static std::string type_name () { return "SinglePrecisionField"; }
+
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
 } // Mesh
 } // CF
 
@@ -81,7 +81,8 @@ FieldGroup::FieldGroup ( const std::string& name  ) :
   Component( name ),
   m_basis(Basis::INVALID),
   m_space("invalid"),
-  m_size(0u)
+  m_size(0u),
+  m_column_major(false)
 {
   mark_basic();
 
@@ -108,6 +109,12 @@ FieldGroup::FieldGroup ( const std::string& name  ) :
     ->attach_trigger ( boost::bind ( &FieldGroup::config_space,   this ) )
     ->mark_basic();
 
+  // Option "column_major"
+  m_options.add_option< OptionT<bool> >("column_major", m_column_major)
+    ->description("Store the fields created in this group column by column")
+    ->pretty_name("Column Major")
+    ->link_to(&m_column_major);
+
   // Static components
   m_topology = create_static_component_ptr<CLink>("topology");
   m_elements_lookup = create_static_component_ptr<CUnifiedData>("elements_lookup");
@@ -179,6 +186,9 @@ void FieldGroup::resize(const Uint size)
 
   boost_foreach(Field& field, find_components<Field>(*this))
     field.resize(m_size);
+
+  boost_foreach(SinglePrecisionField& field, find_components<SinglePrecisionField>(*this))
+    field.resize(m_size);
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -202,11 +212,20 @@ CRegion& FieldGroup::topology() const
 
 Field& FieldGroup::create_field(const std::string &name, const std::string& variables_description)
 {
+  return create_field<Field>(name, variables_description);
+}
 
-  Field& field = create_component<Field>(name);
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename FieldType>
+FieldType& FieldGroup::create_field(const std::string &name, const std::string& variables_description)
+{
+
+  FieldType& field = create_component<FieldType>(name);
   field.set_field_group(*this);
   field.set_topology(topology());
   field.set_basis(m_basis);
+  field.configure_option("column_major", m_column_major);
 
   if (variables_description == "scalar_same_name")
     field.create_descriptor(name+"[scalar]",parent().as_type<CMesh>().dimension());
@@ -250,6 +269,7 @@ Field& FieldGroup::create_field(const std::string &name, Math::VariablesDescript
   field.set_field_group(*this);
   field.set_topology(topology());
   field.set_basis(m_basis);
+  field.configure_option("column_major", m_column_major);
   field.set_descriptor(variables_descriptor);
   field.descriptor().configure_property("dimension",parent().as_type<CMesh>().dimension());
   field.resize(m_size);
@@ -258,6 +278,11 @@ Field& FieldGroup::create_field(const std::string &name, Math::VariablesDescript
 
 ////////////////////////////////////////////////////////////////////////////////
 
+template Field& FieldGroup::create_field<Field>(const std::string&, const std::string&);
+template SinglePrecisionField& FieldGroup::create_field<SinglePrecisionField>(const std::string&, const std::string&);
+
+////////////////////////////////////////////////////////////////////////////////
+
 void FieldGroup::check_sanity()
 {
   boost_foreach(Field& field, find_components<Field>(*this))
@@ -266,6 +291,12 @@ void FieldGroup::check_sanity()
       throw InvalidStructure(FromHere(),"field ["+field.uri().string()+"] has a size "+to_str(field.size())+" != supposed "+to_str(m_size));
   }
 
+  boost_foreach(SinglePrecisionField& field, find_components<SinglePrecisionField>(*this))
+  {
+    if (field.size() != m_size)
+      throw InvalidStructure(FromHere(),"field ["+field.uri().string()+"] has a size "+to_str(field.size())+" != supposed "+to_str(m_size));
+  }
+
   boost_foreach(CList<Uint>& list, find_components<CList<Uint> >(*this))
   {
     if (list.size() != m_size)
@@ -490,9 +521,10 @@ void FieldGroup::create_connectivity_in_space()
   {
 
     // Check if this space is not already bound to another field_group
+    // (it is bound to this one when the elements changed, e.g. after a migration)
     boost_foreach(CEntities& entities, entities_range())
     {
-      if (entities.space(m_space).is_bound_to_fields() > 0)
+      if (entities.space(m_space).is_bound_to_fields() && &entities.space(m_space).bound_fields() != this)
         throw SetupError(FromHere(), "Space ["+entities.space(m_space).uri().string()+"] is already bound to\n"
                          "fields ["+entities.space(m_space).bound_fields().uri().string()+"]\nCreate a new space for field_group ["+uri().string()+"]");
     }
@@ -24,6 +24,7 @@ namespace Mesh {
 
   class CMesh;
   class Field;
+  class SinglePrecisionField;
   class CRegion;
   class CElements;
 
@@ -87,6 +88,12 @@ public: // functions
   /// Create a new field in this group
   Field& create_field( const std::string& name, Math::VariablesDescriptor& variables_descriptor);
 
+  /// Create a new field in this group, with the values stored as FieldType::value_type.
+  /// Use SinglePrecisionField for data that does not need the precision of Real.
+  /// @tparam FieldType Field or SinglePrecisionField
+  template <typename FieldType>
+  FieldType& create_field( const std::string& name, const std::string& variables_description = "scalar_same_name");
+
   /// Return the topology
   CRegion& topology() const;
 
@@ -156,6 +163,9 @@ protected:
 
   Uint m_size;
 
+  /// Layout of newly created fields, see the Field "column_major" option
+  bool m_column_major;
+
   boost::shared_ptr<Common::CLink> m_topology;
   boost::shared_ptr<CList<Uint> > m_glb_idx;
   boost::shared_ptr<CList<Uint> > m_rank;
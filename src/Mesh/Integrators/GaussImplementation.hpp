@@ -397,6 +397,35 @@ struct GaussMappedCoordsImpl<1, GeoShape::TETRA>
 };
 
 
+template<>
+struct GaussMappedCoordsImpl<2, GeoShape::TETRA>
+{
+  static const Uint nb_points = 4;
+
+  typedef Eigen::Matrix<Real, 3, nb_points> CoordsT;
+  typedef Eigen::Matrix<Real, 1, nb_points> WeightsT;
+
+  static CoordsT coords()
+  {
+    static const double a = 0.1381966011250105151795413;
+    static const double b = 0.5854101966249684544613760;
+
+    CoordsT result;
+    result << a, b, a, a,
+              a, a, b, a,
+              a, a, a, b;
+    return result;
+  }
+
+  static WeightsT weights()
+  {
+    WeightsT result;
+    result.setConstant(1.0/24.0);
+    return result;
+  }
+};
+
+
 /// Trapezium rule integration. Uses the end points of the line.
 template<>
 struct GaussMappedCoordsImpl<777, GeoShape::LINE>
@@ -4,13 +4,18 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include "Common/Foreach.hpp"
+#include "Common/FindComponents.hpp"
 #include "Common/MPI/debug.hpp"
 
 #include "Math/Consts.hpp"
 
 #include "Mesh/Manipulations.hpp"
 #include "Mesh/Geometry.hpp"
+#include "Mesh/Field.hpp"
 #include "Mesh/CElements.hpp"
+#include "Mesh/CMesh.hpp"
+#include "Mesh/CSpace.hpp"
 
 namespace CF {
 namespace Mesh {
@@ -19,6 +24,9 @@ using namespace Common;
 using namespace Common::Comm;
 using namespace Math::Consts;
 
+/// Tag of the tables that hold the element-based field values during a migration
+static const char* migrated_field_values_tag = "migrated_field_values";
+
 ////////////////////////////////////////////////////////////////////////////////
 
 RemoveNodes::RemoveNodes(Geometry& nodes) :
@@ -91,7 +99,10 @@ PackUnpackElements::PackUnpackElements(CElements& elements) :
     glb_idx (elements.glb_idx().create_buffer()),
     rank (elements.rank().create_buffer()),
     connected_nodes (elements.node_connectivity().create_buffer())
-{}
+{
+  boost_foreach(CTable<Real>& field_values, find_components_with_tag< CTable<Real> >(elements, migrated_field_values_tag))
+    fields.push_back(field_values.create_buffer_ptr());
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -111,6 +122,8 @@ void PackUnpackElements::remove(const Uint idx)
   glb_idx.rm_row(idx);
   rank.rm_row(idx);
   connected_nodes.rm_row(idx);
+  boost_foreach(CTable<Real>::Buffer::Ptr field, fields)
+    field->rm_row(idx);
 
   //std::cout << PERank << "removed element  " << val << std::endl;
 }
@@ -129,6 +142,9 @@ void PackUnpackElements::pack(Comm::Buffer& buf)
   boost_foreach(const Uint connected_node, m_elements.node_connectivity()[m_idx])
       buf << connected_node;
 
+  boost_foreach(CTable<Real>& field_values, find_components_with_tag< CTable<Real> >(m_elements, migrated_field_values_tag))
+    buf << field_values[m_idx];
+
   //std::cout << PERank << "packed element    glb_idx = " << val << std::endl;
 
   if (m_remove_after_pack)
@@ -154,6 +170,13 @@ void PackUnpackElements::unpack(Comm::Buffer& buf)
   cf_always_assert(rank.add_row(rank_data) == idx);
   cf_always_assert(connected_nodes.add_row(connected_nodes_data) == idx);
 
+  std::vector<Real> field_data;
+  boost_foreach(CTable<Real>::Buffer::Ptr field, fields)
+  {
+    buf >> field_data;
+    cf_always_assert(field->add_row(field_data) == idx);
+  }
+
   // std::cout << PERank << "unpacked and added element    glb_idx = " << glb_idx_data << "\t    rank = " << rank_data << "\t    connected_nodes = " << connected_nodes_data << std::endl;
 }
 
@@ -164,6 +187,8 @@ void PackUnpackElements::flush()
   glb_idx.flush();
   connected_nodes.flush();
   rank.flush();
+  boost_foreach(CTable<Real>::Buffer::Ptr field, fields)
+    field->flush();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -176,7 +201,15 @@ PackUnpackNodes::PackUnpackNodes(Geometry& nodes) :
   rank (nodes.rank().create_buffer(100)),
   coordinates (nodes.coordinates().create_buffer(100)),
   connected_elements (nodes.glb_elem_connectivity().create_buffer(100))
-{}
+{
+  boost_foreach(Field& field, find_components<Field>(nodes))
+  {
+    if (&field != &nodes.coordinates())
+      fields.push_back(field.create_buffer_ptr(100));
+  }
+  boost_foreach(SinglePrecisionField& field, find_components<SinglePrecisionField>(nodes))
+    single_precision_fields.push_back(field.create_buffer_ptr(100));
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -199,6 +232,10 @@ void PackUnpackNodes::remove(const Uint idx)
   rank.rm_row(idx);
   coordinates.rm_row(idx);
   connected_elements.rm_row(idx);
+  boost_foreach(CTable<Real>::Buffer::Ptr field, fields)
+    field->rm_row(idx);
+  boost_foreach(CTable<float>::Buffer::Ptr field, single_precision_fields)
+    field->rm_row(idx);
 
   m_idx = uint_max();
 }
@@ -226,6 +263,14 @@ void PackUnpackNodes::pack(Comm::Buffer& buf)
 
   buf << m_nodes.glb_elem_connectivity()[m_idx];
 
+  boost_foreach(Field& field, find_components<Field>(m_nodes))
+  {
+    if (&field != &m_nodes.coordinates())
+      buf << field[m_idx];
+  }
+  boost_foreach(SinglePrecisionField& field, find_components<SinglePrecisionField>(m_nodes))
+    buf << field[m_idx];
+
 //  std::cout << PERank << "packed node    glb_idx = " << val << std::endl;
 
   if (m_remove_after_pack)
@@ -251,6 +296,19 @@ void PackUnpackNodes::unpack(Comm::Buffer& buf)
   cf_always_assert(coordinates.add_row(coordinates_data) == idx);
   cf_always_assert(connected_elements.add_row(connected_elems_data) == idx);
 
+  std::vector<Real> field_data;
+  boost_foreach(CTable<Real>::Buffer::Ptr field, fields)
+  {
+    buf >> field_data;
+    cf_always_assert(field->add_row(field_data) == idx);
+  }
+  std::vector<float> single_precision_field_data;
+  boost_foreach(CTable<float>::Buffer::Ptr field, single_precision_fields)
+  {
+    buf >> single_precision_field_data;
+    cf_always_assert(field->add_row(single_precision_field_data) == idx);
+  }
+
   //std::cout << PERank << "added node    glb_idx = " << glb_idx_data << "\t    rank = " << rank_data << "\t    coords = " << coordinates_data << "\t    connected_elem = " << connected_elems_data << std::endl;
   m_idx = uint_max();
 }
@@ -263,11 +321,108 @@ void PackUnpackNodes::flush()
   rank.flush();
   coordinates.flush();
   connected_elements.flush();
+  boost_foreach(CTable<Real>::Buffer::Ptr field, fields)
+    field->flush();
+  boost_foreach(CTable<float>::Buffer::Ptr field, single_precision_fields)
+    field->flush();
   m_nodes.resize(m_nodes.coordinates().size());
   m_idx = uint_max();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void store_element_field_values(FieldGroup& field_group)
+{
+  cf_assert(field_group.basis() != FieldGroup::Basis::POINT_BASED);
+
+  Uint nb_values = 0;
+  boost_foreach(const Field& field, find_components<Field>(field_group))
+    nb_values += field.row_size();
+  boost_foreach(const SinglePrecisionField& field, find_components<SinglePrecisionField>(field_group))
+    nb_values += field.row_size();
+  if (nb_values == 0)
+    return;
+
+  boost_foreach(CElements& elements, field_group.elements_range())
+  {
+    CSpace& space = field_group.space(elements);
+    CTable<Real>& field_values = elements.create_component< CTable<Real> >("migrated_"+field_group.name());
+    field_values.add_tag(migrated_field_values_tag);
+    field_values.set_row_size(nb_values*space.nb_states());
+    field_values.resize(elements.size());
+
+    for (Uint elem=0; elem<elements.size(); ++elem)
+    {
+      CTable<Real>::Row values = field_values[elem];
+      Uint col = 0;
+      boost_foreach(const Uint idx, space.indexes_for_element(elem))
+      {
+        boost_foreach(const Field& field, find_components<Field>(field_group))
+          for (Uint j=0; j<field.row_size(); ++j)
+            values[col++] = field[idx][j];
+        boost_foreach(const SinglePrecisionField& field, find_components<SinglePrecisionField>(field_group))
+          for (Uint j=0; j<field.row_size(); ++j)
+            values[col++] = field[idx][j];
+      }
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void restore_element_field_values(FieldGroup& field_group)
+{
+  // the field rows follow the new number of elements
+  field_group.create_connectivity_in_space();
+
+  boost_foreach(CElements& elements, field_group.elements_range())
+  {
+    Component::Ptr field_values_comp = elements.get_child_ptr("migrated_"+field_group.name());
+    if (is_null(field_values_comp))
+      continue;
+
+    CTable<Real>& field_values = field_values_comp->as_type< CTable<Real> >();
+    CSpace& space = field_group.space(elements);
+    cf_assert(field_values.size() == elements.size());
+
+    for (Uint elem=0; elem<elements.size(); ++elem)
+    {
+      CTable<Real>::ConstRow values = field_values[elem];
+      Uint col = 0;
+      boost_foreach(const Uint idx, space.indexes_for_element(elem))
+      {
+        boost_foreach(Field& field, find_components<Field>(field_group))
+          for (Uint j=0; j<field.row_size(); ++j)
+            field[idx][j] = values[col++];
+        boost_foreach(SinglePrecisionField& field, find_components<SinglePrecisionField>(field_group))
+          for (Uint j=0; j<field.row_size(); ++j)
+            field[idx][j] = static_cast<float>(values[col++]);
+      }
+    }
+
+    elements.remove_component(field_values);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<std::string> fields_not_migrated(CMesh& mesh)
+{
+  std::vector<std::string> fields;
+  boost_foreach(FieldGroup& field_group, find_components<FieldGroup>(mesh))
+  {
+    if (&field_group == &mesh.geometry() || field_group.basis() != FieldGroup::Basis::POINT_BASED)
+      continue;
+
+    boost_foreach(Field& field, find_components<Field>(field_group))
+      fields.push_back(field.uri().path());
+    boost_foreach(SinglePrecisionField& field, find_components<SinglePrecisionField>(field_group))
+      fields.push_back(field.uri().path());
+  }
+  return fields;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 } // Mesh
 } // CF
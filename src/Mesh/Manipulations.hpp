@@ -20,6 +20,8 @@ namespace Mesh {
 
   class Geometry;
   class CElements;
+  class CMesh;
+  class FieldGroup;
 
   ////////////////////////////////////////////////////////////////////////////////
 
@@ -73,6 +75,8 @@ struct PackUnpackElements: Common::Comm::PackedObject
   CList<Uint>::Buffer       glb_idx;
   CList<Uint>::Buffer       rank;
   CTable<Uint>::Buffer      connected_nodes;
+  /// buffers of the element-based field values stored with the elements (see store_element_field_values)
+  std::vector<CTable<Real>::Buffer::Ptr> fields;
 };
 
 
@@ -99,8 +103,27 @@ struct PackUnpackNodes: Common::Comm::PackedObject
   CList<Uint>::Buffer       rank;
   CTable<Real>::Buffer      coordinates;
   CDynTable<Uint>::Buffer   connected_elements;
+  /// buffers of the other fields stored in the geometry, so that they move along with the nodes
+  std::vector<CTable<Real>::Buffer::Ptr> fields;
+  /// buffers of the single precision fields stored in the geometry
+  std::vector<CTable<float>::Buffer::Ptr> single_precision_fields;
 };
 
+/// Copy the values of an element-based field group into a table per CElements, with one row per element,
+/// so that PackUnpackElements moves them along with the elements
+void store_element_field_values(FieldGroup& field_group);
+
+/// Resize an element-based field group after its elements migrated,
+/// and put back the values copied by store_element_field_values
+void restore_element_field_values(FieldGroup& field_group);
+
+/// Fields of the mesh whose values would be lost if its nodes and elements were migrated between processes.
+/// The fields of the geometry move along with the nodes (see PackUnpackNodes), and the element-based fields
+/// along with the elements. The fields of the other point-based field groups are resized after a migration
+/// but keep no valid values.
+/// @return the paths of these fields
+std::vector<std::string> fields_not_migrated(CMesh& mesh);
+
 ////////////////////////////////////////////////////////////////////////////////
 
 } // Mesh
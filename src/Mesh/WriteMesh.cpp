@@ -149,6 +149,8 @@ void WriteMesh::write_mesh( const CMesh& mesh, const URI& file )
 
   boost_foreach( const Field& field, find_components<Field>(mesh) )
     fields.push_back(field.uri());
+  boost_foreach( const SinglePrecisionField& field, find_components<SinglePrecisionField>(mesh) )
+    fields.push_back(field.uri());
 
   write_mesh(mesh,file,fields);
 }
@@ -48,6 +48,10 @@ CPartitioner::CPartitioner ( const std::string& name ) :
       ->description("Internal Zoltan debug level (0 to 10)")
       ->pretty_name("Debug Level");
 
+  m_options.add_option<OptionT <std::string> >("approach", "PARTITION")
+      ->description("Load balancing approach: PARTITION (from scratch), REPARTITION (keep migration low) or REFINE")
+      ->pretty_name("Approach");
+
   float version;
   int error_code = Zoltan_Initialize(Core::instance().argc(),Core::instance().argv(),&version);
   cf_assert_desc("Could not initialize Zoltan", error_code == ZOLTAN_OK);
@@ -87,7 +91,7 @@ ZoltanHandle& CPartitioner::zoltan_handle()
 
 void CPartitioner::partition_graph()
 {
-  CFdebug.setFilterRankZero(false);
+  CFdebugStream.setFilterRankZero(false);
 
   m_partitioned = true;
   set_partitioning_params();
@@ -114,7 +118,7 @@ void CPartitioner::partition_graph()
   // see line below: zoltan_handle().Set_Param( "RETURN_LISTS", "EXPORT");
   cf_assert((int)numImport<=0);
 
-  CFdebug.setFilterRankZero(true);
+  CFdebugStream.setFilterRankZero(true);
 
 }
 
@@ -155,7 +159,7 @@ void CPartitioner::set_partitioning_params()
   // HIER (for hybrid hierarchical partitioning)
   // NONE (for no load balancing).
 
-  zoltan_handle().Set_Param( "LB_APPROACH", "PARTITION");
+  zoltan_handle().Set_Param( "LB_APPROACH", m_options["approach"].value<std::string>() );
   // The desired load balancing approach. Only LB_METHOD = HYPERGRAPH or GRAPH
   // uses the LB_APPROACH parameter. Valid values are
   //   PARTITION (Partition "from scratch," not taking into account the current data distribution;
@@ -179,6 +183,10 @@ void CPartitioner::set_partitioning_params()
   // "NONE", to return neither import nor export information
 
 
+  zoltan_handle().Set_Param( "OBJ_WEIGHT_DIM", use_weights() ? "1" : "0" );
+  // The number of weights (to be supplied by the user query function) associated with an object.
+  // If this parameter is zero, all objects have equal weight.
+
   zoltan_handle().Set_Param( "NUM_GLOBAL_PARTS", to_str( m_options["nb_parts"].value<Uint>() ));
   // The total number of parts to be generated by a call to Zoltan_LB_Partition.
 
@@ -245,6 +253,9 @@ void CPartitioner::query_list_of_objects(void *data, int sizeGID, int sizeLID,
 
   p.list_of_objects_owned_by_part(Comm::PE::instance().rank(),globalID);
 
+  if (wgt_dim > 0)
+    p.list_of_object_weights(Comm::PE::instance().rank(),obj_wgts);
+
 
   // for debugging
 #if 0
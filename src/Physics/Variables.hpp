@@ -106,6 +106,10 @@ template < typename PHYS >
 class VariablesT : public Variables {
 public:
 
+  /// whether PHYS also works on batches of states, stored in a PHYS::MODEL::BatchProperties.
+  /// Variables that implement this interface hide this value with true
+  enum { has_batch_interface = false };
+
   /// constructor
   VariablesT ( const std::string& name ) : Variables( name )
   {
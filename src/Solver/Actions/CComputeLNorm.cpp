@@ -28,58 +28,62 @@ namespace Actions {
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 
-void compute_L2( CTable<Real>::ArrayT& array, Real& norm )
+void compute_L2( const CTable<Real>::ConstColumn& column, Real& norm )
 {
   const int size = 1; // sum 1 value in each processor
 
   Real loc_norm = 0.; // norm on local processor
   Real glb_norm = 0.; // norm summed over all processors
 
-  boost_foreach(CTable<Real>::ConstRow row, array )
-      loc_norm += row[0]*row[0];
+  const Uint nb_rows = column.size();
+  for(Uint i = 0; i != nb_rows; ++i)
+    loc_norm += column[i]*column[i];
 
   Comm::PE::instance().all_reduce( Comm::plus(), &loc_norm, size, &glb_norm );
 
   norm = std::sqrt(glb_norm);
 }
 
-void compute_L1( CTable<Real>::ArrayT& array, Real& norm )
+void compute_L1( const CTable<Real>::ConstColumn& column, Real& norm )
 {
   const int size = 1; // sum 1 value in each processor
 
   Real loc_norm = 0.; // norm on local processor
   Real glb_norm = 0.; // norm summed over all processors
 
-  boost_foreach(CTable<Real>::ConstRow row, array )
-      loc_norm += std::abs( row[0] );
+  const Uint nb_rows = column.size();
+  for(Uint i = 0; i != nb_rows; ++i)
+    loc_norm += std::abs( column[i] );
 
   Comm::PE::instance().all_reduce( Comm::plus(), &loc_norm, size, &glb_norm );
 }
 
-void compute_Linf( CTable<Real>::ArrayT& array, Real& norm )
+void compute_Linf( const CTable<Real>::ConstColumn& column, Real& norm )
 {
   const int size = 1; // sum 1 value in each processor
 
   Real loc_norm = 0.; // norm on local processor
   Real glb_norm = 0.; // norm summed over all processors
 
-  boost_foreach(CTable<Real>::ConstRow row, array )
-      loc_norm = std::max( std::abs(row[0]), loc_norm );
+  const Uint nb_rows = column.size();
+  for(Uint i = 0; i != nb_rows; ++i)
+    loc_norm = std::max( std::abs(column[i]), loc_norm );
 
   Comm::PE::instance().all_reduce( Comm::max(), &loc_norm, size, &glb_norm );
 
   norm = glb_norm;
 }
 
-void compute_Lp( CTable<Real>::ArrayT& array, Real& norm, Uint order )
+void compute_Lp( const CTable<Real>::ConstColumn& column, Real& norm, Uint order )
 {
   const int size = 1; // sum 1 value in each processor
 
   Real loc_norm = 0.; // norm on local processor
   Real glb_norm = 0.; // norm summed over all processors
 
-  boost_foreach(CTable<Real>::ConstRow row, array )
-    loc_norm += std::pow( std::abs(row[0]), (int)order ) ;
+  const Uint nb_rows = column.size();
+  for(Uint i = 0; i != nb_rows; ++i)
+    loc_norm += std::pow( std::abs(column[i]), (int)order ) ;
 
   Comm::PE::instance().all_reduce( Comm::plus(), &loc_norm, size, &glb_norm );
 
@@ -117,8 +121,10 @@ void CComputeLNorm::execute()
 {
   if ( m_field.expired() ) 	throw SetupError(FromHere(), "Field was not set");
 
-  CTable<Real>& table = *m_field.lock();
-  CTable<Real>::ArrayT& array =  m_field.lock()->array();
+  const CTable<Real>& table = *m_field.lock();
+
+  // contiguous if the field is stored column major
+  const CTable<Real>::ConstColumn column = table.column(0);
 
   const Uint nbrows = table.size();
 
@@ -132,13 +138,13 @@ void CComputeLNorm::execute()
 
   switch(order) {
 
-  case 2:  compute_L2( array, norm );    break;
+  case 2:  compute_L2( column, norm );    break;
 
-  case 1:  compute_L1( array, norm );    break;
+  case 1:  compute_L1( column, norm );    break;
 
-  case 0:  compute_Linf( array, norm );  break; // consider order 0 as Linf
+  case 0:  compute_Linf( column, norm );  break; // consider order 0 as Linf
 
-  default: compute_Lp( array, norm, order );    break;
+  default: compute_Lp( column, norm, order );    break;
 
   }
 
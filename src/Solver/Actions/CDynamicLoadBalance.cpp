@@ -0,0 +1,140 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <boost/algorithm/string/join.hpp>
+
+#include "Common/CBuilder.hpp"
+#include "Common/OptionT.hpp"
+#include "Common/OptionURI.hpp"
+#include "Common/OptionComponent.hpp"
+#include "Common/Foreach.hpp"
+#include "Common/FindComponents.hpp"
+#include "Common/EventHandler.hpp"
+#include "Common/Log.hpp"
+
+#include "Common/MPI/PE.hpp"
+
+#include "Common/XML/SignalOptions.hpp"
+
+#include "Mesh/CMesh.hpp"
+#include "Mesh/CRegion.hpp"
+#include "Mesh/CEntities.hpp"
+#include "Mesh/CMeshTransformer.hpp"
+#include "Mesh/Manipulations.hpp"
+
+#include "CDynamicLoadBalance.hpp"
+
+
+using namespace CF::Common;
+using namespace CF::Common::XML;
+using namespace CF::Mesh;
+
+namespace CF {
+namespace Solver {
+namespace Actions {
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+Common::ComponentBuilder < CDynamicLoadBalance, CAction, LibActions > CDynamicLoadBalance_Builder;
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+CDynamicLoadBalance::CDynamicLoadBalance ( const std::string& name ) : Solver::Action(name),
+  m_load_balancer( *build_component_abstract_type<CMeshTransformer>("CF.Mesh.Actions.LoadBalance","LoadBalancer") )
+{
+  mark_basic();
+
+  add_static_component(m_load_balancer);
+  m_load_balancer.configure_option("use_weights", true);
+  m_load_balancer.configure_option("approach", std::string("REPARTITION"));
+
+  options().add_option( OptionComponent<Component>::create( "iterator", &m_iterator) )
+      ->pretty_name("Iterator Component")
+      ->description("The component that stores the \'iteration\'");
+
+  options().add_option< OptionT<Uint> >( "check_rate", 10u )
+      ->pretty_name("Check Rate")
+      ->description("Interval of iterations between checks of the load imbalance");
+
+  options().add_option< OptionT<Real> >( "imbalance_threshold", 1.1 )
+      ->pretty_name("Imbalance Threshold")
+      ->description("Maximum over mean cost per processor above which the mesh is rebalanced");
+
+  properties()["imbalance"] = Real(1.);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+Real CDynamicLoadBalance::compute_imbalance()
+{
+  Real loc_cost(0.);
+  boost_foreach(const CEntities& entities, find_components_recursively<CEntities>(mesh().topology()))
+    loc_cost += entities.cost();
+
+  Real max_cost(loc_cost);
+  Real sum_cost(loc_cost);
+  Uint nb_procs(1);
+  if ( Comm::PE::instance().is_active() )
+  {
+    Comm::PE::instance().all_reduce( Comm::max(), &loc_cost, 1, &max_cost );
+    Comm::PE::instance().all_reduce( Comm::plus(), &loc_cost, 1, &sum_cost );
+    nb_procs = Comm::PE::instance().size();
+  }
+
+  const Real mean_cost = sum_cost / static_cast<Real>(nb_procs);
+  return mean_cost > 0. ? max_cost / mean_cost : 1.;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void CDynamicLoadBalance::execute()
+{
+  if( m_iterator.expired() )
+    throw SetupError( FromHere(), "The option 'iterator' was not set in the component " + uri().string() );
+
+  const Uint iteration = boost::any_cast<Uint> ( m_iterator.lock()->property("iteration") );
+
+  const Uint check_rate = option("check_rate").value<Uint>();
+
+  if (check_rate == 0) return;
+
+  if ( iteration % check_rate != 0 ) return;
+
+  // the fields of the geometry migrate with the nodes and the element-based fields with the elements,
+  // the values of other fields would be lost
+  const std::vector<std::string> lost_fields = fields_not_migrated( mesh() );
+  if ( !lost_fields.empty() )
+    throw SetupError( FromHere(), "Mesh " + mesh().uri().string() + " can not be rebalanced, because the values of the fields "
+                                  + boost::algorithm::join(lost_fields, ", ") + " do not migrate with the nodes and elements" );
+
+  const Real imbalance = compute_imbalance();
+  property("imbalance") = imbalance;
+
+  if ( imbalance > option("imbalance_threshold").value<Real>() )
+  {
+    CFinfo << "load imbalance " << imbalance << " at iteration " << iteration << ", rebalancing mesh " << mesh().uri().string() << CFendl;
+
+    m_load_balancer.transform( mesh() );
+
+    // raise an event to indicate that the mesh was rebalanced,
+    // so the fields can follow the new distribution
+    SignalOptions options;
+    options.add_option< OptionURI >("mesh_uri", mesh().uri());
+    options.add_option< OptionT<bool> >("mesh_rebalanced", true);
+    SignalArgs args = options.create_frame();
+    Core::instance().event_handler().raise_event( "mesh_changed", args);
+  }
+
+  // start measuring the cost of the next interval
+  boost_foreach(CEntities& entities, find_components_recursively<CEntities>(mesh().topology()))
+    entities.reset_cost();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // Actions
+} // Solver
+} // CF
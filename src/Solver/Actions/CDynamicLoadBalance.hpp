@@ -0,0 +1,66 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef CF_Solver_Actions_CDynamicLoadBalance_hpp
+#define CF_Solver_Actions_CDynamicLoadBalance_hpp
+
+#include "Solver/Actions/LibActions.hpp"
+#include "Solver/Action.hpp"
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+namespace CF {
+namespace Mesh   { class CMeshTransformer; }
+namespace Solver {
+namespace Actions {
+
+/// Periodically checks the load imbalance between the processors, using the
+/// cost measured by the element loops, and repartitions the mesh with
+/// cost-based weights when the imbalance exceeds a threshold.
+/// The imbalance (maximum over mean of the cost per processor) of the last check
+/// is stored in the property "imbalance".
+/// Only the fields of the geometry migrate with the nodes, so the check throws a SetupError
+/// if the mesh has fields in other field groups, or single precision fields.
+class Solver_Actions_API CDynamicLoadBalance : public Solver::Action {
+
+public: // typedefs
+
+  /// pointers
+  typedef boost::shared_ptr<CDynamicLoadBalance> Ptr;
+  typedef boost::shared_ptr<CDynamicLoadBalance const> ConstPtr;
+
+public: // functions
+  /// Contructor
+  /// @param name of the component
+  CDynamicLoadBalance ( const std::string& name );
+
+  /// Virtual destructor
+  virtual ~CDynamicLoadBalance() {}
+
+  /// Get the class name
+  static std::string type_name () { return "CDynamicLoadBalance"; }
+
+  /// execute the action
+  virtual void execute ();
+
+  /// Compute the current imbalance, maximum over mean of the cost per processor
+  Real compute_imbalance ();
+
+private: // data
+
+  boost::weak_ptr<Component> m_iterator;  ///< component that holds the iteration
+
+  Mesh::CMeshTransformer& m_load_balancer; ///< repartitions and migrates the mesh
+
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // Actions
+} // Solver
+} // CF
+
+#endif // CF_Solver_Actions_CDynamicLoadBalance_hpp
@@ -7,6 +7,7 @@
 #include "Common/Log.hpp"
 #include "Common/CBuilder.hpp"
 #include "Common/Foreach.hpp"
+#include "Common/CTimings.hpp"
 
 #include "Mesh/CRegion.hpp"
 #include "Mesh/CElements.hpp"
@@ -34,9 +35,14 @@ CForAllElements::CForAllElements ( const std::string& name ) :
 
 void CForAllElements::execute()
 {
+  ScopedTimer timer(*this);
+
   boost_foreach(CRegion::Ptr& region, m_loop_regions)
     boost_foreach(CElements& elements, find_components_recursively<CElements>(*region))
   {
+    // measure the cost of the elements, for load balancing
+    ScopedCostTimer cost_timer(elements);
+
     // Setup all child operations
     boost_foreach(CLoopOperation& op, find_components<CLoopOperation>(*this))
     {
@@ -67,6 +67,8 @@ class Solver_Actions_API CForAllElementsT : public CLoop
           op.set_elements(elements);
           if (op.can_start_loop())
           {
+            // measure the cost of the elements, for load balancing
+            Mesh::ScopedCostTimer cost_timer(elements);
             const Uint nb_elem = elements.size();
             for ( Uint elem = 0; elem != nb_elem; ++elem )
             {
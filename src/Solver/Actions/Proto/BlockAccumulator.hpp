@@ -92,6 +92,37 @@ struct BlockAssignmentOp<SystemMatrixTag, OpTagT>
     static const Uint mat_size = DataT::EMatrixSizeT::value;
     static const Uint nb_dofs = mat_size / DataT::SupportT::SF::nb_nodes;
     const Mesh::CTable<Uint>::ConstRow connectivity = data.support().element_connectivity();
+    if(lss.is_matrix_free())
+    {
+      Uint gids[mat_size];
+      for(Uint i = 0; i != mat_size; ++i)
+        gids[i] = connectivity[i % DataT::SupportT::SF::nb_nodes]*nb_dofs + i / DataT::SupportT::SF::nb_nodes;
+
+      if(lss.is_applying_operator())
+      {
+        // Gather the input vector, apply the element matrix and scatter the result
+        const RealVector& x = lss.operator_input();
+        RealVector& y = lss.operator_output();
+        Real x_elem[mat_size];
+        for(Uint i = 0; i != mat_size; ++i)
+          x_elem[i] = x[gids[i]];
+        for(Uint row = 0; row != mat_size; ++row)
+        {
+          Real y_row = 0.;
+          for(Uint col = 0; col != mat_size; ++col)
+            y_row += rhs(row, col) * x_elem[col];
+          do_assign_op(OpTagT(), y[gids[row]], y_row);
+        }
+      }
+      else
+      {
+        // Only the diagonal is stored, for use as preconditioner
+        RealVector& diagonal = lss.diagonal();
+        for(Uint i = 0; i != mat_size; ++i)
+          do_assign_op(OpTagT(), diagonal[gids[i]], rhs(i, i));
+      }
+      return;
+    }
     for(Uint row = 0; row != mat_size; ++row)
     {
       const Uint i_gid = connectivity[row % DataT::SupportT::SF::nb_nodes]*nb_dofs + row / DataT::SupportT::SF::nb_nodes;
@@ -109,6 +140,10 @@ struct BlockAssignmentOp<SystemRHSTag, OpTagT>
   template<typename RhsT, typename DataT>
   void operator()(Solver::CEigenLSS& lss, const RhsT& rhs, const DataT& data) const
   {
+    // The RHS is already assembled when the matrix-free operator is applied
+    if(lss.is_applying_operator())
+      return;
+
     // TODO: We take some shortcuts here that assume the same shape function for every variable. Storage order for the system is i.e. uvp, uvp, ...
     static const Uint mat_size = DataT::EMatrixSizeT::value;
     static const Uint nb_dofs = mat_size / DataT::SupportT::SF::nb_nodes;
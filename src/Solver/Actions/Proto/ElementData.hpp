@@ -14,7 +14,11 @@
 #include <boost/fusion/container/vector.hpp>
 
 #include <boost/mpl/assert.hpp>
+#include <boost/mpl/end.hpp>
+#include <boost/mpl/find_if.hpp>
 #include <boost/mpl/for_each.hpp>
+#include <boost/mpl/not.hpp>
+#include <boost/mpl/or.hpp>
 #include <boost/mpl/range_c.hpp>
 #include <boost/mpl/transform.hpp>
 #include <boost/mpl/vector_c.hpp>
@@ -503,6 +507,18 @@ struct MakeVarData<VariablesT, SF, SF, EquationVariablesT, MatrixSizesT, EMatrix
   };
 };
 
+/// True for linear simplices, where the mapping from the reference element is affine. The jacobian and the
+/// shape function gradients are then constant over each element.
+template<typename SF>
+struct IsAffineSimplex :
+  boost::mpl::bool_
+  <
+    SF::order == 1 && SF::dimension == SF::dimensionality &&
+    (SF::shape == Mesh::GeoShape::LINE || SF::shape == Mesh::GeoShape::TRIAG || SF::shape == Mesh::GeoShape::TETRA)
+  >
+{
+};
+
 /// Stores data that is used when looping over elements to execute Proto expressions. "Data" is meant here in the boost::proto sense,
 /// i.e. it is intended for use as 3rd argument for proto transforms.
 /// VariablesT is a fusion sequence containing each unique variable in the expression
@@ -531,6 +547,21 @@ public:
   /// Type for the element vector (combined for all equations)
   typedef Eigen::Matrix<Real, EMatrixSizeT::value, 1> ElementVectorT;
 
+  /// True if the support is an affine simplex and all variables use the shape function of the support
+  typedef boost::mpl::bool_
+  <
+    IsAffineSimplex<SupportSF>::value &&
+    boost::is_same
+    <
+      typename boost::mpl::find_if
+      <
+        VariablesSFT,
+        boost::mpl::not_< boost::mpl::or_< boost::mpl::is_void_<boost::mpl::_1>, boost::is_same<boost::mpl::_1, SupportSF> > >
+      >::type,
+      typename boost::mpl::end<VariablesSFT>::type
+    >::value
+  > IsAffineT;
+
   typedef typename boost::fusion::result_of::as_vector
   <
     typename boost::mpl::transform
@@ -639,6 +670,18 @@ public:
     return m_support;
   }
 
+  /// Index of the current element
+  Uint element_idx() const
+  {
+    return m_element_idx;
+  }
+
+  /// The elements that are looped over
+  const Mesh::CElements& elements() const
+  {
+    return m_elements;
+  }
+
   /// Retrieve the element matrix at index i
   ElementMatrixT& element_matrix(const int i)
   {
@@ -12,6 +12,7 @@
 #include "BlockAccumulator.hpp"
 #include "ElementIntegration.hpp"
 #include "ElementMatrix.hpp"
+#include "ElementMatrixCache.hpp"
 #include "ElementTransforms.hpp"
 #include "ExpressionGroup.hpp"
 #include "IndexLooping.hpp"
@@ -72,6 +73,8 @@ struct StreamOutputIndexed : StreamOutput< ElementMathIndexed<I, J> >
 struct SingleExprElementGrammar :
   boost::proto::or_
   <
+    // Element matrix contributions that are only computed once
+    CachedElementMatricesGrammar<SingleExprElementGrammar>,
     // Assignment to system matrix
     BlockAccumulation<ElementMath>,
     boost::proto::when
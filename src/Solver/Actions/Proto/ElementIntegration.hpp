@@ -122,6 +122,71 @@ public:
   };  
 };
 
+/// Matches expressions that are constant over an element with an affine mapping, i.e. built from gradients, the jacobian
+/// and constants. Shape function values, coordinates and interpolated fields vary over the element.
+struct AffineConstant :
+  boost::proto::or_
+  <
+    boost::proto::function< boost::proto::terminal< SFOp<NablaOp> >, FieldTypes >,
+    boost::proto::terminal< SFOp<JacobianOp> >,
+    boost::proto::terminal< SFOp<JacobianDeterminantOp> >,
+    boost::proto::terminal< SFOp<VolumeOp> >,
+    boost::proto::terminal< SFOp<NodesOp> >,
+    boost::proto::and_
+    <
+      boost::proto::terminal<boost::proto::_>,
+      boost::proto::not_<FieldTypes>,
+      boost::proto::not_< boost::proto::terminal< SFOp<boost::proto::_> > >
+    >,
+    boost::proto::and_
+    <
+      boost::proto::not_< boost::proto::terminal<boost::proto::_> >,
+      boost::proto::nary_expr< boost::proto::_, boost::proto::vararg<AffineConstant> >
+    >
+  >
+{
+};
+
+/// Matches transpose(N(u)) * N(v), the integrand of a mass matrix
+struct MassMatrixIntegrand :
+  boost::proto::multiplies
+  <
+    boost::proto::function
+    <
+      boost::proto::terminal<TransposeFunction>,
+      boost::proto::function< boost::proto::terminal< SFOp<ShapeFunctionOp> >, FieldTypes >
+    >,
+    boost::proto::function< boost::proto::terminal< SFOp<ShapeFunctionOp> >, FieldTypes >
+  >
+{
+};
+
+/// Closed form of the integral of transpose(N)*N over the reference element of an affine simplex of dimension d:
+/// M_ij = V_ref * (1 + delta_ij) / ((d+1)*(d+2))
+template<typename ShapeFunctionT>
+struct ReferenceMassMatrix
+{
+  typedef Eigen::Matrix<Real, ShapeFunctionT::nb_nodes, ShapeFunctionT::nb_nodes> MatrixT;
+
+  static const MatrixT& value()
+  {
+    static const MatrixT result = compute();
+    return result;
+  }
+
+private:
+  static MatrixT compute()
+  {
+    typedef Mesh::Integrators::GaussMappedCoords<2, ShapeFunctionT::shape> GaussT;
+    static const Real d = static_cast<Real>(ShapeFunctionT::dimensionality);
+    const Real reference_volume = GaussT::instance().weights.sum();
+    MatrixT result;
+    result.setConstant(reference_volume / ((d+1.)*(d+2.)));
+    result.diagonal() *= 2.;
+    return result;
+  }
+};
+
 template<typename GrammarT>
 struct ElementQuadrature :
   boost::proto::transform< ElementQuadrature<GrammarT> >
@@ -132,13 +197,42 @@ struct ElementQuadrature :
     
     typedef void result_type;
   
+    typedef typename boost::remove_reference<DataT>::type::SupportT::SF ShapeFunctionT;
+    typedef Mesh::Integrators::GaussMappedCoords<2, ShapeFunctionT::shape> GaussT;
+
+    /// Kinds of integrand, on affine simplices
+    struct GeneralTerm {};
+    struct ConstantTerm {};
+    struct MassTerm {};
+
+    /// Determine how to integrate the given right hand side of a += expression
+    template<typename RhsT>
+    struct TermKind
+    {
+      typedef typename boost::remove_const<typename boost::remove_reference<RhsT>::type>::type RhsExprT;
+      typedef typename boost::mpl::if_
+      <
+        typename boost::remove_reference<DataT>::type::IsAffineT,
+        typename boost::mpl::if_
+        <
+          boost::proto::matches<RhsExprT, MassMatrixIntegrand>,
+          MassTerm,
+          typename boost::mpl::if_< boost::proto::matches<RhsExprT, AffineConstant>, ConstantTerm, GeneralTerm >::type
+        >::type,
+        GeneralTerm
+      >::type type;
+    };
+
     /// Fusion functor to evaluate each child expression using the GrammarT supplied in the template argument
     struct evaluate_expr
     {
-      evaluate_expr(typename impl::state_param state, typename impl::data_param data, const Real weight) :
+      evaluate_expr(typename impl::state_param state, typename impl::data_param data, const Uint point_idx, bool& needs_all_points) :
         m_state(state),
         m_data(data),
-        m_weight(weight * data.support().jacobian_determinant())
+        m_point_idx(point_idx),
+        m_jacobian_determinant(data.support().jacobian_determinant()),
+        m_weight(GaussT::instance().weights[point_idx] * m_jacobian_determinant),
+        m_needs_all_points(needs_all_points)
       {
       }
       
@@ -151,7 +245,7 @@ struct ElementQuadrature :
       template<typename ChildExprT>
       void tag_dispatch(const boost::proto::tag::plus_assign, ChildExprT& expr) const
       {
-        GrammarT()(boost::proto::left(expr) += m_weight * boost::proto::right(expr), m_state, m_data);
+        term_dispatch(typename TermKind<typename boost::proto::result_of::right<ChildExprT&>::type>::type(), expr);
       }
       
       // Issue an error message if a tag was not supported
@@ -161,10 +255,40 @@ struct ElementQuadrature :
         BOOST_MPL_ASSERT(( boost::is_same<TagT, boost::proto::tag::plus_assign> ));
       }
 
+      /// Integrand that varies over the element, evaluated at each Gauss point
+      template<typename ChildExprT>
+      void term_dispatch(const GeneralTerm, ChildExprT& expr) const
+      {
+        m_needs_all_points = true;
+        GrammarT()(boost::proto::left(expr) += m_weight * boost::proto::right(expr), m_state, m_data);
+      }
+
+      /// Constant integrand, evaluated once and multiplied with the element volume
+      template<typename ChildExprT>
+      void term_dispatch(const ConstantTerm, ChildExprT& expr) const
+      {
+        if(m_point_idx != 0)
+          return;
+        const Real volume_weight = GaussT::instance().weights.sum() * m_jacobian_determinant;
+        GrammarT()(boost::proto::left(expr) += volume_weight * boost::proto::right(expr), m_state, m_data);
+      }
+
+      /// Mass matrix, using the closed form for the reference element
+      template<typename ChildExprT>
+      void term_dispatch(const MassTerm, ChildExprT& expr) const
+      {
+        if(m_point_idx != 0)
+          return;
+        GrammarT()(boost::proto::left(expr) += m_jacobian_determinant * boost::proto::lit(ReferenceMassMatrix<ShapeFunctionT>::value()), m_state, m_data);
+      }
+
     private:
       typename impl::state_param  m_state;
       typename impl::data_param m_data;
+      const Uint m_point_idx;
+      const Real m_jacobian_determinant;
       const Real m_weight; // The integration weight (gauss point weight * jacobian determinant)
+      bool& m_needs_all_points; // Set to true if a term needs evaluation at each Gauss point
     };
     
     void operator ()(
@@ -173,15 +297,16 @@ struct ElementQuadrature :
               , typename impl::data_param data
     ) const
     {
-      typedef typename boost::remove_reference<DataT>::type::SupportT::SF ShapeFunctionT;
-      typedef typename ShapeFunctionT::MappedCoordsT MappedCoordsT;
-      typedef Mesh::Integrators::GaussMappedCoords<2, ShapeFunctionT::shape> GaussT;
-      
+      bool needs_all_points = false;
       for(Uint i = 0; i != GaussT::nb_points; ++i)
       {
         // Precompute the primitive element matrices (shape function values, gradients, ...) for the current Gauss point
         data.precompute_element_matrices(GaussT::instance().coords.col(i), expr);
-        tag_dispatch(typename boost::proto::tag_of<ExprT>::type(), expr, state, data, GaussT::instance().weights[i]);
+        tag_dispatch(typename boost::proto::tag_of<ExprT>::type(), expr, state, data, i, needs_all_points);
+
+        // On affine simplices, constant integrands and mass matrices are complete after the first point
+        if(!needs_all_points)
+          break;
       }
     }
     
@@ -190,9 +315,10 @@ struct ElementQuadrature :
                       typename impl::expr_param expr,
                       typename impl::state_param state,
                       typename impl::data_param data,
-                      const Real weight) const
+                      const Uint point_idx,
+                      bool& needs_all_points) const
     {
-      boost::fusion::for_each(boost::proto::flatten(boost::proto::right(expr)), evaluate_expr(state, data, weight) );
+      boost::fusion::for_each(boost::proto::flatten(boost::proto::right(expr)), evaluate_expr(state, data, point_idx, needs_all_points) );
     }
     
     /// Choose based on tag, element_quadrature(expr) syntax
@@ -200,9 +326,10 @@ struct ElementQuadrature :
                       typename impl::expr_param expr,
                       typename impl::state_param state,
                       typename impl::data_param data,
-                      const Real weight) const
+                      const Uint point_idx,
+                      bool& needs_all_points) const
     {
-      evaluate_expr(state, data, weight)(boost::proto::child_c<1>(expr));
+      evaluate_expr(state, data, point_idx, needs_all_points)(boost::proto::child_c<1>(expr));
     }
   };
 };
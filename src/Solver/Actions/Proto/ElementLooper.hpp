@@ -234,6 +234,8 @@ void for_each_element(Mesh::CRegion& root_region, const ExprT& expr)
   // Traverse all CElements under the root and evaluate the expression
   BOOST_FOREACH(Mesh::CElements& elements, Common::find_components_recursively<Mesh::CElements>(root_region))
   {
+    // measure the cost of the elements, for load balancing
+    Mesh::ScopedCostTimer cost_timer(elements);
     boost::mpl::for_each<ShapeFunctionsT>( ElementLooper<ShapeFunctionsT, ExprT>(elements, expr, vars) );
   }
 };
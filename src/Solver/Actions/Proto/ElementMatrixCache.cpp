@@ -0,0 +1,82 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <algorithm>
+
+#include "Mesh/CElements.hpp"
+
+#include "ElementMatrixCache.hpp"
+
+/// @file
+/// Caching of element matrix contributions that don't change between iterations
+
+namespace CF {
+namespace Solver {
+namespace Actions {
+namespace Proto {
+
+ElementMatrixCache::ElementMatrixCache() :
+  m_last_elements(0),
+  m_last_entry(0)
+{
+}
+
+const Real* ElementMatrixCache::values(const Mesh::CElements& elements, const Uint element_idx)
+{
+  const Entry& e = entry(elements);
+
+  // Nothing stored yet, or the elements were resized since
+  if(e.is_stored.size() != elements.size() || !e.is_stored[element_idx])
+    return 0;
+
+  return &e.values[element_idx * e.nb_values];
+}
+
+Real* ElementMatrixCache::store(const Mesh::CElements& elements, const Uint element_idx, const Uint nb_values)
+{
+  Entry& e = entry(elements);
+
+  if(e.is_stored.size() != elements.size() || e.nb_values != nb_values)
+  {
+    e.nb_values = nb_values;
+    e.values.assign(elements.size() * nb_values, 0.);
+    e.is_stored.assign(elements.size(), false);
+  }
+
+  e.is_stored[element_idx] = true;
+  return &e.values[element_idx * nb_values];
+}
+
+void ElementMatrixCache::reset()
+{
+  m_entries.clear();
+  m_last_elements = 0;
+  m_last_entry = 0;
+}
+
+Uint ElementMatrixCache::nb_stored() const
+{
+  Uint result = 0;
+  for(EntriesT::const_iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+    result += std::count(it->second.is_stored.begin(), it->second.is_stored.end(), true);
+  return result;
+}
+
+ElementMatrixCache::Entry& ElementMatrixCache::entry(const Mesh::CElements& elements)
+{
+  if(&elements != m_last_elements)
+  {
+    m_last_elements = &elements;
+    m_last_entry = &m_entries[&elements];
+  }
+
+  return *m_last_entry;
+}
+
+} // namespace Proto
+} // namespace Actions
+} // namespace Solver
+} // namespace CF
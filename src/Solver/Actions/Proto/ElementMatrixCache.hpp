@@ -0,0 +1,264 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+
+#ifndef CF_Solver_Actions_Proto_ElementMatrixCache_hpp
+#define CF_Solver_Actions_Proto_ElementMatrixCache_hpp
+
+#include <map>
+#include <vector>
+
+#include <boost/fusion/algorithm/iteration/for_each.hpp>
+#include <boost/fusion/include/for_each.hpp>
+
+#include <boost/mpl/for_each.hpp>
+#include <boost/mpl/range_c.hpp>
+
+#include <boost/proto/core.hpp>
+
+#include "Solver/Actions/LibActions.hpp"
+
+#include "ElementMatrix.hpp"
+
+/// @file
+/// Caching of element matrix contributions that don't change between iterations
+
+namespace CF {
+namespace Mesh { class CElements; }
+namespace Solver {
+namespace Actions {
+namespace Proto {
+
+/// Stores element matrix contributions for each element, so terms that only depend on the geometry
+/// (mass matrix, diffusion with constant coefficients, ...) are only integrated the first time an element is visited.
+/// The cache must be reset when the mesh changes, or when a coefficient used in the cached terms is changed.
+/// Each cache should be used by one expression only.
+class Solver_Actions_API ElementMatrixCache
+{
+public:
+  ElementMatrixCache();
+
+  /// Stored values for the element at index element_idx in elements, or a null pointer if nothing was stored yet
+  const Real* values(const Mesh::CElements& elements, const Uint element_idx);
+
+  /// Storage for nb_values values for the element at index element_idx in elements. The element is marked as stored,
+  /// so the caller must fill in all values. All elements of a CElements must store the same number of values.
+  Real* store(const Mesh::CElements& elements, const Uint element_idx, const Uint nb_values);
+
+  /// Forget all stored values
+  void reset();
+
+  /// Total number of elements for which values are stored
+  Uint nb_stored() const;
+
+private:
+  /// Stored values for all elements of a CElements
+  struct Entry
+  {
+    Entry() : nb_values(0) {}
+
+    Uint nb_values;
+    std::vector<Real> values;
+    std::vector<bool> is_stored;
+  };
+
+  /// Look up the entry for the given elements
+  Entry& entry(const Mesh::CElements& elements);
+
+  typedef std::map<const Mesh::CElements*, Entry> EntriesT;
+  EntriesT m_entries;
+
+  /// Last accessed entry, to avoid a map lookup for each element
+  const Mesh::CElements* m_last_elements;
+  Entry* m_last_entry;
+};
+
+/// Primitive transform that evaluates cached(cache, matrices...) << (expr1, expr2, ..., exprN).
+/// The first time an element is visited, the expressions are evaluated and their contribution to the given
+/// element matrices is stored. After that, the stored contribution is added to the element matrices instead.
+template<typename GrammarT>
+struct CachedElementMatrices :
+  boost::proto::transform< CachedElementMatrices<GrammarT> >
+{
+  template<typename ExprT, typename StateT, typename DataT>
+  struct impl : boost::proto::transform_impl<ExprT, StateT, DataT>
+  {
+    typedef void result_type;
+
+    typedef typename boost::remove_reference<DataT>::type::ElementMatrixT ElementMatrixT;
+
+    /// The function expression holding the cache and the matrices
+    typedef typename boost::remove_const
+    <
+      typename boost::remove_reference
+      <
+        typename boost::proto::result_of::left<ExprT>::type
+      >::type
+    >::type CacheExprT;
+
+    /// Child indices of the matrices in the function expression
+    typedef boost::mpl::range_c<int, 2, boost::proto::arity_of<CacheExprT>::value> MatrixRangeT;
+
+    /// Number of values stored per element matrix
+    static const int matrix_size = ElementMatrixT::RowsAtCompileTime * ElementMatrixT::ColsAtCompileTime;
+
+    /// Add the stored contribution to each matrix
+    struct AddStored
+    {
+      AddStored(typename impl::expr_param expr, typename impl::data_param data, const Real* stored) :
+        m_expr(expr),
+        m_data(data),
+        m_stored(stored)
+      {
+      }
+
+      template<typename I>
+      void operator()(const I&) const
+      {
+        Real* matrix = m_data.element_matrix(boost::proto::value(boost::proto::child_c<I::value>(boost::proto::left(m_expr)))).data();
+        const Real* stored = m_stored + (I::value - 2) * matrix_size;
+        for(int i = 0; i != matrix_size; ++i)
+          matrix[i] += stored[i];
+      }
+
+    private:
+      typename impl::expr_param m_expr;
+      typename impl::data_param m_data;
+      const Real* m_stored;
+    };
+
+    /// Keep a copy of each matrix, or store the difference with the copy
+    struct SaveMatrices
+    {
+      SaveMatrices(typename impl::expr_param expr, typename impl::data_param data, ElementMatrixT* saved, Real* storage = 0) :
+        m_expr(expr),
+        m_data(data),
+        m_saved(saved),
+        m_storage(storage)
+      {
+      }
+
+      template<typename I>
+      void operator()(const I&) const
+      {
+        const ElementMatrixT& matrix = m_data.element_matrix(boost::proto::value(boost::proto::child_c<I::value>(boost::proto::left(m_expr))));
+        ElementMatrixT& saved = m_saved[I::value - 2];
+        if(m_storage)
+        {
+          Real* storage = m_storage + (I::value - 2) * matrix_size;
+          for(int i = 0; i != matrix_size; ++i)
+            storage[i] = matrix.data()[i] - saved.data()[i];
+        }
+        else
+        {
+          saved = matrix;
+        }
+      }
+
+    private:
+      typename impl::expr_param m_expr;
+      typename impl::data_param m_data;
+      ElementMatrixT* m_saved;
+      Real* m_storage;
+    };
+
+    /// Fusion functor to evaluate each child expression using the GrammarT supplied in the template argument
+    struct evaluate_expr
+    {
+      evaluate_expr(typename impl::state_param state, typename impl::data_param data) :
+        m_state(state),
+        m_data(data)
+      {
+      }
+
+      template<typename ChildExprT>
+      void operator()(ChildExprT& expr) const
+      {
+        GrammarT()(expr, m_state, m_data);
+      }
+
+    private:
+      typename impl::state_param  m_state;
+      typename impl::data_param m_data;
+    };
+
+    void operator ()(
+                typename impl::expr_param expr
+              , typename impl::state_param state
+              , typename impl::data_param data
+    ) const
+    {
+      ElementMatrixCache& cache = const_cast<ElementMatrixCache&>(boost::proto::value(boost::proto::child_c<1>(boost::proto::left(expr))));
+
+      const Real* stored = cache.values(data.elements(), data.element_idx());
+      if(stored)
+      {
+        boost::mpl::for_each<MatrixRangeT>(AddStored(expr, data, stored));
+        return;
+      }
+
+      ElementMatrixT saved[boost::proto::arity_of<CacheExprT>::value - 2];
+      boost::mpl::for_each<MatrixRangeT>(SaveMatrices(expr, data, saved));
+      evaluate(boost::proto::right(expr), state, data);
+      Real* storage = cache.store(data.elements(), data.element_idx(), (boost::proto::arity_of<CacheExprT>::value - 2) * matrix_size);
+      boost::mpl::for_each<MatrixRangeT>(SaveMatrices(expr, data, saved, storage));
+    }
+
+    /// Evaluate the cached expressions, choosing between a single expression or a comma-separated list
+    template<typename CachedExprT>
+    void evaluate(const CachedExprT& cached_expr, typename impl::state_param state, typename impl::data_param data) const
+    {
+      tag_dispatch(typename boost::proto::tag_of<CachedExprT>::type(), cached_expr, state, data);
+    }
+
+    template<typename CachedExprT>
+    void tag_dispatch(const boost::proto::tag::comma, const CachedExprT& cached_expr, typename impl::state_param state, typename impl::data_param data) const
+    {
+      boost::fusion::for_each(boost::proto::flatten(cached_expr), evaluate_expr(state, data) );
+    }
+
+    template<typename TagT, typename CachedExprT>
+    void tag_dispatch(const TagT, const CachedExprT& cached_expr, typename impl::state_param state, typename impl::data_param data) const
+    {
+      GrammarT()(cached_expr, state, data);
+    }
+  };
+};
+
+/// Tags a terminal that triggers caching of element matrices
+struct CachedElementMatricesTag {};
+
+/// Use cached(cache, _A, _T) << (expr1, expr2, ..., exprN) to store the contributions of the expressions to _A and _T in cache
+/// the first time an element is visited, and reuse them afterwards. The expressions must only depend on the geometry.
+static boost::proto::terminal< CachedElementMatricesTag >::type cached = {};
+
+/// Matches and evaluates cached element matrices, with the cached expressions matching GrammarT
+template<typename GrammarT>
+struct CachedElementMatricesGrammar :
+  boost::proto::when
+  <
+    boost::proto::shift_left
+    <
+      boost::proto::function
+      <
+        boost::proto::terminal<CachedElementMatricesTag>,
+        boost::proto::terminal<ElementMatrixCache>,
+        ElementMatrixTerm,
+        boost::proto::vararg<ElementMatrixTerm>
+      >,
+      boost::proto::_
+    >,
+    CachedElementMatrices<GrammarT>
+  >
+{
+};
+
+} // namespace Proto
+} // namespace Actions
+} // namespace Solver
+} // namespace CF
+
+#endif // CF_Solver_Actions_Proto_ElementMatrixCache_hpp
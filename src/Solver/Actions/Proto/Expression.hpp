@@ -185,10 +185,20 @@ class NodesExpression : public ExpressionBase<ExprT>
   typedef ExpressionBase<ExprT> BaseT;
 public:
 
-  NodesExpression(const ExprT& expr) : BaseT(expr)
+  NodesExpression(const ExprT& expr) : BaseT(expr), m_nb_threads(1)
   {
   }
 
+  void add_options(Common::OptionList& options)
+  {
+    BaseT::add_options(options);
+
+    Common::Option& option = options.check("nb_threads") ? options.option("nb_threads") : *options.add_option< Common::OptionT<Uint> >("nb_threads", m_nb_threads);
+    option.description("Number of threads to use for the loop over the nodes. Only safe for expressions that modify nothing but the current node.");
+    option.pretty_name("Number of Threads");
+    option.link_to(&m_nb_threads);
+  }
+
   void loop(Mesh::CRegion& region)
   {
     // IF COMPILATION FAILS HERE: the espression passed is invalid
@@ -197,8 +207,12 @@ public:
       INVALID_NODE_EXPRESSION,
       (NodeGrammar));
 
-    boost::mpl::for_each< boost::mpl::range_c<Uint, 1, 4> >( NodeLooper<typename BaseT::CopiedExprT>(BaseT::m_expr, region, BaseT::m_variables) );
+    boost::mpl::for_each< boost::mpl::range_c<Uint, 1, 4> >( NodeLooper<typename BaseT::CopiedExprT>(BaseT::m_expr, region, BaseT::m_variables, m_nb_threads) );
   }
+
+private:
+  /// Number of threads used in the loop
+  Uint m_nb_threads;
 };
 
 /// Default element types supported by elements expressions
@@ -7,9 +7,16 @@
 #ifndef CF_Solver_Actions_Proto_NodeLooper_hpp
 #define CF_Solver_Actions_Proto_NodeLooper_hpp
 
+#include <boost/bind.hpp>
 #include <boost/mpl/for_each.hpp>
 #include <boost/mpl/range_c.hpp>
 
+#include "Common/ThreadPool.hpp"
+#include "Common/MPI/PE.hpp"
+
+#include "Mesh/CEntities.hpp"
+#include "Mesh/CList.hpp"
+
 #include "NodeData.hpp"
 #include "NodeGrammar.hpp"
 
@@ -28,6 +35,10 @@ struct WrappableNodeExpressions :
 };
 
 /// Loop over nodes, when the dimension is known
+/// The nodes are taken from the list of used nodes that is cached in the region (see Mesh::CEntities::used_nodes)
+/// If more than one thread is requested, the node list is split in equal parts that are executed concurrently
+/// by the thread pool of the process (see Common::Comm::PE::thread_pool), each with their own copy of the node data. This is only safe for expressions that modify nothing but the
+/// values at the current node, i.e. not for expressions that write to a linear system.
 template<typename ExprT, typename NbDimsT>
 struct NodeLooperDim
 {
@@ -36,10 +47,11 @@ struct NodeLooperDim
   
   typedef NodeData<VariablesT, NbDimsT> DataT;
   
-  NodeLooperDim(const ExprT& expr, Mesh::CRegion& region, VariablesT& variables) :
+  NodeLooperDim(const ExprT& expr, Mesh::CRegion& region, VariablesT& variables, const Uint nb_threads = 1) :
     m_expr(expr),
     m_region(region),
-    m_variables(variables)
+    m_variables(variables),
+    m_nb_threads(nb_threads)
   {
   }
   
@@ -119,25 +131,45 @@ struct NodeLooperDim
   {};
   
   void operator()() const
+  {
+    // Sorted list of unique nodes, only built the first time or after the mesh changed
+    const Mesh::CList<Uint>& nodes = Mesh::CEntities::used_nodes(m_region);
+    const Uint nb_nodes = nodes.size();
+    
+    const Uint nb_threads = std::max(1u, std::min(m_nb_threads, nb_nodes));
+    if(nb_threads == 1)
+    {
+      run_range(nodes, 0, nb_nodes);
+      return;
+    }
+    
+    Common::Comm::PE::instance().thread_pool().run(nb_threads, boost::bind(&NodeLooperDim::run_part, this, boost::cref(nodes), nb_threads, _1));
+  }
+  
+private:
+  /// Run the expression for part i of nb_parts equal parts of the node list
+  void run_part(const Mesh::CList<Uint>& nodes, const Uint nb_parts, const Uint i) const
+  {
+    const Uint nb_nodes = nodes.size();
+    run_range(nodes, (nb_nodes * i) / nb_parts, (nb_nodes * (i+1)) / nb_parts);
+  }
+  
+  /// Run the expression for the nodes in the range [begin, end[ of the node list
+  void run_range(const Mesh::CList<Uint>& nodes, const Uint begin, const Uint end) const
   {
     // Create data used for the evaluation
     DataT node_data(m_variables, m_region, m_region.geometry().coordinates(), m_expr);
     
     // Wrap things up so that we can store the intermediate product results
-    do_run(WrapExpression()(m_expr, 0, node_data), node_data);
+    do_run(WrapExpression()(m_expr, 0, node_data), node_data, nodes, begin, end);
   }
   
-private:
   template<typename FilteredExprT>
-  void do_run(const FilteredExprT& expr, DataT& data) const
+  void do_run(const FilteredExprT& expr, DataT& data, const Mesh::CList<Uint>& nodes, const Uint begin, const Uint end) const
   {
     NodeGrammar grammar;
     
-    std::vector<Uint> nodes;
-    make_node_list(m_region, m_region.geometry().coordinates(), nodes);
-    
-    const Uint nb_nodes = nodes.size();
-    for(Uint i = 0; i != nb_nodes; ++i)
+    for(Uint i = begin; i != end; ++i)
     {
       data.set_node(nodes[i]);
       grammar(expr, 0, data); // The "0" is the proto state, which is unused at the top-level expression
@@ -147,6 +179,7 @@ private:
   const ExprT& m_expr;
   Mesh::CRegion& m_region;
   VariablesT& m_variables;
+  const Uint m_nb_threads;
 };
 
 /// Loop over nodes, using static-sized vectors to store coordinates
@@ -156,10 +189,11 @@ struct NodeLooper
   /// Type of a fusion vector that can contain a copy of each variable that is used in the expression
   typedef typename ExpressionProperties<ExprT>::VariablesT VariablesT;
   
-  NodeLooper(const ExprT& expr, Mesh::CRegion& region, VariablesT& variables) :
+  NodeLooper(const ExprT& expr, Mesh::CRegion& region, VariablesT& variables, const Uint nb_threads = 1) :
     m_expr(expr),
     m_region(region),
-    m_variables(variables)
+    m_variables(variables),
+    m_nb_threads(nb_threads)
   {
   }
   
@@ -171,7 +205,7 @@ struct NodeLooper
       return;
   
     // Execute with known dimension
-    NodeLooperDim<ExprT, NbDimsT>(m_expr, m_region, m_variables)();
+    NodeLooperDim<ExprT, NbDimsT>(m_expr, m_region, m_variables, m_nb_threads)();
   }
   
 private:
@@ -179,13 +213,15 @@ private:
   const ExprT& m_expr;
   Mesh::CRegion& m_region;
   VariablesT& m_variables;
+  const Uint m_nb_threads;
 };
   
 /// Visit all nodes used by root_region exactly once, executing expr
 /// @param variable_names Name of each of the variables, in case a linear system is solved
 /// @param variable_sizes Size (number of scalars) that makes up each variable in the linear system, if any
+/// @param nb_threads Number of threads to use. Only use more than one for expressions that modify only the current node.
 template<typename ExprT>
-void for_each_node(Mesh::CRegion& root_region, const ExprT& expr)
+void for_each_node(Mesh::CRegion& root_region, const ExprT& expr, const Uint nb_threads = 1)
 {
   // IF COMPILATION FAILS HERE: the espression passed is invalid
   BOOST_MPL_ASSERT_MSG(
@@ -199,7 +235,7 @@ void for_each_node(Mesh::CRegion& root_region, const ExprT& expr)
   CopyNumberedVars<VariablesT> ctx(vars);
   boost::proto::eval(expr, ctx);
   
-  boost::mpl::for_each< boost::mpl::range_c<Uint, 1, 4> >( NodeLooper<ExprT>(expr, root_region, vars) );
+  boost::mpl::for_each< boost::mpl::range_c<Uint, 1, 4> >( NodeLooper<ExprT>(expr, root_region, vars, nb_threads) );
 }
 
 } // namespace Proto
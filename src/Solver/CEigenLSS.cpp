@@ -6,9 +6,13 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <cmath>
 #include <iostream>
+#include <map>
 #include <set>
 
+#include <boost/scoped_ptr.hpp>
+
 #include "coolfluid-packages.hpp"
 
 #ifdef CF_HAVE_TRILINOS
@@ -25,6 +29,8 @@
   #include "Teuchos_VerboseObject.hpp"
   #include "Teuchos_XMLParameterListHelpers.hpp"
   #include "Teuchos_CommandLineProcessor.hpp"
+  #include "Teuchos_ParameterList.hpp"
+  #include "ml_MultiLevelPreconditioner.h"
 
 #else
   #ifdef CF_HAVE_SUPERLU
@@ -33,9 +39,12 @@
   #endif
 #endif
 
+#include "Common/CAction.hpp"
 #include "Common/Foreach.hpp"
 #include "Common/Log.hpp"
 #include "Common/CBuilder.hpp"
+#include "Common/OptionComponent.hpp"
+#include "Common/OptionT.hpp"
 #include "Common/OptionURI.hpp"
 #include "Common/MPI/PE.hpp"
 #include "Common/Timer.hpp"
@@ -53,7 +62,99 @@ using namespace CF::Mesh;
 
 CF::Common::ComponentBuilder < CEigenLSS, Common::Component, LibSolver > aCeigenLSS_Builder;
 
-CEigenLSS::CEigenLSS ( const std::string& name ) : Component ( name )
+/// Approximate solver for the symmetric approximate Schur complement of the SIMPLE preconditioner
+class CEigenLSS::SchurComplementSolver
+{
+public:
+  /// Matrix type of the Schur complement. Both triangles are stored, so column i also holds row i.
+  typedef Eigen::DynamicSparseMatrix<Real> MatrixT;
+
+#ifdef CF_HAVE_TRILINOS
+  /// Build a smoothed aggregation multigrid hierarchy for the given matrix
+  SchurComplementSolver(const MatrixT& schur) :
+    m_map(schur.rows(), 0, m_comm),
+    m_matrix(Copy, m_map, 0)
+  {
+    std::vector<int> indices;
+    std::vector<Real> values;
+    for(int row = 0; row != schur.outerSize(); ++row)
+    {
+      indices.clear();
+      values.clear();
+      for(MatrixT::InnerIterator it(schur, row); it; ++it)
+      {
+        indices.push_back(it.index());
+        values.push_back(it.value());
+      }
+      if(!indices.empty())
+        m_matrix.InsertGlobalValues(row, indices.size(), &values[0], &indices[0]);
+    }
+    m_matrix.FillComplete();
+
+    Teuchos::ParameterList ml_list;
+    ML_Epetra::SetDefaults("SA", ml_list);
+    ml_list.set("ML output", 0);
+    m_amg.reset(new ML_Epetra::MultiLevelPreconditioner(m_matrix, ml_list, true));
+  }
+
+  /// Apply one multigrid V-cycle, starting from zero
+  void solve(const RealVector& b, RealVector& x) const
+  {
+    x.setZero(size());
+    const Epetra_Vector ep_b(View, m_map, const_cast<Real*>(b.data()));
+    Epetra_Vector ep_x(View, m_map, x.data());
+    m_amg->ApplyInverse(ep_b, ep_x);
+  }
+
+  Uint size() const
+  {
+    return m_map.NumGlobalElements();
+  }
+
+private:
+  Epetra_SerialComm m_comm;
+  Epetra_Map m_map;
+  Epetra_CrsMatrix m_matrix;
+  boost::scoped_ptr<ML_Epetra::MultiLevelPreconditioner> m_amg;
+#else
+  /// Factorize the given matrix
+  SchurComplementSolver(const MatrixT& schur)
+  {
+    m_cholesky.compute(Eigen::SparseMatrix<Real>(schur));
+    if(m_cholesky.info() != Eigen::Success)
+      throw Common::FailedToConverge(FromHere(), "Factorization of the Schur complement of the SIMPLE preconditioner failed");
+  }
+
+  /// Direct solve
+  void solve(const RealVector& b, RealVector& x) const
+  {
+    x = m_cholesky.solve(b);
+  }
+
+  Uint size() const
+  {
+    return m_cholesky.rows();
+  }
+
+private:
+  Eigen::SimplicialCholesky< Eigen::SparseMatrix<Real> > m_cholesky;
+#endif
+};
+
+CEigenLSS::CEigenLSS ( const std::string& name ) :
+  Component ( name ),
+  m_symmetric_dirichlet(false),
+  m_matrix_free(false),
+  m_applying_operator(false),
+  m_krylov_method("CG"),
+  m_max_iterations(1000),
+  m_tolerance(1e-10),
+  m_gmres_restart(30),
+  m_preconditioner("Jacobi"),
+  m_block_size(0),
+  m_pressure_index(0),
+  m_velocity_sweeps(1),
+  m_reuse_schur_complement(false)
 {
   m_options.add_option< OptionURI >("config_file", URI())
       ->description("Solver config file")
@@ -61,6 +162,67 @@ CEigenLSS::CEigenLSS ( const std::string& name ) : Component ( name )
       ->mark_basic()
       ->cast_to<OptionURI>()->supported_protocol(URI::Scheme::FILE);
 
+  m_options.add_option< OptionT<bool> >("symmetric_dirichlet", m_symmetric_dirichlet)
+      ->description("Zero both the rows and the columns for Dirichlet BCs, so symmetric matrices stay symmetric. The BCs are applied all at once before solving.")
+      ->pretty_name("Symmetric Dirichlet")
+      ->link_to(&m_symmetric_dirichlet);
+
+  m_options.add_option< OptionT<bool> >("matrix_free", m_matrix_free)
+      ->description("Don't store the system matrix, but apply it to a vector by executing the operator action during the solve. Only the diagonal is stored, as Jacobi preconditioner.")
+      ->pretty_name("Matrix Free")
+      ->link_to(&m_matrix_free);
+
+  m_options.add_option( OptionComponent<CAction>::create("operator", &m_operator) )
+      ->description("Action that assembles the system matrix, executed for each matrix-vector product in matrix-free mode")
+      ->pretty_name("Operator");
+
+  m_options.add_option< OptionT<std::string> >("krylov_method", m_krylov_method)
+      ->description("Krylov method used in matrix-free mode: CG for symmetric positive definite systems, or GMRES. The SIMPLE preconditioner always uses GMRES.")
+      ->pretty_name("Krylov Method")
+      ->link_to(&m_krylov_method);
+
+  m_options.add_option< OptionT<Uint> >("max_iterations", m_max_iterations)
+      ->description("Maximum number of iterations for the built-in Krylov solvers")
+      ->pretty_name("Max Iterations")
+      ->link_to(&m_max_iterations);
+
+  m_options.add_option< OptionT<Real> >("tolerance", m_tolerance)
+      ->description("Relative residual norm at which the built-in Krylov solvers stop")
+      ->pretty_name("Tolerance")
+      ->link_to(&m_tolerance);
+
+  m_options.add_option< OptionT<Uint> >("gmres_restart", m_gmres_restart)
+      ->description("Number of GMRES iterations between restarts")
+      ->pretty_name("GMRES Restart")
+      ->link_to(&m_gmres_restart);
+
+  m_options.add_option< OptionT<std::string> >("preconditioner", m_preconditioner)
+      ->description("Preconditioner for the built-in Krylov solvers: Jacobi, or SIMPLE for saddle point systems with interleaved velocity and pressure unknowns. "
+                    "SIMPLE needs a stored matrix, and solves it using GMRES instead of the external solver.")
+      ->pretty_name("Preconditioner")
+      ->link_to(&m_preconditioner);
+
+  m_options.add_option< OptionT<Uint> >("block_size", m_block_size)
+      ->description("Number of interleaved unknowns per node (i.e. 3 for uvp, uvp, ...), used by the SIMPLE preconditioner")
+      ->pretty_name("Block Size")
+      ->link_to(&m_block_size);
+
+  m_options.add_option< OptionT<Uint> >("pressure_index", m_pressure_index)
+      ->description("Index of the pressure within each block of block_size unknowns, used by the SIMPLE preconditioner")
+      ->pretty_name("Pressure Index")
+      ->link_to(&m_pressure_index);
+
+  m_options.add_option< OptionT<Uint> >("velocity_sweeps", m_velocity_sweeps)
+      ->description("Number of symmetric Gauss-Seidel sweeps on the velocity block in the SIMPLE preconditioner")
+      ->pretty_name("Velocity Sweeps")
+      ->link_to(&m_velocity_sweeps);
+
+  m_options.add_option< OptionT<bool> >("reuse_schur_complement", m_reuse_schur_complement)
+      ->description("Keep the Schur complement solver of the SIMPLE preconditioner (the multigrid hierarchy, or the factorization without Trilinos) between solves. "
+                    "Only the velocity block is then updated, which is cheaper if the pressure blocks change little between time steps.")
+      ->pretty_name("Reuse Schur Complement")
+      ->link_to(&m_reuse_schur_complement);
+
   if(!Comm::PE::instance().is_active())
     Comm::PE::instance().init();
 }
@@ -73,19 +235,23 @@ void CEigenLSS::set_config_file(const URI& path)
 
 void CEigenLSS::resize ( Uint nb_dofs )
 {
-  if(nb_dofs == (Uint) m_system_matrix.rows())
+  // In matrix-free mode, no storage is allocated for the matrix
+  const Uint nb_matrix_rows = m_matrix_free ? 0 : nb_dofs;
+  if(nb_dofs == size() && nb_matrix_rows == (Uint) m_system_matrix.rows())
     return;
 
-  m_system_matrix.resize(nb_dofs, nb_dofs);
+  m_system_matrix.resize(nb_matrix_rows, nb_matrix_rows);
   m_rhs.resize(nb_dofs);
   m_solution.resize(nb_dofs);
+  m_diagonal.resize(m_matrix_free ? nb_dofs : 0);
+  m_schur_complement.reset();
 
   set_zero();
 }
 
 Uint CEigenLSS::size() const
 {
-  return m_system_matrix.cols();
+  return m_rhs.size();
 }
 
 Real& CEigenLSS::at(const CF::Uint row, const CF::Uint col)
@@ -99,10 +265,24 @@ void CEigenLSS::set_zero()
   m_system_matrix.setZero();
   m_rhs.setZero();
   m_solution.setZero();
+  m_diagonal.setZero();
+
+  m_bc_rows.clear();
+  m_bc_values.clear();
+  m_bc_coeffs.clear();
 }
 
 void CEigenLSS::set_dirichlet_bc(const CF::Uint row, const CF::Real value, const CF::Real coeff)
 {
+  // Without a stored matrix, the BCs can only be applied when solving
+  if(m_symmetric_dirichlet || m_matrix_free)
+  {
+    m_bc_rows.push_back(row);
+    m_bc_values.push_back(value);
+    m_bc_coeffs.push_back(coeff);
+    return;
+  }
+
   for(MatrixT::InnerIterator it(m_system_matrix, static_cast<int>(row)); it; ++it)
   {
     if(static_cast<Uint>(it.col()) != row)
@@ -117,31 +297,85 @@ void CEigenLSS::set_dirichlet_bc(const CF::Uint row, const CF::Real value, const
   m_rhs[row] = coeff * value;
 }
 
-// This version kept symetry, but it is horribly inefficient because of the way we store the matrix
-// void CEigenLSS::set_dirichlet_bc(const CF::Uint row, const CF::Real value, const CF::Real coeff)
-// {
-//   for(int k=0; k < m_system_matrix.outerSize(); ++k)
-//   {
-//     for(MatrixT::InnerIterator it(m_system_matrix, k); it; ++it)
-//     {
-//       if((Uint) it.row() == row && (Uint) it.col() != row)
-//       {
-//         it.valueRef() = 0.;
-//       }
-//       else if((Uint) it.row() == row && (Uint) it.col() == row)
-//       {
-//         it.valueRef() = coeff;
-//       }
-//       else if((Uint)it.row() != row && (Uint) it.col() == row)
-//       {
-//         m_rhs[it.row()] -= it.value() * value;
-//         it.valueRef() = 0.;
-//       }
-//     }
-//   }
-//
-//   m_rhs[row] = coeff * value;
-// }
+void CEigenLSS::set_dirichlet_bcs(const std::vector<Uint>& rows, const std::vector<Real>& values, const Real coeff)
+{
+  cf_assert(rows.size() == values.size());
+  if(m_matrix_free)
+  {
+    m_bc_rows.insert(m_bc_rows.end(), rows.begin(), rows.end());
+    m_bc_values.insert(m_bc_values.end(), values.begin(), values.end());
+    m_bc_coeffs.resize(m_bc_rows.size(), coeff);
+    return;
+  }
+  apply_symmetric_dirichlet(rows, values, std::vector<Real>(rows.size(), coeff));
+}
+
+void CEigenLSS::apply_dirichlet_bcs()
+{
+  // Stored BCs are needed for each matrix-vector product in matrix-free mode, so they are applied in solve
+  if(m_bc_rows.empty() || m_matrix_free)
+    return;
+
+  apply_symmetric_dirichlet(m_bc_rows, m_bc_values, m_bc_coeffs);
+
+  m_bc_rows.clear();
+  m_bc_values.clear();
+  m_bc_coeffs.clear();
+}
+
+void CEigenLSS::apply_symmetric_dirichlet(const std::vector<Uint>& rows, const std::vector<Real>& values, const std::vector<Real>& coeffs)
+{
+  const Uint nb_rows = size();
+
+  // Mark the constrained rows, so each matrix entry can be checked in constant time
+  std::vector<bool> constrained(nb_rows, false);
+  std::vector<Real> bc_values(nb_rows, 0.);
+  std::vector<Real> bc_coeffs(nb_rows, 0.);
+  const Uint nb_bcs = rows.size();
+  for(Uint i = 0; i != nb_bcs; ++i)
+  {
+    cf_assert(rows[i] < nb_rows);
+    constrained[rows[i]] = true;
+    bc_values[rows[i]] = values[i];
+    bc_coeffs[rows[i]] = coeffs[i];
+  }
+
+  // Since the matrix is stored per row, a constrained column is handled by lifting its known value into the RHS of each row
+  std::vector<bool> has_diagonal(nb_rows, false);
+  for(int row = 0; row < m_system_matrix.outerSize(); ++row)
+  {
+    const Uint urow = static_cast<Uint>(row);
+    for(MatrixT::InnerIterator it(m_system_matrix, row); it; ++it)
+    {
+      const Uint col = static_cast<Uint>(it.col());
+      if(constrained[urow])
+      {
+        if(col == urow)
+        {
+          it.valueRef() = bc_coeffs[urow];
+          has_diagonal[urow] = true;
+        }
+        else
+        {
+          it.valueRef() = 0.;
+        }
+      }
+      else if(constrained[col])
+      {
+        m_rhs[row] -= it.value() * bc_values[col];
+        it.valueRef() = 0.;
+      }
+    }
+  }
+
+  for(Uint i = 0; i != nb_bcs; ++i)
+  {
+    const Uint row = rows[i];
+    if(!has_diagonal[row])
+      m_system_matrix.coeffRef(row, row) = bc_coeffs[row];
+    m_rhs[row] = bc_coeffs[row] * bc_values[row];
+  }
+}
 
 
 RealVector& CEigenLSS::rhs()
@@ -157,6 +391,46 @@ const RealVector& CEigenLSS::solution()
 
 void CEigenLSS::solve()
 {
+  if(m_preconditioner != "Jacobi" && m_preconditioner != "SIMPLE")
+    throw SetupError(FromHere(), "Unknown preconditioner " + m_preconditioner + " for LSS " + uri().string());
+
+  if(m_gmres_restart == 0)
+    throw SetupError(FromHere(), "gmres_restart must be at least 1 for LSS " + uri().string());
+
+  if(m_matrix_free)
+  {
+    if(m_preconditioner == "SIMPLE")
+      throw SetupError(FromHere(), "The SIMPLE preconditioner needs a stored matrix for LSS " + uri().string());
+
+    Timer timer;
+    apply_matrix_free_dirichlet();
+    time_solver_setup = timer.elapsed(); timer.restart();
+
+    if(m_krylov_method == "CG")
+      solve_cg();
+    else if(m_krylov_method == "GMRES")
+      solve_gmres();
+    else
+      throw SetupError(FromHere(), "Unknown Krylov method " + m_krylov_method + " for LSS " + uri().string());
+
+    time_solve = timer.elapsed();
+    return;
+  }
+
+  apply_dirichlet_bcs();
+
+  if(m_preconditioner == "SIMPLE")
+  {
+    Timer timer;
+    setup_simple();
+    time_solver_setup = timer.elapsed(); timer.restart();
+
+    solve_gmres();
+
+    time_solve = timer.elapsed();
+    return;
+  }
+
 #ifdef CF_HAVE_TRILINOS
   Timer timer;
   const Uint nb_rows = size();
@@ -305,6 +579,379 @@ void CEigenLSS::print_matrix()
   std::cout << m_system_matrix << std::endl;
 }
 
+bool CEigenLSS::is_matrix_free() const
+{
+  return m_matrix_free;
+}
+
+bool CEigenLSS::is_applying_operator() const
+{
+  return m_applying_operator;
+}
+
+const RealVector& CEigenLSS::operator_input() const
+{
+  return m_operator_input;
+}
+
+RealVector& CEigenLSS::operator_output()
+{
+  return m_operator_output;
+}
+
+RealVector& CEigenLSS::diagonal()
+{
+  return m_diagonal;
+}
+
+void CEigenLSS::execute_operator(const RealVector& x)
+{
+  if(m_operator.expired())
+    throw SetupError(FromHere(), "No operator action set for matrix-free LSS " + uri().string());
+
+  m_operator_input = x;
+  m_operator_output.setZero(size());
+
+  m_applying_operator = true;
+  try
+  {
+    m_operator.lock()->execute();
+  }
+  catch(...)
+  {
+    m_applying_operator = false;
+    throw;
+  }
+  m_applying_operator = false;
+}
+
+void CEigenLSS::apply_operator(const RealVector& x, RealVector& y)
+{
+  // Stored matrix, with the dirichlet BCs already applied
+  if(!m_matrix_free)
+  {
+    const int nb_rows = m_system_matrix.outerSize();
+    y.resize(nb_rows);
+    for(int row = 0; row != nb_rows; ++row)
+    {
+      Real sum = 0.;
+      for(MatrixT::InnerIterator it(m_system_matrix, row); it; ++it)
+        sum += it.value() * x[it.col()];
+      y[row] = sum;
+    }
+    return;
+  }
+
+  const Uint nb_bcs = m_bc_rows.size();
+
+  // Constrained columns are zero
+  RealVector x_free = x;
+  for(Uint i = 0; i != nb_bcs; ++i)
+    x_free[m_bc_rows[i]] = 0.;
+
+  execute_operator(x_free);
+  y = m_operator_output;
+
+  // Constrained rows only have their diagonal
+  for(Uint i = 0; i != nb_bcs; ++i)
+    y[m_bc_rows[i]] = m_bc_coeffs[i] * x[m_bc_rows[i]];
+}
+
+void CEigenLSS::apply_matrix_free_dirichlet()
+{
+  const Uint nb_bcs = m_bc_rows.size();
+  if(!nb_bcs)
+    return;
+
+  // Move the known values to the RHS, using a single operator application
+  RealVector known_values = RealVector::Zero(size());
+  for(Uint i = 0; i != nb_bcs; ++i)
+    known_values[m_bc_rows[i]] = m_bc_values[i];
+
+  execute_operator(known_values);
+  m_rhs -= m_operator_output;
+
+  for(Uint i = 0; i != nb_bcs; ++i)
+  {
+    const Uint row = m_bc_rows[i];
+    m_rhs[row] = m_bc_coeffs[i] * m_bc_values[i];
+    m_diagonal[row] = m_bc_coeffs[i];
+  }
+}
+
+void CEigenLSS::precondition(const RealVector& x, RealVector& y) const
+{
+  if(m_preconditioner == "SIMPLE")
+  {
+    precondition_simple(x, y);
+    return;
+  }
+
+  const Uint nb_rows = size();
+  y.resize(nb_rows);
+  for(Uint i = 0; i != nb_rows; ++i)
+    y[i] = m_diagonal[i] != 0. ? x[i] / m_diagonal[i] : x[i];
+}
+
+bool CEigenLSS::is_pressure(const Uint i) const
+{
+  return i % m_block_size == m_pressure_index;
+}
+
+void CEigenLSS::setup_simple()
+{
+  if(m_block_size == 0 || m_pressure_index >= m_block_size)
+    throw SetupError(FromHere(), "Invalid block_size or pressure_index for the SIMPLE preconditioner of LSS " + uri().string());
+
+  const Uint nb_rows = size();
+  if(nb_rows % m_block_size != 0)
+    throw SetupError(FromHere(), "Size of LSS " + uri().string() + " is not a multiple of the block size");
+
+  m_diagonal.setZero(nb_rows);
+  for(Uint row = 0; row != nb_rows; ++row)
+  {
+    for(MatrixT::InnerIterator it(m_system_matrix, row); it; ++it)
+    {
+      if(static_cast<Uint>(it.col()) == row)
+        m_diagonal[row] = it.value();
+    }
+  }
+
+  const Uint nb_nodes = nb_rows / m_block_size;
+  if(m_reuse_schur_complement && m_schur_complement && m_schur_complement->size() == nb_nodes)
+    return;
+
+  // S = C - B diag(A)^-1 B^T, one row at a time. Only the symmetric part is kept.
+  SchurComplementSolver::MatrixT schur(nb_nodes, nb_nodes);
+  std::map<Uint, Real> schur_row;
+  for(Uint node = 0; node != nb_nodes; ++node)
+  {
+    schur_row.clear();
+    const Uint row = node * m_block_size + m_pressure_index;
+    for(MatrixT::InnerIterator it(m_system_matrix, row); it; ++it)
+    {
+      const Uint col = static_cast<Uint>(it.col());
+      if(is_pressure(col))
+      {
+        schur_row[col / m_block_size] += it.value();
+        continue;
+      }
+
+      const Real factor = m_diagonal[col] != 0. ? it.value() / m_diagonal[col] : it.value();
+      for(MatrixT::InnerIterator bt_it(m_system_matrix, col); bt_it; ++bt_it)
+      {
+        if(is_pressure(bt_it.col()))
+          schur_row[bt_it.col() / m_block_size] -= factor * bt_it.value();
+      }
+    }
+
+    for(std::map<Uint, Real>::const_iterator it = schur_row.begin(); it != schur_row.end(); ++it)
+    {
+      schur.coeffRef(node, it->first) += 0.5 * it->second;
+      schur.coeffRef(it->first, node) += 0.5 * it->second;
+    }
+  }
+
+  // release the old solver before building the new one
+  m_schur_complement.reset();
+  m_schur_complement.reset(new SchurComplementSolver(schur));
+}
+
+void CEigenLSS::precondition_simple(const RealVector& x, RealVector& y) const
+{
+  const Uint nb_rows = size();
+  const Uint nb_nodes = nb_rows / m_block_size;
+  y.setZero(nb_rows);
+
+  // Velocity predictor: symmetric Gauss-Seidel on A, ignoring the pressure
+  for(Uint sweep = 0; sweep != 2*m_velocity_sweeps; ++sweep)
+  {
+    for(Uint i = 0; i != nb_rows; ++i)
+    {
+      const Uint row = sweep % 2 == 0 ? i : nb_rows - 1 - i;
+      if(is_pressure(row))
+        continue;
+
+      Real sum = x[row];
+      for(MatrixT::InnerIterator it(m_system_matrix, row); it; ++it)
+      {
+        const Uint col = static_cast<Uint>(it.col());
+        if(col != row && !is_pressure(col))
+          sum -= it.value() * y[col];
+      }
+      y[row] = m_diagonal[row] != 0. ? sum / m_diagonal[row] : sum;
+    }
+  }
+
+  // Pressure: S p = x_p - B u*
+  RealVector p_rhs(nb_nodes);
+  for(Uint node = 0; node != nb_nodes; ++node)
+  {
+    const Uint row = node * m_block_size + m_pressure_index;
+    Real sum = x[row];
+    for(MatrixT::InnerIterator it(m_system_matrix, row); it; ++it)
+    {
+      if(!is_pressure(it.col()))
+        sum -= it.value() * y[it.col()];
+    }
+    p_rhs[node] = sum;
+  }
+  RealVector p;
+  m_schur_complement->solve(p_rhs, p);
+
+  // Velocity correction: u = u* - diag(A)^-1 B^T p
+  for(Uint row = 0; row != nb_rows; ++row)
+  {
+    if(is_pressure(row))
+    {
+      y[row] = p[row / m_block_size];
+      continue;
+    }
+
+    Real correction = 0.;
+    for(MatrixT::InnerIterator it(m_system_matrix, row); it; ++it)
+    {
+      if(is_pressure(it.col()))
+        correction += it.value() * p[it.col() / m_block_size];
+    }
+    y[row] -= m_diagonal[row] != 0. ? correction / m_diagonal[row] : correction;
+  }
+}
+
+void CEigenLSS::solve_cg()
+{
+  const Uint nb_rows = size();
+  const Real rhs_norm = m_rhs.norm();
+  if(rhs_norm == 0.)
+  {
+    m_solution.setZero(nb_rows);
+    return;
+  }
+
+  RealVector& x = m_solution;
+  RealVector r(nb_rows), z(nb_rows), p(nb_rows), q(nb_rows);
+
+  apply_operator(x, q);
+  r = m_rhs - q;
+  precondition(r, z);
+  p = z;
+  Real rz = r.dot(z);
+
+  for(Uint iter = 0; iter != m_max_iterations; ++iter)
+  {
+    if(r.norm() <= m_tolerance * rhs_norm)
+    {
+      CFdebug << "CG converged in " << iter << " iterations" << CFendl;
+      return;
+    }
+
+    apply_operator(p, q);
+    const Real alpha = rz / p.dot(q);
+    x += alpha * p;
+    r -= alpha * q;
+
+    precondition(r, z);
+    const Real rz_new = r.dot(z);
+    p = z + (rz_new / rz) * p;
+    rz = rz_new;
+  }
+
+  if(r.norm() > m_tolerance * rhs_norm)
+    throw Common::FailedToConverge(FromHere(), "CG did not converge for LSS " + uri().string());
+}
+
+void CEigenLSS::solve_gmres()
+{
+  const Uint nb_rows = size();
+  const Real rhs_norm = m_rhs.norm();
+  if(rhs_norm == 0.)
+  {
+    m_solution.setZero(nb_rows);
+    return;
+  }
+
+  const Uint m = m_gmres_restart;
+  RealVector& x = m_solution;
+  RealMatrix V(nb_rows, m+1); // Krylov basis
+  RealMatrix H = RealMatrix::Zero(m+1, m); // Hessenberg matrix
+  RealVector cs(m), sn(m), g(m+1);
+  RealVector w(nb_rows), z(nb_rows);
+
+  Uint iter = 0;
+  while(iter < m_max_iterations)
+  {
+    apply_operator(x, w);
+    w = m_rhs - w;
+    Real beta = w.norm();
+    if(beta <= m_tolerance * rhs_norm)
+    {
+      CFdebug << "GMRES converged in " << iter << " iterations" << CFendl;
+      return;
+    }
+
+    V.col(0) = w / beta;
+    g.setZero();
+    g[0] = beta;
+
+    Uint k = 0;
+    for(; k != m && iter < m_max_iterations; ++k, ++iter)
+    {
+      // Arnoldi step on the right-preconditioned operator, using modified Gram-Schmidt
+      precondition(V.col(k), z);
+      apply_operator(z, w);
+      for(Uint i = 0; i <= k; ++i)
+      {
+        H(i, k) = w.dot(V.col(i));
+        w -= H(i, k) * V.col(i);
+      }
+      H(k+1, k) = w.norm();
+      if(H(k+1, k) != 0.)
+        V.col(k+1) = w / H(k+1, k);
+
+      // Apply the previous Givens rotations to the new column, and eliminate the subdiagonal element
+      for(Uint i = 0; i != k; ++i)
+      {
+        const Real h = cs[i] * H(i, k) + sn[i] * H(i+1, k);
+        H(i+1, k) = -sn[i] * H(i, k) + cs[i] * H(i+1, k);
+        H(i, k) = h;
+      }
+      const Real denom = std::sqrt(H(k, k)*H(k, k) + H(k+1, k)*H(k+1, k));
+      cs[k] = H(k, k) / denom;
+      sn[k] = H(k+1, k) / denom;
+      H(k, k) = denom;
+      H(k+1, k) = 0.;
+      g[k+1] = -sn[k] * g[k];
+      g[k] = cs[k] * g[k];
+
+      if(std::abs(g[k+1]) <= m_tolerance * rhs_norm)
+      {
+        ++k;
+        ++iter;
+        break;
+      }
+    }
+
+    // Solve the upper triangular system and update the solution
+    RealVector y(k);
+    for(int i = static_cast<int>(k) - 1; i >= 0; --i)
+    {
+      y[i] = g[i];
+      for(Uint j = i+1; j != k; ++j)
+        y[i] -= H(i, j) * y[j];
+      y[i] /= H(i, i);
+    }
+    w.setZero();
+    for(Uint i = 0; i != k; ++i)
+      w += y[i] * V.col(i);
+    precondition(w, z);
+    x += z;
+  }
+
+  apply_operator(x, w);
+  if((m_rhs - w).norm() > m_tolerance * rhs_norm)
+    throw Common::FailedToConverge(FromHere(), "GMRES did not converge for LSS " + uri().string());
+}
+
 
 void increment_solution(const RealVector& solution, const std::vector<std::string>& field_names, const std::vector<std::string>& var_names, const std::vector<Uint>& var_sizes, CMesh& solution_mesh)
 {
@@ -11,6 +11,7 @@
 
 #define EIGEN_YES_I_KNOW_SPARSE_MODULE_IS_NOT_STABLE_YET
 #include <Eigen/Sparse>
+#include <Eigen/SparseExtra>
 
 #include "Common/Component.hpp"
 
@@ -21,7 +22,7 @@
 #include "LibSolver.hpp"
 
 namespace CF {
-  namespace Common { class URI; }
+  namespace Common { class URI; class CAction; }
 namespace Solver {
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -59,8 +60,17 @@ public: // functions
   /// Zero the system (RHS and system matrix)
   void set_zero();
   
-  /// Set a dirichlet BC value, zeroing the corresponding row and column and adjusting the RHS
+  /// Set a dirichlet BC value, zeroing the corresponding row and adjusting the RHS.
+  /// If the option symmetric_dirichlet is true, the BC is only stored, and applied together with all other
+  /// stored BCs in apply_dirichlet_bcs, which is called automatically before solving.
   void set_dirichlet_bc(const Uint row, const Real value, const Real coeff = 1.);
+
+  /// Set dirichlet BC values for all given rows at once, zeroing the corresponding rows and columns.
+  /// The known values are moved to the RHS, so a symmetric matrix stays symmetric. Needs a single pass over the matrix.
+  void set_dirichlet_bcs(const std::vector<Uint>& rows, const std::vector<Real>& values, const Real coeff = 1.);
+
+  /// Apply the dirichlet BCs that were stored by set_dirichlet_bc, if any
+  void apply_dirichlet_bcs();
   
   /// Reference to the RHS vector
   RealVector& rhs();
@@ -73,6 +83,22 @@ public: // functions
   
   void print_matrix();
   
+  /// True if the system matrix is not stored. The action set in the "operator" option is then executed
+  /// each time the Krylov solver needs a matrix-vector product.
+  bool is_matrix_free() const;
+  
+  /// True while the operator action is executed to apply the system matrix to operator_input()
+  bool is_applying_operator() const;
+  
+  /// Vector the system matrix is applied to while is_applying_operator() is true
+  const RealVector& operator_input() const;
+  
+  /// Result of the matrix-vector product, accumulated while is_applying_operator() is true
+  RealVector& operator_output();
+  
+  /// Diagonal of the system matrix, accumulated during assembly in matrix-free mode and used as Jacobi preconditioner
+  RealVector& diagonal();
+  
   /// Timings
   Real time_matrix_construction;
   Real time_matrix_fill;
@@ -81,6 +107,39 @@ public: // functions
   Real time_residual;
   
 private:
+  /// Zero the given rows and columns in a single pass over the matrix, moving the known values to the RHS
+  void apply_symmetric_dirichlet(const std::vector<Uint>& rows, const std::vector<Real>& values, const std::vector<Real>& coeffs);
+
+  /// Apply the system matrix without BCs to x, by executing the operator action. The result is in m_operator_output.
+  void execute_operator(const RealVector& x);
+
+  /// Apply the system matrix to x in matrix-free mode, with the dirichlet BCs eliminated symmetrically
+  void apply_operator(const RealVector& x, RealVector& y);
+
+  /// Apply the stored dirichlet BCs to the RHS and the diagonal in matrix-free mode
+  void apply_matrix_free_dirichlet();
+
+  /// Apply the preconditioner set in the "preconditioner" option
+  void precondition(const RealVector& x, RealVector& y) const;
+
+  /// Store the diagonal of the stored system matrix and set up the solver for the approximate Schur complement used by the SIMPLE preconditioner
+  void setup_simple();
+
+  /// SIMPLE block preconditioner for the interleaved velocity-pressure saddle point system [A B^T; B C]:
+  /// symmetric Gauss-Seidel sweeps on A for the velocity predictor, followed by an approximate solve with
+  /// the Schur complement S = C - B diag(A)^-1 B^T for the pressure and a velocity correction.
+  /// The pressure solve is an algebraic multigrid V-cycle (ML) with Trilinos, or a sparse Cholesky solve without.
+  void precondition_simple(const RealVector& x, RealVector& y) const;
+
+  /// True if the given row or column of the system matrix belongs to the pressure (Schur complement) variable
+  bool is_pressure(const Uint i) const;
+
+  /// Preconditioned conjugate gradient method, for symmetric positive definite systems
+  void solve_cg();
+
+  /// Restarted GMRES, with right preconditioning
+  void solve_gmres();
+
   /// System matrix
   typedef Eigen::DynamicSparseMatrix<Real, Eigen::RowMajor> MatrixT;
   MatrixT m_system_matrix;
@@ -90,6 +149,61 @@ private:
   
   /// Solution
   RealVector m_solution;
+
+  /// True if dirichlet BCs should keep the matrix symmetric
+  bool m_symmetric_dirichlet;
+
+  /// Dirichlet BCs that still need to be applied, if m_symmetric_dirichlet is true
+  std::vector<Uint> m_bc_rows;
+  std::vector<Real> m_bc_values;
+  std::vector<Real> m_bc_coeffs;
+
+  /// True if the system matrix is applied by executing m_operator instead of being stored
+  bool m_matrix_free;
+
+  /// True while m_operator is executed
+  bool m_applying_operator;
+
+  /// Action that assembles the system matrix, executed in matrix-free mode to compute matrix-vector products
+  boost::weak_ptr<Common::CAction> m_operator;
+
+  /// Krylov method used in matrix-free mode (CG or GMRES)
+  std::string m_krylov_method;
+
+  /// Maximum number of Krylov iterations in matrix-free mode
+  Uint m_max_iterations;
+
+  /// Relative residual at which the Krylov solver stops
+  Real m_tolerance;
+
+  /// Number of GMRES iterations before a restart
+  Uint m_gmres_restart;
+
+  /// Work vectors for the matrix-free operator
+  RealVector m_operator_input;
+  RealVector m_operator_output;
+
+  /// Matrix diagonal in matrix-free mode, or for the SIMPLE preconditioner
+  RealVector m_diagonal;
+
+  /// Preconditioner for the built-in Krylov solvers (Jacobi or SIMPLE)
+  std::string m_preconditioner;
+
+  /// Number of interleaved unknowns per node, for the SIMPLE preconditioner
+  Uint m_block_size;
+
+  /// Index of the pressure within each node block
+  Uint m_pressure_index;
+
+  /// Number of symmetric Gauss-Seidel sweeps for the velocity block in the SIMPLE preconditioner
+  Uint m_velocity_sweeps;
+
+  /// Keep the factorized Schur complement between solves
+  bool m_reuse_schur_complement;
+
+  /// Approximate solver for the symmetric part of the approximate Schur complement
+  class SchurComplementSolver;
+  boost::shared_ptr<SchurComplementSolver> m_schur_complement;
 };
 
 /// Helper function to increment the solution field(s) with the given solution vector from a LSS, i.e. treat the solution vector as the differece between the new  and old field values
@@ -66,16 +66,16 @@ int main(int argc, char ** argv)
       Logger::instance().getStream(INFO).addStringForwarder(forwarder);
     }
 
-  bool rank0 = CFinfo.getFilterRankZero(LogStream::SCREEN);
+  bool rank0 = CFinfoStream.getFilterRankZero(LogStream::SCREEN);
 
-  CFinfo.setFilterRankZero(LogStream::SCREEN, false);
+  CFinfoStream.setFilterRankZero(LogStream::SCREEN, false);
 
   CFinfo << "Worker[" << rank << "] -> Syncing with the parent..." << CFendl;
   PE::instance().barrier();
   MPI_Barrier( parent_comm );
   CFinfo << "Worker[" << rank << "] -> Synced with the parent!" << CFendl;
 
-  CFinfo.setFilterRankZero(LogStream::SCREEN, rank0);
+  CFinfoStream.setFilterRankZero(LogStream::SCREEN, rank0);
 
   mgr->listening_thread().join();
 
@@ -0,0 +1,210 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <fstream>
+#include <iomanip>
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include "Common/BoostFilesystem.hpp"
+#include "Common/Foreach.hpp"
+#include "Common/Log.hpp"
+#include "Common/MPI/PE.hpp"
+
+#include "Tools/Testing/Benchmark.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace CF {
+namespace Tools {
+namespace Testing {
+
+using namespace Common;
+
+////////////////////////////////////////////////////////////////////////////////
+
+BenchmarkResults& BenchmarkResults::instance()
+{
+  static BenchmarkResults results;
+  return results;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BenchmarkResults::BenchmarkResults() :
+  m_nb_procs(1),
+  m_is_writer(true)
+{
+  char** argv = boost::unit_test::framework::master_test_suite().argv;
+  m_executable = boost::filesystem::basename(boost::filesystem::path(argv[0]));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void BenchmarkResults::add(const std::string& name, const Real time, const Uint size)
+{
+  Result result;
+  result.name = name;
+  result.time = time;
+  result.size = size;
+
+  if(Comm::PE::instance().is_active())
+  {
+    m_nb_procs = Comm::PE::instance().size();
+    m_is_writer = Comm::PE::instance().rank() == 0;
+    Comm::PE::instance().all_reduce(Comm::max(), &time, 1, &result.time);
+    Comm::PE::instance().all_reduce(Comm::plus(), &size, 1, &result.size);
+  }
+
+  CFinfo << "benchmark " << name << ": " << result.time << " s" << CFendl;
+
+  m_results.push_back(result);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Uint BenchmarkResults::scale(const Uint default_scale) const
+{
+  const int argc = boost::unit_test::framework::master_test_suite().argc;
+  char** argv = boost::unit_test::framework::master_test_suite().argv;
+
+  for(int i = 1; i < argc; ++i)
+  {
+    const std::string arg(argv[i]);
+    if(!arg.empty() && arg.find_first_not_of("0123456789") == std::string::npos)
+      return boost::lexical_cast<Uint>(arg);
+  }
+
+  return default_scale;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::string BenchmarkResults::output_file() const
+{
+  const int argc = boost::unit_test::framework::master_test_suite().argc;
+  char** argv = boost::unit_test::framework::master_test_suite().argv;
+
+  for(int i = 1; i < argc; ++i)
+  {
+    const std::string arg(argv[i]);
+    if(boost::algorithm::ends_with(arg, ".json") || boost::algorithm::ends_with(arg, ".csv"))
+      return arg;
+  }
+
+  return std::string();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void BenchmarkResults::write() const
+{
+  const std::string file_name = output_file();
+  if(file_name.empty())
+    return;
+
+  if(!m_is_writer)
+    return;
+
+  std::ofstream file(file_name.c_str());
+  if(!file)
+  {
+    // this is called at exit, so don't throw
+    CFerror << "Could not open benchmark output file " << file_name << CFendl;
+    return;
+  }
+
+  if(boost::algorithm::ends_with(file_name, ".csv"))
+    write_csv(file);
+  else
+    write_json(file);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void BenchmarkResults::write_json(std::ostream& stream) const
+{
+  stream << std::setprecision(8);
+  stream << "{\n";
+  stream << "  \"executable\": \"" << m_executable << "\",\n";
+  stream << "  \"nb_procs\": " << m_nb_procs << ",\n";
+  stream << "  \"scale\": " << scale() << ",\n";
+  stream << "  \"results\": [\n";
+  for(Uint i = 0; i != m_results.size(); ++i)
+  {
+    const Result& result = m_results[i];
+    stream << "    { \"name\": \"" << result.name << "\", \"time\": " << result.time << ", \"size\": " << result.size << " }";
+    stream << (i+1 == m_results.size() ? "\n" : ",\n");
+  }
+  stream << "  ]\n";
+  stream << "}\n";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void BenchmarkResults::write_csv(std::ostream& stream) const
+{
+  stream << std::setprecision(8);
+  stream << "executable,name,nb_procs,scale,size,time\n";
+  boost_foreach(const Result& result, m_results)
+  {
+    stream << m_executable << "," << result.name << "," << m_nb_procs << "," << scale() << "," << result.size << "," << result.time << "\n";
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BenchmarkOutput::~BenchmarkOutput()
+{
+  BenchmarkResults::instance().write();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BenchmarkFixture::BenchmarkFixture() :
+  m_size(0)
+{
+  restart_timer();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BenchmarkFixture::~BenchmarkFixture()
+{
+  const Real time = m_timer.elapsed();
+  BenchmarkResults::instance().add(boost::unit_test::framework::current_test_case().p_name.get(), time, m_size);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void BenchmarkFixture::restart_timer()
+{
+  m_timer.restart();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void BenchmarkFixture::set_problem_size(const Uint size)
+{
+  m_size = size;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Uint BenchmarkFixture::scale() const
+{
+  return BenchmarkResults::instance().scale();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // Testing
+} // Tools
+} // CF
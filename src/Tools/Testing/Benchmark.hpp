@@ -0,0 +1,127 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef CF_Tools_Testing_Benchmark_hpp
+#define CF_Tools_Testing_Benchmark_hpp
+
+#include <string>
+#include <vector>
+
+#include "Common/CF.hpp"
+#include "Common/Timer.hpp"
+
+#include "Tools/Testing/LibTesting.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace CF {
+namespace Tools {
+namespace Testing {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Collects the results of a benchmark run and writes them in a machine-readable format,
+/// so they can be compared against a stored baseline using tools/compare-benchmarks.py
+/// The command line arguments of the benchmark executable are interpreted as follows:
+///  - an argument ending in .json or .csv is the file the results are written to
+///  - a numeric argument is the scale of the benchmark, i.e. a factor for the problem size
+class Testing_API BenchmarkResults
+{
+public:
+  /// A single measurement
+  struct Result
+  {
+    /// Name of the measurement, normally the test case name
+    std::string name;
+    /// Wall time in seconds, maximum over all ranks
+    Real time;
+    /// Problem size, e.g. the number of elements, summed over all ranks
+    Uint size;
+  };
+
+  static BenchmarkResults& instance();
+
+  /// Record a measurement. In parallel this is a collective operation.
+  /// @param name The name of the measurement
+  /// @param time Time spent on this rank
+  /// @param size Problem size on this rank
+  void add(const std::string& name, const Real time, const Uint size = 0);
+
+  /// Scale factor from the command line, or the supplied default if none was given
+  Uint scale(const Uint default_scale = 1) const;
+
+  /// File the results are written to, empty if none was given on the command line
+  std::string output_file() const;
+
+  /// Write the results to the output file, if any. Only rank 0 writes.
+  /// This may be called after MPI was finalized, so the rank is the one seen when the results were added.
+  void write() const;
+
+  /// Write the results in JSON format
+  void write_json(std::ostream& stream) const;
+
+  /// Write the results in CSV format
+  void write_csv(std::ostream& stream) const;
+
+  /// Recorded results
+  const std::vector<Result>& results() const { return m_results; }
+
+private:
+  BenchmarkResults();
+
+  /// Name of the executable, without the path
+  std::string m_executable;
+  /// Number of processes the benchmark was run on
+  Uint m_nb_procs;
+  /// True if this process writes the output file, i.e. rank 0 or a serial run
+  bool m_is_writer;
+
+  std::vector<Result> m_results;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Global fixture to write the benchmark results when all tests have run:
+/// BOOST_GLOBAL_FIXTURE( BenchmarkOutput )
+struct Testing_API BenchmarkOutput
+{
+  ~BenchmarkOutput();
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Any test using this fixture (or a derivative) will be timed, and the result recorded
+/// in BenchmarkResults under the name of the test case.
+class Testing_API BenchmarkFixture
+{
+public:
+  BenchmarkFixture();
+
+  ~BenchmarkFixture();
+
+  /// Restart the timer, to exclude setup code from the measurement
+  void restart_timer();
+
+  /// Set the problem size for this rank, recorded together with the time
+  void set_problem_size(const Uint size);
+
+  /// Scale factor for the benchmark problem size
+  Uint scale() const;
+
+private:
+  Common::Timer m_timer;
+  Uint m_size;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // Testing
+} // Tools
+} // CF
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // CF_Tools_Testing_Benchmark_hpp
@@ -12,8 +12,10 @@
 #include <boost/iostreams/device/back_inserter.hpp>
 
 #include <iostream>
+#include <sstream>
 
 #include "Common/Log.hpp"
+#include "Common/LogAsyncWriter.hpp"
 
 using namespace std;
 using namespace boost;
@@ -64,6 +66,67 @@ BOOST_AUTO_TEST_CASE( FlushBuffer )
   CFinfo << "3. this is flushed CFlog line 2" << CFendl;
 }
 
+/// Messages that are filtered out must not be evaluated
+BOOST_AUTO_TEST_CASE( LevelGating )
+{
+  Logger::instance().set_log_level(WARNING);
+  BOOST_CHECK(Logger::instance().is_enabled(ERROR));
+  BOOST_CHECK(Logger::instance().is_enabled(WARNING));
+  BOOST_CHECK(!Logger::instance().is_enabled(INFO));
+  BOOST_CHECK(!Logger::instance().is_enabled(DEBUG));
+
+  Uint nb_evaluations = 0;
+  CFLogInfo("not evaluated " << ++nb_evaluations << "\n");
+  BOOST_CHECK_EQUAL(nb_evaluations, 0u);
+  CFLogWarn("evaluated " << ++nb_evaluations << "\n");
+  BOOST_CHECK_EQUAL(nb_evaluations, 1u);
+
+  // the plain stream macros are gated as well
+  CFinfo << "not evaluated " << ++nb_evaluations << CFendl;
+  CFdebug << "not evaluated " << ++nb_evaluations << CFendl;
+  BOOST_CHECK_EQUAL(nb_evaluations, 1u);
+
+  // no dangling else: the else branch belongs to the outer if
+  bool else_taken = false;
+  if(nb_evaluations == 0)
+    CFinfo << "not reached" << CFendl;
+  else
+    else_taken = true;
+  BOOST_CHECK(else_taken);
+
+  else_taken = false;
+  if(nb_evaluations == 0)
+    CFLogInfo("not reached");
+  else
+    else_taken = true;
+  BOOST_CHECK(else_taken);
+
+  Logger::instance().set_log_level(INFO);
+  BOOST_CHECK(Logger::instance().is_enabled(INFO));
+}
+
+BOOST_AUTO_TEST_CASE( AsyncWriter )
+{
+  boost::shared_ptr<std::ostringstream> target(new std::ostringstream());
+  LogAsyncWriter& writer = LogAsyncWriter::instance();
+
+  writer.start();
+  BOOST_CHECK(writer.is_running());
+
+  for(Uint i = 0; i != 1000; ++i)
+    writer.write(target, "a");
+  writer.wait();
+  BOOST_CHECK_EQUAL(target->str(), std::string(1000, 'a'));
+
+  CFinfo << "this is written by the background thread" << CFendl;
+
+  // stopping writes the remaining messages
+  writer.write(target, "b");
+  writer.stop();
+  BOOST_CHECK(!writer.is_running());
+  BOOST_CHECK_EQUAL(target->str().size(), 1001u);
+}
+
 //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
@@ -72,7 +72,7 @@ BOOST_FIXTURE_TEST_CASE( init, PECollectiveFixture )
 {
   Comm::PE::instance().init(m_argc,m_argv);
   BOOST_CHECK_EQUAL( Comm::PE::instance().is_active() , true );
-  CFinfo.setFilterRankZero(false);
+  CFinfoStream.setFilterRankZero(false);
   PEProcessSortedExecute(-1,CFinfo << "Proccess " << Comm::PE::instance().rank() << "/" << Comm::PE::instance().size() << " reports in." << CFendl;);
 }
 
@@ -177,7 +177,7 @@ BOOST_FIXTURE_TEST_CASE( all_to_all_ring_topology, PECollectiveFixture )
 BOOST_FIXTURE_TEST_CASE( finalize, PECollectiveFixture )
 {
   PEProcessSortedExecute(-1,CFinfo << "Proccess " << Comm::PE::instance().rank() << "/" << Comm::PE::instance().size() << " says good bye." << CFendl;);
-  CFinfo.setFilterRankZero(true);
+  CFinfoStream.setFilterRankZero(true);
   Comm::PE::instance().finalize();
   BOOST_CHECK_EQUAL( Comm::PE::instance().is_active() , false );
 }
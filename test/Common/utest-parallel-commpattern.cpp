@@ -96,7 +96,7 @@ BOOST_AUTO_TEST_CASE( init )
 {
   Comm::PE::instance().init(m_argc,m_argv);
   BOOST_CHECK_EQUAL( Comm::PE::instance().is_active() , true );
-  CFinfo.setFilterRankZero(false);
+  CFinfoStream.setFilterRankZero(false);
   PEProcessSortedExecute(-1,CFinfo << "Proccess " << Comm::PE::instance().rank() << "/" << Comm::PE::instance().size() << " reports in." << CFendl;);
 }
 
@@ -579,7 +579,7 @@ BOOST_AUTO_TEST_CASE( commpattern_external_synchronization )
 BOOST_AUTO_TEST_CASE( finalize )
 {
   PEProcessSortedExecute(-1,CFinfo << "Proccess " << Comm::PE::instance().rank() << "/" << Comm::PE::instance().size() << " says good bye." << CFendl;);
-  CFinfo.setFilterRankZero(true);
+  CFinfoStream.setFilterRankZero(true);
   Comm::PE::instance().finalize();
   BOOST_CHECK_EQUAL( Comm::PE::instance().is_active() , false );
 }
@@ -14,12 +14,16 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <vector>
+#include <boost/bind.hpp>
 #include <boost/test/unit_test.hpp>
 
 ////////////////////////////////////////////////////////////////////////////////
 
+#include "Common/BasicExceptions.hpp"
 #include "Common/Log.hpp"
+#include "Common/ThreadPool.hpp"
 #include "Common/MPI/PE.hpp"
+#include "Common/MPI/SharedWindow.hpp"
 #include "Common/MPI/debug.hpp"
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -31,6 +35,21 @@ using namespace CF::Common;
 
 ////////////////////////////////////////////////////////////////////////////////
 
+/// Task for the thread pool test, adds the task number to its entry
+void add_task_number(std::vector<Uint>& values, const Uint i)
+{
+  values[i] += i;
+}
+
+/// Task for the thread pool test, fails for one task
+void throw_for_task_3(const Uint i)
+{
+  if(i == 3)
+    throw BadValue(FromHere(), "task 3 fails");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 struct PEFixture
 {
   /// common setup for each test case
@@ -81,6 +100,87 @@ BOOST_AUTO_TEST_CASE( rank_and_size )
   BOOST_CHECK_LT( Comm::PE::instance().rank() , Comm::PE::instance().size() );
 }
 
+BOOST_AUTO_TEST_CASE( node_rank_and_size )
+{
+  BOOST_CHECK_LT( Comm::PE::instance().node_rank() , Comm::PE::instance().node_size() );
+  BOOST_CHECK_LE( Comm::PE::instance().node_size() , Comm::PE::instance().size() );
+  BOOST_CHECK_GE( Comm::PE::instance().nb_threads() , (Uint)1 );
+
+  // the number of processes on all nodes adds up to the total
+  Uint nb_node_roots = Comm::PE::instance().node_rank() == 0 ? Comm::PE::instance().node_size() : 0;
+  Uint total = 0;
+  Comm::PE::instance().all_reduce(Comm::plus(), &nb_node_roots, 1, &total);
+  BOOST_CHECK_EQUAL( total , Comm::PE::instance().size() );
+}
+
+BOOST_AUTO_TEST_CASE( node_ranks )
+{
+  const std::vector<int>& node_ranks = Comm::PE::instance().node_ranks();
+  BOOST_CHECK_EQUAL( node_ranks.size() , Comm::PE::instance().size() );
+  BOOST_CHECK_EQUAL( node_ranks[Comm::PE::instance().rank()] , (int)Comm::PE::instance().node_rank() );
+
+  Uint nb_on_node = 0;
+  for(Uint i = 0; i != node_ranks.size(); ++i)
+  {
+    BOOST_CHECK_LT( node_ranks[i] , (int)Comm::PE::instance().node_size() );
+    if(node_ranks[i] >= 0)
+      ++nb_on_node;
+  }
+  BOOST_CHECK_EQUAL( nb_on_node , Comm::PE::instance().node_size() );
+}
+
+BOOST_AUTO_TEST_CASE( thread_pool )
+{
+  Comm::PE::instance().set_nb_threads(3);
+  ThreadPool& pool = Comm::PE::instance().thread_pool();
+  BOOST_CHECK_EQUAL( pool.size() , 3u );
+
+  // the threads are reused, run many times
+  for(Uint run = 0; run != 100; ++run)
+  {
+    std::vector<Uint> values(17, 1);
+    pool.run(values.size(), boost::bind(add_task_number, boost::ref(values), _1));
+    for(Uint i = 0; i != values.size(); ++i)
+      BOOST_CHECK_EQUAL( values[i] , i+1 );
+  }
+
+  BOOST_CHECK_THROW( pool.run(10, throw_for_task_3), ParallelError );
+
+  // changing the number of threads replaces the pool
+  Comm::PE::instance().set_nb_threads(2);
+  BOOST_CHECK_EQUAL( Comm::PE::instance().thread_pool().size() , 2u );
+  Comm::PE::instance().set_nb_threads(0);
+}
+
+BOOST_AUTO_TEST_CASE( shared_window )
+{
+  if(!Comm::SharedWindow::is_supported())
+    return;
+
+  // each process on the node writes its node rank in a part of its own size
+  const Uint node_rank = Comm::PE::instance().node_rank();
+  Comm::SharedWindow window;
+  window.allocate((node_rank+1)*sizeof(Uint));
+  BOOST_CHECK( window.is_allocated() );
+
+  Uint* local = reinterpret_cast<Uint*>(window.data());
+  for(Uint i = 0; i != node_rank+1; ++i)
+    local[i] = node_rank;
+  window.synchronize();
+
+  // all others read it without any message
+  for(Uint r = 0; r != Comm::PE::instance().node_size(); ++r)
+  {
+    const Uint* other = reinterpret_cast<const Uint*>(window.data(r));
+    for(Uint i = 0; i != r+1; ++i)
+      BOOST_CHECK_EQUAL( other[i] , r );
+  }
+  window.synchronize();
+
+  window.free();
+  BOOST_CHECK( !window.is_allocated() );
+}
+
 BOOST_AUTO_TEST_CASE( finalize )
 {
   PEProcessSortedExecute(-1,CFinfo << "Proccess " << Comm::PE::instance().rank() << "/" << Comm::PE::instance().size() << " says good bye." << CFendl;);
@@ -0,0 +1,93 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test module for CTimings"
+
+#include <boost/test/unit_test.hpp>
+
+#include "Common/CF.hpp"
+#include "Common/CActionDirector.hpp"
+#include "Common/Core.hpp"
+#include "Common/CRoot.hpp"
+#include "Common/CTimings.hpp"
+#include "Common/Log.hpp"
+
+using namespace CF;
+using namespace CF::Common;
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// Action that does nothing, for testing purposes
+struct DummyAction : CAction
+{
+  typedef boost::shared_ptr<DummyAction> Ptr;
+  typedef boost::shared_ptr<DummyAction const> ConstPtr;
+  DummyAction(const std::string& name) : CAction(name) {}
+  static std::string type_name () { return "DummyAction"; }
+  virtual void execute()
+  {
+    // Also timed by the director, this one must not count
+    ScopedTimer outer_timer(*this);
+    BOOST_CHECK(!outer_timer.is_active());
+
+    ScopedTimer timer(*this, "inner");
+    timer.add_bytes(8);
+  }
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE( TimingsSuite )
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Disabled )
+{
+  CTimings& timings = Core::instance().timings();
+  BOOST_CHECK(!timings.is_enabled());
+
+  CActionDirector& director = Core::instance().root().create_component<CActionDirector>("director");
+  director << director.create_component<DummyAction>("action");
+  director.execute();
+
+  BOOST_CHECK(timings.timings().empty());
+}
+
+BOOST_AUTO_TEST_CASE( Enabled )
+{
+  CTimings& timings = Core::instance().timings();
+  timings.configure_option("enabled", true);
+  BOOST_CHECK(timings.is_enabled());
+
+  CActionDirector& director = Core::instance().root().get_child("director").as_type<CActionDirector>();
+  director.execute();
+  director.execute();
+
+  const std::string action_path = director.get_child("action").uri().path();
+  const TimingData& action_data = timings.data(action_path);
+  BOOST_CHECK_EQUAL(action_data.calls, 2u);
+  BOOST_CHECK(action_data.time >= 0.);
+
+  const TimingData& inner_data = timings.data(action_path + ":inner");
+  BOOST_CHECK_EQUAL(inner_data.calls, 2u);
+  BOOST_CHECK_EQUAL(inner_data.bytes, 16u);
+
+  const std::string report = timings.report();
+  CFinfo << report << CFendl;
+  BOOST_CHECK(report.find("action:inner") != std::string::npos);
+
+  timings.reset();
+  BOOST_CHECK_EQUAL(timings.data(action_path).calls, 0u);
+
+  timings.configure_option("enabled", false);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+//////////////////////////////////////////////////////////////////////////////
@@ -11,6 +11,7 @@
 
 #include "Common/Log.hpp"
 #include "Common/Core.hpp"
+#include "Common/StringConversion.hpp"
 #include "Common/CRoot.hpp"
 
 #include "Common/FindComponents.hpp"
@@ -211,6 +212,130 @@ BOOST_AUTO_TEST_CASE( build_faces_rectangle )
 
 //////////////////////////////////////////////////////////////////////////////
 
+BOOST_AUTO_TEST_CASE( build_faces_threaded )
+{
+  // Same mesh, with faces built on 1 and on 4 threads
+  std::vector<CMesh::Ptr> meshes;
+  for (Uint nb_threads=1; nb_threads<=4; nb_threads+=3)
+  {
+    CMesh::Ptr tmesh = Core::instance().root().create_component_ptr<CMesh>("threaded_mesh_"+to_str(nb_threads));
+    CSimpleMeshGenerator::create_rectangle(*tmesh, 10. , 10., 20 , 15 );
+
+    CBuildFaces::Ptr facebuilder = allocate_component<CBuildFaces>("facebuilder");
+    facebuilder->configure_option("nb_threads",nb_threads);
+    facebuilder->set_mesh(tmesh);
+    facebuilder->execute();
+    meshes.push_back(tmesh);
+  }
+
+  // 20x15 quads have 19*15 + 20*14 inner faces. The outer faces are all matched with the boundary regions.
+  for (Uint i=0; i<meshes.size(); ++i)
+  {
+    CRegion& inner_faces_region = find_component_recursively_with_name<CRegion>(meshes[i]->topology(),Mesh::Tags::inner_faces());
+    BOOST_CHECK_EQUAL(inner_faces_region.recursive_elements_count(), 19u*15u + 20u*14u);
+    BOOST_CHECK(is_null(find_component_ptr_recursively_with_name<CRegion>(meshes[i]->topology(),Mesh::Tags::outer_faces())));
+  }
+
+  // The faces are numbered the same way, regardless of the number of threads
+  CFaceCellConnectivity& f2c_1 = find_component<CFaceCellConnectivity>(find_component<CCellFaces>(find_component_recursively_with_name<CRegion>(meshes[0]->topology(),Mesh::Tags::inner_faces())));
+  CFaceCellConnectivity& f2c_4 = find_component<CFaceCellConnectivity>(find_component<CCellFaces>(find_component_recursively_with_name<CRegion>(meshes[1]->topology(),Mesh::Tags::inner_faces())));
+  BOOST_CHECK_EQUAL(f2c_1.size(), f2c_4.size());
+  for (Uint face=0; face<f2c_1.size(); ++face)
+  {
+    BOOST_CHECK_EQUAL(f2c_1.connectivity()[face][0], f2c_4.connectivity()[face][0]);
+    BOOST_CHECK_EQUAL(f2c_1.connectivity()[face][1], f2c_4.connectivity()[face][1]);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( build_interfaces_threaded )
+{
+  // The gas region (x <= 4) and the liquid region (x >= 4) share the 2 faces on the line x = 4
+  std::vector<CMesh::Ptr> meshes;
+  for (Uint nb_threads=1; nb_threads<=4; nb_threads+=3)
+  {
+    CMesh::Ptr imesh = Core::instance().root().create_component_ptr<CMesh>("interface_mesh_"+to_str(nb_threads));
+    CMeshReader::Ptr meshreader = build_component_abstract_type<CMeshReader>("CF.Mesh.Neu.CReader","meshreader");
+    meshreader->read_mesh_into("quadtriag.neu",*imesh);
+
+    CBuildFaces::Ptr facebuilder = allocate_component<CBuildFaces>("facebuilder");
+    facebuilder->configure_option("nb_threads",nb_threads);
+    facebuilder->set_mesh(imesh);
+    facebuilder->execute();
+    meshes.push_back(imesh);
+  }
+
+  std::vector<CFaceCellConnectivity::Ptr> interface_f2c;
+  for (Uint i=0; i<meshes.size(); ++i)
+  {
+    std::vector<CRegion::Ptr> interfaces = range_to_vector(find_components_recursively_with_tag<CRegion>(meshes[i]->topology(),Mesh::Tags::interface()));
+    BOOST_CHECK_EQUAL(interfaces.size(), 1u);
+    BOOST_CHECK_EQUAL(interfaces[0]->recursive_elements_count(), 2u);
+
+    CCellFaces& interface_faces = find_component<CCellFaces>(*interfaces[0]);
+    CFaceCellConnectivity& f2c = find_component<CFaceCellConnectivity>(interface_faces);
+    interface_f2c.push_back(f2c.as_ptr<CFaceCellConnectivity>());
+    BOOST_CHECK_EQUAL(f2c.size(), 2u);
+
+    Component::Ptr cells;
+    Uint cell_idx(0);
+    for (Uint face=0; face<f2c.size(); ++face)
+    {
+      const RealMatrix face_coordinates = interface_faces.get_coordinates(face);
+      for (Uint n=0; n<face_coordinates.rows(); ++n)
+        BOOST_CHECK_EQUAL(face_coordinates(n,XX), 4.);
+
+      // One side in each region, and all face nodes are nodes of the cell on that side
+      std::vector<std::string> side_regions;
+      for (Uint side=0; side<2; ++side)
+      {
+        boost::tie(cells,cell_idx) = f2c.lookup().location(f2c.connectivity()[face][side]);
+        side_regions.push_back(cells->parent().name());
+
+        const RealMatrix cell_coordinates = cells->as_type<CElements>().get_coordinates(cell_idx);
+        for (Uint n=0; n<face_coordinates.rows(); ++n)
+        {
+          bool match_found = false;
+          for (Uint i=0; i<cell_coordinates.rows(); ++i)
+          {
+            if (cell_coordinates.row(i) == face_coordinates.row(n))
+            {
+              match_found = true;
+              break;
+            }
+          }
+          BOOST_CHECK(match_found);
+        }
+      }
+      std::sort(side_regions.begin(), side_regions.end());
+      BOOST_CHECK_EQUAL(side_regions[0], "gas");
+      BOOST_CHECK_EQUAL(side_regions[1], "liquid");
+    }
+
+    // The interface faces are no longer inner faces of the regions
+    boost_foreach(CFaceCellConnectivity& region_f2c, find_components_recursively_with_tag<CFaceCellConnectivity>(meshes[i]->topology(),Mesh::Tags::inner_faces()))
+    {
+      for (Uint face=0; face<region_f2c.size(); ++face)
+      {
+        if (region_f2c.is_bdry_face()[face])
+          continue;
+        boost::tie(cells,cell_idx) = region_f2c.lookup().location(region_f2c.connectivity()[face][0]);
+        const std::string region1 = cells->parent().name();
+        boost::tie(cells,cell_idx) = region_f2c.lookup().location(region_f2c.connectivity()[face][1]);
+        BOOST_CHECK_EQUAL(region1, cells->parent().name());
+      }
+    }
+  }
+
+  // Both sides are numbered the same way, regardless of the number of threads
+  for (Uint face=0; face<interface_f2c[0]->size(); ++face)
+  {
+    BOOST_CHECK_EQUAL(interface_f2c[0]->connectivity()[face][0], interface_f2c[1]->connectivity()[face][0]);
+    BOOST_CHECK_EQUAL(interface_f2c[0]->connectivity()[face][1], interface_f2c[1]->connectivity()[face][1]);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 ////////////////////////////////////////////////////////////////////////////////
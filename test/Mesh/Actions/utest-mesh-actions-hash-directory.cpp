@@ -0,0 +1,80 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Tests Mesh::Actions::HashDirectory"
+
+#include <boost/test/unit_test.hpp>
+
+#include "Common/Core.hpp"
+#include "Common/MPI/PE.hpp"
+
+#include "Math/Consts.hpp"
+
+#include "Mesh/Actions/HashDirectory.hpp"
+
+using namespace CF;
+using namespace CF::Common;
+using namespace CF::Mesh::Actions;
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE( TestHashDirectory_TestSuite )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Init )
+{
+  Core::instance().initiate(boost::unit_test::framework::master_test_suite().argc, boost::unit_test::framework::master_test_suite().argv);
+  Comm::PE::instance().init(boost::unit_test::framework::master_test_suite().argc, boost::unit_test::framework::master_test_suite().argv);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Resolve )
+{
+  const Uint rank = Comm::PE::instance().rank();
+  const Uint nb_procs = Comm::PE::instance().size();
+  const Uint next_rank = (rank+1) % nb_procs;
+  const Uint nb_owned = 10;
+
+  HashDirectory directory;
+
+  // hashes are spread over all home ranks
+  for (Uint i=0; i<nb_owned; ++i)
+    directory.add_owned(1000*rank + 7*i, nb_owned*rank + i);
+
+  // ghosts owned by the next rank, and one hash that nobody owns
+  for (Uint i=0; i<nb_owned; ++i)
+    directory.add_ghost(1000*next_rank + 7*i);
+  directory.add_ghost(1000*nb_procs + 1);
+
+  directory.resolve();
+
+  BOOST_REQUIRE_EQUAL(directory.ghost_glb_idx().size(), nb_owned+1);
+  BOOST_REQUIRE_EQUAL(directory.ghost_rank().size(), nb_owned+1);
+  for (Uint i=0; i<nb_owned; ++i)
+  {
+    BOOST_CHECK_EQUAL(directory.ghost_glb_idx()[i], nb_owned*next_rank + i);
+    BOOST_CHECK_EQUAL(directory.ghost_rank()[i], next_rank);
+  }
+  BOOST_CHECK_EQUAL(directory.ghost_glb_idx()[nb_owned], Math::Consts::uint_max());
+  BOOST_CHECK_EQUAL(directory.ghost_rank()[nb_owned], Math::Consts::uint_max());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Finalize )
+{
+  Comm::PE::instance().finalize();
+  Core::instance().terminate();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,199 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test module for CF::Mesh::BlockMesh::CStructuredElements"
+
+#include <algorithm>
+#include <iterator>
+
+#include <boost/bind.hpp>
+#include <boost/test/unit_test.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "Common/Core.hpp"
+#include "Common/CRoot.hpp"
+#include "Common/FindComponents.hpp"
+
+#include "Common/MPI/PE.hpp"
+
+#include "Mesh/CElements.hpp"
+#include "Mesh/CMesh.hpp"
+#include "Mesh/Geometry.hpp"
+
+#include "Mesh/BlockMesh/BlockData.hpp"
+#include "Mesh/BlockMesh/CStructuredElements.hpp"
+
+#include "Mesh/SF/Hexa3DLagrangeP1.hpp"
+
+#include "Tools/MeshGeneration/MeshGeneration.hpp"
+
+using namespace CF;
+using namespace CF::Common;
+using namespace CF::Mesh;
+using namespace CF::Mesh::BlockMesh;
+
+//////////////////////////////////////////////////////////////////////////////
+
+struct StructuredFixture
+{
+  StructuredFixture()
+  {
+    if(!Comm::PE::instance().is_active())
+      Comm::PE::instance().init(boost::unit_test::framework::master_test_suite().argc, boost::unit_test::framework::master_test_suite().argv);
+
+    Tools::MeshGeneration::create_channel_3d(blocks, 10., 0.5, 5., 5, 4, 3, 0.1);
+  }
+
+  BlockData blocks;
+};
+
+/// Compares the nodes passed by CStructuredElements::for_each_element with an explicit connectivity table
+struct CheckNodes
+{
+  CheckNodes(const CTable<Uint>& connectivity) : explicit_connectivity(connectivity), nb_checked(0) {}
+
+  void operator()(const Uint elem_idx, const Uint* nodes)
+  {
+    CTable<Uint>::ConstRow explicit_row = explicit_connectivity[elem_idx];
+    for(Uint i = 0; i != SF::Hexa3DLagrangeP1::nb_nodes; ++i)
+      BOOST_CHECK_EQUAL(nodes[i], explicit_row[i]);
+    ++nb_checked;
+  }
+
+  const CTable<Uint>& explicit_connectivity;
+  Uint nb_checked;
+};
+
+/// Copy the nodes of all elements, using get_nodes
+void read_nodes(const CElements& elements, std::vector<Uint>& nodes)
+{
+  const Uint nb_elems = elements.size();
+  for(Uint elem = 0; elem != nb_elems; ++elem)
+  {
+    CTable<Uint>::ConstRow row = elements.get_nodes(elem);
+    nodes.insert(nodes.end(), row.begin(), row.end());
+  }
+}
+
+BOOST_FIXTURE_TEST_SUITE( BlockMeshStructured, StructuredFixture )
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( CompareExplicit )
+{
+  CMesh& explicit_mesh = Core::instance().root().create_component<CMesh>("explicit_mesh");
+  CMesh& structured_mesh = Core::instance().root().create_component<CMesh>("structured_mesh");
+
+  build_mesh(blocks, explicit_mesh);
+  build_structured_mesh(blocks, structured_mesh);
+
+  const CElements& explicit_elements = find_component_recursively_with_filter<CElements>(explicit_mesh, IsElementsVolume());
+  const CStructuredElements& structured_elements = find_component_recursively<CStructuredElements>(structured_mesh);
+
+  BOOST_CHECK_EQUAL(structured_elements.size(), explicit_elements.size());
+  BOOST_CHECK_EQUAL(structured_elements.geometry().size(), explicit_elements.geometry().size());
+
+  const Uint nb_elems = explicit_elements.size();
+  for(Uint elem = 0; elem != nb_elems; ++elem)
+  {
+    const RealMatrix explicit_coords = explicit_elements.get_coordinates(elem);
+    const RealMatrix structured_coords = structured_elements.get_coordinates(elem);
+    BOOST_CHECK_SMALL((explicit_coords - structured_coords).norm(), 1e-12);
+  }
+
+  // Strided loops over the blocks
+  CheckNodes check_nodes(explicit_elements.node_connectivity());
+  const Uint blocks_end = structured_elements.first_block() + structured_elements.nb_blocks();
+  for(Uint block = structured_elements.first_block(); block != blocks_end; ++block)
+    structured_elements.for_each_element(block, check_nodes);
+  BOOST_CHECK_EQUAL(check_nodes.nb_checked, nb_elems);
+
+  // No connectivity table is stored until an algorithm accesses it
+  BOOST_CHECK(!structured_elements.is_connectivity_stored());
+
+  const CTable<Uint>& structured_connectivity = structured_elements.node_connectivity();
+  BOOST_CHECK(structured_elements.is_connectivity_stored());
+  BOOST_CHECK(structured_connectivity.array() == explicit_elements.node_connectivity().array());
+  for(Uint elem = 0; elem != nb_elems; ++elem)
+  {
+    CTable<Uint>::ConstRow explicit_row = explicit_elements.node_connectivity()[elem];
+    CTable<Uint>::ConstRow structured_row = structured_elements.get_nodes(elem);
+    for(Uint i = 0; i != SF::Hexa3DLagrangeP1::nb_nodes; ++i)
+      BOOST_CHECK_EQUAL(structured_row[i], explicit_row[i]);
+  }
+
+  // The explicit table can be recreated on demand
+  CTable<Uint>::Ptr connectivity = allocate_component< CTable<Uint> >("connectivity");
+  structured_elements.make_connectivity(*connectivity);
+  BOOST_CHECK(connectivity->array() == explicit_elements.node_connectivity().array());
+}
+
+BOOST_AUTO_TEST_CASE( ThreadedFirstAccess )
+{
+  CMesh& mesh = Core::instance().root().create_component<CMesh>("threaded_mesh");
+  build_structured_mesh(blocks, mesh);
+  const CStructuredElements& elements = find_component_recursively<CStructuredElements>(mesh);
+  BOOST_CHECK(!elements.is_connectivity_stored());
+
+  // All threads trigger the creation of the connectivity table at the same time
+  const Uint nb_threads = 4;
+  std::vector< std::vector<Uint> > nodes(nb_threads);
+  boost::thread_group threads;
+  for(Uint i = 0; i != nb_threads; ++i)
+    threads.create_thread(boost::bind(&read_nodes, boost::cref(elements), boost::ref(nodes[i])));
+  threads.join_all();
+
+  CTable<Uint>::Ptr connectivity = allocate_component< CTable<Uint> >("connectivity");
+  elements.make_connectivity(*connectivity);
+  const std::vector<Uint> expected(connectivity->array().data(), connectivity->array().data() + connectivity->array().num_elements());
+  for(Uint i = 0; i != nb_threads; ++i)
+    BOOST_CHECK(nodes[i] == expected);
+}
+
+BOOST_AUTO_TEST_CASE( IndexArithmetic )
+{
+  CMesh& mesh = find_component_with_name<CMesh>(Core::instance().root(), "structured_mesh");
+  const CStructuredElements& elements = find_component_recursively<CStructuredElements>(mesh);
+  const CTable<Real>& coords = elements.geometry().coordinates();
+
+  const Uint nb_elems = elements.size();
+  for(Uint elem = 0; elem != nb_elems; ++elem)
+  {
+    Uint block, i, j, k;
+    elements.element_ijk(elem, block, i, j, k);
+    BOOST_CHECK_EQUAL(elements.element_index(block, i, j, k), elem);
+
+    // On-the-fly coordinates must match the stored ones
+    RealVector node_coords;
+    elements.compute_node_coordinates(block, i, j, k, node_coords);
+    CTable<Real>::ConstRow stored = coords[elements.node_index(block, i, j, k)];
+    for(Uint d = 0; d != DIM_3D; ++d)
+      BOOST_CHECK_SMALL(node_coords[d] - stored[d], 1e-12);
+
+    // Neighbours share a face, i.e. 4 nodes
+    for(Uint face = 0; face != 6; ++face)
+    {
+      const Uint adjacent = elements.adjacent_element(elem, face);
+      if(adjacent == nb_elems)
+        continue;
+
+      std::vector<Uint> elem_nodes(elements.get_nodes(elem).begin(), elements.get_nodes(elem).end());
+      std::vector<Uint> adj_nodes(elements.get_nodes(adjacent).begin(), elements.get_nodes(adjacent).end());
+      std::sort(elem_nodes.begin(), elem_nodes.end());
+      std::sort(adj_nodes.begin(), adj_nodes.end());
+      std::vector<Uint> shared;
+      std::set_intersection(elem_nodes.begin(), elem_nodes.end(), adj_nodes.begin(), adj_nodes.end(), std::back_inserter(shared));
+      BOOST_CHECK_EQUAL(shared.size(), 4u);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
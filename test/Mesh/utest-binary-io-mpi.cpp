@@ -0,0 +1,130 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Parallel test module for CF::Mesh::Binary"
+
+#include <boost/test/unit_test.hpp>
+
+#include "Common/Core.hpp"
+#include "Common/CRoot.hpp"
+#include "Common/FindComponents.hpp"
+#include "Common/Foreach.hpp"
+
+#include "Common/MPI/PE.hpp"
+
+#include "Mesh/CElements.hpp"
+#include "Mesh/CMesh.hpp"
+#include "Mesh/CMeshGenerator.hpp"
+#include "Mesh/CMeshReader.hpp"
+#include "Mesh/CMeshTransformer.hpp"
+#include "Mesh/CMeshWriter.hpp"
+#include "Mesh/CRegion.hpp"
+#include "Mesh/Field.hpp"
+#include "Mesh/Geometry.hpp"
+
+using namespace CF;
+using namespace CF::Mesh;
+using namespace CF::Common;
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE( BinaryMPISuite )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( init_mpi )
+{
+  Core::instance().initiate(boost::unit_test::framework::master_test_suite().argc, boost::unit_test::framework::master_test_suite().argv);
+  Comm::PE::instance().init(boost::unit_test::framework::master_test_suite().argc, boost::unit_test::framework::master_test_suite().argv);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( WriteReadParallel )
+{
+  CRoot& root = Core::instance().root();
+  const Uint nb_procs = Comm::PE::instance().size();
+
+  std::vector<Uint> nb_cells(2);
+  std::vector<Real> lengths(2, 1.);
+  nb_cells[XX] = 10 * nb_procs;
+  nb_cells[YY] = 10;
+
+  CMeshGenerator::Ptr generator = build_component_abstract_type<CMeshGenerator>("CF.Mesh.CSimpleMeshGenerator","generator");
+  generator->configure_option("parent", URI("//Root"));
+  generator->configure_option("name", std::string("mesh"));
+  generator->configure_option("nb_cells", nb_cells);
+  generator->configure_option("lengths", lengths);
+  generator->execute();
+
+  CMesh& mesh = root.get_child("mesh").as_type<CMesh>();
+  build_component_abstract_type<CMeshTransformer>("CF.Mesh.Actions.CGlobalNumbering","glb_numbering")->transform(mesh);
+
+  // Field values are a function of the global node index, so they are the same on all ranks sharing a node
+  Field& field = mesh.geometry().create_field("solution", "u[scalar],v[vector]");
+  field.parallelize();
+  for(Uint i = 0; i != field.size(); ++i)
+    for(Uint j = 0; j != field.row_size(); ++j)
+      field[i][j] = static_cast<Real>(mesh.geometry().glb_idx()[i]*field.row_size() + j);
+
+  CMeshWriter::Ptr writer = build_component_abstract_type<CMeshWriter>("CF.Mesh.Binary.CWriter","meshwriter");
+  writer->write_from_to(mesh, "checkpoint-mpi.cfbin");
+
+  CMesh& restored = root.create_component<CMesh>("restored");
+  CMeshReader::Ptr reader = build_component_abstract_type<CMeshReader>("CF.Mesh.Binary.CReader","meshreader");
+  reader->read_mesh_into("checkpoint-mpi.cfbin", restored);
+
+  BOOST_CHECK_EQUAL(restored.dimension(), mesh.dimension());
+  BOOST_CHECK(restored.geometry().coordinates().array() == mesh.geometry().coordinates().array());
+  BOOST_CHECK(restored.geometry().glb_idx().array() == mesh.geometry().glb_idx().array());
+  BOOST_CHECK(restored.geometry().rank().array() == mesh.geometry().rank().array());
+
+  Field& restored_field = restored.geometry().field("solution");
+  BOOST_CHECK(restored_field.array() == field.array());
+
+  // The restored field is parallel again: wipe the ghosts and get them back through synchronization
+  for(Uint i = 0; i != restored_field.size(); ++i)
+  {
+    if(restored.geometry().is_ghost(i))
+      for(Uint j = 0; j != restored_field.row_size(); ++j)
+        restored_field[i][j] = -1.;
+  }
+  restored_field.synchronize();
+  BOOST_CHECK(restored_field.array() == field.array());
+
+  std::vector<const CElements*> restored_elements_list;
+  boost_foreach(const CElements& restored_elements, find_components_recursively<CElements>(restored.topology()))
+    restored_elements_list.push_back(&restored_elements);
+
+  Uint block = 0;
+  boost_foreach(const CElements& elements, find_components_recursively<CElements>(mesh.topology()))
+  {
+    BOOST_REQUIRE(block < restored_elements_list.size());
+    const CElements& restored_elements = *restored_elements_list[block++];
+    BOOST_CHECK_EQUAL(restored_elements.name(), elements.name());
+    BOOST_CHECK_EQUAL(restored_elements.parent().name(), elements.parent().name());
+    BOOST_CHECK_EQUAL(restored_elements.derived_type_name(), elements.derived_type_name());
+    BOOST_CHECK(restored_elements.node_connectivity().array() == elements.node_connectivity().array());
+    BOOST_CHECK(restored_elements.glb_idx().array() == elements.glb_idx().array());
+    BOOST_CHECK(restored_elements.rank().array() == elements.rank().array());
+  }
+  BOOST_CHECK_EQUAL(block, restored_elements_list.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( finalize_mpi )
+{
+  Comm::PE::instance().finalize();
+  Core::instance().terminate();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,121 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test module for CF::Mesh::Binary"
+
+#include <boost/test/unit_test.hpp>
+
+#include "Common/BoostFilesystem.hpp"
+
+#include "Common/Core.hpp"
+#include "Common/BasicExceptions.hpp"
+#include "Common/CRoot.hpp"
+#include "Common/FindComponents.hpp"
+
+#include "Mesh/CElements.hpp"
+#include "Mesh/CMesh.hpp"
+#include "Mesh/CMeshReader.hpp"
+#include "Mesh/CMeshWriter.hpp"
+#include "Mesh/CRegion.hpp"
+#include "Mesh/Field.hpp"
+#include "Mesh/Geometry.hpp"
+
+#include "Tools/MeshGeneration/MeshGeneration.hpp"
+
+using namespace CF;
+using namespace CF::Mesh;
+using namespace CF::Common;
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE( BinarySuite )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( WriteRead )
+{
+  CRoot& root = Core::instance().root();
+
+  CMesh& mesh = root.create_component<CMesh>("mesh");
+  Tools::MeshGeneration::create_rectangle(mesh, 5., 5., 5, 5);
+
+  Field& field = mesh.geometry().create_field("solution", "u[scalar],v[vector]");
+  for(Uint i = 0; i != field.size(); ++i)
+    for(Uint j = 0; j != field.row_size(); ++j)
+      field[i][j] = static_cast<Real>(i*field.row_size() + j);
+
+  SinglePrecisionField& single_field = mesh.geometry().create_field<SinglePrecisionField>("wave_speed");
+  for(Uint i = 0; i != single_field.size(); ++i)
+    single_field[i][0] = static_cast<float>(i) + 0.5f;
+
+  CMeshWriter::Ptr writer = build_component_abstract_type<CMeshWriter>("CF.Mesh.Binary.CWriter","meshwriter");
+  writer->write_from_to(mesh, "checkpoint.cfbin");
+
+  CMesh& restored = root.create_component<CMesh>("restored");
+  CMeshReader::Ptr reader = build_component_abstract_type<CMeshReader>("CF.Mesh.Binary.CReader","meshreader");
+  reader->read_mesh_into("checkpoint.cfbin", restored);
+
+  BOOST_CHECK_EQUAL(restored.dimension(), mesh.dimension());
+  BOOST_CHECK(restored.geometry().coordinates().array() == mesh.geometry().coordinates().array());
+  BOOST_CHECK(restored.geometry().glb_idx().array() == mesh.geometry().glb_idx().array());
+  BOOST_CHECK(restored.geometry().rank().array() == mesh.geometry().rank().array());
+
+  const Field& restored_field = restored.geometry().field("solution");
+  BOOST_CHECK_EQUAL(restored_field.nb_vars(), 2u);
+  BOOST_CHECK(restored_field.array() == field.array());
+
+  // Single precision fields are restored in single precision
+  const SinglePrecisionField& restored_single_field = restored.geometry().get_child("wave_speed").as_type<SinglePrecisionField>();
+  BOOST_CHECK(restored_single_field.array() == single_field.array());
+
+  std::vector<const CElements*> restored_elements_list;
+  BOOST_FOREACH(const CElements& restored_elements, find_components_recursively<CElements>(restored.topology()))
+    restored_elements_list.push_back(&restored_elements);
+
+  Uint block = 0;
+  BOOST_FOREACH(const CElements& elements, find_components_recursively<CElements>(mesh.topology()))
+  {
+    BOOST_REQUIRE(block < restored_elements_list.size());
+    const CElements& restored_elements = *restored_elements_list[block++];
+    BOOST_CHECK_EQUAL(restored_elements.name(), elements.name());
+    BOOST_CHECK_EQUAL(restored_elements.parent().name(), elements.parent().name());
+    BOOST_CHECK_EQUAL(restored_elements.derived_type_name(), elements.derived_type_name());
+    BOOST_CHECK_EQUAL(restored_elements.element_type().derived_type_name(), elements.element_type().derived_type_name());
+    BOOST_CHECK(restored_elements.node_connectivity().array() == elements.node_connectivity().array());
+    BOOST_CHECK(restored_elements.glb_idx().array() == elements.glb_idx().array());
+  }
+  BOOST_CHECK_EQUAL(block, restored_elements_list.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( IndexMismatch )
+{
+  CRoot& root = Core::instance().root();
+
+  // Change the number of elements listed in the index for rank 0, which must be detected when reading the data file
+  {
+    boost::filesystem::fstream index_file;
+    index_file.open("checkpoint.cfbin", std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+    BOOST_REQUIRE(index_file);
+    // magic, version, sizeof(Uint), sizeof(Real), number of processes and number of nodes come first
+    index_file.seekp(8 + 5*sizeof(Uint));
+    const Uint wrong_nb_elements = 1;
+    index_file.write(reinterpret_cast<const char*>(&wrong_nb_elements), sizeof(Uint));
+    index_file.close();
+  }
+
+  CMesh& restored = root.create_component<CMesh>("restored_mismatch");
+  CMeshReader::Ptr reader = build_component_abstract_type<CMeshReader>("CF.Mesh.Binary.CReader","meshreader_mismatch");
+  BOOST_CHECK_THROW(reader->read_mesh_into("checkpoint.cfbin", restored), FileFormatError);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,217 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test module for parallel output of CF::Mesh::CGNS::CWriter"
+
+#include <boost/test/unit_test.hpp>
+
+#include "Common/Core.hpp"
+#include "Common/CRoot.hpp"
+#include "Common/FindComponents.hpp"
+#include "Common/Foreach.hpp"
+
+#include "Common/MPI/PE.hpp"
+
+#include "Mesh/CElements.hpp"
+#include "Mesh/CMesh.hpp"
+#include "Mesh/CMeshReader.hpp"
+#include "Mesh/CMeshWriter.hpp"
+#include "Mesh/CMeshTransformer.hpp"
+#include "Mesh/CRegion.hpp"
+#include "Mesh/Field.hpp"
+#include "Mesh/Geometry.hpp"
+
+#include "Mesh/CGNS/Shared.hpp"
+
+using namespace CF;
+using namespace CF::Mesh;
+using namespace CF::Common;
+using namespace CF::Mesh::CGNS;
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct CGNSWriterMPIFixture
+{
+  CGNSWriterMPIFixture()
+  {
+    m_argc = boost::unit_test::framework::master_test_suite().argc;
+    m_argv = boost::unit_test::framework::master_test_suite().argv;
+  }
+
+  int    m_argc;
+  char** m_argv;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( CGNSWriterMPISuite, CGNSWriterMPIFixture )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( init_mpi )
+{
+  Core::instance().initiate(m_argc,m_argv);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( WriteSharedFile )
+{
+  CMesh& mesh = Core::instance().root().create_component<CMesh>("mesh");
+  build_component_abstract_type<CMeshReader>("CF.Mesh.Gmsh.CReader","meshreader")->read_mesh_into("rectangle-tg-p1.msh",mesh);
+  build_component_abstract_type<CMeshTransformer>("CF.Mesh.Actions.CGlobalNumbering","glb_numbering")->transform(mesh);
+
+  Field& field = mesh.geometry().create_field("solution", "u[scalar]");
+  for(Uint i = 0; i != field.size(); ++i)
+    field[i][0] = static_cast<Real>(mesh.geometry().glb_idx()[i]);
+
+  CMeshWriter::Ptr writer = build_component_abstract_type<CMeshWriter>("CF.Mesh.CGNS.CWriter","meshwriter");
+  std::vector<Field::Ptr> fields(1, field.as_ptr<Field>());
+  writer->set_fields(fields);
+  writer->configure_option("write_solution", true);
+  writer->write_from_to(mesh, "rectangle-tg-p1-mpi.cgns");
+
+  // Count the owned entities, which must end up in the shared file
+  Uint nb_owned_nodes = 0;
+  for(Uint i = 0; i != mesh.geometry().size(); ++i)
+    if(!mesh.geometry().is_ghost(i))
+      ++nb_owned_nodes;
+
+  Uint nb_owned_elems = 0;
+  const CRegion& zone_region = find_component<CRegion>(mesh.topology());
+  boost_foreach(const CElements& elements, find_components_recursively<CElements>(zone_region))
+    for(Uint i = 0; i != elements.size(); ++i)
+      if(!elements.is_ghost(i))
+        ++nb_owned_elems;
+
+  std::vector<Uint> all_nb_owned_nodes, all_nb_owned_elems;
+  Comm::PE::instance().all_gather(nb_owned_nodes, all_nb_owned_nodes);
+  Comm::PE::instance().all_gather(nb_owned_elems, all_nb_owned_elems);
+
+  if(Comm::PE::instance().rank() == 0)
+  {
+    Uint total_nb_nodes = 0;
+    Uint total_nb_elems = 0;
+    for(Uint i = 0; i != all_nb_owned_nodes.size(); ++i)
+    {
+      total_nb_nodes += all_nb_owned_nodes[i];
+      total_nb_elems += all_nb_owned_elems[i];
+    }
+
+    int file_idx;
+    char zone_name[CGNS_CHAR_MAX];
+    int size[3];
+    CALL_CGNS(cg_open("rectangle-tg-p1-mpi.cgns", CG_MODE_READ, &file_idx));
+    CALL_CGNS(cg_zone_read(file_idx, 1, 1, zone_name, size));
+    BOOST_CHECK_EQUAL(zone_name, zone_region.name());
+    BOOST_CHECK_EQUAL(static_cast<Uint>(size[CGNS_VERT_IDX]), total_nb_nodes);
+    BOOST_CHECK_EQUAL(static_cast<Uint>(size[CGNS_CELL_IDX]), total_nb_elems);
+
+    // The solution was set to the global index, so it must increase by one for each vertex
+    std::vector<Real> solution(size[CGNS_VERT_IDX]);
+    int range_min = 1;
+    int range_max = size[CGNS_VERT_IDX];
+    CALL_CGNS(cg_field_read(file_idx, 1, 1, 1, "u", RealDouble, &range_min, &range_max, &solution[0]));
+    for(Uint i = 0; i != solution.size(); ++i)
+      BOOST_CHECK_EQUAL(solution[i], static_cast<Real>(i));
+
+    CALL_CGNS(cg_close(file_idx));
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( ReadSharedFile )
+{
+  // Each rank reads a part of the file, in small chunks to test the chunked reading
+  CMesh& mesh = Core::instance().root().create_component<CMesh>("read_mesh");
+  CMeshReader::Ptr reader = build_component_abstract_type<CMeshReader>("CF.Mesh.CGNS.CReader","cgnsreader");
+  reader->configure_option("chunk_size", 7u);
+  reader->configure_option("read_distributed", true);
+  reader->read_mesh_into("rectangle-tg-p1-mpi.cgns",mesh);
+
+  Uint nb_owned_nodes = 0;
+  for(Uint i = 0; i != mesh.geometry().size(); ++i)
+    if(!mesh.geometry().is_ghost(i))
+      ++nb_owned_nodes;
+
+  Uint nb_cells = 0;
+  boost_foreach(const CElements& elements, find_components_recursively_with_filter<CElements>(mesh.topology(), IsElementsVolume()))
+  {
+    nb_cells += elements.size();
+
+    // elements are only read by one rank, which owns them
+    for(Uint e = 0; e != elements.size(); ++e)
+      BOOST_CHECK(!elements.is_ghost(e));
+
+    // all nodes used by the elements must be available on this rank
+    for(Uint e = 0; e != elements.size(); ++e)
+      for(Uint n = 0; n != elements.node_connectivity().row_size(); ++n)
+        BOOST_CHECK(elements.node_connectivity()[e][n] < mesh.geometry().size());
+  }
+
+  Uint total_nb_nodes = 0;
+  Uint total_nb_cells = 0;
+  Comm::PE::instance().all_reduce(Comm::plus(), &nb_owned_nodes, 1, &total_nb_nodes);
+  Comm::PE::instance().all_reduce(Comm::plus(), &nb_cells, 1, &total_nb_cells);
+
+  int file_idx;
+  char zone_name[CGNS_CHAR_MAX];
+  int size[3];
+  CALL_CGNS(cg_open("rectangle-tg-p1-mpi.cgns", CG_MODE_READ, &file_idx));
+  CALL_CGNS(cg_zone_read(file_idx, 1, 1, zone_name, size));
+  CALL_CGNS(cg_close(file_idx));
+
+  BOOST_CHECK_EQUAL(static_cast<Uint>(size[CGNS_VERT_IDX]), total_nb_nodes);
+  BOOST_CHECK_EQUAL(static_cast<Uint>(size[CGNS_CELL_IDX]), total_nb_cells);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( ReadReplicated )
+{
+  // By default every rank reads the complete file, and rank 0 owns everything
+  CMesh& mesh = Core::instance().root().create_component<CMesh>("replicated_mesh");
+  CMeshReader::Ptr reader = build_component_abstract_type<CMeshReader>("CF.Mesh.CGNS.CReader","replicated_cgnsreader");
+  reader->read_mesh_into("rectangle-tg-p1-mpi.cgns",mesh);
+
+  const bool is_owner = Comm::PE::instance().rank() == 0;
+
+  for(Uint i = 0; i != mesh.geometry().size(); ++i)
+    BOOST_CHECK_EQUAL(mesh.geometry().is_ghost(i), !is_owner);
+
+  Uint nb_cells = 0;
+  boost_foreach(const CElements& elements, find_components_recursively_with_filter<CElements>(mesh.topology(), IsElementsVolume()))
+  {
+    nb_cells += elements.size();
+    for(Uint e = 0; e != elements.size(); ++e)
+      BOOST_CHECK_EQUAL(elements.is_ghost(e), !is_owner);
+  }
+
+  int file_idx;
+  char zone_name[CGNS_CHAR_MAX];
+  int size[3];
+  CALL_CGNS(cg_open("rectangle-tg-p1-mpi.cgns", CG_MODE_READ, &file_idx));
+  CALL_CGNS(cg_zone_read(file_idx, 1, 1, zone_name, size));
+  CALL_CGNS(cg_close(file_idx));
+
+  BOOST_CHECK_EQUAL(static_cast<Uint>(size[CGNS_VERT_IDX]), mesh.geometry().size());
+  BOOST_CHECK_EQUAL(static_cast<Uint>(size[CGNS_CELL_IDX]), nb_cells);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( finalize_mpi )
+{
+  Core::instance().terminate();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,257 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Benchmark of the mesh generation, transformation, IO and synchronization"
+
+#include <boost/test/unit_test.hpp>
+
+#include "Common/Core.hpp"
+#include "Common/CRoot.hpp"
+#include "Common/FindComponents.hpp"
+#include "Common/Foreach.hpp"
+#include "Common/StringConversion.hpp"
+
+#include "Common/MPI/PE.hpp"
+
+#include "Mesh/CElements.hpp"
+#include "Mesh/CMesh.hpp"
+#include "Mesh/CMeshGenerator.hpp"
+#include "Mesh/CMeshReader.hpp"
+#include "Mesh/CMeshTransformer.hpp"
+#include "Mesh/CMeshWriter.hpp"
+#include "Mesh/CRegion.hpp"
+#include "Mesh/Field.hpp"
+#include "Mesh/Geometry.hpp"
+
+#include "Mesh/BlockMesh/BlockData.hpp"
+#include "Mesh/BlockMesh/CStructuredElements.hpp"
+
+#include "Tools/MeshGeneration/MeshGeneration.hpp"
+#include "Tools/Testing/Benchmark.hpp"
+
+using namespace CF;
+using namespace CF::Mesh;
+using namespace CF::Common;
+using namespace CF::Tools::Testing;
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_GLOBAL_FIXTURE( BenchmarkOutput );
+
+struct MeshBenchmarkFixture : BenchmarkFixture
+{
+  /// Number of volume elements on this rank
+  Uint nb_elements(const CMesh& mesh)
+  {
+    Uint result = 0;
+    boost_foreach(const CElements& elements, find_components_recursively_with_filter<CElements>(mesh.topology(), IsElementsVolume()))
+      result += elements.size();
+    return result;
+  }
+
+  CMesh& mesh()
+  {
+    return Core::instance().root().get_child("mesh").as_type<CMesh>();
+  }
+
+  /// Name of the file written by this rank: the mesh writers add the rank to the file name in parallel
+  std::string rank_file_name(const std::string& basename, const std::string& extension)
+  {
+    if(Comm::PE::instance().size() > 1)
+      return basename + "_P" + to_str(Comm::PE::instance().rank()) + extension;
+    return basename + extension;
+  }
+
+  /// Channel blocks with a constant size per rank, partitioned along X
+  void channel_blocks(BlockMesh::BlockData& partitioned_blocks)
+  {
+    BlockMesh::BlockData blocks;
+    Tools::MeshGeneration::create_channel_3d(blocks, 10., 0.5, 5., 16, 8, 12, 0.1);
+
+    const Uint nb_procs = Comm::PE::instance().size();
+    boost_foreach(BlockMesh::BlockData::CountsT& subdivisions, blocks.block_subdivisions)
+    {
+      for(Uint i = 0; i != subdivisions.size(); ++i)
+        subdivisions[i] *= (i == XX ? scale()*nb_procs : scale());
+    }
+
+    BlockMesh::partition_blocks(blocks, nb_procs, XX, partitioned_blocks);
+  }
+};
+
+/// Sums the node indices of all elements, so the loop can't be optimized away
+struct NodeSum
+{
+  NodeSum() : sum(0) {}
+
+  void operator()(const Uint elem_idx, const Uint* nodes)
+  {
+    for(Uint i = 0; i != 8; ++i)
+      sum += nodes[i];
+  }
+
+  Uint sum;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE( MeshBenchmarkSuite )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( init_mpi )
+{
+  Core::instance().initiate(boost::unit_test::framework::master_test_suite().argc, boost::unit_test::framework::master_test_suite().argv);
+  Comm::PE::instance().init(boost::unit_test::framework::master_test_suite().argc, boost::unit_test::framework::master_test_suite().argv);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_CASE( GenerateMesh, MeshBenchmarkFixture )
+{
+  // The size per rank is kept constant
+  const Uint nb_procs = Comm::PE::instance().size();
+  std::vector<Uint> nb_cells(2);
+  std::vector<Real> lengths(2, 1.);
+  nb_cells[XX] = 250 * scale() * nb_procs;
+  nb_cells[YY] = 250 * scale();
+
+  CMeshGenerator::Ptr generator = build_component_abstract_type<CMeshGenerator>("CF.Mesh.CSimpleMeshGenerator","generator");
+  generator->configure_option("parent", URI("//Root"));
+  generator->configure_option("name", std::string("mesh"));
+  generator->configure_option("nb_cells", nb_cells);
+  generator->configure_option("lengths", lengths);
+
+  restart_timer();
+  generator->execute();
+
+  set_problem_size(nb_elements(mesh()));
+}
+
+BOOST_FIXTURE_TEST_CASE( GlobalNumbering, MeshBenchmarkFixture )
+{
+  CMeshTransformer::Ptr glb_numbering = build_component_abstract_type<CMeshTransformer>("CF.Mesh.Actions.CGlobalNumbering","glb_numbering");
+  restart_timer();
+  glb_numbering->transform(mesh());
+  set_problem_size(mesh().geometry().size());
+}
+
+BOOST_FIXTURE_TEST_CASE( BuildFaces, MeshBenchmarkFixture )
+{
+  CMeshTransformer::Ptr build_faces = build_component_abstract_type<CMeshTransformer>("CF.Mesh.Actions.CBuildFaces","build_faces");
+  restart_timer();
+  build_faces->transform(mesh());
+  set_problem_size(nb_elements(mesh()));
+}
+
+BOOST_FIXTURE_TEST_CASE( Synchronize, MeshBenchmarkFixture )
+{
+  Field& field = mesh().geometry().create_field("benchmark_field", "u[vector]");
+  field.parallelize();
+  for(Uint i = 0; i != field.size(); ++i)
+    for(Uint j = 0; j != field.row_size(); ++j)
+      field[i][j] = static_cast<Real>(Comm::PE::instance().rank());
+
+  restart_timer();
+  for(Uint i = 0; i != 100; ++i)
+    field.synchronize();
+
+  set_problem_size(field.size());
+}
+
+BOOST_FIXTURE_TEST_CASE( WriteMesh, MeshBenchmarkFixture )
+{
+  CMeshWriter::Ptr writer = build_component_abstract_type<CMeshWriter>("CF.Mesh.Binary.CWriter","writer");
+  restart_timer();
+  writer->write_from_to(mesh(), "benchmark-mesh.cfbin");
+  set_problem_size(nb_elements(mesh()));
+}
+
+BOOST_FIXTURE_TEST_CASE( ReadMesh, MeshBenchmarkFixture )
+{
+  CMesh& read_mesh = Core::instance().root().create_component<CMesh>("read_mesh");
+  CMeshReader::Ptr reader = build_component_abstract_type<CMeshReader>("CF.Mesh.Binary.CReader","reader");
+  restart_timer();
+  reader->read_mesh_into("benchmark-mesh.cfbin", read_mesh);
+  set_problem_size(nb_elements(read_mesh));
+
+  BOOST_CHECK_EQUAL(nb_elements(read_mesh), nb_elements(mesh()));
+}
+
+BOOST_FIXTURE_TEST_CASE( WriteMeshGmsh, MeshBenchmarkFixture )
+{
+  CMeshWriter::Ptr writer = build_component_abstract_type<CMeshWriter>("CF.Mesh.Gmsh.CWriter","gmsh_writer");
+  restart_timer();
+  writer->write_from_to(mesh(), "benchmark-mesh.msh");
+  set_problem_size(nb_elements(mesh()));
+}
+
+BOOST_FIXTURE_TEST_CASE( ReadMeshGmsh, MeshBenchmarkFixture )
+{
+  // Each rank reads back the file it wrote as a whole
+  CMesh& read_mesh = Core::instance().root().create_component<CMesh>("read_mesh_gmsh");
+  CMeshReader::Ptr reader = build_component_abstract_type<CMeshReader>("CF.Mesh.Gmsh.CReader","gmsh_reader");
+  reader->configure_option("part", 0u);
+  reader->configure_option("nb_parts", 1u);
+  restart_timer();
+  reader->read_mesh_into(rank_file_name("benchmark-mesh", ".msh"), read_mesh);
+  set_problem_size(nb_elements(read_mesh));
+
+  BOOST_CHECK_EQUAL(nb_elements(read_mesh), nb_elements(mesh()));
+}
+
+BOOST_FIXTURE_TEST_CASE( BuildBlockMesh, MeshBenchmarkFixture )
+{
+  BlockMesh::BlockData blocks;
+  channel_blocks(blocks);
+
+  CMesh& block_mesh = Core::instance().root().create_component<CMesh>("block_mesh");
+  restart_timer();
+  BlockMesh::build_mesh(blocks, block_mesh);
+  set_problem_size(nb_elements(block_mesh));
+}
+
+BOOST_FIXTURE_TEST_CASE( BuildStructuredBlockMesh, MeshBenchmarkFixture )
+{
+  BlockMesh::BlockData blocks;
+  channel_blocks(blocks);
+
+  CMesh& structured_mesh = Core::instance().root().create_component<CMesh>("structured_mesh");
+  restart_timer();
+  BlockMesh::build_structured_mesh(blocks, structured_mesh);
+  set_problem_size(nb_elements(structured_mesh));
+}
+
+BOOST_FIXTURE_TEST_CASE( StructuredElementLoop, MeshBenchmarkFixture )
+{
+  const BlockMesh::CStructuredElements& elements = find_component_recursively<BlockMesh::CStructuredElements>(Core::instance().root().get_child("structured_mesh"));
+  const Uint blocks_end = elements.first_block() + elements.nb_blocks();
+
+  NodeSum node_sum;
+  for(Uint i = 0; i != 10; ++i)
+    for(Uint block = elements.first_block(); block != blocks_end; ++block)
+      elements.for_each_element(block, node_sum);
+
+  set_problem_size(elements.size());
+
+  BOOST_CHECK(node_sum.sum > 0);
+  BOOST_CHECK(!elements.is_connectivity_stored());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( finalize_mpi )
+{
+  Comm::PE::instance().finalize();
+  Core::instance().terminate();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
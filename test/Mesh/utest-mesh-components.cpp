@@ -232,6 +232,53 @@ BOOST_AUTO_TEST_CASE( FlushTest )
 
 //////////////////////////////////////////////////////////////////////////////
 
+BOOST_AUTO_TEST_CASE( ArenaTest )
+{
+  CTable<Uint>::Ptr table (new CTable<Uint>("table"));
+  Uint nbCols = 2;
+  table->set_row_size(nbCols);
+  // start with an arena of 2 rows, which grows by doubling
+  CTable<Uint>::Buffer buffer = table->create_buffer(2);
+
+  std::vector<Uint> row(nbCols);
+  const Uint nb_rows = 1000;
+  for(Uint i=0; i<nb_rows; ++i)
+  {
+    row[0] = i; row[1] = 2*i;
+    BOOST_CHECK_EQUAL(buffer.add_row(row), i);
+  }
+  BOOST_CHECK_EQUAL(buffer.buffers_count(), (Uint) 1);
+  BOOST_CHECK_EQUAL(buffer.total_allocated(), (Uint) 1024);
+  BOOST_CHECK_EQUAL(buffer.get_row(999)[1], (Uint) 1998);
+
+  // remove every other row in the arena
+  for(Uint i=0; i<nb_rows; i+=2)
+    buffer.rm_row(i);
+
+  buffer.flush();
+  BOOST_CHECK_EQUAL(buffer.buffers_count(), (Uint) 0);
+  BOOST_CHECK_EQUAL(table->size(), nb_rows/2);
+  for(Uint i=0; i<table->size(); ++i)
+    BOOST_CHECK_EQUAL((*table)[i][0], 2*i+1);
+
+  // removing the same array row twice only removes it once
+  buffer.rm_row(0);
+  buffer.rm_row(0);
+  buffer.flush();
+  BOOST_CHECK_EQUAL(table->size(), nb_rows/2-1);
+  BOOST_CHECK_EQUAL((*table)[0][0], (Uint) 999);
+
+  // a removed array row that is set again is kept
+  buffer.rm_row(1);
+  row[0] = 42;
+  buffer.set_row(1, row);
+  buffer.flush();
+  BOOST_CHECK_EQUAL(table->size(), nb_rows/2-1);
+  BOOST_CHECK_EQUAL((*table)[1][0], (Uint) 42);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 BOOST_AUTO_TEST_CASE( CTable_Uint_Test )
 {
   // CFinfo << "testing CTable<Uint> \n" << CFflush;
@@ -250,6 +250,57 @@ BOOST_AUTO_TEST_CASE( FieldOperators )
 
 ////////////////////////////////////////////////////////////////////////////////
 
+BOOST_AUTO_TEST_CASE( ColumnMajorField )
+{
+  FieldGroup& cells_P0 = m_mesh->get_child("cells_P0").as_type<FieldGroup>();
+  Field& row_field = cells_P0.create_field("row_field","u[vector]");
+  Field& column_field = cells_P0.create_field("column_field","u[vector]");
+  BOOST_CHECK_EQUAL ( column_field.layout() , Field::ROW_MAJOR );
+
+  for (Uint i=0; i<column_field.size(); ++i)
+    for (Uint j=0; j<column_field.row_size(); ++j)
+      column_field[i][j] = static_cast<Real>(i*column_field.row_size() + j);
+  row_field = column_field;
+
+  // switching the layout keeps the contents
+  column_field.configure_option("column_major", true);
+  BOOST_CHECK_EQUAL ( column_field.layout() , Field::COLUMN_MAJOR );
+  BOOST_CHECK_EQUAL ( column_field.size() , row_field.size() );
+  BOOST_CHECK_EQUAL ( column_field.row_size() , row_field.row_size() );
+  for (Uint i=0; i<column_field.size(); ++i)
+    for (Uint j=0; j<column_field.row_size(); ++j)
+      BOOST_CHECK_EQUAL ( column_field[i][j] , row_field[i][j] );
+
+  // columns are contiguous
+  BOOST_CHECK_GT ( column_field.size() , 1u );
+  Field::Column column = column_field.column(1);
+  BOOST_CHECK_EQUAL ( column.size() , column_field.size() );
+  BOOST_CHECK_EQUAL ( &column[1] - &column[0] , 1 );
+  BOOST_CHECK_EQUAL ( column[1] , row_field[1][1] );
+
+  // the layout survives a resize
+  column_field.resize(column_field.size());
+  BOOST_CHECK_EQUAL ( column_field.layout() , Field::COLUMN_MAJOR );
+
+  // operators on mixed and equal layouts
+  column_field += row_field;
+  BOOST_CHECK_EQUAL ( column_field[1][1] , 2.*row_field[1][1] );
+  column_field -= row_field;
+  BOOST_CHECK_EQUAL ( column_field[1][1] , row_field[1][1] );
+  column_field *= 3.;
+  BOOST_CHECK_EQUAL ( column_field[1][1] , 3.*row_field[1][1] );
+  column_field += column_field;
+  BOOST_CHECK_EQUAL ( column_field[1][1] , 6.*row_field[1][1] );
+
+  // the field group sets the layout of new fields
+  cells_P0.configure_option("column_major", true);
+  Field& group_field = cells_P0.create_field("group_field","u[vector]");
+  BOOST_CHECK_EQUAL ( group_field.layout() , Field::COLUMN_MAJOR );
+  cells_P0.configure_option("column_major", false);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 BOOST_AUTO_TEST_SUITE_END()
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -118,6 +118,31 @@ BOOST_AUTO_TEST_CASE( FillMatrix )
   }
 }
 
+/// Coordinates read from a single precision copy match the double precision path to within float accuracy
+BOOST_AUTO_TEST_CASE( FillSinglePrecision )
+{
+  const CElements& firstRegion = get_first_region();
+  const CTable<Real>& coords = firstRegion.geometry().coordinates();
+  const CTable<Uint>& conn = firstRegion.node_connectivity();
+
+  CTable<float>::Ptr coords_float = allocate_component< CTable<float> >("coords_float");
+  convert(*coords_float, coords);
+  BOOST_CHECK_EQUAL(coords_float->size(), coords.size());
+  BOOST_CHECK_EQUAL(coords_float->row_size(), coords.row_size());
+
+  const Uint element_count = conn.size();
+  RealMatrix node_matrix(conn.row_size(), coords.row_size());
+  RealMatrix node_matrix_float(conn.row_size(), coords.row_size());
+  Real max_error = 0.;
+  for(Uint element = 0; element != element_count; ++element)
+  {
+    fill(node_matrix, coords, conn[element]);
+    fill(node_matrix_float, *coords_float, conn[element]);
+    max_error = std::max(max_error, (node_matrix - node_matrix_float).cwiseAbs().maxCoeff() / std::max(1., node_matrix.cwiseAbs().maxCoeff()));
+  }
+  BOOST_CHECK_LT(max_error, 1e-6);
+}
+
 //////////////////////////////////////////////////////////////////////////////
 
 BOOST_AUTO_TEST_CASE( Construct_Geometry )
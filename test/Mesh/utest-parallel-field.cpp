@@ -27,6 +27,7 @@
 #include "Mesh/CElements.hpp"
 #include "Mesh/CRegion.hpp"
 #include "Mesh/Geometry.hpp"
+#include "Mesh/Field.hpp"
 #include "Mesh/CMeshReader.hpp"
 #include "Mesh/CMeshWriter.hpp"
 #include "Mesh/CMeshGenerator.hpp"
@@ -145,6 +146,15 @@ BOOST_AUTO_TEST_CASE( parallelize_and_synchronize )
 
   BOOST_CHECK(true); // Tadaa
 
+  // A single precision field is synchronized through the same comm pattern
+  SinglePrecisionField& single_field = mesh.geometry().create_field<SinglePrecisionField>("single_node_rank");
+  single_field.parallelize_with(field.parallelize());
+  for (Uint n=0; n<single_field.size(); ++n)
+    single_field[n][0] = static_cast<float>(Comm::PE::instance().rank());
+  single_field.synchronize();
+  for (Uint n=0; n<single_field.size(); ++n)
+    BOOST_CHECK_EQUAL(single_field[n][0], static_cast<float>(mesh.geometry().rank()[n]));
+
   // Create a field with glb element numbers
   boost_foreach(CEntities& elements, mesh.topology().elements_range())
     elements.create_space("elems_P0","CF.Mesh.SF.SF"+elements.element_type().shape_name()+"LagrangeP0");
@@ -194,6 +204,13 @@ BOOST_AUTO_TEST_CASE( parallelize_and_synchronize )
 
   CFinfo << "parallel_fields_P*.msh written" << CFendl;
 
+  // The single precision field is written through the "fields" option
+  std::vector<URI> field_uris;
+  field_uris.push_back(field.uri());
+  field_uris.push_back(single_field.uri());
+  msh_writer->configure_option("fields",field_uris);
+  msh_writer->write_from_to(mesh,"parallel_single_fields.msh");
+
 }
 
 BOOST_AUTO_TEST_CASE( finalize_mpi )
@@ -192,8 +192,8 @@ struct PTScotchTests_Fixture
       CFinfo << CFendl << CFendl;
     }
     
-    bool original_filter = CFinfo.getFilterRankZero(LogStream::SCREEN);
-    CFinfo.setFilterRankZero(LogStream::SCREEN,false);
+    bool original_filter = CFinfoStream.getFilterRankZero(LogStream::SCREEN);
+    CFinfoStream.setFilterRankZero(LogStream::SCREEN,false);
     for (Uint proc=0; proc<Common::mpi::PE::instance().size(); ++proc)
     {
       if (Common::mpi::PE::instance().rank() == proc)
@@ -226,7 +226,7 @@ struct PTScotchTests_Fixture
       Common::mpi::PE::instance().barrier();
     }
     Common::mpi::PE::instance().barrier();
-    CFinfo.setFilterRankZero(LogStream::SCREEN,original_filter);
+    CFinfoStream.setFilterRankZero(LogStream::SCREEN,original_filter);
   }
   
   void partition_graph(const Uint nb_parts)
@@ -248,8 +248,8 @@ struct PTScotchTests_Fixture
   
   void output_graph_partitions()
   {
-    bool original_filter = CFinfo.getFilterRankZero(LogStream::SCREEN);
-    CFinfo.setFilterRankZero(LogStream::SCREEN,false);
+    bool original_filter = CFinfoStream.getFilterRankZero(LogStream::SCREEN);
+    CFinfoStream.setFilterRankZero(LogStream::SCREEN,false);
     for (Uint proc=0; proc<Common::mpi::PE::instance().size(); ++proc)
     {
       if (Common::mpi::PE::instance().rank() == proc)
@@ -268,7 +268,7 @@ struct PTScotchTests_Fixture
       Common::mpi::PE::instance().barrier();
     }
     Common::mpi::PE::instance().barrier();
-    CFinfo.setFilterRankZero(LogStream::SCREEN,original_filter);
+    CFinfoStream.setFilterRankZero(LogStream::SCREEN,original_filter);
     CFinfo << CFendl<< CFendl;    
   }
   
@@ -128,9 +128,9 @@ BOOST_AUTO_TEST_CASE( threeD_test )
   CMesh::Ptr mesh ( allocate_component<CMesh>  ( "mesh" ) );
 
 
-  CFinfo.setFilterRankZero(false);
+  CFinfoStream.setFilterRankZero(false);
   meshreader->do_read_mesh_into(fp_in,mesh);
-  CFinfo.setFilterRankZero(true);
+  CFinfoStream.setFilterRankZero(true);
 
   boost::filesystem::path fp_out ("hextet.msh");
   CMeshWriter::Ptr gmsh_writer = build_component_abstract_type<CMeshWriter>("CF.Mesh.Gmsh.CWriter","meshwriter");
@@ -157,7 +157,7 @@ BOOST_AUTO_TEST_CASE( read_multiple_2D )
   CMesh::Ptr mesh ( allocate_component<CMesh>  ( "mesh" ) );
 
 
-  CFinfo.setFilterRankZero(false);
+  CFinfoStream.setFilterRankZero(false);
 
 
 
@@ -169,7 +169,7 @@ BOOST_AUTO_TEST_CASE( read_multiple_2D )
 
 
 
-  CFinfo.setFilterRankZero(true);
+  CFinfoStream.setFilterRankZero(true);
   CFinfo << mesh->tree() << CFendl;
   CFinfo << meshreader->tree() << CFendl;
   CMeshTransformer::Ptr info  = build_component_abstract_type<CMeshTransformer>("Info","info");
@@ -0,0 +1,213 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Parallel test module for CF::Solver::Actions::CDynamicLoadBalance"
+
+#include <boost/test/unit_test.hpp>
+
+#include "Common/Core.hpp"
+#include "Common/CRoot.hpp"
+#include "Common/CGroup.hpp"
+#include "Common/FindComponents.hpp"
+#include "Common/Foreach.hpp"
+
+#include "Common/MPI/PE.hpp"
+
+#include "Mesh/CElements.hpp"
+#include "Mesh/CEntities.hpp"
+#include "Mesh/CMesh.hpp"
+#include "Mesh/CMeshGenerator.hpp"
+#include "Mesh/CMeshTransformer.hpp"
+#include "Mesh/CRegion.hpp"
+#include "Mesh/CSpace.hpp"
+#include "Mesh/Field.hpp"
+#include "Mesh/Geometry.hpp"
+
+#include "Solver/Actions/CDynamicLoadBalance.hpp"
+
+using namespace CF;
+using namespace CF::Common;
+using namespace CF::Mesh;
+using namespace CF::Solver::Actions;
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Value stored in the geometry fields, a function of the node coordinates so it can be checked after migration
+Real node_value(const CTable<Real>::ConstRow coords)
+{
+  return 1. + coords[XX] + 10.*coords[YY];
+}
+
+/// Value stored in the element-based fields, the node value of the element centroid
+Real elem_value(const CElements& elements, const Uint elem)
+{
+  const RealMatrix coords = elements.get_coordinates(elem);
+  return 1. + coords.col(XX).mean() + 10.*coords.col(YY).mean();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE( DynamicLoadBalanceMPISuite )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( init_mpi )
+{
+  Core::instance().initiate(boost::unit_test::framework::master_test_suite().argc, boost::unit_test::framework::master_test_suite().argv);
+  Comm::PE::instance().init(boost::unit_test::framework::master_test_suite().argc, boost::unit_test::framework::master_test_suite().argv);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( RebalanceMigratesGeometryFields )
+{
+  CRoot& root = Core::instance().root();
+
+  std::vector<Uint> nb_cells(2);
+  std::vector<Real> lengths(2);
+  nb_cells[XX] = 20;
+  nb_cells[YY] = 10;
+  lengths[XX] = 2.;
+  lengths[YY] = 1.;
+
+  CMeshGenerator::Ptr generator = build_component_abstract_type<CMeshGenerator>("CF.Mesh.CSimpleMeshGenerator","generator");
+  generator->configure_option("parent", URI("//Root"));
+  generator->configure_option("name", std::string("mesh"));
+  generator->configure_option("nb_cells", nb_cells);
+  generator->configure_option("lengths", lengths);
+  generator->configure_option("bdry", false);
+  generator->execute();
+
+  CMesh& mesh = root.get_child("mesh").as_type<CMesh>();
+  build_component_abstract_type<CMeshTransformer>("CF.Mesh.Actions.LoadBalance","load_balancer")->transform(mesh);
+
+  Geometry& geometry = mesh.geometry();
+  Field& values = geometry.create_field("values", "u[scalar],v[scalar]");
+  for (Uint n=0; n<values.size(); ++n)
+  {
+    values[n][0] = node_value(geometry.coordinates()[n]);
+    values[n][1] = -values[n][0];
+  }
+  SinglePrecisionField& single_values = geometry.create_field<SinglePrecisionField>("single_values");
+  for (Uint n=0; n<single_values.size(); ++n)
+    single_values[n][0] = static_cast<float>(node_value(geometry.coordinates()[n]));
+
+  // All the work is measured on the first process
+  const Real cost = Comm::PE::instance().rank() == 0 ? 10. : 1.;
+  boost_foreach(CEntities& entities, find_components_recursively<CEntities>(mesh.topology()))
+    entities.add_cost(cost * entities.size());
+
+  CGroup& iterator = root.create_component<CGroup>("iterator");
+  iterator.properties()["iteration"] = Uint(0);
+
+  CDynamicLoadBalance& balancer = root.create_component<CDynamicLoadBalance>("balancer");
+  balancer.configure_option("mesh", mesh.uri());
+  balancer.configure_option("iterator", iterator.uri());
+  balancer.configure_option("check_rate", 1u);
+  balancer.configure_option("imbalance_threshold", 1.5);
+
+  BOOST_CHECK_GT(balancer.compute_imbalance(), 1.5);
+  balancer.execute();
+  BOOST_CHECK_GT(boost::any_cast<Real>(balancer.property("imbalance")), 1.5);
+
+  // The field values moved along with their nodes
+  BOOST_CHECK_EQUAL(values.size(), geometry.size());
+  for (Uint n=0; n<values.size(); ++n)
+  {
+    BOOST_CHECK_CLOSE(values[n][0], node_value(geometry.coordinates()[n]), 1e-12);
+    BOOST_CHECK_CLOSE(values[n][1], -node_value(geometry.coordinates()[n]), 1e-12);
+    BOOST_CHECK_CLOSE(single_values[n][0], static_cast<float>(node_value(geometry.coordinates()[n])), 1e-5f);
+  }
+
+  // The cost is measured again from scratch
+  boost_foreach(const CEntities& entities, find_components_recursively<CEntities>(mesh.topology()))
+    BOOST_CHECK_EQUAL(entities.cost(), 0.);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( RebalanceMigratesElementFields )
+{
+  CRoot& root = Core::instance().root();
+  CMesh& mesh = root.get_child("mesh").as_type<CMesh>();
+  CDynamicLoadBalance& balancer = root.get_child("balancer").as_type<CDynamicLoadBalance>();
+
+  boost_foreach(CElements& elements, find_components_recursively<CElements>(mesh.topology()))
+    elements.create_space("elems_P0","CF.Mesh.SF.SF"+elements.element_type().shape_name()+"LagrangeP0");
+  FieldGroup& elems_P0 = mesh.create_field_group("elems_P0",FieldGroup::Basis::ELEMENT_BASED);
+  Field& elem_values = elems_P0.create_field("elem_values");
+  SinglePrecisionField& single_elem_values = elems_P0.create_field<SinglePrecisionField>("single_elem_values");
+  boost_foreach(CElements& elements, elems_P0.elements_range())
+  {
+    for (Uint elem=0; elem<elements.size(); ++elem)
+    {
+      const Uint idx = elems_P0.space(elements).indexes_for_element(elem)[0];
+      elem_values[idx][0] = elem_value(elements, elem);
+      single_elem_values[idx][0] = static_cast<float>(elem_value(elements, elem));
+    }
+  }
+
+  // This time all the work is measured on the last process
+  const Real cost = Comm::PE::instance().rank() == Comm::PE::instance().size()-1 ? 10. : 1.;
+  boost_foreach(CEntities& entities, find_components_recursively<CEntities>(mesh.topology()))
+    entities.add_cost(cost * entities.size());
+
+  balancer.execute();
+  BOOST_CHECK_GT(boost::any_cast<Real>(balancer.property("imbalance")), 1.5);
+
+  // The field values moved along with their elements
+  Uint nb_elems = 0;
+  boost_foreach(CElements& elements, elems_P0.elements_range())
+  {
+    nb_elems += elements.size();
+    for (Uint elem=0; elem<elements.size(); ++elem)
+    {
+      const Uint idx = elems_P0.space(elements).indexes_for_element(elem)[0];
+      BOOST_CHECK_CLOSE(elem_values[idx][0], elem_value(elements, elem), 1e-12);
+      BOOST_CHECK_CLOSE(single_elem_values[idx][0], static_cast<float>(elem_value(elements, elem)), 1e-5f);
+    }
+  }
+  BOOST_CHECK_EQUAL(elems_P0.size(), nb_elems);
+  BOOST_CHECK_EQUAL(elem_values.size(), nb_elems);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( RefuseToLoseFields )
+{
+  CRoot& root = Core::instance().root();
+  CMesh& mesh = root.get_child("mesh").as_type<CMesh>();
+  CDynamicLoadBalance& balancer = root.get_child("balancer").as_type<CDynamicLoadBalance>();
+
+  // Fields of point-based field groups other than the geometry do not migrate with the nodes
+  boost_foreach(CElements& elements, find_components_recursively<CElements>(mesh.topology()))
+    elements.create_space("P1","CF.Mesh.SF.SF"+elements.element_type().shape_name()+"LagrangeP1");
+  FieldGroup& points_P1 = mesh.create_field_group("points_P1",FieldGroup::Basis::POINT_BASED,"P1");
+  points_P1.create_field("point_values");
+
+  const Uint nb_nodes = mesh.geometry().size();
+  BOOST_CHECK_THROW(balancer.execute(), SetupError);
+  BOOST_CHECK_EQUAL(mesh.geometry().size(), nb_nodes);
+
+  root.remove_component(balancer);
+  root.remove_component(mesh);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( finalize_mpi )
+{
+  Comm::PE::instance().finalize();
+
+  Core::instance().terminate();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -21,6 +21,7 @@
 #include "Solver/Actions/Proto/Terminals.hpp"
 
 #include "Common/Core.hpp"
+#include "Common/FindComponents.hpp"
 #include "Common/CRoot.hpp"
 #include "Common/Log.hpp"
 
@@ -30,8 +31,10 @@
 #include "Mesh/CMesh.hpp"
 #include "Mesh/CRegion.hpp"
 #include "Mesh/CElements.hpp"
+#include "Mesh/CList.hpp"
 #include "Mesh/CMeshReader.hpp"
 #include "Mesh/ElementData.hpp"
+#include "Mesh/Field.hpp"
 #include "Mesh/Geometry.hpp"
 
 #include "Mesh/Integrators/Gauss.hpp"
@@ -245,6 +248,34 @@ BOOST_AUTO_TEST_CASE( RotatingCylinderField )
   BOOST_CHECK_SMALL(force[XX], 1e-8); // Drag should be zero
 }
 
+/// Node loops using multiple threads must give the same result as the serial loop
+BOOST_AUTO_TEST_CASE( ThreadedNodeLoop )
+{
+  CMesh::Ptr mesh = Core::instance().root().create_component_ptr<CMesh>("threaded_rect");
+  Tools::MeshGeneration::create_rectangle(*mesh, 1., 1., 20, 20);
+
+  mesh->geometry().create_field( "Serial", "s" );
+  mesh->geometry().create_field( "Threaded", "t" );
+
+  MeshTerm<0, ScalarField > s("Serial", "s");
+  MeshTerm<1, ScalarField > t("Threaded", "t");
+
+  for_each_node(mesh->topology(), s = coordinates[0] * coordinates[1]);
+  for_each_node(mesh->topology(), t = coordinates[0] * coordinates[1], 4);
+
+  const Field& serial = mesh->geometry().field("Serial");
+  const Field& threaded = mesh->geometry().field("Threaded");
+  for(Uint i = 0; i != serial.size(); ++i)
+    BOOST_CHECK_EQUAL(serial[i][0], threaded[i][0]);
+
+  // The cached node list is rebuilt after a change of the mesh
+  const Uint nb_used_nodes = CEntities::used_nodes(mesh->topology()).size();
+  mesh->clear_used_nodes();
+  BOOST_CHECK(is_null(find_component_ptr_with_tag(mesh->topology(), Mesh::Tags::nodes_used())));
+  for_each_node(mesh->topology(), t = coordinates[0], 2);
+  BOOST_CHECK_EQUAL(CEntities::used_nodes(mesh->topology()).size(), nb_used_nodes);
+}
+
 struct CustomLaplacian
 {
   /// Custom ops must implement the  TR1 result_of protocol
@@ -324,6 +355,58 @@ BOOST_AUTO_TEST_CASE( VoidOp )
 
   BOOST_CHECK_EQUAL(count, 10);
 }
+
+/// Constant integrands and mass matrices on triangles use the closed form integrals, and must match the Gauss quadrature
+BOOST_AUTO_TEST_CASE( AffineQuadrature )
+{
+  CMesh::Ptr mesh = Core::instance().root().create_component_ptr<CMesh>("AffineTriags");
+  Tools::MeshGeneration::create_rectangle_tris(*mesh, 1., 1., 1, 1);
+
+  mesh->geometry().create_field( "Temperature", "T" );
+  mesh->geometry().create_field( "One", "one" );
+
+  MeshTerm<0, ScalarField > temperature("Temperature", "T");
+  MeshTerm<1, ScalarField > one("One", "one");
+
+  for_each_node(mesh->topology(), one = 1.);
+
+  RealMatrix3 mass, mass_gauss, stiffness, stiffness_gauss;
+  mass.setZero(); mass_gauss.setZero(); stiffness.setZero(); stiffness_gauss.setZero();
+
+  // Multiplying with the field "one" forces evaluation at each Gauss point
+  for_each_element< boost::mpl::vector1<SF::Triag2DLagrangeP1> >
+  (
+    mesh->topology(),
+    element_quadrature <<
+    (
+      boost::proto::lit(mass) += transpose(N(temperature))*N(temperature),
+      boost::proto::lit(mass_gauss) += one*transpose(N(temperature))*N(temperature),
+      boost::proto::lit(stiffness) += transpose(nabla(temperature))*nabla(temperature),
+      boost::proto::lit(stiffness_gauss) += one*transpose(nabla(temperature))*nabla(temperature)
+    )
+  );
+
+  for(Uint i = 0; i != 3; ++i)
+  {
+    for(Uint j = 0; j != 3; ++j)
+    {
+      BOOST_CHECK_CLOSE(mass(i,j), mass_gauss(i,j), 1e-10);
+      BOOST_CHECK_CLOSE(stiffness(i,j), stiffness_gauss(i,j), 1e-10);
+    }
+  }
+
+  // The sum of all mass matrix entries is the area
+  BOOST_CHECK_CLOSE(mass.sum(), 1., 1e-10);
+
+  // Reference tetrahedron: volume 1/6, and the quadrature is exact for quadratic functions
+  typedef Integrators::GaussMappedCoords<2, GeoShape::TETRA> TetraGaussT;
+  BOOST_CHECK_CLOSE(ReferenceMassMatrix<SF::Tetra3DLagrangeP1>::value().sum(), 1./6., 1e-10);
+  BOOST_CHECK_CLOSE(ReferenceMassMatrix<SF::Tetra3DLagrangeP1>::value()(0,0), 1./60., 1e-10);
+  Real xi_squared = 0.;
+  for(Uint i = 0; i != TetraGaussT::nb_points; ++i)
+    xi_squared += TetraGaussT::instance().weights[i] * TetraGaussT::instance().coords(0,i) * TetraGaussT::instance().coords(0,i);
+  BOOST_CHECK_CLOSE(xi_squared, 1./60., 1e-10);
+}
 /*
 BOOST_AUTO_TEST_CASE( ElementGaussQuadrature )
 {
@@ -39,6 +39,7 @@
 #include "Solver/Actions/CLoopOperation.hpp"
 #include "Solver/Actions/CComputeVolume.hpp"
 #include "Solver/Actions/CComputeArea.hpp"
+#include "Solver/Actions/CDynamicLoadBalance.hpp"
 
 #include "Mesh/SF/Triag2DLagrangeP1.hpp"
 #include "Mesh/SF/Quad2DLagrangeP1.hpp"
@@ -260,6 +261,31 @@ BOOST_AUTO_TEST_CASE ( test_CForAllElementsT )
   gmsh_writer->set_fields(fields);
   gmsh_writer->write_from_to(*mesh,"test_utest-actions_CForAllElementsT.msh");
 
+  // root.remove_component( *mesh ); // mesh needed for next test
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE ( test_ElementCost )
+{
+  CRoot& root = Core::instance().root();
+  CMesh::Ptr mesh = root.get_child_ptr("mesh2")->as_ptr<CMesh>();
+
+  // the element loops of the previous tests measured the cost of the cells
+  CElements& triags = root.access_component(mesh->topology().uri()/URI("rotation/fluid/Triag")).as_type<CElements>();
+  BOOST_CHECK_GT(triags.cost(), 0.);
+  BOOST_CHECK_CLOSE(triags.cost_per_entity(), triags.cost() / triags.size(), 1e-10);
+
+  // a serial run is always balanced
+  CDynamicLoadBalance::Ptr balancer = root.create_component_ptr<CDynamicLoadBalance>("balancer");
+  balancer->configure_option("mesh", mesh->uri());
+  BOOST_CHECK_EQUAL(balancer->compute_imbalance(), 1.);
+
+  triags.reset_cost();
+  BOOST_CHECK_EQUAL(triags.cost(), 0.);
+  BOOST_CHECK_EQUAL(triags.cost_per_entity(), 0.);
+
+  root.remove_component( *balancer );
   root.remove_component( *mesh );
 }
 
@@ -0,0 +1,245 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test module for CF::Solver::CEigenLSS"
+
+#include <boost/test/unit_test.hpp>
+
+#include "Common/CAction.hpp"
+#include "Common/Foreach.hpp"
+#include "Common/Core.hpp"
+#include "Common/CRoot.hpp"
+
+#include "Math/MatrixTypes.hpp"
+
+#include "Solver/CEigenLSS.hpp"
+
+using namespace CF;
+using namespace CF::Common;
+using namespace CF::Solver;
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Fill the LSS with the 1D Laplacian, which is symmetric
+void fill_laplacian(CEigenLSS& lss)
+{
+  const Uint n = lss.size();
+  lss.set_zero();
+  for(Uint i = 0; i != n; ++i)
+  {
+    lss.at(i, i) = 2.;
+    if(i > 0)
+      lss.at(i, i-1) = -1.;
+    if(i < n-1)
+      lss.at(i, i+1) = -1.;
+  }
+}
+
+/// Copy of the system matrix
+RealMatrix dense_matrix(CEigenLSS& lss)
+{
+  const Uint n = lss.size();
+  RealMatrix result(n, n);
+  for(Uint i = 0; i != n; ++i)
+    for(Uint j = 0; j != n; ++j)
+      result(i, j) = lss.at(i, j);
+  return result;
+}
+
+/// Applies the 1D Laplacian without storing it, as a proto assembly action would in matrix-free mode
+class LaplacianOperator : public CAction
+{
+public:
+  typedef boost::shared_ptr<LaplacianOperator> Ptr;
+  typedef boost::shared_ptr<LaplacianOperator const> ConstPtr;
+
+  LaplacianOperator(const std::string& name) : CAction(name), lss(0), nb_applications(0)
+  {
+  }
+
+  static std::string type_name () { return "LaplacianOperator"; }
+
+  virtual void execute()
+  {
+    const Uint n = lss->size();
+    if(!lss->is_applying_operator())
+    {
+      lss->diagonal().setConstant(2.);
+      return;
+    }
+
+    ++nb_applications;
+    const RealVector& x = lss->operator_input();
+    RealVector& y = lss->operator_output();
+    for(Uint i = 0; i != n; ++i)
+    {
+      y[i] += 2.*x[i];
+      if(i > 0)
+        y[i] -= x[i-1];
+      if(i < n-1)
+        y[i] -= x[i+1];
+    }
+  }
+
+  CEigenLSS* lss;
+  Uint nb_applications;
+};
+
+BOOST_AUTO_TEST_SUITE( CEigenLSSSuite )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( SymmetricDirichlet )
+{
+  CEigenLSS& lss = Core::instance().root().create_component<CEigenLSS>("LSS");
+  const Uint n = 6;
+  lss.resize(n);
+  fill_laplacian(lss);
+
+  std::vector<Uint> rows(2);
+  std::vector<Real> values(2);
+  rows[0] = 0; values[0] = 1.;
+  rows[1] = n-1; values[1] = 2.;
+  lss.set_dirichlet_bcs(rows, values);
+
+  const RealMatrix A = dense_matrix(lss);
+  BOOST_CHECK(A == A.transpose());
+
+  // The solution is linear between both boundary values
+  const RealVector x = Eigen::FullPivLU<RealMatrix>(A).solve(lss.rhs());
+  for(Uint i = 0; i != n; ++i)
+    BOOST_CHECK_CLOSE(x[i], 1. + static_cast<Real>(i) / static_cast<Real>(n-1), 1e-8);
+}
+
+BOOST_AUTO_TEST_CASE( StoredDirichlet )
+{
+  CEigenLSS& lss = Core::instance().root().get_child("LSS").as_type<CEigenLSS>();
+  const Uint n = lss.size();
+  fill_laplacian(lss);
+
+  lss.configure_option("symmetric_dirichlet", true);
+  lss.set_dirichlet_bc(0, 1.);
+  lss.set_dirichlet_bc(n-1, 2.);
+
+  // Nothing changed yet
+  BOOST_CHECK_EQUAL(lss.at(1, 0), -1.);
+
+  lss.apply_dirichlet_bcs();
+  BOOST_CHECK_EQUAL(lss.at(1, 0), 0.);
+  BOOST_CHECK_EQUAL(lss.at(0, 1), 0.);
+  BOOST_CHECK_EQUAL(lss.at(0, 0), 1.);
+  BOOST_CHECK_EQUAL(lss.rhs()[1], 1.);
+  BOOST_CHECK_EQUAL(lss.rhs()[n-2], 2.);
+  BOOST_CHECK_EQUAL(lss.rhs()[n-1], 2.);
+}
+
+BOOST_AUTO_TEST_CASE( MatrixFree )
+{
+  CEigenLSS& lss = Core::instance().root().create_component<CEigenLSS>("MatrixFreeLSS");
+  LaplacianOperator& op = Core::instance().root().create_component<LaplacianOperator>("Operator");
+  op.lss = &lss;
+
+  lss.configure_option("matrix_free", true);
+  lss.configure_option("operator", op.uri());
+  lss.configure_option("tolerance", 1e-12);
+
+  const Uint n = 20;
+  lss.resize(n);
+  BOOST_CHECK_EQUAL(lss.size(), n);
+
+  std::vector<std::string> methods;
+  methods.push_back("CG");
+  methods.push_back("GMRES");
+  boost_foreach(const std::string& method, methods)
+  {
+    lss.configure_option("krylov_method", method);
+    lss.set_zero();
+    op.execute(); // assembly, only filling the diagonal
+    lss.set_dirichlet_bc(0, 1.);
+    lss.set_dirichlet_bc(n-1, 2.);
+
+    op.nb_applications = 0;
+    lss.solve();
+    BOOST_CHECK(op.nb_applications > 0);
+
+    // The solution is linear between both boundary values
+    for(Uint i = 0; i != n; ++i)
+      BOOST_CHECK_CLOSE(lss.solution()[i], 1. + static_cast<Real>(i) / static_cast<Real>(n-1), 1e-6);
+  }
+
+  // GMRES without inner iterations would never converge
+  lss.configure_option("gmres_restart", 0u);
+  BOOST_CHECK_THROW(lss.solve(), SetupError);
+  lss.configure_option("gmres_restart", 30u);
+}
+
+BOOST_AUTO_TEST_CASE( BlockSIMPLE )
+{
+  CEigenLSS& lss = Core::instance().root().create_component<CEigenLSS>("SaddlePointLSS");
+  lss.configure_option("preconditioner", std::string("SIMPLE"));
+  lss.configure_option("block_size", 2u);
+  lss.configure_option("pressure_index", 1u);
+  lss.configure_option("tolerance", 1e-12);
+
+  // 1D Stokes-like system with interleaved (u, p) unknowns: A u + B^T p = f, B u + C p = g, with B = -B^T and C a small pressure Laplacian
+  const Uint nb_nodes = 12;
+  lss.resize(2*nb_nodes);
+  lss.set_zero();
+  for(Uint i = 0; i != nb_nodes; ++i)
+  {
+    const Uint u = 2*i;
+    const Uint p = 2*i+1;
+    lss.at(u, u) = 6.;
+    lss.at(p, p) = 0.2;
+    if(i > 0)
+    {
+      lss.at(u, u-2) = -1.;
+      lss.at(u, p-2) = -0.5;
+      lss.at(p-2, u) = 0.5;
+      lss.at(p, p-2) = -0.1;
+    }
+    if(i < nb_nodes-1)
+    {
+      lss.at(u, u+2) = -1.;
+      lss.at(u, p+2) = 0.5;
+      lss.at(p+2, u) = -0.5;
+      lss.at(p, p+2) = -0.1;
+    }
+    lss.rhs()[u] = 1. + 0.1*i;
+    lss.rhs()[p] = 0.;
+  }
+
+  std::vector<Uint> rows(3);
+  std::vector<Real> values(3);
+  rows[0] = 0; values[0] = 0.;
+  rows[1] = 2*(nb_nodes-1); values[1] = 0.;
+  rows[2] = 1; values[2] = 1.;
+  lss.set_dirichlet_bcs(rows, values);
+
+  const RealMatrix A = dense_matrix(lss);
+  RealVector rhs = lss.rhs();
+  RealVector x = Eigen::FullPivLU<RealMatrix>(A).solve(rhs);
+
+  lss.solve();
+  BOOST_CHECK_SMALL((lss.solution() - x).norm() / x.norm(), 1e-8);
+
+  // Solve again for a different RHS, keeping the factorized Schur complement
+  lss.configure_option("reuse_schur_complement", true);
+  for(Uint i = 1; i != nb_nodes-1; ++i)
+    lss.rhs()[2*i] *= 2.;
+  rhs = lss.rhs();
+  x = Eigen::FullPivLU<RealMatrix>(A).solve(rhs);
+
+  lss.solve();
+  BOOST_CHECK_SMALL((lss.solution() - x).norm() / x.norm(), 1e-8);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,88 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+
+# Compare benchmark results against a stored baseline.
+#
+# Usage: compare-benchmarks.py [--tolerance=0.1] baseline current
+#
+# baseline and current are either files written by a benchmark (.json or .csv), or directories
+# containing such files, as written by the benchmark build target. Measurements are matched on
+# executable, name and number of processes. The script exits with status 1 if any measurement is
+# slower than the baseline by more than the tolerance (relative, default 10%).
+
+from __future__ import print_function
+
+import csv
+import json
+import os
+import sys
+
+def read_file(filename):
+  results = {}
+  if filename.endswith('.json'):
+    with open(filename) as f:
+      data = json.load(f)
+    for result in data['results']:
+      key = (data['executable'], result['name'], int(data['nb_procs']))
+      results[key] = (float(result['time']), int(result['size']))
+  elif filename.endswith('.csv'):
+    with open(filename) as f:
+      for row in csv.DictReader(f):
+        key = (row['executable'], row['name'], int(row['nb_procs']))
+        results[key] = (float(row['time']), int(row['size']))
+  return results
+
+def read_results(path):
+  if not os.path.isdir(path):
+    return read_file(path)
+  results = {}
+  for filename in sorted(os.listdir(path)):
+    results.update(read_file(os.path.join(path, filename)))
+  return results
+
+def main(argv):
+  tolerance = 0.1
+  paths = []
+  for arg in argv[1:]:
+    if arg.startswith('--tolerance='):
+      tolerance = float(arg.split('=')[1])
+    else:
+      paths.append(arg)
+
+  if len(paths) != 2:
+    print('Usage: ' + argv[0] + ' [--tolerance=0.1] baseline current')
+    return 2
+
+  baseline = read_results(paths[0])
+  current = read_results(paths[1])
+
+  regressions = 0
+  print('%-60s %6s %12s %12s %9s' % ('benchmark', 'procs', 'baseline', 'current', 'change'))
+  for key in sorted(current.keys()):
+    name = key[0] + '/' + key[1]
+    time = current[key][0]
+    if key not in baseline:
+      print('%-60s %6d %12s %12.4g %9s' % (name, key[2], '-', time, 'new'))
+      continue
+    base_time = baseline[key][0]
+    if baseline[key][1] != current[key][1]:
+      print('%-60s %6d %12.4g %12.4g %9s' % (name, key[2], base_time, time, 'size'))
+      continue
+    change = (time - base_time) / base_time if base_time > 0. else 0.
+    status = ''
+    if change > tolerance:
+      status = ' REGRESSION'
+      regressions += 1
+    print('%-60s %6d %12.4g %12.4g %+8.1f%%%s' % (name, key[2], base_time, time, 100.*change, status))
+
+  for key in sorted(baseline.keys()):
+    if key not in current:
+      print('%-60s %6d %12.4g %12s %9s' % (key[0] + '/' + key[1], key[2], baseline[key][0], '-', 'missing'))
+
+  if regressions:
+    print(str(regressions) + ' benchmark(s) slower than the baseline by more than ' + str(100.*tolerance) + '%')
+    return 1
+  return 0
+
+if __name__ == '__main__':
+  sys.exit(main(sys.argv))